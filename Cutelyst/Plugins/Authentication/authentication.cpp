@@ -8,6 +8,7 @@
 #include "authenticationstore.h"
 #include "context.h"
 
+#include <Cutelyst/ContextSlot>
 #include <Cutelyst/Plugins/Session/session.h>
 
 #include <QLoggingCategory>
@@ -23,8 +24,9 @@ const QStringView AuthenticationRealm::defaultRealm = u"cutelyst_authentication_
 namespace {
 thread_local Authentication *auth = nullptr;
 
-const auto AUTHENTICATION_USER       = u"_c_authentication_user"_s;
 const auto AUTHENTICATION_USER_REALM = u"_c_authentication_user_realm"_s;
+
+ContextSlot<AuthenticationUser> userSlot;
 } // namespace
 
 Authentication::Authentication(Application *parent)
@@ -107,18 +109,17 @@ AuthenticationUser Authentication::findUser(Cutelyst::Context *c,
 Cutelyst::AuthenticationUser Authentication::user(Cutelyst::Context *c)
 {
     AuthenticationUser ret;
-    const QVariant user = c->stash(AUTHENTICATION_USER);
-    if (user.isNull()) {
-        ret = AuthenticationPrivate::restoreUser(c, {}, {});
+    if (const AuthenticationUser *user = userSlot.get(c)) {
+        ret = *user;
     } else {
-        ret = user.value<AuthenticationUser>();
+        ret = AuthenticationPrivate::restoreUser(c, {}, {});
     }
     return ret;
 }
 
 bool Authentication::userExists(Cutelyst::Context *c)
 {
-    if (!c->stash(AUTHENTICATION_USER).isNull()) {
+    if (userSlot.has(c)) {
         return true;
     } else {
         if (auth) {
@@ -135,9 +136,8 @@ bool Authentication::userExists(Cutelyst::Context *c)
 
 bool Authentication::userInRealm(Cutelyst::Context *c, QStringView realmName)
 {
-    const QVariant authUser = c->stash(AUTHENTICATION_USER);
-    if (!authUser.isNull()) {
-        return authUser.value<AuthenticationUser>().authRealm() == realmName;
+    if (const AuthenticationUser *authUser = userSlot.get(c)) {
+        return authUser->authRealm() == realmName;
     } else {
         if (!auth) {
             qCCritical(C_AUTHENTICATION, "Authentication plugin not registered!");
@@ -235,7 +235,7 @@ void AuthenticationPrivate::setAuthenticated(Context *c,
                                              QStringView realmName,
                                              std::shared_ptr<AuthenticationRealm> realm)
 {
-    AuthenticationPrivate::setUser(c, user, realmName);
+    AuthenticationPrivate::setUser(c, user);
 
     if (!realm) {
         qCWarning(C_AUTHENTICATION) << "Called with invalid realm" << realmName;
@@ -244,16 +244,12 @@ void AuthenticationPrivate::setAuthenticated(Context *c,
     AuthenticationPrivate::persistUser(c, user, realmName, realm);
 }
 
-void AuthenticationPrivate::setUser(Context *c,
-                                    const AuthenticationUser &user,
-                                    QStringView realmName)
+void AuthenticationPrivate::setUser(Context *c, const AuthenticationUser &user)
 {
     if (user.isNull()) {
-        c->setStash(AUTHENTICATION_USER, QVariant());
-        c->setStash(AUTHENTICATION_USER_REALM, QVariant());
+        userSlot.reset(c);
     } else {
-        c->setStash(AUTHENTICATION_USER, QVariant::fromValue(user));
-        c->setStash(AUTHENTICATION_USER_REALM, realmName.toString());
+        userSlot.set(c, user);
     }
 }
 
@@ -27,8 +27,7 @@ public:
                                         const AuthenticationUser &user,
                                         QStringView realmName,
                                         std::shared_ptr<AuthenticationRealm> realm);
-    static inline void
-        setUser(Context *c, const AuthenticationUser &user, QStringView realmName = {});
+    static inline void setUser(Context *c, const AuthenticationUser &user);
     static inline void persistUser(Context *c,
                                    const AuthenticationUser &user,
                                    QStringView realmName,
@@ -44,12 +44,12 @@ const QByteArrayList CSRFProtectionPrivate::secureMethods = QByteArrayList({
 const QByteArray CSRFProtectionPrivate::allowedChars{
     "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_"_ba};
 const QString CSRFProtectionPrivate::sessionKey{u"_csrftoken"_s};
-const QString CSRFProtectionPrivate::stashKeyCookie{u"_c_csrfcookie"_s};
-const QString CSRFProtectionPrivate::stashKeyCookieUsed{u"_c_csrfcookieused"_s};
-const QString CSRFProtectionPrivate::stashKeyCookieNeedsReset{u"_c_csrfcookieneedsreset"_s};
-const QString CSRFProtectionPrivate::stashKeyCookieSet{u"_c_csrfcookieset"_s};
-const QString CSRFProtectionPrivate::stashKeyProcessingDone{u"_c_csrfprocessingdone"_s};
-const QString CSRFProtectionPrivate::stashKeyCheckPassed{u"_c_csrfcheckpassed"_s};
+const ContextSlot<QByteArray> CSRFProtectionPrivate::contextCookie;
+const ContextSlot<bool> CSRFProtectionPrivate::contextCookieUsed;
+const ContextSlot<bool> CSRFProtectionPrivate::contextCookieNeedsReset;
+const ContextSlot<bool> CSRFProtectionPrivate::contextCookieSet;
+const ContextSlot<bool> CSRFProtectionPrivate::contextProcessingDone;
+const ContextSlot<bool> CSRFProtectionPrivate::contextCheckPassed;
 
 CSRFProtection::CSRFProtection(Application *parent)
     : Plugin(parent)
@@ -160,7 +160,7 @@ bool CSRFProtection::setup(Application *app)
         csrf = app->plugin<CSRFProtection *>();
     });
 
-    connect(app, &Application::beforeDispatch, this, [d](Context *c) { d->beforeDispatch(c); });
+    app->addBeforeDispatchHook(this, [d](Context *c) { d->beforeDispatch(c); });
 
     return true;
 }
@@ -239,18 +239,18 @@ QByteArray CSRFProtection::getToken(Context *c)
 {
     QByteArray token;
 
-    const QByteArray contextCookie = c->stash(CSRFProtectionPrivate::stashKeyCookie).toByteArray();
+    const QByteArray contextCookie = CSRFProtectionPrivate::contextCookie.value(c);
     QByteArray secret;
     if (contextCookie.isEmpty()) {
         secret = CSRFProtectionPrivate::getNewCsrfString();
         token  = CSRFProtectionPrivate::saltCipherSecret(secret);
-        c->setStash(CSRFProtectionPrivate::stashKeyCookie, token);
+        CSRFProtectionPrivate::contextCookie.set(c, token);
     } else {
         secret = CSRFProtectionPrivate::unsaltCipherToken(contextCookie);
         token  = CSRFProtectionPrivate::saltCipherSecret(secret);
     }
 
-    c->setStash(CSRFProtectionPrivate::stashKeyCookieUsed, true);
+    CSRFProtectionPrivate::contextCookieUsed.set(c, true);
 
     return token;
 }
@@ -276,16 +276,15 @@ bool CSRFProtection::checkPassed(Context *c)
     if (CSRFProtectionPrivate::secureMethods.contains(c->req()->method())) {
         return true;
     } else {
-        return c->stash(CSRFProtectionPrivate::stashKeyCheckPassed).toBool();
+        return CSRFProtectionPrivate::contextCheckPassed.value(c);
     }
 }
 
 // void CSRFProtection::rotateToken(Context *c)
 //{
-//     c->setStash(CSRFProtectionPrivate::stashKeyCookieUsed, true);
-//     c->setStash(QString CSRFProtectionPrivate::stashKeyCookie,
-//     CSRFProtectionPrivate::getNewCsrfToken());
-//     c->setStash(CSRFProtectionPrivate::stashKeyCookieNeedsReset, true);
+//     CSRFProtectionPrivate::contextCookieUsed.set(c, true);
+//     CSRFProtectionPrivate::contextCookie.set(c, CSRFProtectionPrivate::getNewCsrfToken());
+//     CSRFProtectionPrivate::contextCookieNeedsReset.set(c, true);
 // }
 
 /**
@@ -422,7 +421,7 @@ QByteArray CSRFProtectionPrivate::getToken(Context *c)
 
         token = CSRFProtectionPrivate::sanitizeToken(cookieToken);
         if (token != cookieToken) {
-            c->setStash(CSRFProtectionPrivate::stashKeyCookieNeedsReset, true);
+            CSRFProtectionPrivate::contextCookieNeedsReset.set(c, true);
         }
     }
 
@@ -446,10 +445,10 @@ void CSRFProtectionPrivate::setToken(Context *c)
     if (csrf->d_ptr->useSessions) {
         Session::setValue(c,
                           CSRFProtectionPrivate::sessionKey,
-                          c->stash(CSRFProtectionPrivate::stashKeyCookie).toByteArray());
+                          CSRFProtectionPrivate::contextCookie.value(c));
     } else {
         QNetworkCookie cookie(csrf->d_ptr->cookieName,
-                              c->stash(CSRFProtectionPrivate::stashKeyCookie).toByteArray());
+                              CSRFProtectionPrivate::contextCookie.value(c));
         if (!csrf->d_ptr->cookieDomain.isEmpty()) {
             cookie.setDomain(csrf->d_ptr->cookieDomain);
         }
@@ -468,7 +467,7 @@ void CSRFProtectionPrivate::setToken(Context *c)
     }
 
     qCDebug(C_CSRFPROTECTION) << "Set token"
-                              << c->stash(CSRFProtectionPrivate::stashKeyCookie).toByteArray()
+                              << CSRFProtectionPrivate::contextCookie.value(c)
                               << "to" << (csrf->d_ptr->useSessions ? "session" : "cookie");
 }
 
@@ -481,7 +480,7 @@ void CSRFProtectionPrivate::reject(Context *c,
                                    const QString &logReason,
                                    const QString &displayReason)
 {
-    c->setStash(CSRFProtectionPrivate::stashKeyCheckPassed, false);
+    CSRFProtectionPrivate::contextCheckPassed.set(c, false);
 
     if (!csrf) {
         qCCritical(C_CSRFPROTECTION) << "CSRFProtection plugin not registered";
@@ -555,8 +554,8 @@ void CSRFProtectionPrivate::reject(Context *c,
 
 void CSRFProtectionPrivate::accept(Context *c)
 {
-    c->setStash(CSRFProtectionPrivate::stashKeyCheckPassed, true);
-    c->setStash(CSRFProtectionPrivate::stashKeyProcessingDone, true);
+    CSRFProtectionPrivate::contextCheckPassed.set(c, true);
+    CSRFProtectionPrivate::contextProcessingDone.set(c, true);
 }
 
 /**
@@ -592,12 +591,12 @@ void CSRFProtectionPrivate::beforeDispatch(Context *c)
 
     const QByteArray csrfToken = CSRFProtectionPrivate::getToken(c);
     if (!csrfToken.isNull()) {
-        c->setStash(CSRFProtectionPrivate::stashKeyCookie, csrfToken);
+        CSRFProtectionPrivate::contextCookie.set(c, csrfToken);
     } else {
         CSRFProtection::getToken(c);
     }
 
-    if (c->stash(CSRFProtectionPrivate::stashKeyProcessingDone).toBool()) {
+    if (CSRFProtectionPrivate::contextProcessingDone.value(c)) {
         return;
     }
 
@@ -780,18 +779,18 @@ void CSRFProtectionPrivate::beforeDispatch(Context *c)
     // Set the CSRF cookie even if it's already set, so we renew
     // the expiry timer.
 
-    if (!c->stash(CSRFProtectionPrivate::stashKeyCookieNeedsReset).toBool()) {
-        if (c->stash(CSRFProtectionPrivate::stashKeyCookieSet).toBool()) {
+    if (!CSRFProtectionPrivate::contextCookieNeedsReset.value(c)) {
+        if (CSRFProtectionPrivate::contextCookieSet.value(c)) {
             return;
         }
     }
 
-    if (!c->stash(CSRFProtectionPrivate::stashKeyCookieUsed).toBool()) {
+    if (!CSRFProtectionPrivate::contextCookieUsed.value(c)) {
         return;
     }
 
     CSRFProtectionPrivate::setToken(c);
-    c->setStash(CSRFProtectionPrivate::stashKeyCookieSet, true);
+    CSRFProtectionPrivate::contextCookieSet.set(c, true);
 }
 
 #include "moc_csrfprotection.cpp"
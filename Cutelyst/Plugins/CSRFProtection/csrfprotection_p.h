@@ -8,6 +8,8 @@
 
 #include "csrfprotection.h"
 
+#include <Cutelyst/ContextSlot>
+
 #include <chrono>
 
 #include <QNetworkCookie>
@@ -37,12 +39,12 @@ public:
     static constexpr qsizetype secretLength{32};
     static constexpr qsizetype tokenLength{2 * secretLength};
     static const QString sessionKey;
-    static const QString stashKeyCookie;
-    static const QString stashKeyCookieUsed;
-    static const QString stashKeyCookieNeedsReset;
-    static const QString stashKeyCookieSet;
-    static const QString stashKeyProcessingDone;
-    static const QString stashKeyCheckPassed;
+    static const ContextSlot<QByteArray> contextCookie;
+    static const ContextSlot<bool> contextCookieUsed;
+    static const ContextSlot<bool> contextCookieNeedsReset;
+    static const ContextSlot<bool> contextCookieSet;
+    static const ContextSlot<bool> contextProcessingDone;
+    static const ContextSlot<bool> contextCheckPassed;
 
     QVariantMap defaultConfig;
     QStringList trustedOrigins;
@@ -0,0 +1,534 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "cache_p.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Engine>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
+#include <optional>
+#include <vector>
+
+#include <QHash>
+#include <QLoggingCategory>
+#include <QMutex>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+Q_LOGGING_CATEGORY(C_CACHE, "cutelyst.plugin.cache", QtWarningMsg)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr qint64 defaultShards  = 16;
+constexpr qint64 defaultMaxCost = 64 * 1024 * 1024;
+
+// Memory used by an entry besides its key and value
+constexpr qint64 entryOverhead = 64;
+
+// Approximate access frequency of the recent keys of a shard, made of 4 bit counters
+// that are halved once enough accesses were recorded so that old popularity fades away
+class FrequencySketch
+{
+public:
+    void increment(quint64 hash);
+    [[nodiscard]] int frequency(quint64 hash) const;
+
+private:
+    // 16 counters per word
+    static constexpr std::size_t words = 4096;
+    static constexpr qint64 sampleSize = 10 * qint64(words);
+    static constexpr quint64 halveMask = 0x7777777777777777;
+    static constexpr int depth         = 4;
+
+    static constexpr std::array<quint64, depth> seeds = {
+        0xc3a5c85c97cb3127, 0xb492b66fbe98f273, 0x9ae16a3b2f90404f, 0xcbf29ce484222325};
+
+    [[nodiscard]] static quint64 indexHash(quint64 hash, int i)
+    {
+        const quint64 ret = (hash + seeds[i]) * 0x9e3779b97f4a7c15;
+        return ret ^ (ret >> 32);
+    }
+
+    // Only allocated for the TinyLFU eviction
+    std::vector<quint64> table;
+    qint64 additions = 0;
+};
+
+void FrequencySketch::increment(quint64 hash)
+{
+    if (table.empty()) {
+        table.resize(words);
+    }
+
+    bool added = false;
+    for (int i = 0; i < depth; ++i) {
+        const quint64 h = indexHash(hash, i);
+        quint64 &word   = table[h % words];
+        const int shift = int(h >> 60) * 4;
+        if (((word >> shift) & 0xf) < 15) {
+            word += quint64(1) << shift;
+            added = true;
+        }
+    }
+
+    if (added && ++additions >= sampleSize) {
+        for (quint64 &word : table) {
+            word = (word >> 1) & halveMask;
+        }
+        additions /= 2;
+    }
+}
+
+int FrequencySketch::frequency(quint64 hash) const
+{
+    if (table.empty()) {
+        return 0;
+    }
+
+    int ret = 15;
+    for (int i = 0; i < depth; ++i) {
+        const quint64 h = indexHash(hash, i);
+        ret             = std::min(ret, int((table[h % words] >> (int(h >> 60) * 4)) & 0xf));
+    }
+    return ret;
+}
+
+class Shard
+{
+public:
+    struct Node {
+        QByteArray key;
+        QVariant value;
+        quint64 hash;
+        qint64 cost;
+        // Never expires if not set
+        std::optional<Clock::time_point> expires;
+    };
+
+    QVariant get(const QByteArray &key, quint64 hash, bool tinyLfu);
+    bool set(Node node, bool onlyAdd, qint64 maxCost, bool tinyLfu);
+    bool remove(const QByteArray &key);
+    void clear();
+    Cache::Stats stats();
+    void resetStats();
+
+private:
+    // Must be called with the mutex locked, returns false if the new entry is not admitted
+    bool makeRoom(qint64 needed, qint64 maxCost, quint64 hash, bool tinyLfu, Clock::time_point now);
+    void erase(std::list<Node>::iterator it);
+
+    // Most recently used first
+    std::list<Node> lru;
+    QHash<QByteArray, std::list<Node>::iterator> index;
+    FrequencySketch sketch;
+    QMutex mutex;
+    Cache::Stats counters;
+};
+
+struct Storage {
+    explicit Storage(std::size_t count)
+        : shards(count)
+    {
+    }
+
+    Shard &shard(quint64 hash) { return shards[hash % shards.size()]; }
+
+    // Not movable because of the mutexes, so never resized
+    std::vector<Shard> shards;
+    std::atomic<qint64> maxCost = defaultMaxCost;
+    // Milliseconds
+    std::atomic<qint64> defaultTtl = 0;
+    std::atomic<bool> tinyLfu      = false;
+};
+
+QBasicMutex storageMutex;
+std::unique_ptr<Storage> ownedStorage;
+std::atomic<Storage *> currentStorage = nullptr;
+
+// The storage is created with shardCount shards on the first call
+Storage &storage(std::size_t shardCount = defaultShards)
+{
+    Storage *ret = currentStorage.load(std::memory_order_acquire);
+    if (Q_UNLIKELY(!ret)) {
+        QMutexLocker locker(&storageMutex);
+        ret = currentStorage.load(std::memory_order_relaxed);
+        if (!ret) {
+            ownedStorage = std::make_unique<Storage>(shardCount);
+            ret          = ownedStorage.get();
+            currentStorage.store(ret, std::memory_order_release);
+        }
+    }
+    return *ret;
+}
+
+qint64 stringCost(const QString &string)
+{
+    return qint64(sizeof(QString) + sizeof(QChar) * string.size());
+}
+
+qint64 estimatedCost(const QVariant &value);
+
+template <typename Map>
+qint64 mapCost(const Map &map)
+{
+    qint64 cost = qint64(sizeof(QVariant));
+    for (const auto &[key, item] : map.asKeyValueRange()) {
+        cost += stringCost(key) + estimatedCost(item);
+    }
+    return cost;
+}
+
+// Containers are charged for what they hold, a map of big strings is not a pointer
+qint64 estimatedCost(const QVariant &value)
+{
+    switch (value.typeId()) {
+    case QMetaType::QByteArray:
+        return qint64(sizeof(QVariant)) + value.toByteArray().size();
+    case QMetaType::QString:
+        return qint64(sizeof(QVariant) + sizeof(QChar) * value.toString().size());
+    case QMetaType::QStringList:
+    {
+        qint64 cost = qint64(sizeof(QVariant));
+        for (const QString &string : value.toStringList()) {
+            cost += stringCost(string);
+        }
+        return cost;
+    }
+    case QMetaType::QVariantList:
+    {
+        qint64 cost = qint64(sizeof(QVariant));
+        for (const QVariant &item : value.toList()) {
+            cost += estimatedCost(item);
+        }
+        return cost;
+    }
+    case QMetaType::QVariantMap:
+        return mapCost(value.toMap());
+    case QMetaType::QVariantHash:
+        return mapCost(value.toHash());
+    default:
+        return qint64(sizeof(QVariant)) + value.metaType().sizeOf();
+    }
+}
+
+bool isExpired(const Shard::Node &node, Clock::time_point now)
+{
+    return node.expires && *node.expires <= now;
+}
+
+QVariant Shard::get(const QByteArray &key, quint64 hash, bool tinyLfu)
+{
+    QMutexLocker locker(&mutex);
+    if (tinyLfu) {
+        sketch.increment(hash);
+    }
+
+    auto it = index.constFind(key);
+    if (it == index.cend()) {
+        ++counters.misses;
+        return {};
+    }
+
+    auto node = *it;
+    if (isExpired(*node, Clock::now())) {
+        ++counters.misses;
+        ++counters.expirations;
+        erase(node);
+        return {};
+    }
+
+    ++counters.hits;
+    lru.splice(lru.begin(), lru, node);
+    return node->value;
+}
+
+bool Shard::set(Node node, bool onlyAdd, qint64 maxCost, bool tinyLfu)
+{
+    const auto now = Clock::now();
+
+    QMutexLocker locker(&mutex);
+    if (tinyLfu) {
+        sketch.increment(node.hash);
+    }
+
+    auto it = index.find(node.key);
+    if (it != index.end()) {
+        auto existing = *it;
+        if (!isExpired(*existing, now)) {
+            if (onlyAdd) {
+                return false;
+            }
+        } else {
+            ++counters.expirations;
+        }
+        erase(existing);
+    }
+
+    if (node.cost > maxCost || !makeRoom(node.cost, maxCost, node.hash, tinyLfu, now)) {
+        ++counters.rejections;
+        return false;
+    }
+
+    counters.cost += node.cost;
+    lru.push_front(std::move(node));
+    index.insert(lru.front().key, lru.begin());
+    return true;
+}
+
+bool Shard::remove(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return false;
+    }
+    erase(*it);
+    return true;
+}
+
+void Shard::clear()
+{
+    QMutexLocker locker(&mutex);
+    lru.clear();
+    index.clear();
+    counters.cost = 0;
+}
+
+Cache::Stats Shard::stats()
+{
+    QMutexLocker locker(&mutex);
+    Cache::Stats ret = counters;
+    ret.count        = index.size();
+    return ret;
+}
+
+void Shard::resetStats()
+{
+    QMutexLocker locker(&mutex);
+    counters = {.cost = counters.cost};
+}
+
+bool Shard::makeRoom(qint64 needed,
+                     qint64 maxCost,
+                     quint64 hash,
+                     bool tinyLfu,
+                     Clock::time_point now)
+{
+    if (counters.cost + needed <= maxCost) {
+        return true;
+    }
+
+    // Entries that would be evicted must be expired or less popular than the new one
+    if (tinyLfu) {
+        const int frequency = sketch.frequency(hash);
+        qint64 freed        = 0;
+        for (auto it = lru.crbegin();
+             it != lru.crend() && counters.cost - freed + needed > maxCost;
+             ++it) {
+            if (!isExpired(*it, now) && sketch.frequency(it->hash) >= frequency) {
+                return false;
+            }
+            freed += it->cost;
+        }
+    }
+
+    while (counters.cost + needed > maxCost) {
+        auto last = std::prev(lru.end());
+        if (isExpired(*last, now)) {
+            ++counters.expirations;
+        } else {
+            ++counters.evictions;
+        }
+        erase(last);
+    }
+    return true;
+}
+
+void Shard::erase(std::list<Node>::iterator it)
+{
+    counters.cost -= it->cost;
+    index.remove(it->key);
+    lru.erase(it);
+}
+
+bool store(const QByteArray &key,
+           const QVariant &value,
+           std::chrono::milliseconds ttl,
+           qint64 cost,
+           bool onlyAdd)
+{
+    Storage &s = storage();
+
+    Shard::Node node{
+        .key   = key,
+        .value = value,
+        .hash  = qHash(key),
+        .cost  = key.size() + entryOverhead + (cost < 0 ? estimatedCost(value) : cost),
+    };
+    if (ttl.count() > 0) {
+        node.expires = Clock::now() + ttl;
+    }
+
+    const qint64 maxCost = s.maxCost / qint64(s.shards.size());
+    return s.shard(node.hash).set(std::move(node), onlyAdd, maxCost, s.tinyLfu);
+}
+
+} // namespace
+
+Cache::Cache(Application *parent)
+    : Plugin(parent)
+    , d_ptr(new CachePrivate)
+{
+}
+
+Cache::Cache(Application *parent, const QVariantMap &defaultConfig)
+    : Plugin(parent)
+    , d_ptr(new CachePrivate)
+{
+    Q_D(Cache);
+    d->defaultConfig = defaultConfig;
+}
+
+Cache::~Cache() = default;
+
+QVariant Cache::get(const QByteArray &key)
+{
+    Storage &s         = storage();
+    const quint64 hash = qHash(key);
+    return s.shard(hash).get(key, hash, s.tinyLfu);
+}
+
+bool Cache::set(const QByteArray &key, const QVariant &value)
+{
+    return store(key, value, std::chrono::milliseconds{storage().defaultTtl}, -1, false);
+}
+
+bool Cache::set(const QByteArray &key,
+                const QVariant &value,
+                std::chrono::milliseconds ttl,
+                qint64 cost)
+{
+    return store(key, value, ttl, cost, false);
+}
+
+bool Cache::add(const QByteArray &key,
+                const QVariant &value,
+                std::chrono::milliseconds ttl,
+                qint64 cost)
+{
+    return store(key, value, ttl, cost, true);
+}
+
+bool Cache::remove(const QByteArray &key)
+{
+    return storage().shard(qHash(key)).remove(key);
+}
+
+void Cache::clear()
+{
+    for (Shard &shard : storage().shards) {
+        shard.clear();
+    }
+}
+
+Cache::Stats Cache::stats()
+{
+    Stats ret;
+    for (Shard &shard : storage().shards) {
+        const Stats stats = shard.stats();
+        ret.hits += stats.hits;
+        ret.misses += stats.misses;
+        ret.evictions += stats.evictions;
+        ret.expirations += stats.expirations;
+        ret.rejections += stats.rejections;
+        ret.count += stats.count;
+        ret.cost += stats.cost;
+    }
+    return ret;
+}
+
+QVector<Cache::Stats> Cache::shardStats()
+{
+    QVector<Stats> ret;
+    for (Shard &shard : storage().shards) {
+        ret.append(shard.stats());
+    }
+    return ret;
+}
+
+void Cache::resetStats()
+{
+    for (Shard &shard : storage().shards) {
+        shard.resetStats();
+    }
+}
+
+void Cache::setMaxCost(qint64 cost)
+{
+    storage().maxCost = cost;
+}
+
+qint64 Cache::maxCost()
+{
+    return storage().maxCost;
+}
+
+void Cache::setEviction(Eviction eviction)
+{
+    storage().tinyLfu = eviction == Eviction::TinyLFU;
+}
+
+Cache::Eviction Cache::eviction()
+{
+    return storage().tinyLfu ? Eviction::TinyLFU : Eviction::LRU;
+}
+
+bool Cache::setup(Application *app)
+{
+    Q_D(Cache);
+
+    const QVariantMap config = app->engine()->config(u"Cutelyst_Cache_Plugin"_s);
+    auto value               = [&](const QString &key, const QVariant &defaultValue) {
+        return config.value(key, d->defaultConfig.value(key, defaultValue));
+    };
+
+    auto integer = [&](const QString &key, qint64 defaultValue, qint64 minimum) {
+        bool ok;
+        const qint64 ret = value(key, defaultValue).toLongLong(&ok);
+        if (!ok || ret < minimum) {
+            qCWarning(C_CACHE) << "Invalid" << key << "using" << defaultValue;
+            return defaultValue;
+        }
+        return ret;
+    };
+
+    const auto shards = std::size_t(integer(u"shards"_s, defaultShards, 1));
+    Storage &s        = storage(shards);
+    if (s.shards.size() != shards) {
+        qCWarning(C_CACHE) << "The cache is already in use with" << s.shards.size() << "shards";
+    }
+
+    s.maxCost    = integer(u"max_cost"_s, defaultMaxCost, 0);
+    s.defaultTtl = integer(u"default_ttl"_s, 0, 0) * 1000;
+
+    const QString eviction = value(u"eviction"_s, u"lru"_s).toString().toLower();
+    if (eviction == "tinylfu"_L1) {
+        s.tinyLfu = true;
+    } else if (eviction == "lru"_L1) {
+        s.tinyLfu = false;
+    } else {
+        qCWarning(C_CACHE) << "Invalid eviction" << eviction << "using lru";
+        s.tinyLfu = false;
+    }
+
+    return true;
+}
+
+#include "moc_cache.cpp"
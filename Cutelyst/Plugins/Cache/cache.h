@@ -0,0 +1,231 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugin>
+#include <Cutelyst/Plugins/cache_export.h>
+#include <chrono>
+#include <memory>
+
+#include <QVariant>
+
+namespace Cutelyst {
+
+class CachePrivate;
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/Cache/Cache>
+ * \brief In-process cache shared by all worker threads.
+ *
+ * The %Cache plugin keeps values in memory for as long as the process lives, a single
+ * storage is shared by the Application of every worker thread, so hot lookups like
+ * feature flags or user to tenant maps neither cost a network round trip nor are kept
+ * once per thread.
+ *
+ * Values are QVariant objects, which are implicitly shared, so getting one does not copy
+ * its data. Keys are spread over shards that each have their own lock, so threads only
+ * contend when they use keys of the same shard.
+ *
+ * <H3>Eviction</H3>
+ *
+ * Every shard keeps up to its part of \c max_cost, the cost of an entry is the size of its
+ * key plus the one passed to set() or, if not given, an estimate of the memory used by its
+ * value. Once a shard is full the least recently used entries are evicted. With the
+ * \c tinylfu eviction a count-min sketch keeps an approximate access frequency of recent keys,
+ * and a new entry is only admitted if it is accessed more often than the entries it would
+ * evict, protecting popular entries from scans of keys used only once.
+ *
+ * Entries can also expire, expired entries are removed when accessed or evicted.
+ *
+ * <H3>Statistics</H3>
+ *
+ * Each shard counts its hits, misses, evictions, expirations and the entries that were not
+ * admitted, see stats() and shardStats().
+ *
+ * <H3>Runtime configuration</H3>
+ *
+ * The plugin reads the \c Cutelyst_Cache_Plugin section of the
+ * \ref configuration "application configuration file", the \a defaultConfig passed to the
+ * constructor is used for missing keys. The static methods can be used without creating
+ * the plugin, in which case the defaults are used.
+ *
+ * \configblock{max_cost,integer,67108864}
+ * Maximum cost of all entries, usually bytes.
+ * \endconfigblock
+ *
+ * \configblock{shards,integer,16}
+ * Number of shards, it can not be changed once the cache was used.
+ * \endconfigblock
+ *
+ * \configblock{default_ttl,integer,0}
+ * Seconds entries stored without a ttl are kept, \c 0 keeps them until they are evicted.
+ * \endconfigblock
+ *
+ * \configblock{eviction,string,lru}
+ * Either \c lru or \c tinylfu.
+ * \endconfigblock
+ *
+ * \code{.cpp}
+ * bool MyApp::init()
+ * {
+ *     new Cache(this, {{u"max_cost"_s, 16 * 1024 * 1024}, {u"eviction"_s, u"tinylfu"_s}});
+ * }
+ *
+ * QString Users::tenant(const QString &user)
+ * {
+ *     const QByteArray key = "tenant_" + user.toUtf8();
+ *     QVariant tenant      = Cache::get(key);
+ *     if (tenant.isNull()) {
+ *         tenant = loadTenant(user);
+ *         Cache::set(key, tenant, 5min);
+ *     }
+ *     return tenant.toString();
+ * }
+ * \endcode
+ *
+ * \logcat{plugin.cache}
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_CACHE_EXPORT Cache : public Plugin
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(Cache) // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    Q_DISABLE_COPY(Cache)
+public:
+    /**
+     * How entries are evicted when a shard is full.
+     */
+    enum class Eviction {
+        /** The least recently used entries are evicted. */
+        LRU,
+        /** Like LRU, but new entries less frequently used than the evicted ones are dropped. */
+        TinyLFU,
+    };
+    Q_ENUM(Eviction)
+
+    /**
+     * Counters of a shard or of the whole cache.
+     */
+    struct Stats {
+        /** Lookups that found a value. */
+        quint64 hits = 0;
+        /** Lookups that found nothing or an expired entry. */
+        quint64 misses = 0;
+        /** Entries removed to make room for new ones. */
+        quint64 evictions = 0;
+        /** Entries removed because they expired. */
+        quint64 expirations = 0;
+        /** New entries bigger than a shard or not admitted by the TinyLFU eviction. */
+        quint64 rejections = 0;
+        /** Entries currently stored. */
+        qint64 count = 0;
+        /** Cost of the entries currently stored. */
+        qint64 cost = 0;
+    };
+
+    /**
+     * Constructs a new %Cache plugin with the given \a parent.
+     */
+    explicit Cache(Application *parent);
+
+    /**
+     * Constructs a new %Cache plugin with the given \a parent and \a defaultConfig
+     * values for the configuration file entries.
+     */
+    Cache(Application *parent, const QVariantMap &defaultConfig);
+
+    /**
+     * Destroys the %Cache object.
+     */
+    ~Cache() override;
+
+    /**
+     * Returns the value of \a key or a null QVariant if it is not stored or expired.
+     */
+    [[nodiscard]] static QVariant get(const QByteArray &key);
+
+    /**
+     * Stores \a value at \a key for the \c default_ttl, replacing any previous value.
+     * Returns \c false if the value was not admitted.
+     */
+    static bool set(const QByteArray &key, const QVariant &value);
+
+    /**
+     * Stores \a value at \a key for \a ttl, a zero \a ttl keeps it until it is evicted.
+     * If \a cost is negative it is estimated from \a value. Returns \c false if the value
+     * was not admitted.
+     */
+    static bool set(const QByteArray &key,
+                    const QVariant &value,
+                    std::chrono::milliseconds ttl,
+                    qint64 cost = -1);
+
+    /**
+     * Stores \a value at \a key for \a ttl only if \a key is not stored yet, returns
+     * \c false if it is or if the value was not admitted.
+     */
+    static bool add(const QByteArray &key,
+                    const QVariant &value,
+                    std::chrono::milliseconds ttl,
+                    qint64 cost = -1);
+
+    /**
+     * Removes \a key from the cache, returns \c false if it was not stored.
+     */
+    static bool remove(const QByteArray &key);
+
+    /**
+     * Removes all entries, statistics are kept.
+     */
+    static void clear();
+
+    /**
+     * Returns the sum of the statistics of all shards.
+     */
+    [[nodiscard]] static Stats stats();
+
+    /**
+     * Returns the statistics of each shard.
+     */
+    [[nodiscard]] static QVector<Stats> shardStats();
+
+    /**
+     * Resets the hit, miss, eviction, expiration and rejection counters.
+     */
+    static void resetStats();
+
+    /**
+     * Sets the maximum cost of all entries, shards shrink on their next insertion.
+     */
+    static void setMaxCost(qint64 cost);
+
+    /**
+     * Returns the maximum cost of all entries.
+     */
+    [[nodiscard]] static qint64 maxCost();
+
+    /**
+     * Sets the \a eviction used when a shard is full.
+     */
+    static void setEviction(Eviction eviction);
+
+    /**
+     * Returns the eviction used when a shard is full.
+     */
+    [[nodiscard]] static Eviction eviction();
+
+    /**
+     * Reads the \c Cutelyst_Cache_Plugin configuration section, the first plugin set up
+     * decides the number of shards.
+     */
+    bool setup(Application *app) override;
+
+private:
+    std::unique_ptr<CachePrivate> d_ptr;
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,27 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "cache.h"
+
+#include <QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(C_CACHE)
+
+namespace Cutelyst {
+
+class CachePrivate
+{
+public:
+    QVariantMap defaultConfig;
+};
+
+class SharedMemoryCachePrivate
+{
+public:
+    QVariantMap defaultConfig;
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,697 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "cache_p.h"
+#include "sharedmemorycache.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Engine>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <vector>
+
+#include <QHash>
+#include <QMutex>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr qint64 defaultSize     = 64 * 1024 * 1024;
+constexpr qint64 defaultShards   = 16;
+constexpr qint64 defaultSlotSize = 256;
+
+// Slot indexes are used as links, this one is the end of a list
+constexpr quint32 none = std::numeric_limits<quint32>::max();
+
+// The state of a shard, followed by its buckets and slots in the shared memory
+struct ShardHeader {
+    pthread_mutex_t mutex;
+    quint32 freeHead;
+    quint32 freeCount;
+    // Most recently used first
+    quint32 lruHead;
+    quint32 lruTail;
+    quint64 hits;
+    quint64 misses;
+    quint64 evictions;
+    quint64 expirations;
+    quint64 rejections;
+    qint64 count;
+};
+
+// Every slot starts with the index of the next slot of its item or free list
+struct SlotHeader {
+    quint32 next;
+    quint32 padding;
+};
+
+// Starts the data of the first slot of an item, followed by its key and value
+struct ItemHeader {
+    quint32 hashNext;
+    quint32 lruPrev;
+    quint32 lruNext;
+    quint32 hash;
+    // Milliseconds of the monotonic clock, which is the same for all processes, 0 never expires
+    qint64 expires;
+    quint32 keySize;
+    quint32 valueSize;
+    quint32 slots;
+    quint32 padding;
+};
+
+constexpr qsizetype aligned(qsizetype size)
+{
+    return (size + 7) & ~qsizetype(7);
+}
+
+qint64 now()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               Clock::now().time_since_epoch())
+        .count();
+}
+
+// A view of a shard in the shared memory of this process
+class Shard
+{
+public:
+    Shard(char *base, quint32 slotSize, quint32 slotCount);
+
+    // Initializes the memory of the shard, must be called before forking
+    void init();
+
+    [[nodiscard]] QByteArray get(const QByteArray &key, quint32 hash);
+    bool set(const QByteArray &key, quint32 hash, QByteArrayView value, qint64 ttl, bool onlyAdd);
+    bool remove(const QByteArray &key, quint32 hash);
+    std::optional<qint64> increment(const QByteArray &key, quint32 hash, qint64 delta, qint64 ttl);
+    void clear();
+    [[nodiscard]] Cache::Stats stats();
+
+    static qsizetype size(quint32 slotSize, quint32 slotCount);
+
+private:
+    friend class ShardLocker;
+
+    [[nodiscard]] SlotHeader *slot(quint32 index) const
+    {
+        return reinterpret_cast<SlotHeader *>(slots + qsizetype(index) * slotSize);
+    }
+    [[nodiscard]] ItemHeader *item(quint32 index) const
+    {
+        return reinterpret_cast<ItemHeader *>(slot(index) + 1);
+    }
+
+    // Calls fn with the chunks of the bytes from pos to pos + size of the data of the item
+    // that starts at the first slot, until fn returns false
+    template <typename Fn>
+    bool forEachChunk(quint32 first, qsizetype pos, qsizetype size, Fn fn) const;
+
+    [[nodiscard]] quint32 find(const QByteArray &key, quint32 hash) const;
+    [[nodiscard]] bool isExpired(quint32 index, qint64 time) const;
+    // Returns the first slot of a new item, evicting old ones if needed
+    quint32 allocate(const QByteArray &key, quint32 hash, qsizetype valueSize, qint64 ttl);
+    void write(quint32 index, qsizetype pos, QByteArrayView data);
+    void unlink(quint32 index);
+    void lruPushFront(quint32 index);
+    void lruRemove(quint32 index);
+    // Must be called with the mutex locked
+    void reset();
+
+    ShardHeader *header;
+    quint32 *buckets;
+    char *slots;
+    quint32 slotSize;
+    quint32 slotCount;
+    // Bytes of data in a slot
+    qsizetype payload;
+};
+
+class ShardLocker
+{
+public:
+    explicit ShardLocker(Shard *shard)
+        : m_shard(shard)
+    {
+        [[maybe_unused]] const int ret = pthread_mutex_lock(&shard->header->mutex);
+#ifdef Q_OS_LINUX
+        if (Q_UNLIKELY(ret == EOWNERDEAD)) {
+            // The process that died might have left the shard half changed
+            pthread_mutex_consistent(&shard->header->mutex);
+            shard->reset();
+            qCWarning(C_CACHE) << "Cleared a shared memory cache shard left by a dead process";
+        }
+#endif
+    }
+
+    ~ShardLocker() { pthread_mutex_unlock(&m_shard->header->mutex); }
+
+private:
+    Shard *m_shard;
+};
+
+Shard::Shard(char *base, quint32 slotSize, quint32 slotCount)
+    : header(reinterpret_cast<ShardHeader *>(base))
+    , buckets(reinterpret_cast<quint32 *>(base + aligned(sizeof(ShardHeader))))
+    , slots(base + aligned(sizeof(ShardHeader)) + aligned(qsizetype(sizeof(quint32)) * slotCount))
+    , slotSize(slotSize)
+    , slotCount(slotCount)
+    , payload(slotSize - qsizetype(sizeof(SlotHeader)))
+{
+}
+
+qsizetype Shard::size(quint32 slotSize, quint32 slotCount)
+{
+    return aligned(sizeof(ShardHeader)) + aligned(qsizetype(sizeof(quint32)) * slotCount) +
+           qsizetype(slotSize) * slotCount;
+}
+
+void Shard::init()
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#ifdef Q_OS_LINUX
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+#endif
+    pthread_mutex_init(&header->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    reset();
+}
+
+void Shard::reset()
+{
+    header->hits        = 0;
+    header->misses      = 0;
+    header->evictions   = 0;
+    header->expirations = 0;
+    header->rejections  = 0;
+    clear();
+}
+
+void Shard::clear()
+{
+    std::fill_n(buckets, slotCount, none);
+    for (quint32 i = 0; i < slotCount; ++i) {
+        slot(i)->next = i + 1 < slotCount ? i + 1 : none;
+    }
+    header->freeHead  = 0;
+    header->freeCount = slotCount;
+    header->lruHead   = none;
+    header->lruTail   = none;
+    header->count     = 0;
+}
+
+template <typename Fn>
+bool Shard::forEachChunk(quint32 first, qsizetype pos, qsizetype size, Fn fn) const
+{
+    quint32 current = first;
+    while (pos >= payload) {
+        current = slot(current)->next;
+        pos -= payload;
+    }
+
+    while (size > 0) {
+        const qsizetype chunk = std::min(size, payload - pos);
+        if (!fn(reinterpret_cast<char *>(slot(current) + 1) + pos, chunk)) {
+            return false;
+        }
+        size -= chunk;
+        pos     = 0;
+        current = slot(current)->next;
+    }
+    return true;
+}
+
+quint32 Shard::find(const QByteArray &key, quint32 hash) const
+{
+    quint32 index = buckets[hash % slotCount];
+    for (; index != none; index = item(index)->hashNext) {
+        const ItemHeader *it = item(index);
+        if (it->hash != hash || it->keySize != quint32(key.size())) {
+            continue;
+        }
+
+        const char *data = key.constData();
+        const bool equal = forEachChunk(
+            index, sizeof(ItemHeader), key.size(), [&data](const char *chunk, qsizetype size) {
+            const bool ret = std::memcmp(chunk, data, size) == 0;
+            data += size;
+            return ret;
+        });
+        if (equal) {
+            return index;
+        }
+    }
+    return none;
+}
+
+bool Shard::isExpired(quint32 index, qint64 time) const
+{
+    const qint64 expires = item(index)->expires;
+    return expires && expires <= time;
+}
+
+quint32 Shard::allocate(const QByteArray &key, quint32 hash, qsizetype valueSize, qint64 ttl)
+{
+    const qsizetype size   = qsizetype(sizeof(ItemHeader)) + key.size() + valueSize;
+    const auto slotsNeeded = quint32((size + payload - 1) / payload);
+    if (slotsNeeded > slotCount / 2) {
+        ++header->rejections;
+        return none;
+    }
+
+    const qint64 time = now();
+    while (header->freeCount < slotsNeeded) {
+        if (isExpired(header->lruTail, time)) {
+            ++header->expirations;
+        } else {
+            ++header->evictions;
+        }
+        unlink(header->lruTail);
+    }
+
+    // The free list is already a chain of slots
+    const quint32 first = header->freeHead;
+    quint32 last        = first;
+    for (quint32 i = 1; i < slotsNeeded; ++i) {
+        last = slot(last)->next;
+    }
+    header->freeHead = slot(last)->next;
+    header->freeCount -= slotsNeeded;
+    slot(last)->next = none;
+
+    ItemHeader *it = item(first);
+    it->hash       = hash;
+    it->expires    = ttl > 0 ? time + ttl : 0;
+    it->keySize    = quint32(key.size());
+    it->valueSize  = quint32(valueSize);
+    it->slots      = slotsNeeded;
+    write(first, sizeof(ItemHeader), key);
+
+    quint32 &bucket = buckets[hash % slotCount];
+    it->hashNext    = bucket;
+    bucket          = first;
+    lruPushFront(first);
+    ++header->count;
+
+    return first;
+}
+
+void Shard::write(quint32 index, qsizetype pos, QByteArrayView data)
+{
+    const char *source = data.data();
+    forEachChunk(index, pos, data.size(), [&source](char *chunk, qsizetype size) {
+        std::memcpy(chunk, source, size);
+        source += size;
+        return true;
+    });
+}
+
+void Shard::unlink(quint32 index)
+{
+    ItemHeader *it = item(index);
+
+    quint32 *link = &buckets[it->hash % slotCount];
+    while (*link != index) {
+        link = &item(*link)->hashNext;
+    }
+    *link = it->hashNext;
+
+    lruRemove(index);
+
+    quint32 last = index;
+    for (quint32 i = 1; i < it->slots; ++i) {
+        last = slot(last)->next;
+    }
+    slot(last)->next = header->freeHead;
+    header->freeHead = index;
+    header->freeCount += it->slots;
+    --header->count;
+}
+
+void Shard::lruPushFront(quint32 index)
+{
+    ItemHeader *it = item(index);
+    it->lruPrev    = none;
+    it->lruNext    = header->lruHead;
+    if (header->lruHead != none) {
+        item(header->lruHead)->lruPrev = index;
+    } else {
+        header->lruTail = index;
+    }
+    header->lruHead = index;
+}
+
+void Shard::lruRemove(quint32 index)
+{
+    const ItemHeader *it = item(index);
+    if (it->lruPrev != none) {
+        item(it->lruPrev)->lruNext = it->lruNext;
+    } else {
+        header->lruHead = it->lruNext;
+    }
+    if (it->lruNext != none) {
+        item(it->lruNext)->lruPrev = it->lruPrev;
+    } else {
+        header->lruTail = it->lruPrev;
+    }
+}
+
+QByteArray Shard::get(const QByteArray &key, quint32 hash)
+{
+    ShardLocker locker(this);
+
+    const quint32 index = find(key, hash);
+    if (index == none) {
+        ++header->misses;
+        return {};
+    }
+
+    if (isExpired(index, now())) {
+        ++header->misses;
+        ++header->expirations;
+        unlink(index);
+        return {};
+    }
+
+    ++header->hits;
+    lruRemove(index);
+    lruPushFront(index);
+
+    const ItemHeader *it = item(index);
+    QByteArray ret(it->valueSize, Qt::Uninitialized);
+    char *dest = ret.data();
+    forEachChunk(index,
+                 qsizetype(sizeof(ItemHeader)) + it->keySize,
+                 it->valueSize,
+                 [&dest](const char *chunk, qsizetype size) {
+        std::memcpy(dest, chunk, size);
+        dest += size;
+        return true;
+    });
+    return ret;
+}
+
+bool Shard::set(const QByteArray &key,
+                quint32 hash,
+                QByteArrayView value,
+                qint64 ttl,
+                bool onlyAdd)
+{
+    ShardLocker locker(this);
+
+    const quint32 existing = find(key, hash);
+    if (existing != none) {
+        if (!isExpired(existing, now())) {
+            if (onlyAdd) {
+                return false;
+            }
+        } else {
+            ++header->expirations;
+        }
+        unlink(existing);
+    }
+
+    const quint32 index = allocate(key, hash, value.size(), ttl);
+    if (index == none) {
+        return false;
+    }
+    write(index, qsizetype(sizeof(ItemHeader)) + key.size(), value);
+    return true;
+}
+
+bool Shard::remove(const QByteArray &key, quint32 hash)
+{
+    ShardLocker locker(this);
+
+    const quint32 index = find(key, hash);
+    if (index == none) {
+        return false;
+    }
+    unlink(index);
+    return true;
+}
+
+std::optional<qint64>
+    Shard::increment(const QByteArray &key, quint32 hash, qint64 delta, qint64 ttl)
+{
+    ShardLocker locker(this);
+
+    quint32 index = find(key, hash);
+    if (index != none && isExpired(index, now())) {
+        ++header->expirations;
+        unlink(index);
+        index = none;
+    }
+
+    qint64 value = 0;
+    if (index == none) {
+        index = allocate(key, hash, sizeof(qint64), ttl);
+        if (index == none) {
+            return std::nullopt;
+        }
+    } else if (item(index)->valueSize != sizeof(qint64)) {
+        return std::nullopt;
+    } else {
+        const qsizetype pos = qsizetype(sizeof(ItemHeader)) + key.size();
+        forEachChunk(index, pos, sizeof(qint64), [&value](const char *chunk, qsizetype size) {
+            std::memcpy(&value, chunk, size);
+            return true;
+        });
+    }
+
+    value += delta;
+    write(index,
+          qsizetype(sizeof(ItemHeader)) + key.size(),
+          QByteArrayView(reinterpret_cast<const char *>(&value), sizeof(qint64)));
+    return value;
+}
+
+Cache::Stats Shard::stats()
+{
+    ShardLocker locker(this);
+    return {
+        .hits        = header->hits,
+        .misses      = header->misses,
+        .evictions   = header->evictions,
+        .expirations = header->expirations,
+        .rejections  = header->rejections,
+        .count       = header->count,
+        .cost        = qint64(slotCount - header->freeCount) * slotSize,
+    };
+}
+
+struct Storage {
+    std::vector<Shard> shards;
+
+    Shard &shard(quint32 hash) { return shards[hash % shards.size()]; }
+};
+
+QBasicMutex storageMutex;
+std::unique_ptr<Storage> ownedStorage;
+std::atomic<Storage *> currentStorage = nullptr;
+
+Storage *storage()
+{
+    return currentStorage.load(std::memory_order_acquire);
+}
+
+quint32 keyHash(const QByteArray &key)
+{
+    // Must be the same in all processes, unlike the seeded qHash()
+    return quint32(qHash(QByteArrayView{key}, 0));
+}
+
+} // namespace
+
+SharedMemoryCache::SharedMemoryCache(Application *parent)
+    : Plugin(parent)
+    , d_ptr(new SharedMemoryCachePrivate)
+{
+}
+
+SharedMemoryCache::SharedMemoryCache(Application *parent, const QVariantMap &defaultConfig)
+    : Plugin(parent)
+    , d_ptr(new SharedMemoryCachePrivate)
+{
+    Q_D(SharedMemoryCache);
+    d->defaultConfig = defaultConfig;
+}
+
+SharedMemoryCache::~SharedMemoryCache() = default;
+
+bool SharedMemoryCache::isAvailable()
+{
+    return storage();
+}
+
+QByteArray SharedMemoryCache::get(const QByteArray &key)
+{
+    Storage *s = storage();
+    if (!s) {
+        return {};
+    }
+    const quint32 hash = keyHash(key);
+    return s->shard(hash).get(key, hash);
+}
+
+bool SharedMemoryCache::set(const QByteArray &key,
+                            const QByteArray &value,
+                            std::chrono::milliseconds ttl)
+{
+    Storage *s = storage();
+    if (!s) {
+        return false;
+    }
+    const quint32 hash = keyHash(key);
+    return s->shard(hash).set(key, hash, value, ttl.count(), false);
+}
+
+bool SharedMemoryCache::add(const QByteArray &key,
+                            const QByteArray &value,
+                            std::chrono::milliseconds ttl)
+{
+    Storage *s = storage();
+    if (!s) {
+        return false;
+    }
+    const quint32 hash = keyHash(key);
+    return s->shard(hash).set(key, hash, value, ttl.count(), true);
+}
+
+bool SharedMemoryCache::remove(const QByteArray &key)
+{
+    Storage *s = storage();
+    if (!s) {
+        return false;
+    }
+    const quint32 hash = keyHash(key);
+    return s->shard(hash).remove(key, hash);
+}
+
+std::optional<qint64> SharedMemoryCache::increment(const QByteArray &key,
+                                                   qint64 delta,
+                                                   std::chrono::milliseconds ttl)
+{
+    Storage *s = storage();
+    if (!s) {
+        return std::nullopt;
+    }
+    const quint32 hash = keyHash(key);
+    return s->shard(hash).increment(key, hash, delta, ttl.count());
+}
+
+void SharedMemoryCache::clear()
+{
+    if (Storage *s = storage()) {
+        for (Shard &shard : s->shards) {
+            ShardLocker locker(&shard);
+            shard.clear();
+        }
+    }
+}
+
+Cache::Stats SharedMemoryCache::stats()
+{
+    Cache::Stats ret;
+    const QVector<Cache::Stats> shards = shardStats();
+    for (const Cache::Stats &stats : shards) {
+        ret.hits += stats.hits;
+        ret.misses += stats.misses;
+        ret.evictions += stats.evictions;
+        ret.expirations += stats.expirations;
+        ret.rejections += stats.rejections;
+        ret.count += stats.count;
+        ret.cost += stats.cost;
+    }
+    return ret;
+}
+
+QVector<Cache::Stats> SharedMemoryCache::shardStats()
+{
+    QVector<Cache::Stats> ret;
+    if (Storage *s = storage()) {
+        for (Shard &shard : s->shards) {
+            ret.append(shard.stats());
+        }
+    }
+    return ret;
+}
+
+bool SharedMemoryCache::setup(Application *app)
+{
+    Q_D(SharedMemoryCache);
+
+    QMutexLocker locker(&storageMutex);
+    if (storage()) {
+        return true;
+    }
+
+    const QVariantMap config = app->engine()->config(u"Cutelyst_SharedMemoryCache_Plugin"_s);
+    auto integer             = [&](const QString &key, qint64 defaultValue, qint64 minimum) {
+        bool ok;
+        const qint64 ret =
+            config.value(key, d->defaultConfig.value(key, defaultValue)).toLongLong(&ok);
+        if (!ok || ret < minimum) {
+            qCWarning(C_CACHE) << "Invalid" << key << "using" << defaultValue;
+            return defaultValue;
+        }
+        return ret;
+    };
+
+    const qint64 size      = integer(u"size"_s, defaultSize, 64 * 1024);
+    const auto shardCount  = quint32(integer(u"shards"_s, defaultShards, 1));
+    const auto slotSize    = quint32(aligned(integer(u"slot_size"_s, defaultSlotSize, 64)));
+    const qint64 shardSize = (size / shardCount) & ~qint64(7);
+
+    // Biggest slot count whose shard fits its part of the memory, leaving room to align
+    // the buckets
+    const qint64 slotCount =
+        std::min<qint64>((shardSize - aligned(sizeof(ShardHeader)) - 8) /
+                             (slotSize + qint64(sizeof(quint32))),
+                         none - 1);
+    if (slotCount < 2 || Shard::size(slotSize, quint32(slotCount)) > shardSize) {
+        qCCritical(C_CACHE) << "The shared memory size is too small for" << shardCount
+                            << "shards of slots of" << slotSize << "bytes";
+        return false;
+    }
+
+    void *memory = mmap(nullptr,
+                        size_t(size),
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS,
+                        -1,
+                        0);
+    if (memory == MAP_FAILED) {
+        qCCritical(C_CACHE) << "Failed to map the shared memory" << std::strerror(errno);
+        return false;
+    }
+
+    // The mapping is inherited by forked processes and kept until the process exits
+    auto s = std::make_unique<Storage>();
+    s->shards.reserve(shardCount);
+    for (quint32 i = 0; i < shardCount; ++i) {
+        Shard &shard = s->shards.emplace_back(static_cast<char *>(memory) + i * shardSize,
+                                              slotSize,
+                                              quint32(slotCount));
+        shard.init();
+    }
+
+    ownedStorage = std::move(s);
+    currentStorage.store(ownedStorage.get(), std::memory_order_release);
+
+    return true;
+}
+
+#include "moc_sharedmemorycache.cpp"
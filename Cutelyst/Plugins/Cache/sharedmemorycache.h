@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugins/Cache/cache.h>
+#include <optional>
+
+namespace Cutelyst {
+
+class SharedMemoryCachePrivate;
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/Cache/SharedMemoryCache>
+ * \brief Cache shared by all worker processes of a server.
+ *
+ * The %SharedMemoryCache plugin keeps values in an anonymous shared memory mapping, which
+ * is inherited by the processes forked from the one that created it. When the server runs
+ * more than one process and the application is not loaded in \c lazy mode, the plugin is
+ * set up by the master before it forks the workers, so all of them share the same
+ * entries without the need of a memcached server.
+ *
+ * \note In \c lazy mode every process sets up its own application and so gets its own
+ * mapping, entries are then only shared by the threads of a process.
+ *
+ * The memory is split into shards, each one with its own hash table, a process-shared
+ * mutex and fixed-size slots, values bigger than a slot use a chain of them. When a shard
+ * has no free slots the least recently used entries are evicted. On Linux the mutexes are
+ * robust, if a process dies while holding one, the shard it was changing is cleared by the
+ * next process that locks it.
+ *
+ * Values are QByteArray objects, increment() keeps counters that can be used for rate
+ * limiting. The ResponseCacheSharedMemoryStore and the SessionStoreSharedMemory keep
+ * responses and sessions here.
+ *
+ * <H3>Runtime configuration</H3>
+ *
+ * The plugin reads the \c Cutelyst_SharedMemoryCache_Plugin section of the
+ * \ref configuration "application configuration file", the \a defaultConfig passed to the
+ * constructor is used for missing keys. The mapping is created by the first plugin that
+ * is set up, the static methods fail until then.
+ *
+ * \configblock{size,integer,67108864}
+ * Size in bytes of the shared memory.
+ * \endconfigblock
+ *
+ * \configblock{shards,integer,16}
+ * Number of shards.
+ * \endconfigblock
+ *
+ * \configblock{slot_size,integer,256}
+ * Size in bytes of the slots, a multiple of 8.
+ * \endconfigblock
+ *
+ * \code{.cpp}
+ * bool MyApp::init()
+ * {
+ *     new SharedMemoryCache(this, {{u"size"_s, 256 * 1024 * 1024}});
+ * }
+ *
+ * bool Api::Auto(Context *c)
+ * {
+ *     const QByteArray key = "rate_" + c->req()->addressString().toLatin1();
+ *     if (SharedMemoryCache::increment(key, 1, 1min).value_or(0) > 100) {
+ *         c->res()->setStatus(429);
+ *         return false;
+ *     }
+ *     return true;
+ * }
+ * \endcode
+ *
+ * \logcat{plugin.cache}
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_CACHE_EXPORT SharedMemoryCache : public Plugin
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(SharedMemoryCache) // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    Q_DISABLE_COPY(SharedMemoryCache)
+public:
+    /**
+     * Constructs a new %SharedMemoryCache plugin with the given \a parent.
+     */
+    explicit SharedMemoryCache(Application *parent);
+
+    /**
+     * Constructs a new %SharedMemoryCache plugin with the given \a parent and
+     * \a defaultConfig values for the configuration file entries.
+     */
+    SharedMemoryCache(Application *parent, const QVariantMap &defaultConfig);
+
+    /**
+     * Destroys the %SharedMemoryCache object, the shared memory is kept.
+     */
+    ~SharedMemoryCache() override;
+
+    /**
+     * Returns \c true if the shared memory was created.
+     */
+    [[nodiscard]] static bool isAvailable();
+
+    /**
+     * Returns the value of \a key or a null QByteArray if it is not stored or expired.
+     */
+    [[nodiscard]] static QByteArray get(const QByteArray &key);
+
+    /**
+     * Stores \a value at \a key for \a ttl, replacing any previous value, a zero \a ttl
+     * keeps it until it is evicted. Returns \c false if it does not fit in a shard.
+     */
+    static bool
+        set(const QByteArray &key, const QByteArray &value, std::chrono::milliseconds ttl = {});
+
+    /**
+     * Stores \a value at \a key for \a ttl only if \a key is not stored yet, returns
+     * \c false if it is or if it does not fit in a shard.
+     */
+    static bool
+        add(const QByteArray &key, const QByteArray &value, std::chrono::milliseconds ttl = {});
+
+    /**
+     * Removes \a key from the cache, returns \c false if it was not stored.
+     */
+    static bool remove(const QByteArray &key);
+
+    /**
+     * Adds \a delta to the counter at \a key and returns its new value. A counter that is
+     * not stored yet starts at zero and expires after \a ttl, which is not changed by later
+     * increments, making fixed windows for rate limiting easy. Returns \c std::nullopt if the
+     * value at \a key is not a counter or the cache is not available.
+     */
+    static std::optional<qint64>
+        increment(const QByteArray &key, qint64 delta, std::chrono::milliseconds ttl = {});
+
+    /**
+     * Removes all entries, statistics are kept.
+     */
+    static void clear();
+
+    /**
+     * Returns the sum of the statistics of all shards, the cost is the size of the used slots.
+     */
+    [[nodiscard]] static Cache::Stats stats();
+
+    /**
+     * Returns the statistics of each shard.
+     */
+    [[nodiscard]] static QVector<Cache::Stats> shardStats();
+
+    /**
+     * Creates the shared memory, if not yet created, with the
+     * \c Cutelyst_SharedMemoryCache_Plugin configuration section.
+     */
+    bool setup(Application *app) override;
+
+private:
+    std::unique_ptr<SharedMemoryCachePrivate> d_ptr;
+};
+
+} // namespace Cutelyst
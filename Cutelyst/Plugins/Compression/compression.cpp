@@ -0,0 +1,577 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "compression_p.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Context>
+#include <Cutelyst/Engine>
+#include <Cutelyst/Request>
+#include <Cutelyst/Response>
+#include <algorithm>
+#include <array>
+#include <optional>
+
+#include <QLoggingCategory>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+Q_LOGGING_CATEGORY(C_COMPRESSION, "cutelyst.plugin.compression", QtWarningMsg)
+
+namespace {
+
+// Contexts kept per worker, each zlib one uses around 256KiB
+constexpr std::size_t maxPoolSize = 16;
+
+std::optional<Compression::Level> levelFromString(QStringView level)
+{
+    if (level.compare(u"fast", Qt::CaseInsensitive) == 0) {
+        return Compression::Level::Fast;
+    } else if (level.compare(u"balanced", Qt::CaseInsensitive) == 0) {
+        return Compression::Level::Balanced;
+    } else if (level.compare(u"max", Qt::CaseInsensitive) == 0) {
+        return Compression::Level::Max;
+    }
+    return {};
+}
+
+// Returns the q-value of the parameters in thousandths
+int quality(QByteArrayView params)
+{
+    while (!params.isEmpty()) {
+        qsizetype end = params.indexOf(';');
+        if (end < 0) {
+            end = params.size();
+        }
+
+        const QByteArrayView param = params.first(end).trimmed();
+        params                     = params.sliced(std::min(end + 1, params.size()));
+
+        const qsizetype equal = param.indexOf('=');
+        if (equal < 0 || param.first(equal).trimmed().compare("q", Qt::CaseInsensitive) != 0) {
+            continue;
+        }
+
+        bool ok;
+        const double q = param.sliced(equal + 1).trimmed().toDouble(&ok);
+        if (!ok || q <= 0) {
+            return 0;
+        }
+        return q >= 1 ? 1000 : int(q * 1000 + 0.5);
+    }
+    return 1000;
+}
+
+} // namespace
+
+Compression::Compression(Application *parent)
+    : Plugin(parent)
+    , d_ptr(new CompressionPrivate)
+{
+}
+
+Compression::Compression(Application *parent, const QVariantMap &defaultConfig)
+    : Plugin(parent)
+    , d_ptr(new CompressionPrivate)
+{
+    Q_D(Compression);
+    d->defaultConfig = defaultConfig;
+}
+
+Compression::~Compression() = default;
+
+void Compression::setMimeType(const QByteArray &mimeType, Level level, qint64 minSize)
+{
+    Q_D(Compression);
+    const CompressionPrivate::Rule rule{level, minSize};
+    d->userRules.insert(mimeType.toLower(), rule);
+    d->rules.insert(mimeType.toLower(), rule);
+}
+
+QByteArrayList Compression::supportedEncodings()
+{
+    return {
+#ifdef CUTELYST_COMPRESSION_WITH_BROTLI
+        "br"_ba,
+#endif
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+        "zstd"_ba,
+#endif
+        "gzip"_ba,
+        "deflate"_ba,
+    };
+}
+
+QByteArray Compression::negotiate(QByteArrayView acceptEncoding, const QByteArrayList &encodings)
+{
+    std::vector<std::pair<QByteArrayView, int>> accepted;
+    int anyQuality = -1;
+
+    while (!acceptEncoding.isEmpty()) {
+        qsizetype end = acceptEncoding.indexOf(',');
+        if (end < 0) {
+            end = acceptEncoding.size();
+        }
+
+        const QByteArrayView item = acceptEncoding.first(end);
+        acceptEncoding            = acceptEncoding.sliced(std::min(end + 1, acceptEncoding.size()));
+
+        const qsizetype semicolon = item.indexOf(';');
+        const QByteArrayView coding = (semicolon < 0 ? item : item.first(semicolon)).trimmed();
+        if (coding.isEmpty()) {
+            continue;
+        }
+
+        const int q = semicolon < 0 ? 1000 : quality(item.sliced(semicolon + 1));
+        if (coding == "*") {
+            anyQuality = q;
+        } else {
+            const bool xGzip = coding.compare("x-gzip", Qt::CaseInsensitive) == 0;
+            accepted.emplace_back(xGzip ? QByteArrayView{"gzip"} : coding, q);
+        }
+    }
+
+    // Codings not listed get the quality of "*", ties keep the server order
+    QByteArray best;
+    int bestQuality = 0;
+    for (const QByteArray &encoding : encodings) {
+        auto it = std::ranges::find_if(accepted, [&encoding](const auto &entry) {
+            return entry.first.compare(encoding, Qt::CaseInsensitive) == 0;
+        });
+        const int q = it == accepted.end() ? anyQuality : it->second;
+        if (q > bestQuality) {
+            best        = encoding;
+            bestQuality = q;
+        }
+    }
+    return best;
+}
+
+bool Compression::setup(Application *app)
+{
+    Q_D(Compression);
+
+    const QVariantMap config = app->engine()->config(u"Cutelyst_Compression_Plugin"_s);
+    auto value               = [&](const QString &key, const QVariant &defaultValue) {
+        return config.value(key, d->defaultConfig.value(key, defaultValue));
+    };
+
+    const QString level = value(u"level"_s, u"balanced"_s).toString();
+    if (const auto parsed = levelFromString(level)) {
+        d->defaultRule.level = *parsed;
+    } else {
+        qCWarning(C_COMPRESSION) << "Invalid compression level" << level << "using balanced";
+    }
+
+    bool ok;
+    const qint64 minSize = value(u"min_size"_s, 256).toLongLong(&ok);
+    if (ok && minSize >= 0) {
+        d->defaultRule.minSize = minSize;
+    } else {
+        qCWarning(C_COMPRESSION) << "Invalid minimum size, using" << d->defaultRule.minSize;
+    }
+
+    d->rules.clear();
+    d->parseMimeTypes(value(u"mime_types"_s,
+                            u"text/html,text/css,text/plain,text/xml,text/csv,text/javascript,"
+                            "application/javascript,application/json,application/ld+json,"
+                            "application/xml,application/xhtml+xml,application/rss+xml,"
+                            "application/atom+xml,image/svg+xml"_s)
+                          .toString());
+    d->rules.insert(d->userRules);
+
+    const QByteArrayList supported = supportedEncodings();
+    const QStringList encodings =
+        value(u"encodings"_s, u"br,zstd,gzip,deflate"_s).toString().split(u',', Qt::SkipEmptyParts);
+    d->encodings.clear();
+    d->encodingIds.clear();
+    for (const QString &encoding : encodings) {
+        const QByteArray name = encoding.trimmed().toLower().toLatin1();
+        if (!supported.contains(name)) {
+            qCInfo(C_COMPRESSION) << "Encoding not supported by this build" << name;
+            continue;
+        }
+
+        CompressionPrivate::Encoding id = CompressionPrivate::Gzip;
+        if (name == "br") {
+            id = CompressionPrivate::Brotli;
+        } else if (name == "zstd") {
+            id = CompressionPrivate::Zstd;
+        } else if (name == "deflate") {
+            id = CompressionPrivate::Deflate;
+        }
+        d->encodings.append(name);
+        d->encodingIds.push_back(id);
+    }
+    qCInfo(C_COMPRESSION) << "Encodings:" << d->encodings;
+
+    app->addBeforePrepareActionHook(this,
+                                    [d](Context *c, bool *) { d->beforePrepareAction(c); });
+
+    return true;
+}
+
+void CompressionPrivate::beforePrepareAction(Context *c)
+{
+    const QByteArray acceptEncoding = c->request()->header("Accept-Encoding");
+    if (acceptEncoding.isEmpty()) {
+        return;
+    }
+
+    const QByteArray encoding = Compression::negotiate(acceptEncoding, encodings);
+    if (!encoding.isEmpty()) {
+        const auto id = encodingIds[std::size_t(encodings.indexOf(encoding))];
+        c->response()->setFilter(new CompressionFilter(this, id));
+    }
+}
+
+const CompressionPrivate::Rule *CompressionPrivate::rule(const QByteArray &contentType) const
+{
+    auto it = rules.constFind(contentType);
+    if (it != rules.cend()) {
+        return &it.value();
+    }
+
+    const qsizetype slash = contentType.indexOf('/');
+    if (slash > 0) {
+        it = rules.constFind(contentType.first(slash + 1));
+        if (it != rules.cend()) {
+            return &it.value();
+        }
+    }
+    return nullptr;
+}
+
+void CompressionPrivate::parseMimeTypes(const QString &mimeTypes)
+{
+    const QStringList entries = mimeTypes.split(u',', Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        const QStringList parts   = entry.split(u':');
+        const QByteArray mimeType = parts.at(0).trimmed().toLower().toLatin1();
+        if (mimeType.isEmpty()) {
+            continue;
+        }
+
+        Rule rule = defaultRule;
+        if (parts.size() > 1) {
+            if (const auto level = levelFromString(parts.at(1).trimmed())) {
+                rule.level = *level;
+            } else {
+                qCWarning(C_COMPRESSION) << "Invalid compression level for" << entry;
+            }
+        }
+        if (parts.size() > 2) {
+            bool ok;
+            const qint64 minSize = parts.at(2).trimmed().toLongLong(&ok);
+            if (ok && minSize >= 0) {
+                rule.minSize = minSize;
+            } else {
+                qCWarning(C_COMPRESSION) << "Invalid minimum size for" << entry;
+            }
+        }
+        rules.insert(mimeType, rule);
+    }
+}
+
+std::unique_ptr<CompressionPrivate::ZlibStream> CompressionPrivate::takeZlib(Encoding encoding,
+                                                                             int level)
+{
+    auto &pool = encoding == Gzip ? gzipPool : deflatePool;
+    if (!pool.empty()) {
+        std::unique_ptr<ZlibStream> zlib = std::move(pool.back());
+        pool.pop_back();
+
+        // Streams in the pool were reset, so no data needs flushing
+        if (zlib->level != level &&
+            deflateParams(&zlib->stream, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return {};
+        }
+        zlib->level = level;
+        return zlib;
+    }
+
+    auto zlib = std::make_unique<ZlibStream>();
+    // gzip asks for the header and trailer by adding 16 to the window bits
+    const int ret = deflateInit2(&zlib->stream,
+                                 level,
+                                 Z_DEFLATED,
+                                 encoding == Gzip ? MAX_WBITS + 16 : MAX_WBITS,
+                                 8,
+                                 Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) {
+        qCWarning(C_COMPRESSION) << "Failed to initialize zlib" << ret;
+        return {};
+    }
+    zlib->level = level;
+    return zlib;
+}
+
+void CompressionPrivate::releaseZlib(Encoding encoding, std::unique_ptr<ZlibStream> stream)
+{
+    auto &pool = encoding == Gzip ? gzipPool : deflatePool;
+    if (pool.size() < maxPoolSize && deflateReset(&stream->stream) == Z_OK) {
+        pool.push_back(std::move(stream));
+    }
+}
+
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+CompressionPrivate::ZstdContext CompressionPrivate::takeZstd(int level)
+{
+    ZstdContext cctx;
+    if (!zstdPool.empty()) {
+        cctx = std::move(zstdPool.back());
+        zstdPool.pop_back();
+    } else {
+        cctx.reset(ZSTD_createCCtx());
+        if (!cctx) {
+            qCWarning(C_COMPRESSION) << "Failed to create Zstandard context";
+            return {};
+        }
+    }
+
+    if (ZSTD_isError(ZSTD_CCtx_setParameter(cctx.get(), ZSTD_c_compressionLevel, level))) {
+        return {};
+    }
+    return cctx;
+}
+
+void CompressionPrivate::releaseZstd(ZstdContext cctx)
+{
+    if (zstdPool.size() < maxPoolSize &&
+        !ZSTD_isError(ZSTD_CCtx_reset(cctx.get(), ZSTD_reset_session_only))) {
+        zstdPool.push_back(std::move(cctx));
+    }
+}
+#endif
+
+QByteArrayView CompressionPrivate::encodingName(Encoding encoding) noexcept
+{
+    switch (encoding) {
+    case Brotli:
+        return "br";
+    case Zstd:
+        return "zstd";
+    case Gzip:
+        return "gzip";
+    case Deflate:
+        return "deflate";
+    }
+    return {};
+}
+
+int CompressionPrivate::encoderLevel(Encoding encoding, Compression::Level level) noexcept
+{
+    const auto index = std::size_t(level);
+    switch (encoding) {
+    case Brotli:
+        return std::array{1, 5, 11}[index];
+    case Zstd:
+        return std::array{1, 3, 19}[index];
+    case Gzip:
+    case Deflate:
+        break;
+    }
+    return std::array{1, 6, 9}[index];
+}
+
+CompressionFilter::CompressionFilter(CompressionPrivate *d, CompressionPrivate::Encoding encoding)
+    : d(d)
+    , m_encoding(encoding)
+{
+}
+
+CompressionFilter::~CompressionFilter()
+{
+    if (m_zlib) {
+        d->releaseZlib(m_encoding, std::move(m_zlib));
+    }
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+    if (m_zstd) {
+        d->releaseZstd(std::move(m_zstd));
+    }
+#endif
+#ifdef CUTELYST_COMPRESSION_WITH_BROTLI
+    if (m_brotli) {
+        BrotliEncoderDestroyInstance(m_brotli);
+    }
+#endif
+}
+
+QString CompressionFilter::name() const
+{
+    return u"Compression " + QString::fromLatin1(CompressionPrivate::encodingName(m_encoding));
+}
+
+bool CompressionFilter::start(Response *response)
+{
+    const quint16 status = response->status();
+    if (status < Response::OK || status == Response::NoContent ||
+        status == Response::PartialContent || status == Response::NotModified) {
+        return false;
+    }
+
+    Headers &headers = response->headers();
+    if (headers.contains(Headers::KnownHeader::ContentEncoding)) {
+        return false;
+    }
+
+    const CompressionPrivate::Rule *rule = d->rule(headers.contentType());
+    if (!rule) {
+        return false;
+    }
+
+    // The size is only unknown when the body is being written
+    const qint64 size = response->size();
+    m_streaming       = size < 0;
+
+    const qint64 length = m_streaming ? headers.contentLength() : size;
+    if (length >= 0 && length < rule->minSize) {
+        return false;
+    }
+
+    const int level = CompressionPrivate::encoderLevel(m_encoding, rule->level);
+    switch (m_encoding) {
+    case CompressionPrivate::Gzip:
+    case CompressionPrivate::Deflate:
+        m_zlib = d->takeZlib(m_encoding, level);
+        if (!m_zlib) {
+            return false;
+        }
+        break;
+    case CompressionPrivate::Zstd:
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+        m_zstd = d->takeZstd(level);
+        if (!m_zstd) {
+            return false;
+        }
+        if (!m_streaming) {
+            ZSTD_CCtx_setPledgedSrcSize(m_zstd.get(), quint64(size));
+        }
+        break;
+#else
+        return false;
+#endif
+    case CompressionPrivate::Brotli:
+#ifdef CUTELYST_COMPRESSION_WITH_BROTLI
+        m_brotli = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
+        if (!m_brotli) {
+            return false;
+        }
+        BrotliEncoderSetParameter(m_brotli, BROTLI_PARAM_QUALITY, quint32(level));
+        if (!m_streaming) {
+            BrotliEncoderSetParameter(
+                m_brotli, BROTLI_PARAM_SIZE_HINT, quint32(std::min<qint64>(size, 1 << 30)));
+        }
+        break;
+#else
+        return false;
+#endif
+    }
+
+    headers.setContentEncoding(CompressionPrivate::encodingName(m_encoding).toByteArray());
+    headers.removeHeader(Headers::KnownHeader::ContentLength);
+
+    const QByteArray vary = headers.header(Headers::KnownHeader::Vary);
+    if (vary.isEmpty()) {
+        headers.setHeader(Headers::KnownHeader::Vary, "Accept-Encoding"_ba);
+    } else if (vary.trimmed() != "*" && !vary.toLower().contains("accept-encoding")) {
+        headers.setHeader(Headers::KnownHeader::Vary, vary + ", Accept-Encoding");
+    }
+
+    // The compressed representation is not byte for byte the same anymore
+    const QByteArray etag = headers.header(Headers::KnownHeader::ETag);
+    if (etag.startsWith('"')) {
+        headers.setHeader(Headers::KnownHeader::ETag, "W/" + etag);
+    }
+
+    return true;
+}
+
+QByteArray CompressionFilter::write(QByteArrayView data)
+{
+    QByteArray out;
+    compress(data, false, out);
+    return out;
+}
+
+QByteArray CompressionFilter::finish()
+{
+    QByteArray out;
+    compress({}, true, out);
+    return out;
+}
+
+void CompressionFilter::compress(QByteArrayView data, bool end, QByteArray &out)
+{
+    // Encoders are called again until they have nothing else to output
+    const qsizetype chunk = std::clamp<qsizetype>(data.size() / 2 + 64, 512, 64 * 1024);
+
+    if (m_zlib) {
+        z_stream &stream = m_zlib->stream;
+        stream.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+        stream.avail_in  = uInt(data.size());
+
+        const int flush = end ? Z_FINISH : (m_streaming ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+        int ret;
+        do {
+            const qsizetype offset = out.size();
+            out.resize(offset + chunk);
+            stream.next_out  = reinterpret_cast<Bytef *>(out.data() + offset);
+            stream.avail_out = uInt(chunk);
+            ret              = deflate(&stream, flush);
+            out.resize(offset + chunk - qsizetype(stream.avail_out));
+        } while (stream.avail_out == 0 && ret != Z_STREAM_ERROR);
+        return;
+    }
+
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+    if (m_zstd) {
+        ZSTD_inBuffer input{data.data(), std::size_t(data.size()), 0};
+        const ZSTD_EndDirective mode =
+            end ? ZSTD_e_end : (m_streaming ? ZSTD_e_flush : ZSTD_e_continue);
+        bool done;
+        do {
+            const qsizetype offset = out.size();
+            out.resize(offset + chunk);
+            ZSTD_outBuffer output{out.data() + offset, std::size_t(chunk), 0};
+            const std::size_t remaining = ZSTD_compressStream2(m_zstd.get(), &output, &input, mode);
+            out.resize(offset + qsizetype(output.pos));
+            if (ZSTD_isError(remaining)) {
+                qCWarning(C_COMPRESSION) << "Zstandard failed" << ZSTD_getErrorName(remaining);
+                break;
+            }
+            done = mode == ZSTD_e_continue ? input.pos == input.size : remaining == 0;
+        } while (!done);
+        return;
+    }
+#endif
+
+#ifdef CUTELYST_COMPRESSION_WITH_BROTLI
+    if (m_brotli) {
+        std::size_t availableIn = std::size_t(data.size());
+        auto nextIn             = reinterpret_cast<const uint8_t *>(data.data());
+        const BrotliEncoderOperation operation =
+            end ? BROTLI_OPERATION_FINISH
+                : (m_streaming ? BROTLI_OPERATION_FLUSH : BROTLI_OPERATION_PROCESS);
+        do {
+            // Output is taken from the encoder buffer instead of copied to ours
+            std::size_t availableOut = 0;
+            uint8_t *nextOut         = nullptr;
+            if (!BrotliEncoderCompressStream(
+                    m_brotli, operation, &availableIn, &nextIn, &availableOut, &nextOut, nullptr)) {
+                qCWarning(C_COMPRESSION) << "Brotli failed";
+                break;
+            }
+
+            std::size_t size;
+            const uint8_t *output = BrotliEncoderTakeOutput(m_brotli, &size);
+            out.append(reinterpret_cast<const char *>(output), qsizetype(size));
+        } while (availableIn > 0 || BrotliEncoderHasMoreOutput(m_brotli) ||
+                 (end && !BrotliEncoderIsFinished(m_brotli)));
+    }
+#endif
+}
+
+#include "moc_compression.cpp"
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugin>
+#include <Cutelyst/Plugins/compression_export.h>
+
+namespace Cutelyst {
+
+class CompressionPrivate;
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/Compression/Compression>
+ * \brief Compresses dynamic responses with the best encoding the client accepts.
+ *
+ * The %Compression plugin negotiates one of the \c br, \c zstd, \c gzip or \c deflate
+ * content codings from the \c Accept-Encoding request header, honoring q-values, and
+ * installs a ResponseFilter that compresses the body of every response with a configured
+ * content type, no matter if it was rendered by a View, set with Response::setBody() or
+ * written piece by piece. Written responses are compressed incrementally and flushed on
+ * every write so that clients receive data as soon as it is produced.
+ *
+ * Compressor contexts are reused by the worker that created them, bodies smaller than the
+ * configured minimum size, responses with a \c Content-Encoding and bodies that are a
+ * QIODevice, like static files, are sent as they are. The time spent compressing is shown
+ * in the stats report.
+ *
+ * \c gzip and \c deflate are always available, build with
+ * <TT>-DPLUGIN_COMPRESSION_BROTLI:BOOL=ON</TT> and <TT>-DPLUGIN_COMPRESSION_ZSTD:BOOL=ON</TT>
+ * to also support Brotli and Zstandard, in which case \c CUTELYST_COMPRESSION_WITH_BROTLI
+ * and \c CUTELYST_COMPRESSION_WITH_ZSTD are defined.
+ *
+ * <H3>Runtime configuration</H3>
+ *
+ * The plugin reads the \c Cutelyst_Compression_Plugin section of the
+ * \ref configuration "application configuration file", the \a defaultConfig passed to the
+ * constructor is used for missing keys.
+ *
+ * \configblock{encodings,string,br\,zstd\,gzip\,deflate}
+ * Comma separated list of encodings in the order of preference when the client accepts
+ * more than one with the same q-value.
+ * \endconfigblock
+ *
+ * \configblock{mime_types,string,text/html\,text/css\,text/plain\,...}
+ * Comma separated list of content types to compress, an entry ending with a slash like
+ * \c text/ matches all subtypes. Each entry can be followed by <TT>:level</TT> or
+ * <TT>:level:min_size</TT> to override the defaults for that type, as in
+ * <TT>application/json:fast:1024</TT>.
+ * \endconfigblock
+ *
+ * \configblock{level,string,balanced}
+ * Default compression level, one of \c fast, \c balanced or \c max.
+ * \endconfigblock
+ *
+ * \configblock{min_size,integer,256}
+ * Default minimum body size in bytes to compress, bodies written in pieces are always
+ * compressed unless they have a smaller \c Content-Length.
+ * \endconfigblock
+ *
+ * \code{.cpp}
+ * bool MyApp::init()
+ * {
+ *     auto compression = new Compression(this);
+ *     compression->setMimeType("application/json"_ba, Compression::Level::Fast, 1024);
+ * }
+ * \endcode
+ *
+ * \logcat{plugin.compression}
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_COMPRESSION_EXPORT Compression : public Plugin
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(Compression) // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    Q_DISABLE_COPY(Compression)
+public:
+    /**
+     * Trade-off between compression speed and size, mapped to each encoder's own levels.
+     */
+    enum class Level {
+        Fast,
+        Balanced,
+        Max,
+    };
+    Q_ENUM(Level)
+
+    /**
+     * Constructs a new %Compression plugin with the given \a parent.
+     */
+    explicit Compression(Application *parent);
+
+    /**
+     * Constructs a new %Compression plugin with the given \a parent and \a defaultConfig
+     * values for the configuration file entries.
+     */
+    Compression(Application *parent, const QVariantMap &defaultConfig);
+
+    /**
+     * Destroys the %Compression object.
+     */
+    ~Compression() override;
+
+    /**
+     * Compresses responses of \a mimeType with \a level when the body has at least
+     * \a minSize bytes, takes precedence over the configuration file.
+     */
+    void setMimeType(const QByteArray &mimeType, Level level, qint64 minSize = 256);
+
+    /**
+     * Returns the encodings supported by this build in the default order of preference.
+     */
+    [[nodiscard]] static QByteArrayList supportedEncodings();
+
+    /**
+     * Returns the encoding of \a encodings the \a acceptEncoding header value gives the
+     * highest q-value, the first one wins a tie. Returns an empty value if none of them is
+     * acceptable.
+     */
+    [[nodiscard]] static QByteArray negotiate(QByteArrayView acceptEncoding,
+                                              const QByteArrayList &encodings);
+
+    /**
+     * Reads the \c Cutelyst_Compression_Plugin configuration section and registers the hook
+     * that picks the encoding of each request.
+     */
+    bool setup(Application *app) override;
+
+private:
+    std::unique_ptr<CompressionPrivate> d_ptr;
+};
+
+} // namespace Cutelyst
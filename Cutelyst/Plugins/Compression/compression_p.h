@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "compression.h"
+
+#include <Cutelyst/ResponseFilter>
+#include <memory>
+#include <vector>
+#include <zlib.h>
+
+#include <QHash>
+
+#ifdef CUTELYST_COMPRESSION_WITH_BROTLI
+#    include <brotli/encode.h>
+#endif
+
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+#    include <zstd.h>
+#endif
+
+namespace Cutelyst {
+
+class Context;
+
+class CompressionPrivate
+{
+public:
+    enum Encoding { Brotli, Zstd, Gzip, Deflate };
+
+    struct Rule {
+        Compression::Level level = Compression::Level::Balanced;
+        qint64 minSize           = 256;
+    };
+
+    struct ZlibStream {
+        ~ZlibStream() { deflateEnd(&stream); }
+
+        z_stream stream{};
+        int level = Z_DEFAULT_COMPRESSION;
+    };
+
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+    struct ZstdDeleter {
+        void operator()(ZSTD_CCtx *cctx) const { ZSTD_freeCCtx(cctx); }
+    };
+    using ZstdContext = std::unique_ptr<ZSTD_CCtx, ZstdDeleter>;
+#endif
+
+    void beforePrepareAction(Context *c);
+
+    // Returns the rule of the content type or nullptr if it is not compressed
+    [[nodiscard]] const Rule *rule(const QByteArray &contentType) const;
+
+    void parseMimeTypes(const QString &mimeTypes);
+
+    // Compressor contexts are borrowed by a filter and returned once it's done,
+    // there is one plugin per worker so no locking is needed
+    [[nodiscard]] std::unique_ptr<ZlibStream> takeZlib(Encoding encoding, int level);
+    void releaseZlib(Encoding encoding, std::unique_ptr<ZlibStream> stream);
+
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+    [[nodiscard]] ZstdContext takeZstd(int level);
+    void releaseZstd(ZstdContext cctx);
+#endif
+
+    [[nodiscard]] static QByteArrayView encodingName(Encoding encoding) noexcept;
+    [[nodiscard]] static int encoderLevel(Encoding encoding, Compression::Level level) noexcept;
+
+    QVariantMap defaultConfig;
+    QHash<QByteArray, Rule> rules;
+    // Set from code, applied over the configuration
+    QHash<QByteArray, Rule> userRules;
+    QByteArrayList encodings;
+    std::vector<Encoding> encodingIds;
+    std::vector<std::unique_ptr<ZlibStream>> gzipPool;
+    std::vector<std::unique_ptr<ZlibStream>> deflatePool;
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+    std::vector<ZstdContext> zstdPool;
+#endif
+    Rule defaultRule;
+};
+
+class CompressionFilter final : public ResponseFilter
+{
+public:
+    CompressionFilter(CompressionPrivate *d, CompressionPrivate::Encoding encoding);
+    ~CompressionFilter() override;
+
+    [[nodiscard]] QString name() const override;
+    bool start(Response *response) override;
+    QByteArray write(QByteArrayView data) override;
+    QByteArray finish() override;
+
+private:
+    // Flushes after every write when streaming, otherwise the encoder decides
+    void compress(QByteArrayView data, bool end, QByteArray &out);
+
+    CompressionPrivate *d;
+    std::unique_ptr<CompressionPrivate::ZlibStream> m_zlib;
+#ifdef CUTELYST_COMPRESSION_WITH_ZSTD
+    CompressionPrivate::ZstdContext m_zstd;
+#endif
+#ifdef CUTELYST_COMPRESSION_WITH_BROTLI
+    BrotliEncoderState *m_brotli = nullptr;
+#endif
+    CompressionPrivate::Encoding m_encoding;
+    bool m_streaming = false;
+};
+
+} // namespace Cutelyst
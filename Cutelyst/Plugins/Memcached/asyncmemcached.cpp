@@ -0,0 +1,860 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "asyncmemcached.h"
+#include "memcached_p.h"
+#include "memcachedconnection_p.h"
+
+#include <Cutelyst/Context>
+#include <Cutelyst/async.h>
+
+#include <map>
+#include <optional>
+
+#include <QPointer>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+using Kind  = MemcachedRequest::Kind;
+using Reply = AsyncMemcached::Reply;
+
+void finish(const AsyncMemcached::Callback &callback, Memcached::ReturnType returnType)
+{
+    Reply reply;
+    reply.returnType = returnType;
+    callback(reply);
+}
+
+MemcachedPool *pool(const AsyncMemcached::Callback &callback)
+{
+    MemcachedPool *pool = MemcachedPrivate::pool();
+    if (!pool) {
+        qCCritical(C_MEMCACHED) << "Memcached plugin not registered";
+        finish(callback, Memcached::ReturnType::PluginNotRegisterd);
+    }
+    return pool;
+}
+
+// Keeps c detached until the reply arrives
+AsyncMemcached::Callback guard(Context *c, AsyncMemcached::Callback callback)
+{
+    if (!c) {
+        return callback;
+    }
+
+    return [callback = std::move(callback), async = ASync{c}, c = QPointer<Context>{c}](
+               const Reply &reply) {
+        if (c) {
+            callback(reply);
+        }
+    };
+}
+
+// Drops keys from the near cache once the servers answered their write
+AsyncMemcached::Callback invalidating(QByteArrayList keys, AsyncMemcached::Callback callback)
+{
+    return [keys = std::move(keys), callback = std::move(callback)](const Reply &reply) {
+        for (const QByteArray &key : keys) {
+            MemcachedPrivate::invalidateNear(key);
+        }
+        callback(reply);
+    };
+}
+
+// Collects the replies of a request split among several servers
+AsyncMemcached::Callback gather(int parts, AsyncMemcached::Callback callback)
+{
+    struct Gathered {
+        Reply reply;
+        int remaining;
+        AsyncMemcached::Callback callback;
+    };
+
+    auto gathered              = std::make_shared<Gathered>();
+    gathered->reply.returnType = Memcached::ReturnType::Success;
+    gathered->remaining        = parts;
+    gathered->callback         = std::move(callback);
+
+    return [gathered](const Reply &reply) {
+        Reply &result = gathered->reply;
+        if (!reply.ok() && result.ok()) {
+            result.returnType = reply.returnType;
+        }
+        result.values.insert(reply.values);
+        result.casValues.insert(reply.casValues);
+        result.flagValues.insert(reply.flagValues);
+
+        if (--gathered->remaining == 0) {
+            gathered->callback(result);
+        }
+    };
+}
+
+// Returns the key with the namespace, or finishes the callback if it is not valid
+QByteArray fullKey(MemcachedPool *memcPool,
+                   QByteArrayView key,
+                   const AsyncMemcached::Callback &callback)
+{
+    auto returnType       = Memcached::ReturnType::Success;
+    const QByteArray full = memcPool->key(key, returnType);
+    if (full.isNull()) {
+        qCWarning(C_MEMCACHED) << "Invalid key" << key;
+        finish(callback, returnType);
+    }
+    return full;
+}
+
+/**
+ * Sends a meta command for @a key to the server selected by @a groupKey, or by @a key if it
+ * is null, the command is built as "<verb> <key> <args>\r\n", followed by @a data if it is
+ * not null.
+ */
+void send(Context *c,
+          QByteArrayView groupKey,
+          QByteArrayView key,
+          Kind kind,
+          QByteArrayView verb,
+          QByteArrayView args,
+          const QByteArray &data,
+          AsyncMemcached::Callback callback)
+{
+    MemcachedPool *memcPool = pool(callback);
+    if (!memcPool) {
+        return;
+    }
+
+    const QByteArray prefixed = fullKey(memcPool, key, callback);
+    if (prefixed.isNull()) {
+        return;
+    }
+
+    QByteArray command;
+    command.reserve(verb.size() + prefixed.size() + args.size() + data.size() + 6);
+    command.append(verb).append(' ').append(prefixed);
+    if (!args.isEmpty()) {
+        command.append(' ').append(args);
+    }
+    command.append("\r\n");
+    if (!data.isNull()) {
+        command.append(data).append("\r\n");
+    }
+
+    AsyncMemcached::Callback done = guard(c, std::move(callback));
+    if (kind == Kind::Store || kind == Kind::Delete || kind == Kind::Arithmetic) {
+        done = invalidating({key.toByteArray()}, std::move(done));
+    }
+
+    const auto route = memcPool->routeFor(groupKey.isNull() ? key : groupKey);
+    memcPool->send(route, std::make_unique<MemcachedRequest>(kind, std::move(command), done));
+}
+
+// Returns the size, TTL and flags arguments of a set, with the value to send in data
+QByteArray storeArgs(const QByteArray &value, std::chrono::seconds expiration, QByteArray &data)
+{
+    MemcachedPrivate::Flags flags;
+    data = MemcachedPrivate::compressIfNeeded(value, flags);
+    if (data.isNull()) {
+        data = ""_ba;
+    }
+
+    return QByteArray::number(data.size()) + " T" + QByteArray::number(expiration.count()) +
+           " F" + QByteArray::number(flags.toInt());
+}
+
+void store(Context *c,
+           QByteArrayView groupKey,
+           QByteArrayView key,
+           const QByteArray &value,
+           std::chrono::seconds expiration,
+           char mode,
+           uint64_t cas,
+           AsyncMemcached::Callback callback)
+{
+    // Needed by compressIfNeeded()
+    if (!pool(callback)) {
+        return;
+    }
+
+    QByteArray data;
+    QByteArray args = storeArgs(value, expiration, data) + " M" + mode;
+    if (cas) {
+        args += " C" + QByteArray::number(cas);
+    }
+
+    send(c, groupKey, key, Kind::Store, "ms", args, data, std::move(callback));
+}
+
+void arithmetic(Context *c,
+                QByteArrayView groupKey,
+                QByteArrayView key,
+                bool incr,
+                uint64_t offset,
+                std::optional<std::pair<uint64_t, std::chrono::seconds>> initial,
+                AsyncMemcached::Callback callback)
+{
+    QByteArray args = (incr ? "MI D" : "MD D") + QByteArray::number(offset) + " v";
+    if (initial && initial->second != Memcached::expirationNotAddDuration) {
+        args += " J" + QByteArray::number(initial->first) + " N" +
+                QByteArray::number(initial->second.count());
+    }
+
+    send(c, groupKey, key, Kind::Arithmetic, "ma", args, {}, std::move(callback));
+}
+
+/**
+ * Sends a quiet command for each of @a keys, built by @a command from the key with the
+ * namespace, grouped per server and followed by a no-op, so only hits and failures are
+ * answered.
+ */
+void batch(Context *c,
+           QByteArrayView groupKey,
+           const QByteArrayList &keys,
+           Kind kind,
+           const std::function<QByteArray(const QByteArray &key, const QByteArray &prefixed)>
+               &command,
+           AsyncMemcached::Callback callback)
+{
+    MemcachedPool *memcPool = pool(callback);
+    if (!memcPool) {
+        return;
+    }
+
+    if (keys.isEmpty()) {
+        finish(callback, Memcached::ReturnType::Success);
+        return;
+    }
+
+    std::map<MemcachedPool::Route, QByteArray> commands;
+    for (const QByteArray &key : keys) {
+        const QByteArray prefixed = fullKey(memcPool, key, callback);
+        if (prefixed.isNull()) {
+            return;
+        }
+
+        const auto route = memcPool->routeFor(groupKey.isNull() ? QByteArrayView{key} : groupKey);
+        commands[route].append(command(key, prefixed));
+    }
+
+    AsyncMemcached::Callback done = guard(c, std::move(callback));
+    if (kind == Kind::Batch) {
+        done = invalidating(keys, std::move(done));
+    }
+    if (commands.size() > 1) {
+        done = gather(int(commands.size()), std::move(done));
+    }
+
+    for (auto &&[route, routeCommand] : commands) {
+        routeCommand.append("mn\r\n");
+        auto request = std::make_unique<MemcachedRequest>(kind, std::move(routeCommand), done);
+        request->namespaceSize = memcPool->keyPrefix.size();
+        memcPool->send(route, std::move(request));
+    }
+}
+
+void mgetFrom(Context *c,
+              QByteArrayView groupKey,
+              const QByteArrayList &keys,
+              AsyncMemcached::Callback callback)
+{
+    batch(
+        c,
+        groupKey,
+        keys,
+        Kind::MultiGet,
+        [](const QByteArray &, const QByteArray &prefixed) {
+            return "mg " + prefixed + " k v f c q\r\n";
+        },
+        std::move(callback));
+}
+
+void msetFrom(Context *c,
+              QByteArrayView groupKey,
+              const QHash<QByteArray, QByteArray> &values,
+              std::chrono::seconds expiration,
+              AsyncMemcached::Callback callback)
+{
+    batch(
+        c,
+        groupKey,
+        values.keys(),
+        Kind::Batch,
+        [&values, expiration](const QByteArray &key, const QByteArray &prefixed) {
+            QByteArray data;
+            const QByteArray args = storeArgs(values.value(key), expiration, data);
+            return "ms " + prefixed + ' ' + args + " q\r\n" + data + "\r\n";
+        },
+        std::move(callback));
+}
+
+void mremoveFrom(Context *c,
+                 QByteArrayView groupKey,
+                 const QByteArrayList &keys,
+                 AsyncMemcached::Callback callback)
+{
+    batch(
+        c,
+        groupKey,
+        keys,
+        Kind::Batch,
+        [](const QByteArray &, const QByteArray &prefixed) { return "md " + prefixed + " q\r\n"; },
+        std::move(callback));
+}
+
+} // namespace
+
+void AsyncMemcached::set(Context *c,
+                         QByteArrayView key,
+                         const QByteArray &value,
+                         std::chrono::seconds expiration,
+                         Callback callback)
+{
+    store(c, {}, key, value, expiration, 'S', 0, std::move(callback));
+}
+
+void AsyncMemcached::setByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              const QByteArray &value,
+                              std::chrono::seconds expiration,
+                              Callback callback)
+{
+    store(c, groupKey, key, value, expiration, 'S', 0, std::move(callback));
+}
+
+void AsyncMemcached::add(Context *c,
+                         QByteArrayView key,
+                         const QByteArray &value,
+                         std::chrono::seconds expiration,
+                         Callback callback)
+{
+    store(c, {}, key, value, expiration, 'E', 0, std::move(callback));
+}
+
+void AsyncMemcached::addByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              const QByteArray &value,
+                              std::chrono::seconds expiration,
+                              Callback callback)
+{
+    store(c, groupKey, key, value, expiration, 'E', 0, std::move(callback));
+}
+
+void AsyncMemcached::replace(Context *c,
+                             QByteArrayView key,
+                             const QByteArray &value,
+                             std::chrono::seconds expiration,
+                             Callback callback)
+{
+    store(c, {}, key, value, expiration, 'R', 0, std::move(callback));
+}
+
+void AsyncMemcached::replaceByKey(Context *c,
+                                  QByteArrayView groupKey,
+                                  QByteArrayView key,
+                                  const QByteArray &value,
+                                  std::chrono::seconds expiration,
+                                  Callback callback)
+{
+    store(c, groupKey, key, value, expiration, 'R', 0, std::move(callback));
+}
+
+void AsyncMemcached::get(Context *c, QByteArrayView key, Callback callback)
+{
+    getByKey(c, {}, key, std::move(callback));
+}
+
+void AsyncMemcached::getByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              Callback callback)
+{
+    MemcachedPool *memcPool = pool(callback);
+    if (!memcPool) {
+        return;
+    }
+
+    if (!memcPool->batchGets) {
+        send(c, groupKey, key, Kind::Get, "mg", "v f c", {}, std::move(callback));
+        return;
+    }
+
+    const QByteArray prefixed = fullKey(memcPool, key, callback);
+    if (prefixed.isNull()) {
+        return;
+    }
+
+    const auto route = memcPool->routeFor(groupKey.isNull() ? key : groupKey);
+    memcPool->queueGet(route, prefixed, guard(c, std::move(callback)));
+}
+
+void AsyncMemcached::remove(Context *c, QByteArrayView key, Callback callback)
+{
+    send(c, {}, key, Kind::Delete, "md", {}, {}, std::move(callback));
+}
+
+void AsyncMemcached::removeByKey(Context *c,
+                                 QByteArrayView groupKey,
+                                 QByteArrayView key,
+                                 Callback callback)
+{
+    send(c, groupKey, key, Kind::Delete, "md", {}, {}, std::move(callback));
+}
+
+void AsyncMemcached::exist(Context *c, QByteArrayView key, Callback callback)
+{
+    send(c, {}, key, Kind::Exist, "mg", {}, {}, std::move(callback));
+}
+
+void AsyncMemcached::existByKey(Context *c,
+                                QByteArrayView groupKey,
+                                QByteArrayView key,
+                                Callback callback)
+{
+    send(c, groupKey, key, Kind::Exist, "mg", {}, {}, std::move(callback));
+}
+
+void AsyncMemcached::increment(Context *c, QByteArrayView key, uint32_t offset, Callback callback)
+{
+    arithmetic(c, {}, key, true, offset, {}, std::move(callback));
+}
+
+void AsyncMemcached::incrementByKey(Context *c,
+                                    QByteArrayView groupKey,
+                                    QByteArrayView key,
+                                    uint64_t offset,
+                                    Callback callback)
+{
+    arithmetic(c, groupKey, key, true, offset, {}, std::move(callback));
+}
+
+void AsyncMemcached::incrementWithInitial(Context *c,
+                                          QByteArrayView key,
+                                          uint64_t offset,
+                                          uint64_t initial,
+                                          std::chrono::seconds expiration,
+                                          Callback callback)
+{
+    arithmetic(
+        c, {}, key, true, offset, std::pair{initial, expiration}, std::move(callback));
+}
+
+void AsyncMemcached::incrementWithInitialByKey(Context *c,
+                                               QByteArrayView groupKey,
+                                               QByteArrayView key,
+                                               uint64_t offset,
+                                               uint64_t initial,
+                                               std::chrono::seconds expiration,
+                                               Callback callback)
+{
+    arithmetic(
+        c, groupKey, key, true, offset, std::pair{initial, expiration}, std::move(callback));
+}
+
+void AsyncMemcached::decrement(Context *c, QByteArrayView key, uint32_t offset, Callback callback)
+{
+    arithmetic(c, {}, key, false, offset, {}, std::move(callback));
+}
+
+void AsyncMemcached::decrementByKey(Context *c,
+                                    QByteArrayView groupKey,
+                                    QByteArrayView key,
+                                    uint64_t offset,
+                                    Callback callback)
+{
+    arithmetic(c, groupKey, key, false, offset, {}, std::move(callback));
+}
+
+void AsyncMemcached::decrementWithInitial(Context *c,
+                                          QByteArrayView key,
+                                          uint64_t offset,
+                                          uint64_t initial,
+                                          std::chrono::seconds expiration,
+                                          Callback callback)
+{
+    arithmetic(
+        c, {}, key, false, offset, std::pair{initial, expiration}, std::move(callback));
+}
+
+void AsyncMemcached::decrementWithInitialByKey(Context *c,
+                                               QByteArrayView groupKey,
+                                               QByteArrayView key,
+                                               uint64_t offset,
+                                               uint64_t initial,
+                                               std::chrono::seconds expiration,
+                                               Callback callback)
+{
+    arithmetic(
+        c, groupKey, key, false, offset, std::pair{initial, expiration}, std::move(callback));
+}
+
+void AsyncMemcached::cas(Context *c,
+                         QByteArrayView key,
+                         const QByteArray &value,
+                         std::chrono::seconds expiration,
+                         uint64_t cas,
+                         Callback callback)
+{
+    store(c, {}, key, value, expiration, 'S', cas, std::move(callback));
+}
+
+void AsyncMemcached::casByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              const QByteArray &value,
+                              std::chrono::seconds expiration,
+                              uint64_t cas,
+                              Callback callback)
+{
+    store(c, groupKey, key, value, expiration, 'S', cas, std::move(callback));
+}
+
+void AsyncMemcached::flush(Context *c, std::chrono::seconds expiration, Callback callback)
+{
+    MemcachedPool *memcPool = pool(callback);
+    if (!memcPool) {
+        return;
+    }
+
+    Callback done = gather(memcPool->serverCount(),
+                           [callback = guard(c, std::move(callback))](const Reply &reply) {
+        MemcachedPrivate::clearNear();
+        callback(reply);
+    });
+    for (int server = 0; server < memcPool->serverCount(); ++server) {
+        memcPool->send({server, 0},
+                       std::make_unique<MemcachedRequest>(
+                           Kind::Flush,
+                           "flush_all " + QByteArray::number(expiration.count()) + "\r\n",
+                           done));
+    }
+}
+
+void AsyncMemcached::mget(Context *c, const QByteArrayList &keys, Callback callback)
+{
+    mgetFrom(c, {}, keys, std::move(callback));
+}
+
+void AsyncMemcached::mgetByKey(Context *c,
+                               QByteArrayView groupKey,
+                               const QByteArrayList &keys,
+                               Callback callback)
+{
+    mgetFrom(c, groupKey, keys, std::move(callback));
+}
+
+void AsyncMemcached::mset(Context *c,
+                          const QHash<QByteArray, QByteArray> &values,
+                          std::chrono::seconds expiration,
+                          Callback callback)
+{
+    msetFrom(c, {}, values, expiration, std::move(callback));
+}
+
+void AsyncMemcached::msetByKey(Context *c,
+                               QByteArrayView groupKey,
+                               const QHash<QByteArray, QByteArray> &values,
+                               std::chrono::seconds expiration,
+                               Callback callback)
+{
+    msetFrom(c, groupKey, values, expiration, std::move(callback));
+}
+
+void AsyncMemcached::mremove(Context *c, const QByteArrayList &keys, Callback callback)
+{
+    mremoveFrom(c, {}, keys, std::move(callback));
+}
+
+void AsyncMemcached::mremoveByKey(Context *c,
+                                  QByteArrayView groupKey,
+                                  const QByteArrayList &keys,
+                                  Callback callback)
+{
+    mremoveFrom(c, groupKey, keys, std::move(callback));
+}
+
+void AsyncMemcached::touch(Context *c,
+                           QByteArrayView key,
+                           std::chrono::seconds expiration,
+                           Callback callback)
+{
+    send(c,
+         {},
+         key,
+         Kind::Touch,
+         "mg",
+         "T" + QByteArray::number(expiration.count()),
+         {},
+         std::move(callback));
+}
+
+void AsyncMemcached::touchByKey(Context *c,
+                                QByteArrayView groupKey,
+                                QByteArrayView key,
+                                std::chrono::seconds expiration,
+                                Callback callback)
+{
+    send(c,
+         groupKey,
+         key,
+         Kind::Touch,
+         "mg",
+         "T" + QByteArray::number(expiration.count()),
+         {},
+         std::move(callback));
+}
+
+AwaitedMemcached AsyncMemcached::coSet(Context *c,
+                                       QByteArrayView key,
+                                       const QByteArray &value,
+                                       std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) { set(c, key, value, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coSetByKey(Context *c,
+                                            QByteArrayView groupKey,
+                                            QByteArrayView key,
+                                            const QByteArray &value,
+                                            std::chrono::seconds expiration)
+{
+    return await(
+        [&](Callback callback) { setByKey(c, groupKey, key, value, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coAdd(Context *c,
+                                       QByteArrayView key,
+                                       const QByteArray &value,
+                                       std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) { add(c, key, value, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coAddByKey(Context *c,
+                                            QByteArrayView groupKey,
+                                            QByteArrayView key,
+                                            const QByteArray &value,
+                                            std::chrono::seconds expiration)
+{
+    return await(
+        [&](Callback callback) { addByKey(c, groupKey, key, value, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coReplace(Context *c,
+                                           QByteArrayView key,
+                                           const QByteArray &value,
+                                           std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) { replace(c, key, value, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coReplaceByKey(Context *c,
+                                                QByteArrayView groupKey,
+                                                QByteArrayView key,
+                                                const QByteArray &value,
+                                                std::chrono::seconds expiration)
+{
+    return await(
+        [&](Callback callback) { replaceByKey(c, groupKey, key, value, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coGet(Context *c, QByteArrayView key)
+{
+    return await([&](Callback callback) { get(c, key, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coGetByKey(Context *c, QByteArrayView groupKey, QByteArrayView key)
+{
+    return await([&](Callback callback) { getByKey(c, groupKey, key, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coRemove(Context *c, QByteArrayView key)
+{
+    return await([&](Callback callback) { remove(c, key, callback); });
+}
+
+AwaitedMemcached
+    AsyncMemcached::coRemoveByKey(Context *c, QByteArrayView groupKey, QByteArrayView key)
+{
+    return await([&](Callback callback) { removeByKey(c, groupKey, key, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coExist(Context *c, QByteArrayView key)
+{
+    return await([&](Callback callback) { exist(c, key, callback); });
+}
+
+AwaitedMemcached
+    AsyncMemcached::coExistByKey(Context *c, QByteArrayView groupKey, QByteArrayView key)
+{
+    return await([&](Callback callback) { existByKey(c, groupKey, key, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coIncrement(Context *c, QByteArrayView key, uint32_t offset)
+{
+    return await([&](Callback callback) { increment(c, key, offset, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coIncrementByKey(Context *c,
+                                                  QByteArrayView groupKey,
+                                                  QByteArrayView key,
+                                                  uint64_t offset)
+{
+    return await([&](Callback callback) { incrementByKey(c, groupKey, key, offset, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coIncrementWithInitial(Context *c,
+                                                        QByteArrayView key,
+                                                        uint64_t offset,
+                                                        uint64_t initial,
+                                                        std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) {
+        incrementWithInitial(c, key, offset, initial, expiration, callback);
+    });
+}
+
+AwaitedMemcached AsyncMemcached::coIncrementWithInitialByKey(Context *c,
+                                                             QByteArrayView groupKey,
+                                                             QByteArrayView key,
+                                                             uint64_t offset,
+                                                             uint64_t initial,
+                                                             std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) {
+        incrementWithInitialByKey(c, groupKey, key, offset, initial, expiration, callback);
+    });
+}
+
+AwaitedMemcached AsyncMemcached::coDecrement(Context *c, QByteArrayView key, uint32_t offset)
+{
+    return await([&](Callback callback) { decrement(c, key, offset, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coDecrementByKey(Context *c,
+                                                  QByteArrayView groupKey,
+                                                  QByteArrayView key,
+                                                  uint64_t offset)
+{
+    return await([&](Callback callback) { decrementByKey(c, groupKey, key, offset, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coDecrementWithInitial(Context *c,
+                                                        QByteArrayView key,
+                                                        uint64_t offset,
+                                                        uint64_t initial,
+                                                        std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) {
+        decrementWithInitial(c, key, offset, initial, expiration, callback);
+    });
+}
+
+AwaitedMemcached AsyncMemcached::coDecrementWithInitialByKey(Context *c,
+                                                             QByteArrayView groupKey,
+                                                             QByteArrayView key,
+                                                             uint64_t offset,
+                                                             uint64_t initial,
+                                                             std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) {
+        decrementWithInitialByKey(c, groupKey, key, offset, initial, expiration, callback);
+    });
+}
+
+AwaitedMemcached AsyncMemcached::coCas(Context *c,
+                                       QByteArrayView key,
+                                       const QByteArray &value,
+                                       std::chrono::seconds expiration,
+                                       uint64_t cas)
+{
+    return await(
+        [&](Callback callback) { AsyncMemcached::cas(c, key, value, expiration, cas, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coCasByKey(Context *c,
+                                            QByteArrayView groupKey,
+                                            QByteArrayView key,
+                                            const QByteArray &value,
+                                            std::chrono::seconds expiration,
+                                            uint64_t cas)
+{
+    return await([&](Callback callback) {
+        casByKey(c, groupKey, key, value, expiration, cas, callback);
+    });
+}
+
+AwaitedMemcached AsyncMemcached::coFlush(Context *c, std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) { flush(c, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coMget(Context *c, const QByteArrayList &keys)
+{
+    return await([&](Callback callback) { mget(c, keys, callback); });
+}
+
+AwaitedMemcached
+    AsyncMemcached::coMgetByKey(Context *c, QByteArrayView groupKey, const QByteArrayList &keys)
+{
+    return await([&](Callback callback) { mgetByKey(c, groupKey, keys, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coMset(Context *c,
+                                        const QHash<QByteArray, QByteArray> &values,
+                                        std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) { mset(c, values, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coMsetByKey(Context *c,
+                                             QByteArrayView groupKey,
+                                             const QHash<QByteArray, QByteArray> &values,
+                                             std::chrono::seconds expiration)
+{
+    return await(
+        [&](Callback callback) { msetByKey(c, groupKey, values, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coMremove(Context *c, const QByteArrayList &keys)
+{
+    return await([&](Callback callback) { mremove(c, keys, callback); });
+}
+
+AwaitedMemcached
+    AsyncMemcached::coMremoveByKey(Context *c, QByteArrayView groupKey, const QByteArrayList &keys)
+{
+    return await([&](Callback callback) { mremoveByKey(c, groupKey, keys, callback); });
+}
+
+AwaitedMemcached
+    AsyncMemcached::coTouch(Context *c, QByteArrayView key, std::chrono::seconds expiration)
+{
+    return await([&](Callback callback) { touch(c, key, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::coTouchByKey(Context *c,
+                                              QByteArrayView groupKey,
+                                              QByteArrayView key,
+                                              std::chrono::seconds expiration)
+{
+    return await(
+        [&](Callback callback) { touchByKey(c, groupKey, key, expiration, callback); });
+}
+
+AwaitedMemcached AsyncMemcached::await(const std::function<void(Callback callback)> &run)
+{
+    AwaitedMemcached awaited;
+    run([state = awaited.m_state](const Reply &reply) {
+        state->reply    = reply;
+        state->hasReply = true;
+        if (state->handle) {
+            state->handle.resume();
+        }
+    });
+    return awaited;
+}
@@ -0,0 +1,1019 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugins/Memcached/memcached.h>
+#include <Cutelyst/Plugins/memcached_export.h>
+#include <chrono>
+#include <coroutine>
+#include <functional>
+#include <memory>
+
+#include <QByteArrayList>
+#include <QDataStream>
+#include <QHash>
+
+namespace Cutelyst {
+
+class Context;
+class AwaitedMemcached;
+
+/**
+ * @ingroup plugins
+ * @headerfile "" <Cutelyst/Plugins/Memcached/AsyncMemcached>
+ * @brief Non-blocking access to the memcached servers of the %Memcached plugin.
+ *
+ * The static methods of Memcached block the worker thread until libmemcached gets the
+ * answer of the server, so one slow server stalls every request handled by that worker.
+ * %AsyncMemcached provides the same operations on top of the event loop of the worker,
+ * calling a callback, or resuming a coroutine, once the reply arrives.
+ *
+ * It talks the memcached meta protocol, available since memcached 1.6, to the servers
+ * configured for the Memcached plugin, which has to be registered. Every worker keeps its
+ * own connections to each server, requests are pipelined on them and the commands for a
+ * key always use the same connection. Keys are distributed among the servers by libmemcached,
+ * following the @c distribution, @c hash and @c hash_with_namespace options, so both APIs
+ * find a key on the same server. The key namespace and the compression settings of the plugin
+ * are shared, values stored by one can be read by the other.
+ *
+ * When a Context is passed it is detached until the reply arrives and the callback is not
+ * called if the Context gets destroyed in the meantime. Errors detected before sending
+ * anything, like invalid keys, call the callback before the method returns.
+ *
+ * @note The @c encryption_key and the SASL options of the plugin are not supported, the
+ * servers used with %AsyncMemcached must accept plain connections and values.
+ *
+ * In addition to the configuration of the Memcached plugin the following keys of the
+ * @c Cutelyst_Memcached_Plugin section are used:
+ *
+ * @configblock{async_connections,integer,2}
+ * The maximum number of connections of every worker to each server.
+ * @endconfigblock
+ *
+ * @configblock{async_timeout,integer,1000}
+ * Milliseconds to wait for a server to answer, when it is exceeded every request waiting
+ * on that connection fails with Memcached::ReturnType::Timeout.
+ * @endconfigblock
+ *
+ * @configblock{async_batch_gets,bool,true}
+ * Collects the get() calls issued in the same event loop iteration into a single multi-get
+ * per server, saving round trips when an action or its dependencies read several keys.
+ * @endconfigblock
+ *
+ * @par Usage example
+ * @code{.cpp}
+ * void MyController::index(Context *c)
+ * {
+ *     AsyncMemcached::get(c, "MyKey", [c](const AsyncMemcached::Reply &reply) {
+ *         if (reply.ok()) {
+ *             c->response()->setBody(reply.value);
+ *         }
+ *     });
+ * }
+ *
+ * CoroContext MyController::view(Context *c)
+ * {
+ *     const auto reply = co_await AsyncMemcached::coIncrement(c, "counter", 1);
+ *     c->response()->setBody(QByteArray::number(reply.number));
+ * }
+ * @endcode
+ *
+ * @since %Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_MEMCACHED_EXPORT AsyncMemcached
+{
+public:
+    /**
+     * The answer of the servers to a request.
+     */
+    struct Reply {
+        /** The outcome of the request. */
+        Memcached::ReturnType returnType = Memcached::ReturnType::Failure;
+        /** The value read by get() and getByKey(). */
+        QByteArray value;
+        /** The CAS value of the item read by get() and getByKey(). */
+        uint64_t cas = 0;
+        /** The new value of the item changed by increment() or decrement(). */
+        uint64_t number = 0;
+        /** The values read by mget() and mgetByKey(), keys not found are not present. */
+        QHash<QByteArray, QByteArray> values;
+        /** The CAS values of the items read by mget() and mgetByKey(). */
+        QHash<QByteArray, uint64_t> casValues;
+        /** The codec flags of the value read by get() and getByKey(), see Memcached::decode(). */
+        quint32 flags = 0;
+        /** The codec flags of the values read by mget() and mgetByKey(). */
+        QHash<QByteArray, quint32> flagValues;
+
+        /**
+         * Returns @c true if the request succeeded.
+         */
+        [[nodiscard]] bool ok() const noexcept
+        {
+            return returnType == Memcached::ReturnType::Success;
+        }
+
+        /**
+         * Returns the value deserialized with the codec it was stored with.
+         */
+        template <typename T>
+        [[nodiscard]] T valueAs() const;
+
+        /**
+         * Returns the values deserialized with the codec they were stored with.
+         */
+        template <typename T>
+        [[nodiscard]] QHash<QByteArray, T> valuesAs() const;
+    };
+
+    /**
+     * Receives the reply of a request.
+     */
+    using Callback = std::function<void(const Reply &reply)>;
+
+    /**
+     * Stores the @a value under @a key for @a expiration.
+     */
+    static void set(Context *c,
+                    QByteArrayView key,
+                    const QByteArray &value,
+                    std::chrono::seconds expiration,
+                    Callback callback);
+
+    /**
+     * Serializes the @a value with QDataStream and stores it under @a key for @a expiration.
+     */
+    template <typename T>
+    static void set(Context *c,
+                    QByteArrayView key,
+                    const T &value,
+                    std::chrono::seconds expiration,
+                    Callback callback);
+
+    /**
+     * Like set(), but uses @a groupKey to select the server.
+     */
+    static void setByKey(Context *c,
+                         QByteArrayView groupKey,
+                         QByteArrayView key,
+                         const QByteArray &value,
+                         std::chrono::seconds expiration,
+                         Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void setByKey(Context *c,
+                         QByteArrayView groupKey,
+                         QByteArrayView key,
+                         const T &value,
+                         std::chrono::seconds expiration,
+                         Callback callback);
+
+    /**
+     * Stores the @a value under @a key for @a expiration if the key does not exist yet,
+     * otherwise fails with Memcached::ReturnType::NotStored.
+     */
+    static void add(Context *c,
+                    QByteArrayView key,
+                    const QByteArray &value,
+                    std::chrono::seconds expiration,
+                    Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void add(Context *c,
+                    QByteArrayView key,
+                    const T &value,
+                    std::chrono::seconds expiration,
+                    Callback callback);
+
+    /**
+     * Like add(), but uses @a groupKey to select the server.
+     */
+    static void addByKey(Context *c,
+                         QByteArrayView groupKey,
+                         QByteArrayView key,
+                         const QByteArray &value,
+                         std::chrono::seconds expiration,
+                         Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void addByKey(Context *c,
+                         QByteArrayView groupKey,
+                         QByteArrayView key,
+                         const T &value,
+                         std::chrono::seconds expiration,
+                         Callback callback);
+
+    /**
+     * Replaces the value of the existing @a key with @a value, otherwise fails with
+     * Memcached::ReturnType::NotStored.
+     */
+    static void replace(Context *c,
+                        QByteArrayView key,
+                        const QByteArray &value,
+                        std::chrono::seconds expiration,
+                        Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void replace(Context *c,
+                        QByteArrayView key,
+                        const T &value,
+                        std::chrono::seconds expiration,
+                        Callback callback);
+
+    /**
+     * Like replace(), but uses @a groupKey to select the server.
+     */
+    static void replaceByKey(Context *c,
+                             QByteArrayView groupKey,
+                             QByteArrayView key,
+                             const QByteArray &value,
+                             std::chrono::seconds expiration,
+                             Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void replaceByKey(Context *c,
+                             QByteArrayView groupKey,
+                             QByteArrayView key,
+                             const T &value,
+                             std::chrono::seconds expiration,
+                             Callback callback);
+
+    /**
+     * Reads the value and the CAS value of @a key into Reply::value and Reply::cas.
+     *
+     * Unless @c async_batch_gets is disabled, gets issued in the same event loop iteration,
+     * like the ones of a single dispatch phase, are sent to each server as one multi-get.
+     */
+    static void get(Context *c, QByteArrayView key, Callback callback);
+
+    /**
+     * Like get(), but uses @a groupKey to select the server.
+     */
+    static void
+        getByKey(Context *c, QByteArrayView groupKey, QByteArrayView key, Callback callback);
+
+    /**
+     * Removes the @a key.
+     */
+    static void remove(Context *c, QByteArrayView key, Callback callback);
+
+    /**
+     * Like remove(), but uses @a groupKey to select the server.
+     */
+    static void
+        removeByKey(Context *c, QByteArrayView groupKey, QByteArrayView key, Callback callback);
+
+    /**
+     * Checks if the @a key exists, without reading its value.
+     */
+    static void exist(Context *c, QByteArrayView key, Callback callback);
+
+    /**
+     * Like exist(), but uses @a groupKey to select the server.
+     */
+    static void
+        existByKey(Context *c, QByteArrayView groupKey, QByteArrayView key, Callback callback);
+
+    /**
+     * Increments the numeric value of @a key by @a offset, the new value is set to
+     * Reply::number.
+     */
+    static void increment(Context *c, QByteArrayView key, uint32_t offset, Callback callback);
+
+    /**
+     * Like increment(), but uses @a groupKey to select the server.
+     */
+    static void incrementByKey(Context *c,
+                               QByteArrayView groupKey,
+                               QByteArrayView key,
+                               uint64_t offset,
+                               Callback callback);
+
+    /**
+     * Increments the numeric value of @a key by @a offset, if it does not exist it is
+     * created with @a initial for @a expiration, unless @a expiration is
+     * Memcached::expirationNotAddDuration.
+     */
+    static void incrementWithInitial(Context *c,
+                                     QByteArrayView key,
+                                     uint64_t offset,
+                                     uint64_t initial,
+                                     std::chrono::seconds expiration,
+                                     Callback callback);
+
+    /**
+     * Like incrementWithInitial(), but uses @a groupKey to select the server.
+     */
+    static void incrementWithInitialByKey(Context *c,
+                                          QByteArrayView groupKey,
+                                          QByteArrayView key,
+                                          uint64_t offset,
+                                          uint64_t initial,
+                                          std::chrono::seconds expiration,
+                                          Callback callback);
+
+    /**
+     * Decrements the numeric value of @a key by @a offset, the new value is set to
+     * Reply::number.
+     */
+    static void decrement(Context *c, QByteArrayView key, uint32_t offset, Callback callback);
+
+    /**
+     * Like decrement(), but uses @a groupKey to select the server.
+     */
+    static void decrementByKey(Context *c,
+                               QByteArrayView groupKey,
+                               QByteArrayView key,
+                               uint64_t offset,
+                               Callback callback);
+
+    /**
+     * Decrements the numeric value of @a key by @a offset, if it does not exist it is
+     * created with @a initial for @a expiration, unless @a expiration is
+     * Memcached::expirationNotAddDuration.
+     */
+    static void decrementWithInitial(Context *c,
+                                     QByteArrayView key,
+                                     uint64_t offset,
+                                     uint64_t initial,
+                                     std::chrono::seconds expiration,
+                                     Callback callback);
+
+    /**
+     * Like decrementWithInitial(), but uses @a groupKey to select the server.
+     */
+    static void decrementWithInitialByKey(Context *c,
+                                          QByteArrayView groupKey,
+                                          QByteArrayView key,
+                                          uint64_t offset,
+                                          uint64_t initial,
+                                          std::chrono::seconds expiration,
+                                          Callback callback);
+
+    /**
+     * Stores the @a value under @a key only if it was not changed since it was read with
+     * the @a cas value, otherwise fails with Memcached::ReturnType::DataExists.
+     */
+    static void cas(Context *c,
+                    QByteArrayView key,
+                    const QByteArray &value,
+                    std::chrono::seconds expiration,
+                    uint64_t cas,
+                    Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void cas(Context *c,
+                    QByteArrayView key,
+                    const T &value,
+                    std::chrono::seconds expiration,
+                    uint64_t cas,
+                    Callback callback);
+
+    /**
+     * Like cas(), but uses @a groupKey to select the server.
+     */
+    static void casByKey(Context *c,
+                         QByteArrayView groupKey,
+                         QByteArrayView key,
+                         const QByteArray &value,
+                         std::chrono::seconds expiration,
+                         uint64_t cas,
+                         Callback callback);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    static void casByKey(Context *c,
+                         QByteArrayView groupKey,
+                         QByteArrayView key,
+                         const T &value,
+                         std::chrono::seconds expiration,
+                         uint64_t cas,
+                         Callback callback);
+
+    /**
+     * Invalidates all items on all servers after @a expiration.
+     */
+    static void flush(Context *c, std::chrono::seconds expiration, Callback callback);
+
+    /**
+     * Reads the values of all @a keys into Reply::values and Reply::casValues, keys on
+     * different servers are fetched in parallel.
+     */
+    static void mget(Context *c, const QByteArrayList &keys, Callback callback);
+
+    /**
+     * Like mget(), but uses @a groupKey to select the server of all keys.
+     */
+    static void mgetByKey(Context *c,
+                          QByteArrayView groupKey,
+                          const QByteArrayList &keys,
+                          Callback callback);
+
+    /**
+     * Stores all @a values with quiet commands, pipelined on one request per server, the
+     * servers only answer the items that failed, which make the reply
+     * Memcached::ReturnType::SomeErrors.
+     */
+    static void mset(Context *c,
+                     const QHash<QByteArray, QByteArray> &values,
+                     std::chrono::seconds expiration,
+                     Callback callback);
+
+    /**
+     * Like mset(), but uses @a groupKey to select the server of all keys.
+     */
+    static void msetByKey(Context *c,
+                          QByteArrayView groupKey,
+                          const QHash<QByteArray, QByteArray> &values,
+                          std::chrono::seconds expiration,
+                          Callback callback);
+
+    /**
+     * Removes all @a keys with quiet commands, pipelined on one request per server, keys
+     * that do not exist are not reported as errors.
+     */
+    static void mremove(Context *c, const QByteArrayList &keys, Callback callback);
+
+    /**
+     * Like mremove(), but uses @a groupKey to select the server of all keys.
+     */
+    static void mremoveByKey(Context *c,
+                             QByteArrayView groupKey,
+                             const QByteArrayList &keys,
+                             Callback callback);
+
+    /**
+     * Changes the expiration of @a key to @a expiration.
+     */
+    static void
+        touch(Context *c, QByteArrayView key, std::chrono::seconds expiration, Callback callback);
+
+    /**
+     * Like touch(), but uses @a groupKey to select the server.
+     */
+    static void touchByKey(Context *c,
+                           QByteArrayView groupKey,
+                           QByteArrayView key,
+                           std::chrono::seconds expiration,
+                           Callback callback);
+
+    /**
+     * Like set(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coSet(Context *c,
+                                                QByteArrayView key,
+                                                const QByteArray &value,
+                                                std::chrono::seconds expiration);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached
+        coSet(Context *c, QByteArrayView key, const T &value, std::chrono::seconds expiration);
+
+    /**
+     * Like setByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coSetByKey(Context *c,
+                                                     QByteArrayView groupKey,
+                                                     QByteArrayView key,
+                                                     const QByteArray &value,
+                                                     std::chrono::seconds expiration);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached coSetByKey(Context *c,
+                                                     QByteArrayView groupKey,
+                                                     QByteArrayView key,
+                                                     const T &value,
+                                                     std::chrono::seconds expiration);
+
+    /**
+     * Like add(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coAdd(Context *c,
+                                                QByteArrayView key,
+                                                const QByteArray &value,
+                                                std::chrono::seconds expiration);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached
+        coAdd(Context *c, QByteArrayView key, const T &value, std::chrono::seconds expiration);
+
+    /**
+     * Like addByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coAddByKey(Context *c,
+                                                     QByteArrayView groupKey,
+                                                     QByteArrayView key,
+                                                     const QByteArray &value,
+                                                     std::chrono::seconds expiration);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached coAddByKey(Context *c,
+                                                     QByteArrayView groupKey,
+                                                     QByteArrayView key,
+                                                     const T &value,
+                                                     std::chrono::seconds expiration);
+
+    /**
+     * Like replace(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coReplace(Context *c,
+                                                    QByteArrayView key,
+                                                    const QByteArray &value,
+                                                    std::chrono::seconds expiration);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached
+        coReplace(Context *c, QByteArrayView key, const T &value, std::chrono::seconds expiration);
+
+    /**
+     * Like replaceByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coReplaceByKey(Context *c,
+                                                         QByteArrayView groupKey,
+                                                         QByteArrayView key,
+                                                         const QByteArray &value,
+                                                         std::chrono::seconds expiration);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached coReplaceByKey(Context *c,
+                                                         QByteArrayView groupKey,
+                                                         QByteArrayView key,
+                                                         const T &value,
+                                                         std::chrono::seconds expiration);
+
+    /**
+     * Like get(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coGet(Context *c, QByteArrayView key);
+
+    /**
+     * Like getByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coGetByKey(Context *c, QByteArrayView groupKey, QByteArrayView key);
+
+    /**
+     * Like remove(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coRemove(Context *c, QByteArrayView key);
+
+    /**
+     * Like removeByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coRemoveByKey(Context *c, QByteArrayView groupKey, QByteArrayView key);
+
+    /**
+     * Like exist(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coExist(Context *c, QByteArrayView key);
+
+    /**
+     * Like existByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coExistByKey(Context *c, QByteArrayView groupKey, QByteArrayView key);
+
+    /**
+     * Like increment(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coIncrement(Context *c, QByteArrayView key, uint32_t offset);
+
+    /**
+     * Like incrementByKey(), but returns an awaitable for the reply to be used in a
+     * CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coIncrementByKey(Context *c, QByteArrayView groupKey, QByteArrayView key, uint64_t offset);
+
+    /**
+     * Like incrementWithInitial(), but returns an awaitable for the reply to be used in a
+     * CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coIncrementWithInitial(Context *c,
+                                                                 QByteArrayView key,
+                                                                 uint64_t offset,
+                                                                 uint64_t initial,
+                                                                 std::chrono::seconds expiration);
+
+    /**
+     * Like incrementWithInitialByKey(), but returns an awaitable for the reply to be used in
+     * a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coIncrementWithInitialByKey(Context *c,
+                                    QByteArrayView groupKey,
+                                    QByteArrayView key,
+                                    uint64_t offset,
+                                    uint64_t initial,
+                                    std::chrono::seconds expiration);
+
+    /**
+     * Like decrement(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coDecrement(Context *c, QByteArrayView key, uint32_t offset);
+
+    /**
+     * Like decrementByKey(), but returns an awaitable for the reply to be used in a
+     * CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coDecrementByKey(Context *c, QByteArrayView groupKey, QByteArrayView key, uint64_t offset);
+
+    /**
+     * Like decrementWithInitial(), but returns an awaitable for the reply to be used in a
+     * CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coDecrementWithInitial(Context *c,
+                                                                 QByteArrayView key,
+                                                                 uint64_t offset,
+                                                                 uint64_t initial,
+                                                                 std::chrono::seconds expiration);
+
+    /**
+     * Like decrementWithInitialByKey(), but returns an awaitable for the reply to be used in
+     * a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coDecrementWithInitialByKey(Context *c,
+                                    QByteArrayView groupKey,
+                                    QByteArrayView key,
+                                    uint64_t offset,
+                                    uint64_t initial,
+                                    std::chrono::seconds expiration);
+
+    /**
+     * Like cas(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coCas(Context *c,
+                                                QByteArrayView key,
+                                                const QByteArray &value,
+                                                std::chrono::seconds expiration,
+                                                uint64_t cas);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached coCas(Context *c,
+                                                QByteArrayView key,
+                                                const T &value,
+                                                std::chrono::seconds expiration,
+                                                uint64_t cas);
+
+    /**
+     * Like casByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coCasByKey(Context *c,
+                                                     QByteArrayView groupKey,
+                                                     QByteArrayView key,
+                                                     const QByteArray &value,
+                                                     std::chrono::seconds expiration,
+                                                     uint64_t cas);
+
+    /**
+     * @overload
+     */
+    template <typename T>
+    [[nodiscard]] static AwaitedMemcached coCasByKey(Context *c,
+                                                     QByteArrayView groupKey,
+                                                     QByteArrayView key,
+                                                     const T &value,
+                                                     std::chrono::seconds expiration,
+                                                     uint64_t cas);
+
+    /**
+     * Like flush(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coFlush(Context *c, std::chrono::seconds expiration);
+
+    /**
+     * Like mget(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coMget(Context *c, const QByteArrayList &keys);
+
+    /**
+     * Like mgetByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coMgetByKey(Context *c, QByteArrayView groupKey, const QByteArrayList &keys);
+
+    /**
+     * Like mset(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coMset(Context *c,
+                                                 const QHash<QByteArray, QByteArray> &values,
+                                                 std::chrono::seconds expiration);
+
+    /**
+     * Like msetByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coMsetByKey(Context *c,
+                    QByteArrayView groupKey,
+                    const QHash<QByteArray, QByteArray> &values,
+                    std::chrono::seconds expiration);
+
+    /**
+     * Like mremove(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coMremove(Context *c, const QByteArrayList &keys);
+
+    /**
+     * Like mremoveByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coMremoveByKey(Context *c, QByteArrayView groupKey, const QByteArrayList &keys);
+
+    /**
+     * Like touch(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached
+        coTouch(Context *c, QByteArrayView key, std::chrono::seconds expiration);
+
+    /**
+     * Like touchByKey(), but returns an awaitable for the reply to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedMemcached coTouchByKey(Context *c,
+                                                       QByteArrayView groupKey,
+                                                       QByteArrayView key,
+                                                       std::chrono::seconds expiration);
+
+private:
+    template <typename T>
+    static QByteArray serialize(const T &value);
+
+    // Calls run with the callback that resumes the returned awaitable
+    static AwaitedMemcached await(const std::function<void(Callback callback)> &run);
+};
+
+/**
+ * @ingroup plugins
+ * @headerfile "" <Cutelyst/Plugins/Memcached/AsyncMemcached>
+ * @brief Coroutine awaitable for the replies of AsyncMemcached.
+ * @since %Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_MEMCACHED_EXPORT AwaitedMemcached
+{
+public:
+    bool await_ready() const noexcept { return m_state->hasReply; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        m_state->handle = h;
+        return !await_ready();
+    }
+
+    AsyncMemcached::Reply await_resume() { return m_state->reply; }
+
+private:
+    friend class AsyncMemcached;
+
+    struct State {
+        AsyncMemcached::Reply reply;
+        std::coroutine_handle<> handle;
+        bool hasReply = false;
+    };
+
+    AwaitedMemcached()
+        : m_state(std::make_shared<State>())
+    {
+    }
+
+    // Shared with the callback, which might be called before the coroutine is suspended
+    std::shared_ptr<State> m_state;
+};
+
+template <typename T>
+T AsyncMemcached::Reply::valueAs() const
+{
+    return Memcached::decode<T>(value, flags);
+}
+
+template <typename T>
+QHash<QByteArray, T> AsyncMemcached::Reply::valuesAs() const
+{
+    QHash<QByteArray, T> hash;
+    for (const auto &[key, data] : values.asKeyValueRange()) {
+        hash.insert(key, Memcached::decode<T>(data, flagValues.value(key)));
+    }
+    return hash;
+}
+
+template <typename T>
+QByteArray AsyncMemcached::serialize(const T &value)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODeviceBase::WriteOnly);
+    out << value;
+    return data;
+}
+
+template <typename T>
+void AsyncMemcached::set(Context *c,
+                         QByteArrayView key,
+                         const T &value,
+                         std::chrono::seconds expiration,
+                         Callback callback)
+{
+    AsyncMemcached::set(c, key, serialize(value), expiration, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::setByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              const T &value,
+                              std::chrono::seconds expiration,
+                              Callback callback)
+{
+    AsyncMemcached::setByKey(c, groupKey, key, serialize(value), expiration, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::add(Context *c,
+                         QByteArrayView key,
+                         const T &value,
+                         std::chrono::seconds expiration,
+                         Callback callback)
+{
+    AsyncMemcached::add(c, key, serialize(value), expiration, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::addByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              const T &value,
+                              std::chrono::seconds expiration,
+                              Callback callback)
+{
+    AsyncMemcached::addByKey(c, groupKey, key, serialize(value), expiration, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::replace(Context *c,
+                             QByteArrayView key,
+                             const T &value,
+                             std::chrono::seconds expiration,
+                             Callback callback)
+{
+    AsyncMemcached::replace(c, key, serialize(value), expiration, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::replaceByKey(Context *c,
+                                  QByteArrayView groupKey,
+                                  QByteArrayView key,
+                                  const T &value,
+                                  std::chrono::seconds expiration,
+                                  Callback callback)
+{
+    AsyncMemcached::replaceByKey(
+        c, groupKey, key, serialize(value), expiration, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::cas(Context *c,
+                         QByteArrayView key,
+                         const T &value,
+                         std::chrono::seconds expiration,
+                         uint64_t cas,
+                         Callback callback)
+{
+    AsyncMemcached::cas(c, key, serialize(value), expiration, cas, std::move(callback));
+}
+
+template <typename T>
+void AsyncMemcached::casByKey(Context *c,
+                              QByteArrayView groupKey,
+                              QByteArrayView key,
+                              const T &value,
+                              std::chrono::seconds expiration,
+                              uint64_t cas,
+                              Callback callback)
+{
+    AsyncMemcached::casByKey(
+        c, groupKey, key, serialize(value), expiration, cas, std::move(callback));
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coSet(Context *c,
+                                       QByteArrayView key,
+                                       const T &value,
+                                       std::chrono::seconds expiration)
+{
+    return AsyncMemcached::coSet(c, key, serialize(value), expiration);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coSetByKey(Context *c,
+                                            QByteArrayView groupKey,
+                                            QByteArrayView key,
+                                            const T &value,
+                                            std::chrono::seconds expiration)
+{
+    return AsyncMemcached::coSetByKey(c, groupKey, key, serialize(value), expiration);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coAdd(Context *c,
+                                       QByteArrayView key,
+                                       const T &value,
+                                       std::chrono::seconds expiration)
+{
+    return AsyncMemcached::coAdd(c, key, serialize(value), expiration);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coAddByKey(Context *c,
+                                            QByteArrayView groupKey,
+                                            QByteArrayView key,
+                                            const T &value,
+                                            std::chrono::seconds expiration)
+{
+    return AsyncMemcached::coAddByKey(c, groupKey, key, serialize(value), expiration);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coReplace(Context *c,
+                                           QByteArrayView key,
+                                           const T &value,
+                                           std::chrono::seconds expiration)
+{
+    return AsyncMemcached::coReplace(c, key, serialize(value), expiration);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coReplaceByKey(Context *c,
+                                                QByteArrayView groupKey,
+                                                QByteArrayView key,
+                                                const T &value,
+                                                std::chrono::seconds expiration)
+{
+    return AsyncMemcached::coReplaceByKey(c, groupKey, key, serialize(value), expiration);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coCas(Context *c,
+                                       QByteArrayView key,
+                                       const T &value,
+                                       std::chrono::seconds expiration,
+                                       uint64_t cas)
+{
+    return AsyncMemcached::coCas(c, key, serialize(value), expiration, cas);
+}
+
+template <typename T>
+AwaitedMemcached AsyncMemcached::coCasByKey(Context *c,
+                                            QByteArrayView groupKey,
+                                            QByteArrayView key,
+                                            const T &value,
+                                            std::chrono::seconds expiration,
+                                            uint64_t cas)
+{
+    return AsyncMemcached::coCasByKey(c, groupKey, key, serialize(value), expiration, cas);
+}
+
+} // namespace Cutelyst
@@ -9,8 +9,25 @@
 #include <Cutelyst/Context>
 #include <Cutelyst/Engine>
 
+#include <QCborValue>
 #include <QLoggingCategory>
+#include <QMutex>
 #include <QStringList>
+#include <QUrl>
+#include <QUuid>
+#include <QtEndian>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#ifdef CUTELYST_MEMCACHED_WITH_ZSTD
+#    include <zstd.h>
+#endif
+
+#ifdef CUTELYST_MEMCACHED_WITH_LZ4
+#    include <lz4.h>
+#endif
 
 Q_LOGGING_CATEGORY(C_MEMCACHED, "cutelyst.plugin.memcached", QtWarningMsg)
 
@@ -19,6 +36,9 @@ using namespace Qt::Literals::StringLiterals;
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 static thread_local Memcached *mcd = nullptr;
+// Shared by the workers of a process when near_cache is set to process
+static QBasicMutex processNearCacheMutex;
+static std::weak_ptr<MemcachedNearCache> processNearCache;
 const time_t Memcached::expirationNotAdd{static_cast<time_t>(MEMCACHED_EXPIRATION_NOT_ADD)};
 const std::chrono::seconds Memcached::expirationNotAddDuration{
     static_cast<std::chrono::seconds::rep>(MEMCACHED_EXPIRATION_NOT_ADD)};
@@ -43,6 +63,29 @@ void Memcached::setDefaultConfig(const QVariantMap &defaultConfig)
     d->defaultConfig = defaultConfig;
 }
 
+void Memcached::addNearCachePolicy(const QByteArray &prefix,
+                                   std::chrono::milliseconds ttl,
+                                   const QByteArray &versionKey)
+{
+    Q_D(Memcached);
+    d->nearPolicies.push_back({prefix, ttl, versionKey});
+}
+
+Memcached::NearCacheStats Memcached::nearCacheStats()
+{
+    if (mcd && mcd->d_ptr->nearCache) {
+        return mcd->d_ptr->nearCache->stats();
+    }
+    return {};
+}
+
+void Memcached::resetNearCacheStats()
+{
+    if (mcd && mcd->d_ptr->nearCache) {
+        mcd->d_ptr->nearCache->resetStats();
+    }
+}
+
 bool Memcached::setup(Application *app)
 {
     Q_D(Memcached);
@@ -199,14 +242,37 @@ bool Memcached::setup(Application *app)
         d->compressionThreshold =
             d->config(u"compression_threshold"_s, MemcachedPrivate::defaultCompressionThreshold)
                 .toInt();
+        const QString algorithm = d->config(u"compression_algorithm"_s, u"zlib"_s).toString();
+        if (algorithm == "zstd"_L1) {
+#ifdef CUTELYST_MEMCACHED_WITH_ZSTD
+            d->compressionAlgorithm = MemcachedPrivate::Zstd;
+#else
+            qCWarning(C_MEMCACHED) << "Zstandard compression not available, using zlib";
+#endif
+        } else if (algorithm == "lz4"_L1) {
+#ifdef CUTELYST_MEMCACHED_WITH_LZ4
+            d->compressionAlgorithm = MemcachedPrivate::Lz4;
+#else
+            qCWarning(C_MEMCACHED) << "LZ4 compression not available, using zlib";
+#endif
+        } else if (algorithm != "zlib"_L1) {
+            qCWarning(C_MEMCACHED) << "Invalid compression_algorithm value:" << algorithm;
+        }
         if (d->compression) {
             qCInfo(C_MEMCACHED).nospace()
-                << "Compression: enabled (Compression level: " << d->compressionLevel
+                << "Compression: enabled (Compression algorithm: " << algorithm
+                << ", Compression level: " << d->compressionLevel
                 << ", Compression threshold: " << d->compressionThreshold << " bytes";
         } else {
             qCInfo(C_MEMCACHED) << "Compression: disabled";
         }
 
+        const QString codec = d->config(u"codec"_s, u"datastream"_s).toString();
+        d->cborCodec        = codec == "cbor"_L1;
+        if (!d->cborCodec && codec != "datastream"_L1) {
+            qCWarning(C_MEMCACHED) << "Invalid codec value:" << codec;
+        }
+
         const QString encKey = d->config(u"encryption_key"_s).toString();
         if (!encKey.isEmpty()) {
             const QByteArray encKeyBa = encKey.toUtf8();
@@ -242,11 +308,74 @@ bool Memcached::setup(Application *app)
 #    endif
 #endif
 
-        if (d->memc) {
-            memcached_free(d->memc);
+        d->asyncPool = std::make_unique<MemcachedPool>(
+            new_memc,
+            d->config(u"async_connections"_s, MemcachedPrivate::defaultAsyncConnections).toInt(),
+            std::chrono::milliseconds{
+                d->config(u"async_timeout"_s, qint64(MemcachedPrivate::defaultAsyncTimeout.count()))
+                    .toLongLong()},
+            d->config(u"namespace"_s).toString().toUtf8());
+        d->asyncPool->batchGets = d->config(u"async_batch_gets"_s, true).toBool();
+
+        const QString nearCache = d->config(u"near_cache"_s, u"disabled"_s).toString();
+        if (nearCache == "worker"_L1 || nearCache == "process"_L1) {
+            const std::chrono::milliseconds nearCacheTtl{
+                d->config(u"near_cache_ttl"_s,
+                          qint64(MemcachedPrivate::defaultNearCacheTtl.count()))
+                    .toLongLong()};
+            std::vector<MemcachedNearCache::Policy> policies = d->nearPolicies;
+            const QStringList prefixes =
+                d->config(u"near_cache_prefixes"_s).toString().split(u',', Qt::SkipEmptyParts);
+            for (const QString &prefix : prefixes) {
+                policies.push_back({prefix.trimmed().toUtf8(), nearCacheTtl, {}});
+            }
+
+            const qsizetype nearCacheSize =
+                d->config(u"near_cache_size"_s, qint64(MemcachedPrivate::defaultNearCacheSize))
+                    .toLongLong();
+            if (nearCache == "process"_L1) {
+                QMutexLocker locker(&processNearCacheMutex);
+                d->nearCache = processNearCache.lock();
+                if (!d->nearCache) {
+                    d->nearCache     = std::make_shared<MemcachedNearCache>(nearCacheSize);
+                    processNearCache = d->nearCache;
+                }
+            } else {
+                d->nearCache = std::make_shared<MemcachedNearCache>(nearCacheSize);
+            }
+
+            d->nearCache->setPolicies(std::move(policies));
+            d->nearCache->setVersionInterval(std::chrono::milliseconds{
+                d->config(u"near_cache_version_interval"_s,
+                          qint64(MemcachedPrivate::defaultNearCacheVersionInterval.count()))
+                    .toLongLong()});
+            qCInfo(C_MEMCACHED) << "Near cache:" << nearCache;
+        } else if (nearCache != "disabled"_L1) {
+            qCWarning(C_MEMCACHED) << "Invalid near_cache value:" << nearCache;
+        }
+
+        memcached_st *new_pipelineMemc = nullptr;
+        if (!useUDP) {
+            // Set once before connecting, changing BUFFER_REQUESTS later reconnects
+            new_pipelineMemc = memcached_clone(nullptr, new_memc);
+            if (new_pipelineMemc) {
+                memcached_behavior_set(new_pipelineMemc, MEMCACHED_BEHAVIOR_NOREPLY, 1);
+                memcached_behavior_set(new_pipelineMemc, MEMCACHED_BEHAVIOR_BUFFER_REQUESTS, 1);
+                if (!encKey.isEmpty()) {
+                    const QByteArray encKeyBa = encKey.toUtf8();
+                    memcached_set_encoding_key(
+                        new_pipelineMemc, encKeyBa.constData(), encKeyBa.size());
+                }
+            } else {
+                qCWarning(C_MEMCACHED) << "Failed to create the connection used by mset/mremove";
+            }
         }
-        d->memc = new_memc;
-        ok      = true;
+
+        d->freeMemc(d->memc);
+        d->freeMemc(d->pipelineMemc);
+        d->memc         = new_memc;
+        d->pipelineMemc = new_pipelineMemc;
+        ok              = true;
     }
 
     if (ok) {
@@ -259,36 +388,90 @@ bool Memcached::setup(Application *app)
     return ok;
 }
 
-bool Memcached::set(QByteArrayView key,
-                    const QByteArray &value,
-                    time_t expiration,
-                    ReturnType *returnType)
+namespace {
+
+// Returns the current value of a version key, reading it from the servers at most once per
+// near_cache_version_interval
+QByteArray nearVersion(MemcachedNearCache *cache, const QByteArray &versionKey)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
+    if (auto version = cache->version(versionKey)) {
+        return *version;
     }
 
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
+    size_t size = 0;
+    uint32_t flags{0};
+    memcached_return_t rt{MEMCACHED_FAILURE};
+    char *value = memcached_get(
+        mcd->d_ptr->memc, versionKey.constData(), versionKey.size(), &size, &flags, &rt);
+
+    QByteArray version;
+    if (value) {
+        version = QByteArray(value, static_cast<QByteArray::size_type>(size));
+        free(value);
+    } else if (rt != MEMCACHED_NOTFOUND) {
+        qCWarning(C_MEMCACHED).nospace() << "Failed to get version key " << versionKey << ": "
+                                         << memcached_strerror(mcd->d_ptr->memc, rt);
+    }
 
-    const memcached_return_t rt = memcached_set(mcd->d_ptr->memc,
-                                                key.constData(),
-                                                key.size(),
-                                                _value.constData(),
-                                                _value.size(),
-                                                expiration,
-                                                flags);
+    cache->setVersion(versionKey, version);
+    return version;
+}
 
-    const bool ok = memcached_success(rt);
+// Serves a read from the near cache when the key has a policy, keeping what the servers return
+class NearRead
+{
+public:
+    NearRead(QByteArrayView groupKey, QByteArrayView key, const uint64_t *cas)
+        : m_key(key)
+        , m_cache(mcd->d_ptr->nearCache.get())
+    {
+        // The CAS value of a cached item might be outdated, and the same key can have
+        // different values on the servers selected by different group keys
+        if (!m_cache || cas || !groupKey.isEmpty()) {
+            return;
+        }
 
-    if (!ok) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to store key " << key << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
+        m_policy = m_cache->policy(key);
+        if (m_policy && !m_policy->versionKey.isEmpty()) {
+            m_version = nearVersion(m_cache, m_policy->versionKey);
+        }
     }
 
-    MemcachedPrivate::setReturnType(returnType, rt);
+    [[nodiscard]] std::optional<MemcachedNearCache::Value> cached() const
+    {
+        if (!m_policy) {
+            return {};
+        }
+        return m_cache->get(m_key, m_version);
+    }
 
-    return ok;
+    void finish(bool hit, const QByteArray &value, quint32 codec) const
+    {
+        if (!m_cache) {
+            return;
+        }
+
+        m_cache->recordMemcached(hit);
+        if (hit && m_policy) {
+            m_cache->insert(m_key, {value, codec}, m_version, m_policy->ttl);
+        }
+    }
+
+private:
+    QByteArrayView m_key;
+    MemcachedNearCache *m_cache;
+    std::optional<MemcachedNearCache::Policy> m_policy;
+    QByteArray m_version;
+};
+
+} // namespace
+
+bool Memcached::set(QByteArrayView key,
+                    const QByteArray &value,
+                    time_t expiration,
+                    ReturnType *returnType)
+{
+    return storeEncoded(StoreMode::Set, {}, key, value, 0, expiration, 0, returnType);
 }
 
 bool Memcached::setByKey(QByteArrayView groupKey,
@@ -297,34 +480,7 @@ bool Memcached::setByKey(QByteArrayView groupKey,
                          time_t expiration,
                          ReturnType *returnType)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
-    }
-
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
-
-    const memcached_return_t rt = memcached_set_by_key(mcd->d_ptr->memc,
-                                                       groupKey.constData(),
-                                                       groupKey.size(),
-                                                       key.constData(),
-                                                       key.size(),
-                                                       _value.constData(),
-                                                       _value.size(),
-                                                       expiration,
-                                                       flags);
-
-    const bool ok = memcached_success(rt);
-
-    if (!ok) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to store key " << key << " on group " << groupKey << ": "
-            << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ok;
+    return storeEncoded(StoreMode::Set, groupKey, key, value, 0, expiration, 0, returnType);
 }
 
 bool Memcached::add(QByteArrayView key,
@@ -332,31 +488,7 @@ bool Memcached::add(QByteArrayView key,
                     time_t expiration,
                     ReturnType *returnType)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
-    }
-
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
-
-    const memcached_return_t rt = memcached_add(mcd->d_ptr->memc,
-                                                key.constData(),
-                                                key.size(),
-                                                _value.constData(),
-                                                _value.size(),
-                                                expiration,
-                                                flags);
-
-    const bool ok = memcached_success(rt);
-
-    if (!ok && (rt != MEMCACHED_NOTSTORED)) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to add key " << key << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ok;
+    return storeEncoded(StoreMode::Add, {}, key, value, 0, expiration, 0, returnType);
 }
 
 bool Memcached::addByKey(QByteArrayView groupKey,
@@ -365,33 +497,7 @@ bool Memcached::addByKey(QByteArrayView groupKey,
                          time_t expiration,
                          ReturnType *returnType)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
-    }
-
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
-
-    const memcached_return_t rt = memcached_add_by_key(mcd->d_ptr->memc,
-                                                       groupKey.constData(),
-                                                       groupKey.size(),
-                                                       key.constData(),
-                                                       key.size(),
-                                                       _value.constData(),
-                                                       _value.size(),
-                                                       expiration,
-                                                       flags);
-
-    const bool ok = memcached_success(rt);
-
-    if (!ok && (rt != MEMCACHED_NOTSTORED)) {
-        qCWarning(C_MEMCACHED).nospace() << "Failed to add key " << key << " on group " << groupKey
-                                         << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ok;
+    return storeEncoded(StoreMode::Add, groupKey, key, value, 0, expiration, 0, returnType);
 }
 
 bool Memcached::replace(QByteArrayView key,
@@ -399,31 +505,7 @@ bool Memcached::replace(QByteArrayView key,
                         time_t expiration,
                         ReturnType *returnType)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
-    }
-
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
-
-    const memcached_return_t rt = memcached_replace(mcd->d_ptr->memc,
-                                                    key.constData(),
-                                                    key.size(),
-                                                    _value.constData(),
-                                                    _value.size(),
-                                                    expiration,
-                                                    flags);
-
-    const bool ok = memcached_success(rt);
-
-    if (!ok && (rt != MEMCACHED_NOTSTORED)) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to replace key " << key << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ok;
+    return storeEncoded(StoreMode::Replace, {}, key, value, 0, expiration, 0, returnType);
 }
 
 bool Memcached::replaceByKey(QByteArrayView groupKey,
@@ -432,85 +514,27 @@ bool Memcached::replaceByKey(QByteArrayView groupKey,
                              time_t expiration,
                              ReturnType *returnType)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
-    }
-
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
-
-    const memcached_return_t rt = memcached_replace_by_key(mcd->d_ptr->memc,
-                                                           groupKey.constData(),
-                                                           groupKey.size(),
-                                                           key.constData(),
-                                                           key.size(),
-                                                           _value.constData(),
-                                                           _value.size(),
-                                                           expiration,
-                                                           flags);
-
-    const bool ok = memcached_success(rt);
-
-    if (!ok && (rt != MEMCACHED_NOTSTORED)) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to replace key " << key << " on group " << groupKey << ": "
-            << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ok;
+    return storeEncoded(StoreMode::Replace, groupKey, key, value, 0, expiration, 0, returnType);
 }
 
 QByteArray Memcached::get(QByteArrayView key, uint64_t *cas, ReturnType *returnType)
 {
-    QByteArray retData;
-
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return retData;
-    }
-
-    memcached_return_t rt{MEMCACHED_FAILURE};
-    bool ok = false;
-
-    std::vector<const char *> keys;
-    std::vector<size_t> sizes;
-    keys.emplace_back(key.constData());
-    sizes.emplace_back(key.size());
-    rt = memcached_mget(mcd->d_ptr->memc, &keys[0], &sizes[0], keys.size());
-
-    if (memcached_success(rt)) {
-        memcached_result_st *result = memcached_fetch_result(mcd->d_ptr->memc, nullptr, &rt);
-        if (result) {
-            retData =
-                QByteArray(memcached_result_value(result),
-                           static_cast<QByteArray::size_type>(memcached_result_length(result)));
-            if (cas) {
-                *cas = memcached_result_cas(result);
-            }
-            retData = MemcachedPrivate::uncompressIfNeeded(retData, result);
-            ok      = true;
-            // fetch another result even if there is no one to get
-            // a NULL for the internal of libmemcached
-            memcached_fetch_result(mcd->d_ptr->memc, nullptr, nullptr);
-        }
-        memcached_result_free(result);
-    }
-
-    if (!ok && (rt != MEMCACHED_NOTFOUND)) {
-        qCWarning(C_MEMCACHED).nospace() << "Failed to get data for key " << key << ": "
-                                         << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return retData;
+    return Memcached::getEncoded({}, key, cas, nullptr, returnType);
 }
 
 QByteArray Memcached::getByKey(QByteArrayView groupKey,
                                QByteArrayView key,
                                uint64_t *cas,
                                ReturnType *returnType)
+{
+    return Memcached::getEncoded(groupKey, key, cas, nullptr, returnType);
+}
+
+QByteArray Memcached::getEncoded(QByteArrayView groupKey,
+                                 QByteArrayView key,
+                                 uint64_t *cas,
+                                 quint32 *codec,
+                                 ReturnType *returnType)
 {
     QByteArray retData;
 
@@ -518,14 +542,24 @@ QByteArray Memcached::getByKey(QByteArrayView groupKey,
         return retData;
     }
 
-    bool ok = false;
+    NearRead near(groupKey, key, cas);
+    if (auto cached = near.cached()) {
+        if (codec) {
+            *codec = cached->codec;
+        }
+        MemcachedPrivate::setReturnType(returnType, MEMCACHED_SUCCESS);
+        return cached->data;
+    }
+
+    bool ok           = false;
+    quint32 dataCodec = 0;
 
-    std::vector<const char *> keys;
-    std::vector<size_t> sizes;
-    keys.emplace_back(key.constData());
-    sizes.emplace_back(key.size());
-    memcached_return_t rt = memcached_mget_by_key(
-        mcd->d_ptr->memc, groupKey.constData(), groupKey.size(), &keys[0], &sizes[0], keys.size());
+    // Without a group key the server is selected by the key itself
+    const QByteArrayView group = groupKey.isEmpty() ? key : groupKey;
+    const char *keys[]         = {key.constData()};
+    const size_t sizes[]       = {size_t(key.size())};
+    memcached_return_t rt      = memcached_mget_by_key(
+        mcd->d_ptr->memc, group.constData(), group.size(), keys, sizes, 1);
 
     if (memcached_success(rt)) {
         memcached_result_st *result = memcached_fetch_result(mcd->d_ptr->memc, nullptr, &rt);
@@ -536,8 +570,9 @@ QByteArray Memcached::getByKey(QByteArrayView groupKey,
             if (cas) {
                 *cas = memcached_result_cas(result);
             }
-            retData = MemcachedPrivate::uncompressIfNeeded(retData, result);
-            ok      = true;
+            retData   = MemcachedPrivate::uncompressIfNeeded(retData, result);
+            dataCodec = memcached_result_flags(result) & Memcached::codecMask;
+            ok        = true;
             // fetch another result even if there is no one to get
             // a NULL for the internal of libmemcached
             memcached_fetch_result(mcd->d_ptr->memc, nullptr, nullptr);
@@ -546,9 +581,19 @@ QByteArray Memcached::getByKey(QByteArrayView groupKey,
     }
 
     if (!ok && (rt != MEMCACHED_NOTFOUND)) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to get data for key " << key << " on group " << groupKey << ": "
-            << memcached_strerror(mcd->d_ptr->memc, rt);
+        if (groupKey.isEmpty()) {
+            qCWarning(C_MEMCACHED).nospace() << "Failed to get data for key " << key << ": "
+                                             << memcached_strerror(mcd->d_ptr->memc, rt);
+        } else {
+            qCWarning(C_MEMCACHED).nospace()
+                << "Failed to get data for key " << key << " on group " << groupKey << ": "
+                << memcached_strerror(mcd->d_ptr->memc, rt);
+        }
+    }
+
+    near.finish(ok, retData, dataCodec);
+    if (codec) {
+        *codec = dataCodec;
     }
 
     MemcachedPrivate::setReturnType(returnType, rt);
@@ -572,6 +617,8 @@ bool Memcached::remove(QByteArrayView key, ReturnType *returnType)
                                          << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -594,6 +641,8 @@ bool Memcached::removeByKey(QByteArrayView groupKey, QByteArrayView key, ReturnT
             << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -660,6 +709,8 @@ bool Memcached::increment(QByteArrayView key,
                                          << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -691,6 +742,8 @@ bool Memcached::incrementByKey(QByteArrayView groupKey,
             << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -718,6 +771,8 @@ bool Memcached::incrementWithInitial(QByteArrayView key,
             << " or initial " << initial << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -753,6 +808,8 @@ bool Memcached::incrementWithInitialByKey(QByteArrayView groupKey,
             << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -777,6 +834,8 @@ bool Memcached::decrement(QByteArrayView key,
                                          << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -808,6 +867,8 @@ bool Memcached::decrementByKey(QByteArrayView groupKey,
             << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -835,6 +896,8 @@ bool Memcached::decrementWithInitial(QByteArrayView key,
             << " or initialize " << initial << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -870,6 +933,8 @@ bool Memcached::decrementWithInitialByKey(QByteArrayView groupKey,
             << memcached_strerror(mcd->d_ptr->memc, rt);
     }
 
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
@@ -881,32 +946,7 @@ bool Memcached::cas(QByteArrayView key,
                     uint64_t cas,
                     ReturnType *returnType)
 {
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return false;
-    }
-
-    MemcachedPrivate::Flags flags;
-    const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
-
-    const memcached_return_t rt = memcached_cas(mcd->d_ptr->memc,
-                                                key.constData(),
-                                                key.size(),
-                                                _value.constData(),
-                                                _value.size(),
-                                                expiration,
-                                                flags,
-                                                cas);
-
-    const bool ok = memcached_success(rt);
-
-    if (!ok && (rt != MEMCACHED_DATA_EXISTS)) {
-        qCWarning(C_MEMCACHED).nospace() << "Failed to compare and set (cas) key " << key << ": "
-                                         << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ok;
+    return storeEncoded(StoreMode::Cas, {}, key, value, 0, expiration, cas, returnType);
 }
 
 bool Memcached::casByKey(QByteArrayView groupKey,
@@ -915,38 +955,164 @@ bool Memcached::casByKey(QByteArrayView groupKey,
                          time_t expiration,
                          uint64_t cas,
                          ReturnType *returnType)
+{
+    return storeEncoded(StoreMode::Cas, groupKey, key, value, 0, expiration, cas, returnType);
+}
+
+bool Memcached::storeEncoded(StoreMode mode,
+                             QByteArrayView groupKey,
+                             QByteArrayView key,
+                             const QByteArray &value,
+                             quint32 codec,
+                             time_t expiration,
+                             uint64_t cas,
+                             ReturnType *returnType)
 {
     if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
         return false;
     }
 
-    MemcachedPrivate::Flags flags;
+    MemcachedPrivate::Flags flags{codec};
     const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
 
-    const memcached_return_t rt = memcached_cas_by_key(mcd->d_ptr->memc,
-                                                       groupKey.constData(),
-                                                       groupKey.size(),
-                                                       key.constData(),
-                                                       key.size(),
-                                                       _value.constData(),
-                                                       _value.size(),
-                                                       expiration,
-                                                       flags,
-                                                       cas);
+    // Without a group key the server is selected by the key itself
+    const QByteArrayView group = groupKey.isEmpty() ? key : groupKey;
+    memcached_return_t rt{MEMCACHED_FAILURE};
+    switch (mode) {
+    case StoreMode::Set:
+        rt = memcached_set_by_key(mcd->d_ptr->memc,
+                                  group.constData(),
+                                  group.size(),
+                                  key.constData(),
+                                  key.size(),
+                                  _value.constData(),
+                                  _value.size(),
+                                  expiration,
+                                  flags);
+        break;
+    case StoreMode::Add:
+        rt = memcached_add_by_key(mcd->d_ptr->memc,
+                                  group.constData(),
+                                  group.size(),
+                                  key.constData(),
+                                  key.size(),
+                                  _value.constData(),
+                                  _value.size(),
+                                  expiration,
+                                  flags);
+        break;
+    case StoreMode::Replace:
+        rt = memcached_replace_by_key(mcd->d_ptr->memc,
+                                      group.constData(),
+                                      group.size(),
+                                      key.constData(),
+                                      key.size(),
+                                      _value.constData(),
+                                      _value.size(),
+                                      expiration,
+                                      flags);
+        break;
+    case StoreMode::Cas:
+        rt = memcached_cas_by_key(mcd->d_ptr->memc,
+                                  group.constData(),
+                                  group.size(),
+                                  key.constData(),
+                                  key.size(),
+                                  _value.constData(),
+                                  _value.size(),
+                                  expiration,
+                                  flags,
+                                  cas);
+        break;
+    }
 
     const bool ok = memcached_success(rt);
 
-    if (!ok && (rt != MEMCACHED_DATA_EXISTS)) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to compare and set (cas) key " << key << " in group " << groupKey << ": "
-            << memcached_strerror(mcd->d_ptr->memc, rt);
+    static constexpr std::array actions{
+        "store"_L1, "add"_L1, "replace"_L1, "compare and set (cas)"_L1};
+    // Not storing because of the add/replace/cas condition is an expected outcome
+    const bool expected = (mode == StoreMode::Cas && rt == MEMCACHED_DATA_EXISTS) ||
+                          (mode != StoreMode::Set && rt == MEMCACHED_NOTSTORED);
+    if (!ok && !expected) {
+        if (groupKey.isEmpty()) {
+            qCWarning(C_MEMCACHED).nospace()
+                << "Failed to " << actions[int(mode)] << " key " << key << ": "
+                << memcached_strerror(mcd->d_ptr->memc, rt);
+        } else {
+            qCWarning(C_MEMCACHED).nospace()
+                << "Failed to " << actions[int(mode)] << " key " << key << " on group "
+                << groupKey << ": " << memcached_strerror(mcd->d_ptr->memc, rt);
+        }
     }
 
+    // After the write, so a concurrent read can not cache the previous value
+    MemcachedPrivate::invalidateNear(key);
+
     MemcachedPrivate::setReturnType(returnType, rt);
 
     return ok;
 }
 
+bool Memcached::cborCodec()
+{
+    return mcd && mcd->d_ptr->cborCodec;
+}
+
+namespace {
+
+// Types that survive a round trip through QCborValue, up to integer and map types
+bool cborRepresentable(const QVariant &value)
+{
+    switch (value.typeId()) {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::QString:
+    case QMetaType::QByteArray:
+    case QMetaType::QDateTime:
+    case QMetaType::QUrl:
+    case QMetaType::QUuid:
+    case QMetaType::QStringList:
+        return true;
+    case QMetaType::ULongLong:
+        return value.toULongLong() <= quint64(std::numeric_limits<qint64>::max());
+    case QMetaType::QVariantList:
+        return std::ranges::all_of(value.toList(), cborRepresentable);
+    case QMetaType::QVariantMap:
+        return std::ranges::all_of(value.toMap(), cborRepresentable);
+    case QMetaType::QVariantHash:
+        return std::ranges::all_of(value.toHash(), cborRepresentable);
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+QByteArray Memcached::encodeCbor(const QVariant &value)
+{
+    if (!cborRepresentable(value)) {
+        return {};
+    }
+    return QCborValue::fromVariant(value).toCbor();
+}
+
+QVariant Memcached::decodeCbor(const QByteArray &data)
+{
+    QCborParserError error;
+    const QCborValue value = QCborValue::fromCbor(data, &error);
+    if (error.error != QCborError::NoError) {
+        qCWarning(C_MEMCACHED) << "Failed to decode CBOR value:" << error.errorString();
+        return {};
+    }
+    return value.toVariant();
+}
+
 bool Memcached::flushBuffers(ReturnType *returnType)
 {
     if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
@@ -974,6 +1140,7 @@ bool Memcached::flush(time_t expiration, ReturnType *returnType)
     }
 
     const memcached_return_t rt = memcached_flush(mcd->d_ptr->memc, expiration);
+    MemcachedPrivate::clearNear();
 
     const bool ok = memcached_success(rt);
 
@@ -991,6 +1158,32 @@ QHash<QByteArray, QByteArray> Memcached::mget(const QByteArrayList &keys,
                                               QHash<QByteArray, uint64_t> *casValues,
                                               ReturnType *returnType)
 {
+    return Memcached::mgetEncoded(std::nullopt, keys, casValues, nullptr, returnType);
+}
+
+QHash<QByteArray, QByteArray> Memcached::mgetByKey(QByteArrayView groupKey,
+                                                   const QByteArrayList &keys,
+                                                   QHash<QByteArray, uint64_t> *casValues,
+                                                   ReturnType *returnType)
+{
+    return Memcached::mgetEncoded(groupKey, keys, casValues, nullptr, returnType);
+}
+
+QHash<QByteArray, QByteArray> Memcached::mgetEncoded(std::optional<QByteArrayView> groupKey,
+                                                     const QByteArrayList &keys,
+                                                     QHash<QByteArray, uint64_t> *casValues,
+                                                     QHash<QByteArray, quint32> *codecs,
+                                                     ReturnType *returnType)
+{
+    if (groupKey && groupKey->isEmpty()) {
+        qCWarning(C_MEMCACHED)
+            << "Can not get multiple values from specific server when groupKey is empty.";
+        if (returnType) {
+            *returnType = ReturnType::BadKeyProvided;
+        }
+        return {};
+    }
+
     QHash<QByteArray, QByteArray> ret;
 
     if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
@@ -1017,8 +1210,11 @@ QHash<QByteArray, QByteArray> Memcached::mget(const QByteArrayList &keys,
 
     bool ok = false;
 
-    memcached_return_t rt =
-        memcached_mget(mcd->d_ptr->memc, &_keys[0], &_keysSizes[0], _keys.size());
+    // Without a group key every key selects its own server
+    const QByteArrayView group = groupKey.value_or(QByteArrayView{});
+    const char *groupData      = group.isEmpty() ? nullptr : group.constData();
+    memcached_return_t rt      = memcached_mget_by_key(
+        mcd->d_ptr->memc, groupData, group.size(), &_keys[0], &_keysSizes[0], _keys.size());
 
     if (memcached_success(rt)) {
         ok = true;
@@ -1034,6 +1230,9 @@ QHash<QByteArray, QByteArray> Memcached::mget(const QByteArrayList &keys,
                 if (casValues) {
                     casValues->insert(rk, memcached_result_cas(result));
                 }
+                if (codecs) {
+                    codecs->insert(rk, memcached_result_flags(result) & Memcached::codecMask);
+                }
                 rd = MemcachedPrivate::uncompressIfNeeded(rd, result);
                 ret.insert(rk, rd);
             }
@@ -1042,8 +1241,14 @@ QHash<QByteArray, QByteArray> Memcached::mget(const QByteArrayList &keys,
     }
 
     if (!ok) {
-        qCWarning(C_MEMCACHED) << "Failed to get values for multiple keys:"
-                               << memcached_strerror(mcd->d_ptr->memc, rt);
+        if (group.isEmpty()) {
+            qCWarning(C_MEMCACHED) << "Failed to get values for multiple keys:"
+                                   << memcached_strerror(mcd->d_ptr->memc, rt);
+        } else {
+            qCWarning(C_MEMCACHED).nospace()
+                << "Failed to get values for multiple keys in group " << group << ": "
+                << memcached_strerror(mcd->d_ptr->memc, rt);
+        }
     }
 
     MemcachedPrivate::setReturnType(returnType, rt);
@@ -1051,83 +1256,59 @@ QHash<QByteArray, QByteArray> Memcached::mget(const QByteArrayList &keys,
     return ret;
 }
 
-QHash<QByteArray, QByteArray> Memcached::mgetByKey(QByteArrayView groupKey,
-                                                   const QByteArrayList &keys,
-                                                   QHash<QByteArray, uint64_t> *casValues,
-                                                   ReturnType *returnType)
+bool Memcached::mset(const QHash<QByteArray, QByteArray> &values,
+                     time_t expiration,
+                     ReturnType *returnType)
 {
-    QHash<QByteArray, QByteArray> ret;
+    return Memcached::msetEncoded(std::nullopt, values, nullptr, expiration, returnType);
+}
 
-    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
-        return ret;
-    }
+bool Memcached::msetByKey(QByteArrayView groupKey,
+                          const QHash<QByteArray, QByteArray> &values,
+                          time_t expiration,
+                          ReturnType *returnType)
+{
+    return Memcached::msetEncoded(groupKey, values, nullptr, expiration, returnType);
+}
 
-    if (groupKey.isEmpty()) {
+bool Memcached::msetEncoded(std::optional<QByteArrayView> groupKey,
+                            const QHash<QByteArray, QByteArray> &values,
+                            const QHash<QByteArray, quint32> *codecs,
+                            time_t expiration,
+                            ReturnType *returnType)
+{
+    if (groupKey && groupKey->isEmpty()) {
         qCWarning(C_MEMCACHED)
-            << "Can not get multiple values from specific server when groupKey is empty.";
+            << "Can not set multiple values on specific server when groupKey is empty.";
         if (returnType) {
             *returnType = ReturnType::BadKeyProvided;
         }
-        return ret;
-    }
-
-    if (keys.empty()) {
-        qCWarning(C_MEMCACHED) << "Can not get multiple values without a list of keys.";
-        if (returnType) {
-            *returnType = ReturnType::BadKeyProvided;
-        }
-        return ret;
-    }
-
-    std::vector<const char *> _keys;
-    _keys.reserve(keys.size());
-    std::vector<size_t> _keysSizes;
-    _keysSizes.reserve(keys.size());
-
-    for (const auto &key : keys) {
-        _keys.emplace_back(key.data());
-        _keysSizes.emplace_back(key.size());
+        return false;
     }
 
-    bool ok = false;
+    return MemcachedPrivate::storeMulti(
+        groupKey.value_or(QByteArrayView{}), values, codecs, expiration, returnType);
+}
 
-    memcached_return_t rt = memcached_mget_by_key(mcd->d_ptr->memc,
-                                                  groupKey.constData(),
-                                                  groupKey.size(),
-                                                  &_keys[0],
-                                                  &_keysSizes[0],
-                                                  _keys.size());
+bool Memcached::mremove(const QByteArrayList &keys, ReturnType *returnType)
+{
+    return MemcachedPrivate::removeMulti({}, keys, returnType);
+}
 
-    if (memcached_success(rt)) {
-        ok = true;
-        ret.reserve(keys.size());
-        while ((rt != MEMCACHED_END) && (rt != MEMCACHED_NOTFOUND)) {
-            memcached_result_st *result = memcached_fetch_result(mcd->d_ptr->memc, nullptr, &rt);
-            if (result) {
-                const QByteArray rk =
-                    QByteArray(memcached_result_key_value(result),
-                               static_cast<qsizetype>(memcached_result_key_length(result)));
-                QByteArray rd(memcached_result_value(result),
-                              static_cast<qsizetype>(memcached_result_length(result)));
-                if (casValues) {
-                    casValues->insert(rk, memcached_result_cas(result));
-                }
-                rd = MemcachedPrivate::uncompressIfNeeded(rd, result);
-                ret.insert(rk, rd);
-            }
-            memcached_result_free(result);
+bool Memcached::mremoveByKey(QByteArrayView groupKey,
+                             const QByteArrayList &keys,
+                             ReturnType *returnType)
+{
+    if (groupKey.isEmpty()) {
+        qCWarning(C_MEMCACHED)
+            << "Can not remove multiple values from specific server when groupKey is empty.";
+        if (returnType) {
+            *returnType = ReturnType::BadKeyProvided;
         }
+        return false;
     }
 
-    if (!ok) {
-        qCWarning(C_MEMCACHED).nospace()
-            << "Failed to get values for multiple keys in group " << groupKey << ": "
-            << memcached_strerror(mcd->d_ptr->memc, rt);
-    }
-
-    MemcachedPrivate::setReturnType(returnType, rt);
-
-    return ret;
+    return MemcachedPrivate::removeMulti(groupKey, keys, returnType);
 }
 
 bool Memcached::touch(QByteArrayView key, time_t expiration, ReturnType *returnType)
@@ -1182,6 +1363,63 @@ bool Memcached::touchByKey(QByteArrayView groupKey,
     return ok;
 }
 
+namespace {
+// Stores the loaded value, unless another process stored it meanwhile
+SingleFlight::Loader storingLoader(const QByteArray &key,
+                                   std::chrono::seconds expiration,
+                                   SingleFlight::Loader loader)
+{
+    return [key, expiration, loader = std::move(loader)](SingleFlight::Callback done) {
+        const QByteArray value = Memcached::get(key);
+        if (!value.isNull()) {
+            done({value, {}});
+            return;
+        }
+
+        loader([key, expiration, done](const SingleFlight::Result &result) {
+            if (!result.hasError()) {
+                Memcached::set(key, result.value.toByteArray(), expiration);
+            }
+            done(result);
+        });
+    };
+}
+} // namespace
+
+void Memcached::getOrLoad(Context *c,
+                          QByteArrayView key,
+                          std::chrono::seconds expiration,
+                          SingleFlight::Loader loader,
+                          SingleFlight::Callback callback)
+{
+    const QByteArray value = Memcached::get(key);
+    if (!value.isNull()) {
+        callback({value, {}});
+        return;
+    }
+
+    const QByteArray keyData = key.toByteArray();
+    SingleFlight::run(c,
+                      "cutelyst_memcached_" + keyData,
+                      storingLoader(keyData, expiration, std::move(loader)),
+                      std::move(callback));
+}
+
+AwaitedSingleFlight Memcached::coGetOrLoad(Context *c,
+                                           QByteArrayView key,
+                                           std::chrono::seconds expiration,
+                                           SingleFlight::Loader loader)
+{
+    const QByteArray value = Memcached::get(key);
+    if (!value.isNull()) {
+        return AwaitedSingleFlight{{value, {}}};
+    }
+
+    const QByteArray keyData = key.toByteArray();
+    return SingleFlight::coRun(
+        c, "cutelyst_memcached_" + keyData, storingLoader(keyData, expiration, std::move(loader)));
+}
+
 QString Memcached::errorString(Context *c, ReturnType rt)
 {
     switch (rt) {
@@ -1418,34 +1656,276 @@ bool MemcachedPrivate::isRegistered(const Memcached *ptr, Memcached::ReturnType
     return true;
 }
 
+namespace {
+
+#if defined(CUTELYST_MEMCACHED_WITH_ZSTD) || defined(CUTELYST_MEMCACHED_WITH_LZ4)
+// Guards against allocating huge buffers for corrupted values
+constexpr quint32 maxUncompressedSize = 256 * 1024 * 1024;
+#endif
+
+#ifdef CUTELYST_MEMCACHED_WITH_ZSTD
+QByteArray zstdCompress(const QByteArray &value, int level)
+{
+    QByteArray out(qsizetype(ZSTD_compressBound(value.size())), Qt::Uninitialized);
+    const size_t size = ZSTD_compress(out.data(),
+                                      out.size(),
+                                      value.constData(),
+                                      value.size(),
+                                      level < 0 ? ZSTD_CLEVEL_DEFAULT : level);
+    if (ZSTD_isError(size)) {
+        qCWarning(C_MEMCACHED) << "Failed to compress value:" << ZSTD_getErrorName(size);
+        return {};
+    }
+    out.resize(qsizetype(size));
+    return out;
+}
+
+QByteArray zstdUncompress(const QByteArray &value)
+{
+    const unsigned long long size = ZSTD_getFrameContentSize(value.constData(), value.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        size > maxUncompressedSize) {
+        qCWarning(C_MEMCACHED) << "Failed to uncompress value: invalid Zstandard frame";
+        return {};
+    }
+
+    QByteArray out(qsizetype(size), Qt::Uninitialized);
+    const size_t ret = ZSTD_decompress(out.data(), out.size(), value.constData(), value.size());
+    if (ZSTD_isError(ret)) {
+        qCWarning(C_MEMCACHED) << "Failed to uncompress value:" << ZSTD_getErrorName(ret);
+        return {};
+    }
+    return out;
+}
+#endif
+
+#ifdef CUTELYST_MEMCACHED_WITH_LZ4
+// LZ4 blocks do not store their size, it is prepended like qCompress() does
+QByteArray lz4Compress(const QByteArray &value)
+{
+    const int bound = LZ4_compressBound(int(value.size()));
+    QByteArray out(4 + bound, Qt::Uninitialized);
+    qToBigEndian<quint32>(quint32(value.size()), out.data());
+    const int size =
+        LZ4_compress_default(value.constData(), out.data() + 4, int(value.size()), bound);
+    if (size <= 0) {
+        qCWarning(C_MEMCACHED) << "Failed to compress value with LZ4";
+        return {};
+    }
+    out.resize(4 + size);
+    return out;
+}
+
+QByteArray lz4Uncompress(const QByteArray &value)
+{
+    const quint32 size = value.size() < 4 ? 0 : qFromBigEndian<quint32>(value.constData());
+    if (value.size() < 4 || size > maxUncompressedSize) {
+        qCWarning(C_MEMCACHED) << "Failed to uncompress value: invalid LZ4 block";
+        return {};
+    }
+
+    QByteArray out(qsizetype(size), Qt::Uninitialized);
+    const int ret = LZ4_decompress_safe(
+        value.constData() + 4, out.data(), int(value.size() - 4), int(size));
+    if (ret != int(size)) {
+        qCWarning(C_MEMCACHED) << "Failed to uncompress value with LZ4";
+        return {};
+    }
+    return out;
+}
+#endif
+
+} // namespace
+
 /**
  * @internal
- * Compresses the @a value with @link QByteArray::qCompress() qCompress()@endlink if compression
- * has been enabled. Will also set the correct @a flags.
+ * Compresses the @a value with the configured algorithm if compression has been enabled and
+ * the value is bigger than the threshold. Will also set the correct @a flags.
  */
 QByteArray MemcachedPrivate::compressIfNeeded(const QByteArray &value, Flags &flags)
 {
-    if (mcd->d_ptr->compression && (value.size() > mcd->d_ptr->compressionThreshold)) {
+    if (!mcd->d_ptr->compression || (value.size() <= mcd->d_ptr->compressionThreshold)) {
+        return value;
+    }
+
+    QByteArray compressed;
+    switch (mcd->d_ptr->compressionAlgorithm) {
+#ifdef CUTELYST_MEMCACHED_WITH_ZSTD
+    case MemcachedPrivate::Zstd:
+        compressed = zstdCompress(value, mcd->d_ptr->compressionLevel);
+        break;
+#endif
+#ifdef CUTELYST_MEMCACHED_WITH_LZ4
+    case MemcachedPrivate::Lz4:
+        compressed = lz4Compress(value);
+        break;
+#endif
+    default:
         flags |= MemcachedPrivate::Compressed;
         return qCompress(value, mcd->d_ptr->compressionLevel);
-    } else {
+    }
+
+    if (compressed.isNull()) {
         return value;
     }
+    flags |= mcd->d_ptr->compressionAlgorithm;
+    return compressed;
 }
 
 /**
  * @internal
- * Reads the stored flags from @a result and uncompresses the @a value if needed
- * with @link QByteArray::qUncompress() qUncompress()@endlink and returns it.
+ * Uncompresses the @a value if one of the compression @a flags is set and returns it, values
+ * compressed with an algorithm that is not available are returned as a null QByteArray.
  */
-QByteArray MemcachedPrivate::uncompressIfNeeded(const QByteArray &value,
-                                                memcached_result_st *result)
+QByteArray MemcachedPrivate::uncompress(const QByteArray &value, Flags flags)
 {
-    const MemcachedPrivate::Flags flags{memcached_result_flags(result)};
     if (flags.testFlag(MemcachedPrivate::Compressed)) {
         return qUncompress(value);
-    } else {
-        return value;
+    } else if (flags.testFlag(MemcachedPrivate::Zstd)) {
+#ifdef CUTELYST_MEMCACHED_WITH_ZSTD
+        return zstdUncompress(value);
+#else
+        qCWarning(C_MEMCACHED) << "Can not read value compressed with Zstandard";
+        return {};
+#endif
+    } else if (flags.testFlag(MemcachedPrivate::Lz4)) {
+#ifdef CUTELYST_MEMCACHED_WITH_LZ4
+        return lz4Uncompress(value);
+#else
+        qCWarning(C_MEMCACHED) << "Can not read value compressed with LZ4";
+        return {};
+#endif
+    }
+    return value;
+}
+
+/**
+ * @internal
+ * Reads the stored flags from @a result and uncompresses the @a value if needed.
+ */
+QByteArray MemcachedPrivate::uncompressIfNeeded(const QByteArray &value,
+                                                memcached_result_st *result)
+{
+    return uncompress(value, MemcachedPrivate::Flags{memcached_result_flags(result)});
+}
+
+/**
+ * @internal
+ * Stores all @a values without waiting for replies, on the server selected by @a groupKey or
+ * by each key if it is empty. The optional @a codecs are the codec flags of each value.
+ */
+bool MemcachedPrivate::storeMulti(QByteArrayView groupKey,
+                                  const QHash<QByteArray, QByteArray> &values,
+                                  const QHash<QByteArray, quint32> *codecs,
+                                  time_t expiration,
+                                  Memcached::ReturnType *returnType)
+{
+    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
+        return false;
+    }
+
+    const MemcachedPrivate *d = mcd->d_ptr.get();
+    memcached_st *memc        = d->pipelineMemc ? d->pipelineMemc : d->memc;
+    memcached_return_t rt     = MEMCACHED_SUCCESS;
+    for (const auto &[key, value] : values.asKeyValueRange()) {
+        const QByteArrayView group = groupKey.isEmpty() ? QByteArrayView{key} : groupKey;
+
+        MemcachedPrivate::Flags flags{codecs ? codecs->value(key) : 0};
+        const QByteArray _value = MemcachedPrivate::compressIfNeeded(value, flags);
+
+        const memcached_return_t keyRt = memcached_set_by_key(memc,
+                                                              group.constData(),
+                                                              group.size(),
+                                                              key.constData(),
+                                                              key.size(),
+                                                              _value.constData(),
+                                                              _value.size(),
+                                                              expiration,
+                                                              flags);
+        if (!memcached_success(keyRt)) {
+            qCWarning(C_MEMCACHED).nospace() << "Failed to store key " << key << ": "
+                                             << memcached_strerror(memc, keyRt);
+            rt = keyRt;
+        }
+    }
+
+    const memcached_return_t flushRt = memcached_flush_buffers(memc);
+    if (memcached_success(rt)) {
+        rt = flushRt;
+    }
+
+    for (const QByteArray &key : values.keys()) {
+        MemcachedPrivate::invalidateNear(key);
+    }
+
+    MemcachedPrivate::setReturnType(returnType, rt);
+
+    return memcached_success(rt);
+}
+
+/**
+ * @internal
+ * Removes all @a keys without waiting for replies, from the server selected by @a groupKey or
+ * by each key if it is empty.
+ */
+bool MemcachedPrivate::removeMulti(QByteArrayView groupKey,
+                                   const QByteArrayList &keys,
+                                   Memcached::ReturnType *returnType)
+{
+    if (!MemcachedPrivate::isRegistered(mcd, returnType)) {
+        return false;
+    }
+
+    const MemcachedPrivate *d = mcd->d_ptr.get();
+    memcached_st *memc        = d->pipelineMemc ? d->pipelineMemc : d->memc;
+    memcached_return_t rt     = MEMCACHED_SUCCESS;
+    for (const QByteArray &key : keys) {
+        const QByteArrayView group = groupKey.isEmpty() ? QByteArrayView{key} : groupKey;
+
+        const memcached_return_t keyRt = memcached_delete_by_key(
+            memc, group.constData(), group.size(), key.constData(), key.size(), 0);
+        if (!memcached_success(keyRt)) {
+            qCWarning(C_MEMCACHED).nospace() << "Failed to remove key " << key << ": "
+                                             << memcached_strerror(memc, keyRt);
+            rt = keyRt;
+        }
+    }
+
+    const memcached_return_t flushRt = memcached_flush_buffers(memc);
+    if (memcached_success(rt)) {
+        rt = flushRt;
+    }
+
+    for (const QByteArray &key : keys) {
+        MemcachedPrivate::invalidateNear(key);
+    }
+
+    MemcachedPrivate::setReturnType(returnType, rt);
+
+    return memcached_success(rt);
+}
+
+/**
+ * @internal
+ * Returns the connections of the current worker used by AsyncMemcached or @c nullptr if the
+ * plugin has not been registered.
+ */
+MemcachedPool *MemcachedPrivate::pool()
+{
+    return mcd ? mcd->d_ptr->asyncPool.get() : nullptr;
+}
+
+void MemcachedPrivate::invalidateNear(QByteArrayView key)
+{
+    if (mcd && mcd->d_ptr->nearCache) {
+        mcd->d_ptr->nearCache->remove(key);
+    }
+}
+
+void MemcachedPrivate::clearNear()
+{
+    if (mcd && mcd->d_ptr->nearCache) {
+        mcd->d_ptr->nearCache->clear();
     }
 }
 
@@ -6,9 +6,12 @@
 
 #include <Cutelyst/Plugins/memcached_export.h>
 #include <Cutelyst/plugin.h>
+#include <Cutelyst/singleflight.h>
 #include <chrono>
+#include <optional>
 
 #include <QDataStream>
+#include <QVariant>
 #include <QVersionNumber>
 
 namespace Cutelyst {
@@ -31,7 +34,11 @@ class MemcachedPrivate;
  * into a QByteArray and vice versa on retrieval. For more complex or custom types you can use
  * QDataStream to serialize them into a QByteArray. For most methods in this plugin there are
  * template functions for convenience that perform this serialization. The requirement to use
- * them is that the types to store and get provide stream operators for QDataStream.
+ * them is that the types to store and get provide stream operators for QDataStream. See
+ * <A HREF="#codecs">Codecs and compression</A> for a more compact alternative.
+ *
+ * The methods of this class block the worker thread until the server answers, AsyncMemcached
+ * provides the same operations without blocking, using the same servers and configuration.
  *
  * <H3 id="configfile">Configuration</h3>
  *
@@ -55,10 +62,17 @@ class MemcachedPrivate;
  * Enables compression of input values based on qCompress / zlib.
  * @endconfigblock
  *
+ * @configblock{compression_algorithm,string,zlib}
+ * The algorithm used to compress values when @c compression is enabled, either @c zlib,
+ * @c zstd or @c lz4. Zstandard and LZ4 are only available if the plugin was built with
+ * PLUGIN_MEMCACHED_ZSTD or PLUGIN_MEMCACHED_LZ4, otherwise zlib is used.
+ * @endconfigblock
+ *
  * @configblock{compression_level,integer,-1}
  * The compression level used by @link QByteArray::qCompress() qCompress()@endlink. Valid values
  * are between 0 and 9, with 9 corresponding to the greatest compression. The value 0 corresponds
  * to no compression at all. The default value is -1, which specifies zlib’s default compression.
+ * Zstandard uses it as its own compression level, LZ4 ignores it.
  * @endconfigblock
  *
  * @configblock{compression_threshold,integer,100}
@@ -66,6 +80,11 @@ class MemcachedPrivate;
  * compressed.
  * @endconfigblock
  *
+ * @configblock{codec,string,datastream}
+ * The serialization used by the template methods, either @c datastream or @c cbor. See
+ * <A HREF="#codecs">Codecs and compression</A>.
+ * @endconfigblock
+ *
  * @configblock{encryption_key,string,empty}
  * If set and not empty, AES encryption will be enabled for storing data on the memcached servers.
  * @endconfigblock
@@ -79,6 +98,28 @@ class MemcachedPrivate;
  * Password used for the SASL authentication with the memcached server(s).
  * @endconfigblock
  *
+ * @configblock{near_cache,string,disabled}
+ * Enables a near cache in front of the servers, either @c worker, keeping one for each worker,
+ * or @c process, sharing one among the workers of a process. See
+ * <A HREF="#nearcache">Near cache</A>.
+ * @endconfigblock
+ *
+ * @configblock{near_cache_size,integer,10000}
+ * Maximum number of values kept by the near cache, the least recently used are evicted first.
+ * @endconfigblock
+ *
+ * @configblock{near_cache_prefixes,string,empty}
+ * Comma separated list of key prefixes cached for @c near_cache_ttl milliseconds.
+ * @endconfigblock
+ *
+ * @configblock{near_cache_ttl,integer,1000}
+ * Milliseconds the values of keys matching @c near_cache_prefixes are kept.
+ * @endconfigblock
+ *
+ * @configblock{near_cache_version_interval,integer,100}
+ * Milliseconds a version key of a near cache policy is kept before being read again.
+ * @endconfigblock
+ *
  * @note If you want to use non-ASCII key names, you have to enable the binary protocol.
  *
  * To set default values directly in your application, use setDefaultConfig() or the overloaded
@@ -95,6 +136,50 @@ class MemcachedPrivate;
  * namespace=foobar
  * @endcode
  *
+ * <H3 id="nearcache">Near cache</H3>
+ *
+ * Keys that are read very often and rarely change can be kept for a short time in memory by
+ * enabling the @c near_cache, saving the round trip to the servers and the decompression of
+ * their values. Only keys matching a policy are kept, policies are added with
+ * addNearCachePolicy() or @c near_cache_prefixes and the policy with the longest matching
+ * prefix is used.
+ *
+ * Values stored, changed or removed through this plugin, also with AsyncMemcached, drop the
+ * cached copy of the near cache they use. Other workers, when not sharing a process-wide near
+ * cache, and other hosts keep their copy until it expires, unless the policy has a version key:
+ * cached values are then only used while the version key keeps the value it had when they were
+ * read, so incrementing it invalidates all keys of the policy everywhere after at most
+ * @c near_cache_version_interval.
+ *
+ * The near cache is used by get() and its template version when they are not asked for a CAS
+ * value, nearCacheStats() returns the hit counters of both tiers. getByKey() is not cached as
+ * the same key can have different values on the servers selected by different group keys.
+ * mget(), mgetByKey() and the reads of AsyncMemcached always go to the servers, batching many
+ * keys or not blocking the event loop is what they are used for.
+ *
+ * <H3 id="codecs">Codecs and compression</H3>
+ *
+ * The template methods serialize values with QDataStream by default. Setting @c codec to
+ * @c cbor stores values that QCborValue can represent, like numbers, strings, byte arrays,
+ * date times, URLs, UUIDs and lists or maps of them, as much smaller CBOR instead, values of
+ * other types still use QDataStream. Integers are read back as @c qlonglong and maps nested in
+ * a value as QVariantMap. AsyncMemcached reads values of both codecs but always writes with
+ * QDataStream.
+ *
+ * Values bigger than @c compression_threshold are compressed if @c compression is enabled.
+ * The codec and the compression algorithm are stored in the memcached flags of every item, so
+ * values keep being readable after changing @c codec or @c compression_algorithm, as long as
+ * the plugin was built with the algorithm they use.
+ *
+ * Versions of this plugin older than %Cutelyst 5.1.0 only know the zlib flag, they don't fail
+ * on values written with @c cbor, @c zstd or @c lz4 but silently read them as QDataStream data
+ * or uncompressed data, getting empty or wrong values. When rolling out the new settings to
+ * applications that share the cache, first deploy the new version everywhere with the default
+ * @c codec and @c compression_algorithm, and only then change them.
+ *
+ * The set of codecs is fixed, there is no interface to register other ones, values that need
+ * a different serialization can be serialized by the application and stored as QByteArray.
+ *
  * <H3>Expiration times</H3>
  *
  * Expiration times are set in seconds. If the value is bigger than 30 days, it is interpreted as a
@@ -259,6 +344,67 @@ public:
      */
     void setDefaultConfig(const QVariantMap &defaultConfig);
 
+    /**
+     * Keeps the values of keys starting with @a prefix in the near cache for @a ttl. If
+     * @a versionKey is not empty, cached values are only used while the value stored at
+     * @a versionKey is the same as when they were read.
+     *
+     * Has to be called before the plugin is set up and only has an effect if the
+     * @c near_cache is enabled.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    void addNearCachePolicy(const QByteArray &prefix,
+                            std::chrono::milliseconds ttl,
+                            const QByteArray &versionKey = {});
+
+    /**
+     * Counters of the near cache and of the reads that went to the servers.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    struct NearCacheStats {
+        /** Reads answered by the near cache. */
+        quint64 nearHits = 0;
+        /** Reads of keys with a policy not found or expired in the near cache. */
+        quint64 nearMisses = 0;
+        /** Reads answered by the servers with a value. */
+        quint64 memcachedHits = 0;
+        /** Reads the servers did not find a value for. */
+        quint64 memcachedMisses = 0;
+        /** Values currently kept by the near cache. */
+        qint64 nearCount = 0;
+
+        /** Returns the ratio of near cache reads that were hits. */
+        [[nodiscard]] double nearHitRatio() const noexcept
+        {
+            const quint64 total = nearHits + nearMisses;
+            return total ? double(nearHits) / double(total) : 0;
+        }
+
+        /** Returns the ratio of server reads that were hits. */
+        [[nodiscard]] double memcachedHitRatio() const noexcept
+        {
+            const quint64 total = memcachedHits + memcachedMisses;
+            return total ? double(memcachedHits) / double(total) : 0;
+        }
+    };
+
+    /**
+     * Returns the counters of the near cache used by the current worker, or empty ones if it
+     * is disabled.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    [[nodiscard]] static NearCacheStats nearCacheStats();
+
+    /**
+     * Resets the counters of the near cache used by the current worker.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    static void resetNearCacheStats();
+
     /**
      * Writes the @a value to the memcached server using @a key. If the @a key
      * already exists it will overwrite what is on the server. If the object
@@ -1361,6 +1507,115 @@ public:
                                           QHash<QByteArray, uint64_t> *casValues = nullptr,
                                           ReturnType *returnType                 = nullptr);
 
+    /**
+     * Stores all @a values, mapped by their keys, for @a expiration. The commands are buffered
+     * and sent without asking the servers for replies, so storing many values only costs the
+     * time needed to write them instead of one round trip per key.
+     *
+     * As there are no replies, only failures to send the commands are reported, the values
+     * might still not be stored, for example if they are too big. The commands are written
+     * on separate connections to the servers, set up once for this mode; when @c use_udp is
+     * enabled they are sent one by one on the regular connections.
+     *
+     * @param[in] values the keys and values to store
+     * @param[in] expiration expiration time in seconds
+     * @param[out] returnType optional pointer to a ReturnType variable that takes the
+     * return type of the operation
+     * @return @c true if all commands have been sent; @c false otherwise
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    static bool mset(const QHash<QByteArray, QByteArray> &values,
+                     time_t expiration,
+                     ReturnType *returnType = nullptr);
+
+    /**
+     * @overload
+     * @since %Cutelyst 5.1.0
+     */
+    inline static bool mset(const QHash<QByteArray, QByteArray> &values,
+                            std::chrono::seconds expiration,
+                            ReturnType *returnType = nullptr);
+
+    /**
+     * Stores all @a values of type @a T, mapped by their keys, for @a expiration like the
+     * QByteArray overload.
+     *
+     * Type @a T has to be serializable into a QByteArray using QDataStream.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    template <typename T>
+    static bool mset(const QHash<QByteArray, T> &values,
+                     std::chrono::seconds expiration,
+                     ReturnType *returnType = nullptr);
+
+    /**
+     * Stores all @a values on the server specified by @a groupKey. This method behaves in a
+     * similar nature as Memcached::mset().
+     *
+     * @param[in] groupKey key that specifies the server to write to
+     * @param[in] values the keys and values to store
+     * @param[in] expiration expiration time in seconds
+     * @param[out] returnType optional pointer to a ReturnType variable that takes the
+     * return type of the operation
+     * @return @c true if all commands have been sent; @c false otherwise
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    static bool msetByKey(QByteArrayView groupKey,
+                          const QHash<QByteArray, QByteArray> &values,
+                          time_t expiration,
+                          ReturnType *returnType = nullptr);
+
+    /**
+     * @overload
+     * @since %Cutelyst 5.1.0
+     */
+    inline static bool msetByKey(QByteArrayView groupKey,
+                                 const QHash<QByteArray, QByteArray> &values,
+                                 std::chrono::seconds expiration,
+                                 ReturnType *returnType = nullptr);
+
+    /**
+     * @overload
+     * @since %Cutelyst 5.1.0
+     */
+    template <typename T>
+    static bool msetByKey(QByteArrayView groupKey,
+                          const QHash<QByteArray, T> &values,
+                          std::chrono::seconds expiration,
+                          ReturnType *returnType = nullptr);
+
+    /**
+     * Removes all @a keys, buffering the commands and sending them without asking the servers
+     * for replies like Memcached::mset().
+     *
+     * @param[in] keys the keys to remove
+     * @param[out] returnType optional pointer to a ReturnType variable that takes the
+     * return type of the operation
+     * @return @c true if all commands have been sent; @c false otherwise
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    static bool mremove(const QByteArrayList &keys, ReturnType *returnType = nullptr);
+
+    /**
+     * Removes all @a keys from the server specified by @a groupKey. This method behaves in a
+     * similar nature as Memcached::mremove().
+     *
+     * @param[in] groupKey key that specifies the server to remove the keys from
+     * @param[in] keys the keys to remove
+     * @param[out] returnType optional pointer to a ReturnType variable that takes the
+     * return type of the operation
+     * @return @c true if all commands have been sent; @c false otherwise
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    static bool mremoveByKey(QByteArrayView groupKey,
+                             const QByteArrayList &keys,
+                             ReturnType *returnType = nullptr);
+
     /**
      * Updates the @a expiration time on an existing @a key.
      *
@@ -1408,6 +1663,64 @@ public:
                                   std::chrono::seconds expiration,
                                   ReturnType *returnType = nullptr);
 
+    /**
+     * Fetches the value of @a key and calls @a callback with it, if it is not found it is
+     * loaded with @a loader and stored for @a expiration. Concurrent misses of the same @a key
+     * on any worker thread are coalesced with SingleFlight, only the first one calls the
+     * @a loader while the others are resumed with its result or error.
+     *
+     * The loaded value is stored as QByteArray, failed loads are not stored.
+     *
+     * @par Usage example
+     * @code{.cpp}
+     * void MyController::index(Context *c)
+     * {
+     *     Memcached::getOrLoad(c, "MyKey", 5min,
+     *         [](SingleFlight::Callback done) {
+     *             done({expensiveQuery(), {}});
+     *         },
+     *         [c](const SingleFlight::Result &result) {
+     *             c->response()->setBody(result.value.toByteArray());
+     *         });
+     * }
+     * @endcode
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    static void getOrLoad(Context *c,
+                          QByteArrayView key,
+                          std::chrono::seconds expiration,
+                          SingleFlight::Loader loader,
+                          SingleFlight::Callback callback);
+
+    /**
+     * Like getOrLoad(), but returns an awaitable for the result to be used in a CoroContext.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    [[nodiscard]] static AwaitedSingleFlight coGetOrLoad(Context *c,
+                                                         QByteArrayView key,
+                                                         std::chrono::seconds expiration,
+                                                         SingleFlight::Loader loader);
+
+    /**
+     * Serializes @a value like the template methods of this plugin do, with the configured
+     * codec, and sets @a flags to the codec flags that have to be passed to decode().
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    template <typename T>
+    static QByteArray encode(const T &value, quint32 *flags);
+
+    /**
+     * Deserializes @a data created by encode() with the codec marked in @a flags, returns a
+     * default constructed value if @a data is empty.
+     *
+     * @since %Cutelyst 5.1.0
+     */
+    template <typename T>
+    static T decode(const QByteArray &data, quint32 flags);
+
     /**
      * Converts the return type @a rt into human readable error string.
      */
@@ -1425,6 +1738,40 @@ protected:
     bool setup(Application *app) override;
 
 private:
+    enum class StoreMode { Set, Add, Replace, Cas };
+
+    // The memcached flag of values encoded as CBOR
+    static constexpr quint32 codecMask = 0x2;
+
+    static bool cborCodec();
+    // Returns a null QByteArray if value can not be represented as CBOR
+    static QByteArray encodeCbor(const QVariant &value);
+    static QVariant decodeCbor(const QByteArray &data);
+
+    static bool storeEncoded(StoreMode mode,
+                             QByteArrayView groupKey,
+                             QByteArrayView key,
+                             const QByteArray &value,
+                             quint32 codec,
+                             time_t expiration,
+                             uint64_t cas,
+                             ReturnType *returnType);
+    static QByteArray getEncoded(QByteArrayView groupKey,
+                                 QByteArrayView key,
+                                 uint64_t *cas,
+                                 quint32 *codec,
+                                 ReturnType *returnType);
+    static QHash<QByteArray, QByteArray> mgetEncoded(std::optional<QByteArrayView> groupKey,
+                                                     const QByteArrayList &keys,
+                                                     QHash<QByteArray, uint64_t> *casValues,
+                                                     QHash<QByteArray, quint32> *codecs,
+                                                     ReturnType *returnType);
+    static bool msetEncoded(std::optional<QByteArrayView> groupKey,
+                            const QHash<QByteArray, QByteArray> &values,
+                            const QHash<QByteArray, quint32> *codecs,
+                            time_t expiration,
+                            ReturnType *returnType);
+
     const std::unique_ptr<MemcachedPrivate> d_ptr;
 };
 
@@ -1439,10 +1786,9 @@ inline bool Memcached::set(QByteArrayView key,
 template <typename T>
 bool Memcached::set(QByteArrayView key, const T &value, time_t expiration, ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::set(key, data, expiration, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(StoreMode::Set, {}, key, data, codec, expiration, 0, returnType);
 }
 
 template <typename T>
@@ -1470,10 +1816,10 @@ bool Memcached::setByKey(QByteArrayView groupKey,
                          time_t expiration,
                          ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::setByKey(groupKey, key, data, expiration, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(
+        StoreMode::Set, groupKey, key, data, codec, expiration, 0, returnType);
 }
 
 template <typename T>
@@ -1497,10 +1843,9 @@ inline bool Memcached::add(QByteArrayView key,
 template <typename T>
 bool Memcached::add(QByteArrayView key, const T &value, time_t expiration, ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::add(key, data, expiration, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(StoreMode::Add, {}, key, data, codec, expiration, 0, returnType);
 }
 
 template <typename T>
@@ -1528,10 +1873,10 @@ bool Memcached::addByKey(QByteArrayView groupKey,
                          time_t expiration,
                          ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::addByKey(groupKey, key, data, expiration, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(
+        StoreMode::Add, groupKey, key, data, codec, expiration, 0, returnType);
 }
 
 template <typename T>
@@ -1558,10 +1903,10 @@ bool Memcached::replace(QByteArrayView key,
                         time_t expiration,
                         ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::replace(key, data, expiration, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(
+        StoreMode::Replace, {}, key, data, codec, expiration, 0, returnType);
 }
 
 template <typename T>
@@ -1589,10 +1934,10 @@ bool Memcached::replaceByKey(QByteArrayView groupKey,
                              time_t expiration,
                              ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::replaceByKey(groupKey, key, data, expiration, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(
+        StoreMode::Replace, groupKey, key, data, codec, expiration, 0, returnType);
 }
 
 template <typename T>
@@ -1654,13 +1999,9 @@ inline bool Memcached::decrementWithInitialByKey(QByteArrayView groupKey,
 template <typename T>
 T Memcached::get(QByteArrayView key, uint64_t *cas, ReturnType *returnType)
 {
-    T retVal;
-    QByteArray ba = Memcached::get(key, cas, returnType);
-    if (!ba.isEmpty()) {
-        QDataStream in(&ba, QIODeviceBase::ReadOnly);
-        in >> retVal;
-    }
-    return retVal;
+    quint32 codec       = 0;
+    const QByteArray ba = Memcached::getEncoded({}, key, cas, &codec, returnType);
+    return Memcached::decode<T>(ba, codec);
 }
 
 template <typename T>
@@ -1669,13 +2010,9 @@ T Memcached::getByKey(QByteArrayView groupKey,
                       uint64_t *cas,
                       ReturnType *returnType)
 {
-    T retVal;
-    QByteArray ba = Memcached::getByKey(groupKey, key, cas, returnType);
-    if (!ba.isEmpty()) {
-        QDataStream in(&ba, QIODeviceBase::ReadOnly);
-        in >> retVal;
-    }
-    return retVal;
+    quint32 codec       = 0;
+    const QByteArray ba = Memcached::getEncoded(groupKey, key, cas, &codec, returnType);
+    return Memcached::decode<T>(ba, codec);
 }
 
 inline bool Memcached::cas(QByteArrayView key,
@@ -1694,10 +2031,10 @@ bool Memcached::cas(QByteArrayView key,
                     uint64_t cas,
                     ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::cas(key, data, expiration, cas, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(
+        StoreMode::Cas, {}, key, data, codec, expiration, cas, returnType);
 }
 
 template <typename T>
@@ -1728,10 +2065,10 @@ bool Memcached::casByKey(QByteArrayView groupKey,
                          uint64_t cas,
                          ReturnType *returnType)
 {
-    QByteArray data;
-    QDataStream out(&data, QIODeviceBase::WriteOnly);
-    out << value;
-    return Memcached::casByKey(groupKey, key, data, expiration, cas, returnType);
+    quint32 codec         = 0;
+    const QByteArray data = Memcached::encode(value, &codec);
+    return Memcached::storeEncoded(
+        StoreMode::Cas, groupKey, key, data, codec, expiration, cas, returnType);
 }
 
 template <typename T>
@@ -1756,14 +2093,11 @@ QHash<QByteArray, T> Memcached::mget(const QByteArrayList &keys,
                                      ReturnType *returnType)
 {
     QHash<QByteArray, T> hash;
-    const QHash<QByteArray, QByteArray> _data = Memcached::mget(keys, casValues, returnType);
-    if (!_data.empty()) {
-        for (const auto &[key, value] : _data.asKeyValueRange()) {
-            T retVal;
-            QDataStream in(value);
-            in >> retVal;
-            hash.insert(key, retVal);
-        }
+    QHash<QByteArray, quint32> codecs;
+    const QHash<QByteArray, QByteArray> _data =
+        Memcached::mgetEncoded(std::nullopt, keys, casValues, &codecs, returnType);
+    for (const auto &[key, value] : _data.asKeyValueRange()) {
+        hash.insert(key, Memcached::decode<T>(value, codecs.value(key)));
     }
     return hash;
 }
@@ -1775,19 +2109,102 @@ QHash<QByteArray, T> Memcached::mgetByKey(QByteArrayView groupKey,
                                           ReturnType *returnType)
 {
     QHash<QByteArray, T> hash;
+    QHash<QByteArray, quint32> codecs;
     const QHash<QByteArray, QByteArray> _data =
-        Memcached::mgetByKey(groupKey, keys, casValues, returnType);
-    if (!_data.empty()) {
-        for (const auto &[key, value] : _data.asKeyValueRange()) {
-            T retVal;
-            QDataStream in(value);
-            in >> retVal;
-            hash.insert(key, retVal);
-        }
+        Memcached::mgetEncoded(groupKey, keys, casValues, &codecs, returnType);
+    for (const auto &[key, value] : _data.asKeyValueRange()) {
+        hash.insert(key, Memcached::decode<T>(value, codecs.value(key)));
     }
     return hash;
 }
 
+inline bool Memcached::mset(const QHash<QByteArray, QByteArray> &values,
+                            std::chrono::seconds expiration,
+                            ReturnType *returnType)
+{
+    return Memcached::mset(values, expiration.count(), returnType);
+}
+
+template <typename T>
+bool Memcached::mset(const QHash<QByteArray, T> &values,
+                     std::chrono::seconds expiration,
+                     ReturnType *returnType)
+{
+    QHash<QByteArray, QByteArray> data;
+    data.reserve(values.size());
+    QHash<QByteArray, quint32> codecs;
+    for (const auto &[key, value] : values.asKeyValueRange()) {
+        quint32 codec = 0;
+        data.insert(key, Memcached::encode(value, &codec));
+        if (codec) {
+            codecs.insert(key, codec);
+        }
+    }
+    return Memcached::msetEncoded(std::nullopt, data, &codecs, expiration.count(), returnType);
+}
+
+inline bool Memcached::msetByKey(QByteArrayView groupKey,
+                                 const QHash<QByteArray, QByteArray> &values,
+                                 std::chrono::seconds expiration,
+                                 ReturnType *returnType)
+{
+    return Memcached::msetByKey(groupKey, values, expiration.count(), returnType);
+}
+
+template <typename T>
+bool Memcached::msetByKey(QByteArrayView groupKey,
+                          const QHash<QByteArray, T> &values,
+                          std::chrono::seconds expiration,
+                          ReturnType *returnType)
+{
+    QHash<QByteArray, QByteArray> data;
+    data.reserve(values.size());
+    QHash<QByteArray, quint32> codecs;
+    for (const auto &[key, value] : values.asKeyValueRange()) {
+        quint32 codec = 0;
+        data.insert(key, Memcached::encode(value, &codec));
+        if (codec) {
+            codecs.insert(key, codec);
+        }
+    }
+    return Memcached::msetEncoded(groupKey, data, &codecs, expiration.count(), returnType);
+}
+
+template <typename T>
+QByteArray Memcached::encode(const T &value, quint32 *flags)
+{
+    if (Memcached::cborCodec()) {
+        const QByteArray data = Memcached::encodeCbor(QVariant::fromValue(value));
+        if (!data.isNull()) {
+            *flags = codecMask;
+            return data;
+        }
+    }
+
+    *flags = 0;
+    QByteArray data;
+    QDataStream out(&data, QIODeviceBase::WriteOnly);
+    out << value;
+    return data;
+}
+
+template <typename T>
+T Memcached::decode(const QByteArray &data, quint32 flags)
+{
+    T retVal;
+    if (data.isEmpty()) {
+        return retVal;
+    }
+
+    if (flags & codecMask) {
+        return Memcached::decodeCbor(data).value<T>();
+    }
+
+    QDataStream in(data);
+    in >> retVal;
+    return retVal;
+}
+
 inline bool
     Memcached::touch(QByteArrayView key, std::chrono::seconds expiration, ReturnType *returnType)
 {
@@ -7,14 +7,19 @@
 #define CUTELYSTMEMCACHED_P_H
 
 #include "memcached.h"
+#include "memcachedconnection_p.h"
+#include "memcachednearcache_p.h"
 
 #include <libmemcached/memcached.h>
 
 #include <QFlags>
+#include <QLoggingCategory>
 #include <QMap>
 #include <QString>
 #include <QVariant>
 
+Q_DECLARE_LOGGING_CATEGORY(C_MEMCACHED)
+
 namespace Cutelyst {
 
 class MemcachedPrivate
@@ -30,39 +35,71 @@ public:
 
     ~MemcachedPrivate()
     {
-        if (memc) {
+        freeMemc(memc);
+        freeMemc(pipelineMemc);
+    }
+
+    void freeMemc(memcached_st *ptr) const
+    {
+        if (ptr) {
 #ifdef LIBMEMCACHED_WITH_SASL_SUPPORT
 #    if LIBMEMCACHED_WITH_SASL_SUPPORT == 1
             if (saslEnabled) {
-                memcached_destroy_sasl_auth_data(memc);
+                memcached_destroy_sasl_auth_data(ptr);
             }
 #    endif
 #endif
-            memcached_free(memc);
+            memcached_free(ptr);
         }
     }
 
-    enum Flag : quint32 { NoFlags = 0x0, Compressed = 0x1 };
+    // Compressed is zlib, Cbor marks values encoded with QCborValue instead of QDataStream
+    enum Flag : quint32 { NoFlags = 0x0, Compressed = 0x1, Cbor = 0x2, Zstd = 0x4, Lz4 = 0x8 };
     Q_DECLARE_FLAGS(Flags, Flag)
 
     static Memcached::ReturnType returnTypeConvert(memcached_return_t rt);
     static void setReturnType(Memcached::ReturnType *rt1, memcached_return_t rt2);
     static bool isRegistered(const Memcached *ptr, Memcached::ReturnType *rt);
     static QByteArray compressIfNeeded(const QByteArray &value, Flags &flags);
+    static QByteArray uncompress(const QByteArray &value, Flags flags);
     static QByteArray uncompressIfNeeded(const QByteArray &value, memcached_result_st *result);
+    static bool storeMulti(QByteArrayView groupKey,
+                           const QHash<QByteArray, QByteArray> &values,
+                           const QHash<QByteArray, quint32> *codecs,
+                           time_t expiration,
+                           Memcached::ReturnType *returnType);
+    static bool removeMulti(QByteArrayView groupKey,
+                            const QByteArrayList &keys,
+                            Memcached::ReturnType *returnType);
+    static MemcachedPool *pool();
+    static void invalidateNear(QByteArrayView key);
+    static void clearNear();
 
     QVariant config(const QString &key, const QVariant &defaultValue = {}) const;
 
     static constexpr uint16_t defaultPort{11211};
     static constexpr int defaultCompressionThreshold{100};
+    static constexpr int defaultAsyncConnections{2};
+    static constexpr std::chrono::milliseconds defaultAsyncTimeout{1000};
+    static constexpr qsizetype defaultNearCacheSize{10000};
+    static constexpr std::chrono::milliseconds defaultNearCacheTtl{1000};
+    static constexpr std::chrono::milliseconds defaultNearCacheVersionInterval{100};
 
     QMap<int, std::pair<QString, quint16>> servers;
     memcached_st *memc = nullptr;
-
-    bool compression         = false;
-    int compressionThreshold = defaultCompressionThreshold;
-    int compressionLevel     = -1;
-    bool saslEnabled         = false;
+    // Clone of memc that buffers commands without asking for replies, used by mset and
+    // mremove, null with UDP where requests can not be buffered
+    memcached_st *pipelineMemc = nullptr;
+    std::unique_ptr<MemcachedPool> asyncPool;
+    std::vector<MemcachedNearCache::Policy> nearPolicies;
+    std::shared_ptr<MemcachedNearCache> nearCache;
+
+    bool compression          = false;
+    Flag compressionAlgorithm = Compressed;
+    int compressionThreshold  = defaultCompressionThreshold;
+    int compressionLevel      = -1;
+    bool cborCodec            = false;
+    bool saslEnabled          = false;
 
     QVariantMap loadedConfig;
     QVariantMap defaultConfig;
@@ -0,0 +1,443 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "memcached_p.h"
+#include "memcachedconnection_p.h"
+
+#include <algorithm>
+#include <map>
+
+#include <QHash>
+#include <QLocalSocket>
+#include <QLoggingCategory>
+#include <QSet>
+#include <QTcpSocket>
+#include <QTimer>
+
+using namespace Cutelyst;
+using namespace Qt::StringLiterals;
+
+namespace {
+
+constexpr qsizetype maxKeySize = 250;
+
+} // namespace
+
+QByteArray MemcachedResponse::flag(char name) const
+{
+    for (const QByteArray &flag : flags) {
+        if (flag.startsWith(name)) {
+            return flag.mid(1);
+        }
+    }
+    return {};
+}
+
+MemcachedRequest::MemcachedRequest(Kind kind, QByteArray command, AsyncMemcached::Callback callback)
+    : kind(kind)
+    , command(std::move(command))
+    , callback(std::move(callback))
+{
+    if (kind == Kind::MultiGet || kind == Kind::Batch) {
+        reply.returnType = Memcached::ReturnType::Success;
+    }
+}
+
+bool MemcachedRequest::consume(const MemcachedResponse &response)
+{
+    const MemcachedPrivate::Flags flags{response.flag('f').toUInt()};
+    const quint32 codec = flags & MemcachedPrivate::Cbor;
+
+    if (kind == Kind::MultiGet || kind == Kind::Batch) {
+        if (response.code == "MN") {
+            return true;
+        }
+
+        if (kind == Kind::MultiGet && response.code == "VA") {
+            const QByteArray key = response.flag('k').mid(namespaceSize);
+            reply.values.insert(key, MemcachedPrivate::uncompress(response.data, flags));
+            reply.casValues.insert(key, response.flag('c').toULongLong());
+            reply.flagValues.insert(key, codec);
+        } else {
+            // Misses and stored items are quiet, so anything else is an error of one of the keys
+            reply.returnType = Memcached::ReturnType::SomeErrors;
+        }
+        return false;
+    }
+
+    reply.returnType = returnType(response.code);
+    if (response.code == "VA") {
+        if (kind == Kind::Arithmetic) {
+            reply.number = response.data.toULongLong();
+        } else {
+            reply.value = MemcachedPrivate::uncompress(response.data, flags);
+            reply.cas   = response.flag('c').toULongLong();
+            reply.flags = codec;
+        }
+    }
+    return true;
+}
+
+Memcached::ReturnType MemcachedRequest::returnType(const QByteArray &code)
+{
+    using enum Memcached::ReturnType;
+    if (code == "HD" || code == "VA" || code == "OK") {
+        return Success;
+    } else if (code == "EN" || code == "NF") {
+        return NotFound;
+    } else if (code == "NS") {
+        return NotStored;
+    } else if (code == "EX") {
+        return DataExists;
+    } else if (code == "CLIENT_ERROR") {
+        return ClientError;
+    } else if (code == "SERVER_ERROR") {
+        return ServerError;
+    } else if (code == "ERROR") {
+        return Error;
+    }
+    return ProtocolError;
+}
+
+MemcachedConnection::MemcachedConnection(const MemcachedServer &server,
+                                         std::chrono::milliseconds timeout)
+    : m_server(server)
+    , m_timeout(timeout)
+{
+}
+
+MemcachedConnection::~MemcachedConnection()
+{
+    delete m_socket;
+}
+
+void MemcachedConnection::send(std::unique_ptr<MemcachedRequest> request)
+{
+    if (!m_socket) {
+        connectToServer();
+    }
+
+    if (m_connected) {
+        m_socket->write(request->command);
+    } else {
+        m_outgoing.append(request->command);
+    }
+
+    if (m_queue.empty()) {
+        m_timer->start();
+    }
+    m_queue.push_back(std::move(request));
+}
+
+void MemcachedConnection::connectToServer()
+{
+    if (!m_timer) {
+        m_timer = std::make_unique<QTimer>();
+        m_timer->setSingleShot(true);
+        m_timer->setInterval(m_timeout);
+        QObject::connect(m_timer.get(), &QTimer::timeout, m_timer.get(), [this] {
+            qCWarning(C_MEMCACHED) << "Timed out waiting for memcached server" << m_server.name;
+            reset(Memcached::ReturnType::Timeout);
+        });
+    }
+
+    // Signals of a socket that was reset are ignored
+    if (m_server.isSocket) {
+        auto socket = new QLocalSocket;
+        m_socket    = socket;
+        QObject::connect(socket, &QLocalSocket::connected, socket, [this, socket] {
+            if (socket == m_socket) {
+                onConnected();
+            }
+        });
+        QObject::connect(socket, &QLocalSocket::errorOccurred, socket, [this, socket] {
+            if (socket == m_socket) {
+                qCWarning(C_MEMCACHED) << "Connection to memcached server" << m_server.name
+                                       << "failed:" << socket->errorString();
+                reset(Memcached::ReturnType::ConnectionFailure);
+            }
+        });
+        socket->connectToServer(m_server.name);
+    } else {
+        auto socket = new QTcpSocket;
+        m_socket    = socket;
+        QObject::connect(socket, &QTcpSocket::connected, socket, [this, socket] {
+            if (socket == m_socket) {
+                socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+                onConnected();
+            }
+        });
+        QObject::connect(socket, &QTcpSocket::errorOccurred, socket, [this, socket] {
+            if (socket == m_socket) {
+                qCWarning(C_MEMCACHED).nospace()
+                    << "Connection to memcached server " << m_server.name << ":" << m_server.port
+                    << " failed: " << socket->errorString();
+                reset(Memcached::ReturnType::ConnectionFailure);
+            }
+        });
+        socket->connectToHost(m_server.name, m_server.port);
+    }
+
+    QObject::connect(m_socket, &QIODevice::readyRead, m_socket, [this, socket = m_socket] {
+        if (socket == m_socket) {
+            onReadyRead();
+        }
+    });
+}
+
+void MemcachedConnection::onConnected()
+{
+    m_connected = true;
+    if (!m_outgoing.isEmpty()) {
+        m_socket->write(m_outgoing);
+        m_outgoing.clear();
+    }
+}
+
+void MemcachedConnection::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+
+    MemcachedResponse response;
+    while (readResponse(response)) {
+        if (m_queue.empty()) {
+            qCWarning(C_MEMCACHED) << "Unexpected response from memcached server" << m_server.name
+                                   << response.code;
+            reset(Memcached::ReturnType::ProtocolError);
+            return;
+        }
+
+        if (!m_queue.front()->consume(response)) {
+            continue;
+        }
+
+        std::unique_ptr<MemcachedRequest> request = std::move(m_queue.front());
+        m_queue.pop_front();
+        if (m_queue.empty()) {
+            m_timer->stop();
+        } else {
+            m_timer->start();
+        }
+
+        // Might send new requests to this connection
+        request->callback(request->reply);
+        if (!m_socket) {
+            return;
+        }
+    }
+
+    m_buffer.remove(0, m_pos);
+    m_pos = 0;
+}
+
+bool MemcachedConnection::readResponse(MemcachedResponse &response)
+{
+    const qsizetype eol = m_buffer.indexOf("\r\n", m_pos);
+    if (eol == -1) {
+        return false;
+    }
+
+    QList<QByteArray> tokens = m_buffer.sliced(m_pos, eol - m_pos).split(' ');
+    qsizetype next           = eol + 2;
+
+    response.code = tokens.takeFirst();
+    response.data.clear();
+    if (response.code == "VA") {
+        const qsizetype size = tokens.isEmpty() ? 0 : tokens.takeFirst().toLongLong();
+        if (m_buffer.size() < next + size + 2) {
+            return false;
+        }
+        response.data = m_buffer.sliced(next, size);
+        next += size + 2;
+    }
+    response.flags = std::move(tokens);
+
+    m_pos = next;
+    return true;
+}
+
+void MemcachedConnection::reset(Memcached::ReturnType returnType)
+{
+    QIODevice *socket = std::exchange(m_socket, nullptr);
+    if (socket) {
+        socket->close();
+        socket->deleteLater();
+    }
+    m_timer->stop();
+    m_connected = false;
+    m_outgoing.clear();
+    m_buffer.clear();
+    m_pos = 0;
+
+    // Callbacks might send new requests, which will use a new socket
+    auto queue = std::exchange(m_queue, {});
+    for (const auto &request : queue) {
+        request->reply            = {};
+        request->reply.returnType = returnType;
+        request->callback(request->reply);
+    }
+}
+
+MemcachedPool::MemcachedPool(memcached_st *memc,
+                             int connections,
+                             std::chrono::milliseconds timeout,
+                             const QByteArray &keyPrefix)
+    : keyPrefix(keyPrefix)
+    , m_memc(memc)
+    , m_timeout(timeout)
+    , m_hashWithNamespace(
+          memcached_behavior_get(memc, MEMCACHED_BEHAVIOR_HASH_WITH_PREFIX_KEY) != 0)
+{
+    // Positions match the server keys returned by memcached_generate_hash()
+    const uint32_t count = memcached_server_count(memc);
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto instance = memcached_server_instance_by_position(memc, i);
+        const QString name  = QString::fromUtf8(memcached_server_name(instance));
+        m_servers.push_back({name,
+                             quint16(memcached_server_port(instance)),
+                             qstrcmp(memcached_server_type(instance), "SOCKET") == 0});
+    }
+
+    if (m_servers.empty()) {
+        m_servers.push_back({u"localhost"_s, MemcachedPrivate::defaultPort, false});
+    }
+
+    m_connections.resize(m_servers.size());
+    for (auto &serverConnections : m_connections) {
+        serverConnections.resize(std::max(connections, 1));
+    }
+}
+
+MemcachedPool::~MemcachedPool() = default;
+
+QByteArray MemcachedPool::key(QByteArrayView key, Memcached::ReturnType &returnType) const
+{
+    if (key.isEmpty()) {
+        returnType = Memcached::ReturnType::BadKeyProvided;
+        return {};
+    }
+
+    if (keyPrefix.size() + key.size() > maxKeySize) {
+        returnType = Memcached::ReturnType::KeyTooBig;
+        return {};
+    }
+
+    // The text protocol does not allow whitespace or control characters in keys
+    const bool valid = std::ranges::all_of(key, [](char ch) {
+        return static_cast<unsigned char>(ch) > ' ' && ch != 0x7f;
+    });
+    if (!valid) {
+        returnType = Memcached::ReturnType::BadKeyProvided;
+        return {};
+    }
+
+    QByteArray prefixed = keyPrefix;
+    prefixed.append(key);
+    return prefixed;
+}
+
+int MemcachedPool::serverFor(QByteArrayView hashKey) const
+{
+    if (m_servers.size() < 2) {
+        return 0;
+    }
+
+    // libmemcached hashes group keys the same way, with the namespace if configured
+    uint32_t server = 0;
+    if (m_hashWithNamespace && !keyPrefix.isEmpty()) {
+        QByteArray prefixed = keyPrefix;
+        prefixed.append(hashKey);
+        server = memcached_generate_hash(m_memc, prefixed.constData(), size_t(prefixed.size()));
+    } else {
+        server = memcached_generate_hash(m_memc, hashKey.data(), size_t(hashKey.size()));
+    }
+    return server < m_servers.size() ? int(server) : 0;
+}
+
+MemcachedPool::Route MemcachedPool::routeFor(QByteArrayView hashKey) const
+{
+    const int server = serverFor(hashKey);
+    return {server, int(qHash(hashKey) % m_connections[server].size())};
+}
+
+void MemcachedPool::send(Route route, std::unique_ptr<MemcachedRequest> request)
+{
+    // Connections are pipelined but independent, picking the least busy one would let a
+    // later command for a key be answered before an earlier one
+    auto &connection = m_connections[route.server][route.connection];
+    if (!connection) {
+        connection = std::make_unique<MemcachedConnection>(m_servers[route.server], m_timeout);
+    }
+    connection->send(std::move(request));
+}
+
+void MemcachedPool::queueGet(Route route,
+                             const QByteArray &fullKey,
+                             AsyncMemcached::Callback callback)
+{
+    if (!m_batchTimer) {
+        m_batchTimer = std::make_unique<QTimer>();
+        m_batchTimer->setSingleShot(true);
+        m_batchTimer->setInterval(0);
+        QObject::connect(m_batchTimer.get(), &QTimer::timeout, m_batchTimer.get(), [this] {
+            sendQueuedGets();
+        });
+    }
+
+    if (m_pendingGets.empty()) {
+        m_batchTimer->start();
+    }
+    m_pendingGets.push_back({route, fullKey, std::move(callback)});
+}
+
+void MemcachedPool::sendQueuedGets()
+{
+    std::map<Route, std::vector<PendingGet>> perRoute;
+    for (PendingGet &get : std::exchange(m_pendingGets, {})) {
+        perRoute[get.route].push_back(std::move(get));
+    }
+
+    for (auto &&[route, gets] : perRoute) {
+        if (gets.size() == 1) {
+            PendingGet &get = gets.front();
+            send(route,
+                 std::make_unique<MemcachedRequest>(MemcachedRequest::Kind::Get,
+                                                    "mg " + get.fullKey + " v f c\r\n",
+                                                    std::move(get.callback)));
+            continue;
+        }
+
+        // Quiet gets followed by a no-op, a key asked twice is only sent once
+        QByteArray command;
+        QSet<QByteArray> sent;
+        for (const PendingGet &get : gets) {
+            if (!sent.contains(get.fullKey)) {
+                sent.insert(get.fullKey);
+                command.append("mg " + get.fullKey + " k v f c q\r\n");
+            }
+        }
+        command.append("mn\r\n");
+
+        auto dispatch = [gets = std::make_shared<std::vector<PendingGet>>(std::move(gets))](
+                            const AsyncMemcached::Reply &batch) {
+            for (const PendingGet &get : *gets) {
+                AsyncMemcached::Reply reply;
+                auto it = batch.values.constFind(get.fullKey);
+                if (it != batch.values.constEnd()) {
+                    reply.returnType = Memcached::ReturnType::Success;
+                    reply.value      = it.value();
+                    reply.cas        = batch.casValues.value(get.fullKey);
+                    reply.flags      = batch.flagValues.value(get.fullKey);
+                } else {
+                    reply.returnType =
+                        batch.ok() ? Memcached::ReturnType::NotFound : batch.returnType;
+                }
+                get.callback(reply);
+            }
+        };
+        send(route,
+             std::make_unique<MemcachedRequest>(
+                 MemcachedRequest::Kind::MultiGet, std::move(command), std::move(dispatch)));
+    }
+}
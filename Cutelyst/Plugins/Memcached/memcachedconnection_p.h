@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "asyncmemcached.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+class QIODevice;
+class QTimer;
+struct memcached_st;
+
+namespace Cutelyst {
+
+struct MemcachedServer {
+    QString name;
+    quint16 port  = 11211;
+    bool isSocket = false;
+};
+
+/**
+ * @internal
+ * A response line of the meta protocol, with its data block if it has one.
+ */
+struct MemcachedResponse {
+    QByteArray code;
+    QList<QByteArray> flags;
+    QByteArray data;
+
+    [[nodiscard]] QByteArray flag(char name) const;
+};
+
+/**
+ * @internal
+ * A command written to a connection, waiting for its responses.
+ */
+class MemcachedRequest
+{
+public:
+    enum class Kind { Get, Store, Delete, Arithmetic, Touch, Exist, Flush, MultiGet, Batch };
+
+    MemcachedRequest(Kind kind, QByteArray command, AsyncMemcached::Callback callback);
+
+    // Returns true once the last response of the request has been read
+    bool consume(const MemcachedResponse &response);
+
+    static Memcached::ReturnType returnType(const QByteArray &code);
+
+    Kind kind;
+    QByteArray command;
+    AsyncMemcached::Reply reply;
+    AsyncMemcached::Callback callback;
+    // Size of the namespace prefixed to keys returned by a MultiGet
+    qsizetype namespaceSize = 0;
+};
+
+/**
+ * @internal
+ * A pipelined connection to a single memcached server, living on the worker thread.
+ */
+class MemcachedConnection
+{
+    Q_DISABLE_COPY(MemcachedConnection)
+public:
+    MemcachedConnection(const MemcachedServer &server, std::chrono::milliseconds timeout);
+    ~MemcachedConnection();
+
+    void send(std::unique_ptr<MemcachedRequest> request);
+
+    [[nodiscard]] qsizetype pending() const noexcept { return qsizetype(m_queue.size()); }
+
+private:
+    void connectToServer();
+    void onConnected();
+    void onReadyRead();
+    bool readResponse(MemcachedResponse &response);
+    void reset(Memcached::ReturnType returnType);
+
+    MemcachedServer m_server;
+    std::chrono::milliseconds m_timeout;
+    QIODevice *m_socket = nullptr;
+    std::unique_ptr<QTimer> m_timer;
+    std::deque<std::unique_ptr<MemcachedRequest>> m_queue;
+    QByteArray m_outgoing;
+    QByteArray m_buffer;
+    qsizetype m_pos  = 0;
+    bool m_connected = false;
+};
+
+/**
+ * @internal
+ * The connections of a worker to the servers of the synchronous API, keys are distributed
+ * by libmemcached so both APIs honor the distribution, hash and hash_with_namespace options.
+ */
+class MemcachedPool
+{
+    Q_DISABLE_COPY(MemcachedPool)
+public:
+    MemcachedPool(memcached_st *memc,
+                  int connections,
+                  std::chrono::milliseconds timeout,
+                  const QByteArray &keyPrefix);
+    ~MemcachedPool();
+
+    // Returns the key with the namespace or a null QByteArray if it is not valid
+    [[nodiscard]] QByteArray key(QByteArrayView key, Memcached::ReturnType &returnType) const;
+
+    // A connection to a server, commands sharing a route are answered in the order sent
+    struct Route {
+        int server     = 0;
+        int connection = 0;
+
+        auto operator<=>(const Route &) const = default;
+    };
+
+    // Every command for the same key takes the same route, so writes are not reordered
+    [[nodiscard]] Route routeFor(QByteArrayView hashKey) const;
+
+    [[nodiscard]] int serverCount() const noexcept { return int(m_servers.size()); }
+
+    void send(Route route, std::unique_ptr<MemcachedRequest> request);
+
+    // Gets queued in the same event loop iteration are sent as a single multi-get per route
+    void queueGet(Route route, const QByteArray &fullKey, AsyncMemcached::Callback callback);
+
+    QByteArray keyPrefix;
+    bool batchGets = true;
+
+private:
+    struct PendingGet {
+        Route route;
+        QByteArray fullKey;
+        AsyncMemcached::Callback callback;
+    };
+
+    [[nodiscard]] int serverFor(QByteArrayView hashKey) const;
+    void sendQueuedGets();
+
+    std::vector<PendingGet> m_pendingGets;
+    std::unique_ptr<QTimer> m_batchTimer;
+    std::vector<MemcachedServer> m_servers;
+    std::vector<std::vector<std::unique_ptr<MemcachedConnection>>> m_connections;
+    memcached_st *m_memc;
+    std::chrono::milliseconds m_timeout;
+    bool m_hashWithNamespace = false;
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "memcachednearcache_p.h"
+
+#include <algorithm>
+
+using namespace Cutelyst;
+
+namespace {
+
+// Looks up a hash with a view without copying it
+QByteArray lookupKey(QByteArrayView key)
+{
+    return QByteArray::fromRawData(key.constData(), key.size());
+}
+
+} // namespace
+
+MemcachedNearCache::MemcachedNearCache(qsizetype maxEntries)
+    : m_maxEntries(std::max<qsizetype>(maxEntries, 1))
+{
+}
+
+void MemcachedNearCache::setPolicies(std::vector<Policy> policies)
+{
+    QMutexLocker locker(&m_mutex);
+    m_policies = std::move(policies);
+}
+
+void MemcachedNearCache::setVersionInterval(std::chrono::milliseconds interval)
+{
+    QMutexLocker locker(&m_mutex);
+    m_versionInterval = interval;
+}
+
+std::optional<MemcachedNearCache::Policy> MemcachedNearCache::policy(QByteArrayView key) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Policy *ret = nullptr;
+    for (const Policy &policy : m_policies) {
+        if (key.startsWith(policy.prefix) &&
+            (!ret || policy.prefix.size() > ret->prefix.size())) {
+            ret = &policy;
+        }
+    }
+
+    if (ret) {
+        return *ret;
+    }
+    return {};
+}
+
+std::optional<MemcachedNearCache::Value> MemcachedNearCache::get(QByteArrayView key,
+                                                                const QByteArray &version)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.constFind(lookupKey(key));
+    if (it == m_index.cend()) {
+        ++m_stats.nearMisses;
+        return {};
+    }
+
+    auto node = *it;
+    if (node->expires <= Clock::now() || node->version != version) {
+        ++m_stats.nearMisses;
+        erase(node);
+        return {};
+    }
+
+    ++m_stats.nearHits;
+    m_lru.splice(m_lru.begin(), m_lru, node);
+    return node->value;
+}
+
+void MemcachedNearCache::insert(QByteArrayView key,
+                                const Value &value,
+                                const QByteArray &version,
+                                std::chrono::milliseconds ttl)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(lookupKey(key));
+    if (it != m_index.end()) {
+        erase(*it);
+    }
+
+    while (m_index.size() >= m_maxEntries) {
+        erase(std::prev(m_lru.end()));
+    }
+
+    m_lru.push_front({key.toByteArray(), value, version, Clock::now() + ttl});
+    m_index.insert(m_lru.front().key, m_lru.begin());
+}
+
+std::optional<QByteArray> MemcachedNearCache::version(QByteArrayView versionKey)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_versions.constFind(lookupKey(versionKey));
+    if (it == m_versions.cend() || it->expires <= Clock::now()) {
+        return {};
+    }
+    return it->value;
+}
+
+void MemcachedNearCache::setVersion(QByteArrayView versionKey, const QByteArray &version)
+{
+    QMutexLocker locker(&m_mutex);
+    m_versions.insert(versionKey.toByteArray(), {version, Clock::now() + m_versionInterval});
+}
+
+void MemcachedNearCache::remove(QByteArrayView key)
+{
+    const QByteArray lookup = lookupKey(key);
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_index.find(lookup);
+    if (it != m_index.end()) {
+        erase(*it);
+    }
+    m_versions.remove(lookup);
+}
+
+void MemcachedNearCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_lru.clear();
+    m_index.clear();
+    m_versions.clear();
+}
+
+void MemcachedNearCache::recordMemcached(bool hit)
+{
+    QMutexLocker locker(&m_mutex);
+    if (hit) {
+        ++m_stats.memcachedHits;
+    } else {
+        ++m_stats.memcachedMisses;
+    }
+}
+
+Memcached::NearCacheStats MemcachedNearCache::stats()
+{
+    QMutexLocker locker(&m_mutex);
+    Memcached::NearCacheStats ret = m_stats;
+    ret.nearCount                 = m_index.size();
+    return ret;
+}
+
+void MemcachedNearCache::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats = {};
+}
+
+void MemcachedNearCache::erase(std::list<Node>::iterator it)
+{
+    m_index.remove(it->key);
+    m_lru.erase(it);
+}
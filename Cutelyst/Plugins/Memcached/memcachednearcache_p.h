@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "memcached.h"
+
+#include <chrono>
+#include <list>
+#include <optional>
+#include <vector>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+namespace Cutelyst {
+
+/**
+ * @internal
+ * A small LRU cache of values read from memcached, kept for a short time to avoid a round
+ * trip for hot keys. Only keys matching one of the policies are stored.
+ */
+class MemcachedNearCache
+{
+    Q_DISABLE_COPY(MemcachedNearCache)
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Value {
+        QByteArray data;
+        // The codec bits of the memcached flags of the item
+        quint32 codec = 0;
+    };
+
+    struct Policy {
+        QByteArray prefix;
+        std::chrono::milliseconds ttl;
+        QByteArray versionKey;
+    };
+
+    explicit MemcachedNearCache(qsizetype maxEntries);
+
+    void setPolicies(std::vector<Policy> policies);
+
+    void setVersionInterval(std::chrono::milliseconds interval);
+
+    // Returns the policy with the longest prefix of key
+    [[nodiscard]] std::optional<Policy> policy(QByteArrayView key) const;
+
+    // Returns the value of key if it did not expire and was stored with version
+    [[nodiscard]] std::optional<Value> get(QByteArrayView key, const QByteArray &version);
+
+    void insert(QByteArrayView key,
+                const Value &value,
+                const QByteArray &version,
+                std::chrono::milliseconds ttl);
+
+    // Returns the cached value of versionKey, if it was read less than the version interval ago
+    [[nodiscard]] std::optional<QByteArray> version(QByteArrayView versionKey);
+
+    void setVersion(QByteArrayView versionKey, const QByteArray &version);
+
+    // Drops key, and its cached value if it is a version key
+    void remove(QByteArrayView key);
+
+    void clear();
+
+    void recordMemcached(bool hit);
+
+    [[nodiscard]] Memcached::NearCacheStats stats();
+
+    void resetStats();
+
+private:
+    struct Node {
+        QByteArray key;
+        Value value;
+        QByteArray version;
+        Clock::time_point expires;
+    };
+
+    struct Version {
+        QByteArray value;
+        Clock::time_point expires;
+    };
+
+    // Must be called with the mutex locked
+    void erase(std::list<Node>::iterator it);
+
+    // Most recently used first
+    std::list<Node> m_lru;
+    QHash<QByteArray, std::list<Node>::iterator> m_index;
+    QHash<QByteArray, Version> m_versions;
+    std::vector<Policy> m_policies;
+    std::chrono::milliseconds m_versionInterval{100};
+    qsizetype m_maxEntries;
+    Memcached::NearCacheStats m_stats;
+    mutable QMutex m_mutex;
+};
+
+} // namespace Cutelyst
@@ -18,8 +18,8 @@ using namespace Qt::Literals::StringLiterals;
 
 Q_LOGGING_CATEGORY(C_MEMCACHEDSESSIONSTORE, "cutelyst.plugin.sessionmemcached", QtWarningMsg)
 
-const QString MemcachedSessionStorePrivate::stashKeyMemcdSave{u"_c_session_store_memcd_save"_s};
-const QString MemcachedSessionStorePrivate::stashKeyMemcdData{u"_c_session_store_memcd_data"_s};
+const ContextSlot<bool> MemcachedSessionStorePrivate::contextMemcdSave;
+const ContextSlot<QVariantHash> MemcachedSessionStorePrivate::contextMemcdData;
 
 static QVariantHash
     loadMemcSessionData(Context *c, const QByteArray &sid, const QByteArray &groupKey);
@@ -58,8 +58,8 @@ bool MemcachedSessionStore::storeSessionData(Context *c,
     Q_D(MemcachedSessionStore);
     QVariantHash data = loadMemcSessionData(c, sid, d->groupKey);
     data.insert(key, value);
-    c->setStash(MemcachedSessionStorePrivate::stashKeyMemcdData, data);
-    c->setStash(MemcachedSessionStorePrivate::stashKeyMemcdSave, true);
+    MemcachedSessionStorePrivate::contextMemcdData.set(c, std::move(data));
+    MemcachedSessionStorePrivate::contextMemcdSave.set(c, true);
 
     return true;
 }
@@ -69,8 +69,8 @@ bool MemcachedSessionStore::deleteSessionData(Context *c, const QByteArray &sid,
     Q_D(MemcachedSessionStore);
     QVariantHash data = loadMemcSessionData(c, sid, d->groupKey);
     data.remove(key);
-    c->setStash(MemcachedSessionStorePrivate::stashKeyMemcdData, data);
-    c->setStash(MemcachedSessionStorePrivate::stashKeyMemcdSave, true);
+    MemcachedSessionStorePrivate::contextMemcdData.set(c, std::move(data));
+    MemcachedSessionStorePrivate::contextMemcdSave.set(c, true);
 
     return true;
 }
@@ -92,9 +92,8 @@ void MemcachedSessionStore::setGroupKey(const QByteArray &groupKey)
 QVariantHash loadMemcSessionData(Context *c, const QByteArray &sid, const QByteArray &groupKey)
 {
     QVariantHash data;
-    const QVariant sessionVariant = c->stash(MemcachedSessionStorePrivate::stashKeyMemcdData);
-    if (!sessionVariant.isNull()) {
-        data = sessionVariant.toHash();
+    if (const QVariantHash *sessionData = MemcachedSessionStorePrivate::contextMemcdData.get(c)) {
+        data = *sessionData;
         return data;
     }
 
@@ -102,16 +101,16 @@ QVariantHash loadMemcSessionData(Context *c, const QByteArray &sid, const QByteA
         QCoreApplication::applicationName().toLatin1() + "_sess_";
     const QByteArray sessionKey = sessionPrefix + sid;
 
-    QObject::connect(c->app(), &Application::afterDispatch, c, [=]() {
-        if (!c->stash(MemcachedSessionStorePrivate::stashKeyMemcdSave).toBool()) {
+    c->addAfterDispatchHook([groupKey, sessionKey](Context *c) {
+        if (!MemcachedSessionStorePrivate::contextMemcdSave.value(c)) {
             return;
         }
 
-        const QVariantHash data =
-            c->stash(MemcachedSessionStorePrivate::stashKeyMemcdData).toHash();
+        const QVariantHash data = MemcachedSessionStorePrivate::contextMemcdData.value(c);
 
         if (data.isEmpty()) {
             bool ok = false;
+            // Runs before the response is finalized, wait for the reply so a failure is noticed
             if (groupKey.isEmpty()) {
                 ok = Memcached::remove(sessionKey);
             } else {
@@ -141,7 +140,7 @@ QVariantHash loadMemcSessionData(Context *c, const QByteArray &sid, const QByteA
         data = Memcached::getByKey<QVariantHash>(groupKey, sessionKey);
     }
 
-    c->setStash(MemcachedSessionStorePrivate::stashKeyMemcdData, data);
+    MemcachedSessionStorePrivate::contextMemcdData.set(c, data);
 
     return data;
 }
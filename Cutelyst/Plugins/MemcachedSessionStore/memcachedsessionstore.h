@@ -25,6 +25,10 @@ class MemcachedSessionStorePrivate;
  * example delete the data because it runs out of memory and deletes session data. So be careful
  * when using this plugin to store sessions.
  *
+ * Session data is serialized with the @c codec and compressed with the @c compression settings
+ * of the Memcached plugin, setting @c codec to @c cbor makes the stored sessions considerably
+ * smaller if they only contain simple types.
+ *
  * <H3>Configuration</h3>
  *
  * The %MemcachedSessionStore plugin can be configured in the
@@ -7,6 +7,8 @@
 
 #include "memcachedsessionstore.h"
 
+#include <Cutelyst/ContextSlot>
+
 namespace Cutelyst {
 
 class MemcachedSessionStorePrivate
@@ -14,8 +16,8 @@ class MemcachedSessionStorePrivate
 public:
     QByteArray groupKey;
 
-    static const QString stashKeyMemcdSave;
-    static const QString stashKeyMemcdData;
+    static const ContextSlot<bool> contextMemcdSave;
+    static const ContextSlot<QVariantHash> contextMemcdData;
 };
 
 } // namespace Cutelyst
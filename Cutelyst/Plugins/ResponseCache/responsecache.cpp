@@ -0,0 +1,635 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "responsecache_p.h"
+#include "responsecachememorystore.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Context>
+#include <Cutelyst/ContextSlot>
+#include <Cutelyst/Engine>
+#include <Cutelyst/Request>
+#include <Cutelyst/Response>
+#include <algorithm>
+#include <limits>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+using namespace std::chrono_literals;
+
+Q_LOGGING_CATEGORY(C_RESPONSECACHE, "cutelyst.plugin.responsecache", QtWarningMsg)
+
+namespace {
+
+thread_local ResponseCache *rc = nullptr;
+
+ContextSlot<ResponseCachePrivate::Pending> pendingSlot;
+
+// Incremented when the serialized entries change
+constexpr quint8 entryFormat = 1;
+
+// Longest time a single request refreshes a stale response
+constexpr std::chrono::seconds lockTtl = 30s;
+
+bool cacheableStatus(quint16 status)
+{
+    switch (status) {
+    case Response::OK:
+    case Response::NonAuthoritativeInformation:
+    case Response::NoContent:
+    case Response::MovedPermanently:
+    case Response::NotFound:
+    case Response::Gone:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Headers that belong to a single response
+bool storedHeader(const QByteArray &key)
+{
+    static const QByteArrayList skipped{
+        "Age"_ba,
+        "Connection"_ba,
+        "Content-Length"_ba,
+        "Date"_ba,
+        "Set-Cookie"_ba,
+        "Transfer-Encoding"_ba,
+    };
+    return std::ranges::none_of(skipped, [&key](const QByteArray &name) {
+        return key.compare(name, Qt::CaseInsensitive) == 0;
+    });
+}
+
+QByteArray newVersion()
+{
+    return QByteArray::number(QRandomGenerator::global()->generate64(), 16);
+}
+
+QByteArray fragmentKey(const QString &key)
+{
+    return "cutelyst_rc_fragment_"_ba +
+           QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+qint64 msecs(std::chrono::seconds seconds)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(seconds).count();
+}
+
+QByteArrayList normalizedHeaders(const QByteArrayList &headers)
+{
+    QByteArrayList ret;
+    for (const QByteArray &header : headers) {
+        const QByteArray name = header.trimmed().toLower();
+        if (!name.isEmpty() && !ret.contains(name)) {
+            ret.append(name);
+        }
+    }
+    std::ranges::sort(ret);
+    return ret;
+}
+
+} // namespace
+
+QByteArray ResponseCacheEntry::serialize() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODeviceBase::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_5);
+    out << entryFormat << quint8(kind) << status << created << freshUntil << staleUntil
+        << staleIfErrorUntil << headers << body << vary << tags;
+    return data;
+}
+
+std::optional<ResponseCacheEntry> ResponseCacheEntry::deserialize(const QByteArray &data)
+{
+    if (data.isEmpty()) {
+        return {};
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_5);
+
+    quint8 format;
+    quint8 kind;
+    ResponseCacheEntry entry;
+    in >> format >> kind;
+    if (format != entryFormat) {
+        return {};
+    }
+    in >> entry.status >> entry.created >> entry.freshUntil >> entry.staleUntil >>
+        entry.staleIfErrorUntil >> entry.headers >> entry.body >> entry.vary >> entry.tags;
+    if (in.status() != QDataStream::Ok) {
+        qCWarning(C_RESPONSECACHE) << "Failed to read a cached entry";
+        return {};
+    }
+
+    entry.kind = Kind(kind);
+    return entry;
+}
+
+ResponseCacheStore::ResponseCacheStore(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ResponseCache::ResponseCache(Application *parent)
+    : Plugin(parent)
+    , d_ptr(new ResponseCachePrivate)
+{
+}
+
+ResponseCache::ResponseCache(Application *parent, const QVariantMap &defaultConfig)
+    : Plugin(parent)
+    , d_ptr(new ResponseCachePrivate)
+{
+    Q_D(ResponseCache);
+    d->defaultConfig = defaultConfig;
+}
+
+ResponseCache::~ResponseCache() = default;
+
+void ResponseCache::addPath(const QString &path)
+{
+    Q_D(ResponseCache);
+    d->paths.push_back({path, {}});
+    std::ranges::stable_sort(d->paths, [](const auto &a, const auto &b) {
+        return a.path.size() > b.path.size();
+    });
+}
+
+void ResponseCache::addPath(const QString &path, const Policy &policy)
+{
+    Q_D(ResponseCache);
+    Policy normalized = policy;
+    normalized.vary   = normalizedHeaders(policy.vary);
+    d->paths.push_back({path, normalized});
+    std::ranges::stable_sort(d->paths, [](const auto &a, const auto &b) {
+        return a.path.size() > b.path.size();
+    });
+}
+
+void ResponseCache::setStorage(std::unique_ptr<ResponseCacheStore> store)
+{
+    Q_D(ResponseCache);
+    d->store = std::move(store);
+}
+
+ResponseCacheStore *ResponseCache::storage() const
+{
+    Q_D(const ResponseCache);
+    return d->store.get();
+}
+
+void ResponseCache::invalidateTags(const QStringList &tags)
+{
+    Q_D(ResponseCache);
+    for (const QString &tag : tags) {
+        qCDebug(C_RESPONSECACHE) << "Invalidating tag" << tag;
+        d->store->set(ResponseCachePrivate::tagKey(tag), newVersion(), 0s);
+    }
+}
+
+void ResponseCache::addTags(Context *c, const QStringList &tags)
+{
+    pendingSlot.ref(c).tags.append(tags);
+}
+
+void ResponseCache::skip(Context *c)
+{
+    pendingSlot.ref(c).skip = true;
+}
+
+void ResponseCache::invalidate(Context *c, const QStringList &tags)
+{
+    Q_UNUSED(c)
+    if (!rc) {
+        qCCritical(C_RESPONSECACHE) << "ResponseCache plugin not registered";
+        return;
+    }
+    rc->invalidateTags(tags);
+}
+
+std::optional<QByteArray> ResponseCache::fragment(Context *c, const QString &key)
+{
+    Q_UNUSED(c)
+    if (!rc) {
+        qCCritical(C_RESPONSECACHE) << "ResponseCache plugin not registered";
+        return {};
+    }
+
+    const auto entry = rc->d_ptr->lookup(fragmentKey(key));
+    if (!entry || entry->kind != ResponseCacheEntry::Kind::Fragment ||
+        entry->freshUntil <= QDateTime::currentMSecsSinceEpoch()) {
+        return {};
+    }
+    return entry->body;
+}
+
+bool ResponseCache::setFragment(Context *c,
+                                const QString &key,
+                                const QByteArray &data,
+                                std::chrono::seconds ttl,
+                                const QStringList &tags)
+{
+    Q_UNUSED(c)
+    if (!rc) {
+        qCCritical(C_RESPONSECACHE) << "ResponseCache plugin not registered";
+        return false;
+    }
+
+    ResponseCacheEntry entry;
+    entry.kind       = ResponseCacheEntry::Kind::Fragment;
+    entry.created    = QDateTime::currentMSecsSinceEpoch();
+    // The store drops it, a zero ttl never expires
+    entry.freshUntil = ttl.count() > 0 ? entry.created + msecs(ttl)
+                                       : std::numeric_limits<qint64>::max();
+    entry.body       = data;
+    return rc->d_ptr->write(fragmentKey(key), entry, ttl, tags);
+}
+
+bool ResponseCache::setup(Application *app)
+{
+    Q_D(ResponseCache);
+
+    const QVariantMap config = app->engine()->config(u"Cutelyst_ResponseCache_Plugin"_s);
+    auto value               = [&](const QString &key, const QVariant &defaultValue) {
+        return config.value(key, d->defaultConfig.value(key, defaultValue));
+    };
+
+    auto seconds = [&](const QString &key, qint64 defaultValue) {
+        bool ok;
+        const qint64 ret = value(key, defaultValue).toLongLong(&ok);
+        if (!ok || ret < 0) {
+            qCWarning(C_RESPONSECACHE) << "Invalid" << key << "using" << defaultValue;
+            return std::chrono::seconds{defaultValue};
+        }
+        return std::chrono::seconds{ret};
+    };
+
+    d->defaultPolicy.ttl                  = seconds(u"ttl"_s, 60);
+    d->defaultPolicy.staleWhileRevalidate = seconds(u"stale_while_revalidate"_s, 0);
+    d->defaultPolicy.staleIfError         = seconds(u"stale_if_error"_s, 0);
+    d->defaultPolicy.coalesce             = value(u"coalesce"_s, true).toBool();
+    d->defaultPolicy.vary =
+        normalizedHeaders(value(u"vary"_s, QString{}).toString().toLatin1().split(','));
+
+    const QStringList paths =
+        value(u"paths"_s, QString{}).toString().split(u',', Qt::SkipEmptyParts);
+    for (const QString &path : paths) {
+        addPath(path.trimmed());
+    }
+
+    if (!d->store) {
+        bool ok;
+        const qint64 maxCost = value(u"max_cost"_s, 64 * 1024 * 1024).toLongLong(&ok);
+        if (ok && maxCost >= 0) {
+            ResponseCacheMemoryStore::setMaxCost(maxCost);
+        } else {
+            qCWarning(C_RESPONSECACHE) << "Invalid maximum cost, using"
+                                       << ResponseCacheMemoryStore::maxCost();
+        }
+        d->store = std::make_unique<ResponseCacheMemoryStore>();
+    }
+
+    connect(app, &Application::postForked, this, [this] { rc = this; });
+
+    // Runs after plugins serving static files and the ones installing response filters
+    app->addBeforePrepareActionHook(
+        this,
+        [d](Context *c, bool *skipMethod) { d->beforePrepareAction(c, skipMethod); },
+        -10);
+
+    return true;
+}
+
+void ResponseCachePrivate::beforePrepareAction(Context *c, bool *skipMethod)
+{
+    Request *req = c->request();
+    if (!req->isGet() && !req->isHead()) {
+        return;
+    }
+
+    const ResponseCache::Policy *policy = this->policy(req->path());
+    if (!policy) {
+        return;
+    }
+
+    const Headers &headers = req->headers();
+    if (headers.contains(Headers::KnownHeader::Authorization) ||
+        (!policy->cacheWithCookies && headers.contains(Headers::KnownHeader::Cookie))) {
+        return;
+    }
+
+    Pending pending;
+    pending.policy  = policy;
+    pending.baseKey = baseKey(c, *policy);
+
+    std::optional<ResponseCacheEntry> entry = find(c, pending);
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (entry && entry->kind == ResponseCacheEntry::Kind::Response) {
+        if (now < entry->freshUntil) {
+            qCDebug(C_RESPONSECACHE) << "Serving cached" << req->path();
+            serve(c, *entry, now);
+            *skipMethod = true;
+            return;
+        }
+
+        if (now < entry->staleUntil) {
+            // A single request refreshes the response, the others get the stale one
+            pending.lockKey = pending.key + "_lock";
+            if (!store->add(pending.lockKey, "1"_ba, lockTtl)) {
+                qCDebug(C_RESPONSECACHE) << "Serving stale" << req->path();
+                serve(c, *entry, now);
+                *skipMethod = true;
+                return;
+            }
+        }
+
+        if (now < entry->staleIfErrorUntil) {
+            pending.stale = std::move(entry);
+        }
+    }
+
+    if (policy->coalesce && pending.lockKey.isEmpty()) {
+        auto resume = [this, c](const SingleFlight::Result &result) {
+            Q_UNUSED(result)
+            afterCoalesced(c);
+        };
+        pending.finish = SingleFlight::join(c, pending.key, std::move(resume));
+        if (!pending.finish) {
+            // The actions are queued until the first request finishes
+            qCDebug(C_RESPONSECACHE) << "Waiting for a concurrent miss of" << req->path();
+            pendingSlot.set(c, std::move(pending));
+            return;
+        }
+    }
+
+    pendingSlot.set(c, std::move(pending));
+    c->addAfterDispatchHook([this](Context *c) { afterDispatch(c); });
+}
+
+void ResponseCachePrivate::afterCoalesced(Context *c)
+{
+    // Requests without an action are finalized right away
+    if (c->response()->isFinalized()) {
+        return;
+    }
+
+    Pending &pending = pendingSlot.ref(c);
+
+    const std::optional<ResponseCacheEntry> entry = find(c, pending);
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (entry && entry->kind == ResponseCacheEntry::Kind::Response && now < entry->freshUntil) {
+        qCDebug(C_RESPONSECACHE) << "Serving coalesced" << c->request()->path();
+        serve(c, *entry, now);
+        // Drops the queued actions
+        c->detach();
+        return;
+    }
+
+    // The first request did not store a response, so this one runs its actions
+    c->addAfterDispatchHook([this](Context *c) { afterDispatch(c); });
+}
+
+void ResponseCachePrivate::afterDispatch(Context *c)
+{
+    const Pending *pending = pendingSlot.get(c);
+    if (!pending || !pending->policy) {
+        return;
+    }
+
+    Response *res = c->response();
+    if (pending->stale && (c->error() || res->status() >= Response::InternalServerError)) {
+        qCInfo(C_RESPONSECACHE) << "Serving stale" << c->request()->path() << "after an error";
+        c->appendError({});
+        serve(c, *pending->stale, QDateTime::currentMSecsSinceEpoch());
+    } else if (!pending->skip && !c->error()) {
+        storeResponse(c, *pending);
+    }
+
+    if (!pending->lockKey.isEmpty()) {
+        store->remove(pending->lockKey);
+    }
+
+    if (pending->finish) {
+        pending->finish({});
+    }
+}
+
+std::optional<ResponseCacheEntry> ResponseCachePrivate::find(Context *c, Pending &pending)
+{
+    pending.key = pending.baseKey;
+
+    std::optional<ResponseCacheEntry> entry = lookup(pending.key);
+    if (entry && entry->kind == ResponseCacheEntry::Kind::Vary) {
+        pending.responseVary = entry->vary;
+        pending.key          = varyKey(pending.baseKey, c, entry->vary);
+        entry                = lookup(pending.key);
+    }
+    return entry;
+}
+
+const ResponseCache::Policy *ResponseCachePrivate::policy(const QString &path) const
+{
+    for (const Path &entry : paths) {
+        if (path.startsWith(entry.path)) {
+            return entry.policy ? &*entry.policy : &defaultPolicy;
+        }
+    }
+    return nullptr;
+}
+
+QByteArray ResponseCachePrivate::baseKey(Context *c, const ResponseCache::Policy &policy)
+{
+    Request *req = c->request();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    // HEAD requests share the responses of GET
+    hash.addData(req->isHead() ? "GET"_ba : req->method());
+    hash.addData(" ");
+    hash.addData(req->path().toUtf8());
+
+    // Sorted by name
+    const ParamsMultiMap query = req->queryParameters();
+    for (auto it = query.cbegin(); it != query.cend(); ++it) {
+        if (policy.queryParams.isEmpty() || policy.queryParams.contains(it.key())) {
+            hash.addData("\n");
+            hash.addData(it.key().toUtf8());
+            hash.addData("=");
+            hash.addData(it.value().toUtf8());
+        }
+    }
+
+    for (const QByteArray &header : policy.vary) {
+        hash.addData("\n");
+        hash.addData(header);
+        hash.addData(":");
+        hash.addData(req->header(header));
+    }
+
+    return "cutelyst_rc_"_ba + hash.result().toHex();
+}
+
+QByteArray ResponseCachePrivate::varyKey(const QByteArray &key,
+                                         Context *c,
+                                         const QByteArrayList &headers)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QByteArray &header : headers) {
+        hash.addData(header);
+        hash.addData(":");
+        hash.addData(c->request()->header(header));
+        hash.addData("\n");
+    }
+    return key + '_' + hash.result().toHex();
+}
+
+QByteArray ResponseCachePrivate::tagKey(const QString &tag)
+{
+    return "cutelyst_rc_tag_"_ba +
+           QCryptographicHash::hash(tag.toUtf8(), QCryptographicHash::Sha1).toHex();
+}
+
+std::optional<ResponseCacheEntry> ResponseCachePrivate::lookup(const QByteArray &key)
+{
+    auto entry = ResponseCacheEntry::deserialize(store->get(key));
+    if (entry) {
+        // Invalidated tags have a new version, evicted ones none
+        for (const auto &[tag, version] : entry->tags.asKeyValueRange()) {
+            if (store->get(tag) != version) {
+                qCDebug(C_RESPONSECACHE) << "Tag invalidated" << key;
+                return {};
+            }
+        }
+    }
+    return entry;
+}
+
+QHash<QByteArray, QByteArray> ResponseCachePrivate::tagVersions(const QStringList &tags)
+{
+    QHash<QByteArray, QByteArray> versions;
+    for (const QString &tag : tags) {
+        const QByteArray key = tagKey(tag);
+        if (versions.contains(key)) {
+            continue;
+        }
+
+        QByteArray version = store->get(key);
+        if (version.isNull()) {
+            version = newVersion();
+            if (!store->add(key, version, 0s)) {
+                // Another worker created it first
+                version = store->get(key);
+            }
+        }
+        versions.insert(key, version);
+    }
+    return versions;
+}
+
+bool ResponseCachePrivate::write(const QByteArray &key,
+                                 ResponseCacheEntry &entry,
+                                 std::chrono::seconds ttl,
+                                 const QStringList &tags)
+{
+    entry.tags = tagVersions(tags);
+    if (!store->set(key, entry.serialize(), ttl)) {
+        qCDebug(C_RESPONSECACHE) << "Failed to store" << key;
+        return false;
+    }
+    return true;
+}
+
+void ResponseCachePrivate::storeResponse(Context *c, const Pending &pending)
+{
+    Response *res        = c->response();
+    const quint16 status = res->status();
+    // Streamed bodies and devices are not kept
+    if (!cacheableStatus(status) || res->isFinalizedHeaders() || res->bodyDevice()) {
+        return;
+    }
+
+    const Headers &headers = res->headers();
+    if (!res->cookies().isEmpty() || headers.contains(Headers::KnownHeader::SetCookie)) {
+        return;
+    }
+
+    const QByteArray cacheControl = headers.header(Headers::KnownHeader::CacheControl).toLower();
+    if (cacheControl.contains("no-store") || cacheControl.contains("private")) {
+        return;
+    }
+
+    const QByteArrayList vary =
+        normalizedHeaders(headers.header(Headers::KnownHeader::Vary).split(','));
+    if (vary.contains("*")) {
+        return;
+    }
+
+    // The configured headers are already part of the base key
+    QByteArrayList responseVary;
+    for (const QByteArray &header : vary) {
+        if (!pending.policy->vary.contains(header)) {
+            responseVary.append(header);
+        }
+    }
+
+    const ResponseCache::Policy &policy = *pending.policy;
+    const auto ttl = policy.ttl + std::max(policy.staleWhileRevalidate, policy.staleIfError);
+
+    ResponseCacheEntry entry;
+    entry.status            = status;
+    entry.created           = QDateTime::currentMSecsSinceEpoch();
+    entry.freshUntil        = entry.created + msecs(policy.ttl);
+    entry.staleUntil        = entry.freshUntil + msecs(policy.staleWhileRevalidate);
+    entry.staleIfErrorUntil = entry.freshUntil + msecs(policy.staleIfError);
+    for (const auto &header : headers.data()) {
+        if (storedHeader(header.key)) {
+            entry.headers.append({header.key, header.value});
+        }
+    }
+    entry.body = res->body();
+
+    QByteArray key = pending.baseKey;
+    if (!responseVary.isEmpty()) {
+        if (responseVary != pending.responseVary) {
+            ResponseCacheEntry varyEntry;
+            varyEntry.kind = ResponseCacheEntry::Kind::Vary;
+            varyEntry.vary = responseVary;
+            write(pending.baseKey, varyEntry, ttl, {});
+        }
+        key = varyKey(pending.baseKey, c, responseVary);
+    }
+
+    qCDebug(C_RESPONSECACHE) << "Storing" << c->request()->path() << status;
+    write(key, entry, ttl, policy.tags + pending.tags);
+}
+
+void ResponseCachePrivate::serve(Context *c, const ResponseCacheEntry &entry, qint64 now)
+{
+    Response *res = c->response();
+    res->setStatus(entry.status);
+
+    Headers &headers = res->headers();
+    headers.clear();
+    for (const auto &[key, value] : entry.headers) {
+        headers.pushHeader(key, value);
+    }
+    const qint64 age = std::max(qint64(0), now - entry.created) / 1000;
+    headers.setHeader("Age"_ba, QByteArray::number(age));
+
+    res->setBody(entry.body);
+}
+
+#include "moc_responsecache.cpp"
@@ -0,0 +1,289 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugin>
+#include <Cutelyst/Plugins/responsecache_export.h>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+namespace Cutelyst {
+
+class Context;
+class ResponseCachePrivate;
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/ResponseCache/ResponseCache>
+ * \brief Abstract storage of the ResponseCache plugin.
+ *
+ * Reimplement it to keep cached responses somewhere else than the default
+ * ResponseCacheMemoryStore. Implementations are used by the ResponseCache of every
+ * worker thread, each one has its own store object but they are expected to share
+ * their data.
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_RESPONSECACHE_EXPORT ResponseCacheStore : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructs a new %ResponseCacheStore object with the given \a parent.
+     */
+    explicit ResponseCacheStore(QObject *parent = nullptr);
+
+    /**
+     * Returns the value of \a key or a null QByteArray if it is not stored or expired.
+     */
+    [[nodiscard]] virtual QByteArray get(const QByteArray &key) = 0;
+
+    /**
+     * Stores \a value at \a key for \a ttl, a zero \a ttl never expires.
+     */
+    virtual bool set(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) = 0;
+
+    /**
+     * Stores \a value at \a key for \a ttl only if \a key is not stored yet, returns
+     * \c false if it is.
+     */
+    virtual bool add(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) = 0;
+
+    /**
+     * Removes \a key from the store.
+     */
+    virtual bool remove(const QByteArray &key) = 0;
+};
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/ResponseCache/ResponseCache>
+ * \brief Answers requests from cached responses before any action runs.
+ *
+ * The %ResponseCache plugin stores the responses of \c GET and \c HEAD requests to the
+ * paths added with addPath() and serves them from a beforePrepareAction hook, so neither
+ * the dispatcher nor the actions run on a hit. Cached responses get an \c Age header.
+ *
+ * The key of a response is built from the method, the path, the query parameters listed
+ * in the Policy, all of them by default, sorted by name, and the values of the request
+ * headers listed in its \c vary. Headers named by the \c Vary header of a response are
+ * taken into account as well, responses with <TT>Vary: *</TT> are not stored. \c HEAD
+ * requests share the entries of \c GET.
+ *
+ * Responses are stored when they have one of the \c 200, \c 203, \c 204, \c 301, \c 404
+ * or \c 410 statuses and a body that was set as a whole, and are neither \c private nor
+ * \c no-store, nor set cookies. Requests carrying \c Authorization, or \c Cookie unless
+ * the Policy allows it, are not cached. Actions can opt out with skip().
+ *
+ * <H3>Stale responses</H3>
+ *
+ * Once its \c ttl expired a response is still served for \c stale_while_revalidate
+ * seconds, while a single request per key runs the action to refresh it. Up to
+ * \c stale_if_error seconds after its \c ttl the stale response replaces the response of
+ * an action that failed or returned a \c 5xx status.
+ *
+ * <H3>Request coalescing</H3>
+ *
+ * When a key is missing, the requests for it that arrive while the first one runs its
+ * action, on any worker thread, are detached with SingleFlight and wait for it. Once the
+ * first response is stored they are answered from the cache, if it was not stored they
+ * run their actions. This keeps a popular response that expired from running its action
+ * once per concurrent request.
+ *
+ * <H3>Invalidation</H3>
+ *
+ * Responses can be tagged with the tags of their Policy and addTags(), invalidate()
+ * and invalidateTags() then drop every response and fragment carrying one of the
+ * tags at once, in all workers sharing the store. Tags are versioned in the store, so
+ * invalidation is a single write per tag.
+ *
+ * <H3>Storage</H3>
+ *
+ * Responses are kept by a ResponseCacheMemoryStore shared by all workers of the
+ * process by default, built with <TT>-DPLUGIN_MEMCACHED:BOOL=ON</TT> the
+ * ResponseCacheMemcachedStore shares them among processes and servers using the
+ * Memcached plugin, in which case \c CUTELYST_RESPONSECACHE_WITH_MEMCACHED is defined.
+ * On UNIX systems the ResponseCacheSharedMemoryStore shares them among the processes
+ * forked by the server using the SharedMemoryCache plugin.
+ *
+ * <H3>Fragments</H3>
+ *
+ * Parts of a page can be cached with fragment() and setFragment(), Cutelee templates
+ * do it with the \c c_cache tag, which caches its content for \c ttl seconds under a
+ * name and optional values it varies on:
+ *
+ * \code{.html}
+ * {% c_cache 300 "sidebar" user.id %}
+ *   ...
+ * {% endc_cache %}
+ * \endcode
+ *
+ * <H3>Runtime configuration</H3>
+ *
+ * The plugin reads the \c Cutelyst_ResponseCache_Plugin section of the
+ * \ref configuration "application configuration file", the \a defaultConfig passed to the
+ * constructor is used for missing keys. The values are the defaults of the Policy of the
+ * paths added without one.
+ *
+ * \configblock{paths,string,empty}
+ * Comma separated list of path prefixes to cache, like \c /api/products.
+ * \endconfigblock
+ *
+ * \configblock{ttl,integer,60}
+ * Seconds a response is fresh.
+ * \endconfigblock
+ *
+ * \configblock{stale_while_revalidate,integer,0}
+ * Seconds a response is served after its \c ttl while it is refreshed.
+ * \endconfigblock
+ *
+ * \configblock{stale_if_error,integer,0}
+ * Seconds after its \c ttl a response replaces failed ones.
+ * \endconfigblock
+ *
+ * \configblock{coalesce,bool,true}
+ * Makes concurrent misses of a key wait for the response of the first one.
+ * \endconfigblock
+ *
+ * \configblock{vary,string,empty}
+ * Comma separated list of request headers that select different responses.
+ * \endconfigblock
+ *
+ * \configblock{max_cost,integer,67108864}
+ * Maximum number of bytes kept by the default ResponseCacheMemoryStore.
+ * \endconfigblock
+ *
+ * \code{.cpp}
+ * bool MyApp::init()
+ * {
+ *     auto cache = new ResponseCache(this);
+ *     cache->addPath(u"/products"_s,
+ *                    {.ttl = 300s, .staleIfError = 1h, .tags = {u"products"_s}});
+ * }
+ *
+ * void Products::update(Context *c)
+ * {
+ *     // ...
+ *     ResponseCache::invalidate(c, {u"products"_s});
+ * }
+ * \endcode
+ *
+ * \logcat{plugin.responsecache}
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_RESPONSECACHE_EXPORT ResponseCache : public Plugin
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(ResponseCache) // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    Q_DISABLE_COPY(ResponseCache)
+public:
+    /**
+     * How the responses of a path are cached.
+     */
+    struct Policy {
+        /** Seconds a response is fresh. */
+        std::chrono::seconds ttl = std::chrono::seconds{60};
+        /** Seconds a response is served after its \c ttl while it is refreshed. */
+        std::chrono::seconds staleWhileRevalidate = std::chrono::seconds{0};
+        /** Seconds after its \c ttl a response replaces failed ones. */
+        std::chrono::seconds staleIfError = std::chrono::seconds{0};
+        /** Query parameters that are part of the key, all of them if empty. */
+        QStringList queryParams;
+        /** Request headers that are part of the key. */
+        QByteArrayList vary;
+        /** Tags of all responses of the path. */
+        QStringList tags;
+        /** Caches requests carrying a \c Cookie header. */
+        bool cacheWithCookies = false;
+        /** Makes concurrent misses of a key wait for the response of the first one. */
+        bool coalesce = true;
+    };
+
+    /**
+     * Constructs a new %ResponseCache plugin with the given \a parent.
+     */
+    explicit ResponseCache(Application *parent);
+
+    /**
+     * Constructs a new %ResponseCache plugin with the given \a parent and \a defaultConfig
+     * values for the configuration file entries.
+     */
+    ResponseCache(Application *parent, const QVariantMap &defaultConfig);
+
+    /**
+     * Destroys the %ResponseCache object.
+     */
+    ~ResponseCache() override;
+
+    /**
+     * Caches the responses of requests whose path starts with \a path with the Policy
+     * of the configuration file.
+     */
+    void addPath(const QString &path);
+
+    /**
+     * Caches the responses of requests whose path starts with \a path with \a policy,
+     * the longest matching path wins.
+     */
+    void addPath(const QString &path, const Policy &policy);
+
+    /**
+     * Sets the \a store where responses are kept, the plugin takes its ownership.
+     */
+    void setStorage(std::unique_ptr<ResponseCacheStore> store);
+
+    /**
+     * Returns the store where responses are kept.
+     */
+    [[nodiscard]] ResponseCacheStore *storage() const;
+
+    /**
+     * Invalidates the responses and fragments tagged with one of \a tags.
+     */
+    void invalidateTags(const QStringList &tags);
+
+    /**
+     * Tags the response of \a c with \a tags in addition to the ones of its Policy.
+     */
+    static void addTags(Context *c, const QStringList &tags);
+
+    /**
+     * Prevents the response of \a c from being stored.
+     */
+    static void skip(Context *c);
+
+    /**
+     * Invalidates the responses and fragments tagged with one of \a tags, using the
+     * ResponseCache of the application of \a c.
+     */
+    static void invalidate(Context *c, const QStringList &tags);
+
+    /**
+     * Returns the fragment stored as \a key, if any.
+     */
+    [[nodiscard]] static std::optional<QByteArray> fragment(Context *c, const QString &key);
+
+    /**
+     * Stores \a data as the fragment \a key for \a ttl, tagged with \a tags.
+     */
+    static bool setFragment(Context *c,
+                            const QString &key,
+                            const QByteArray &data,
+                            std::chrono::seconds ttl,
+                            const QStringList &tags = {});
+
+    /**
+     * Reads the \c Cutelyst_ResponseCache_Plugin configuration section and registers the
+     * hook that answers requests from the cache.
+     */
+    bool setup(Application *app) override;
+
+private:
+    std::unique_ptr<ResponseCachePrivate> d_ptr;
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "responsecache.h"
+
+#include <Cutelyst/SingleFlight>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <QHash>
+
+namespace Cutelyst {
+
+// A cached response, the Vary header names of the responses of a key or a fragment
+class ResponseCacheEntry
+{
+public:
+    enum class Kind : quint8 { Response = 'R', Vary = 'V', Fragment = 'F' };
+
+    [[nodiscard]] QByteArray serialize() const;
+    [[nodiscard]] static std::optional<ResponseCacheEntry> deserialize(const QByteArray &data);
+
+    Kind kind      = Kind::Response;
+    quint16 status = 200;
+    // Milliseconds since the epoch
+    qint64 created           = 0;
+    qint64 freshUntil        = 0;
+    qint64 staleUntil        = 0;
+    qint64 staleIfErrorUntil = 0;
+    QVector<std::pair<QByteArray, QByteArray>> headers;
+    // The response body or the fragment
+    QByteArray body;
+    QByteArrayList vary;
+    // Tag keys and the versions they had when this entry was stored
+    QHash<QByteArray, QByteArray> tags;
+};
+
+class ResponseCachePrivate
+{
+public:
+    struct Path {
+        QString path;
+        // The configured policy is used if not set
+        std::optional<ResponseCache::Policy> policy;
+    };
+
+    // State of a request that missed the cache
+    struct Pending {
+        const ResponseCache::Policy *policy = nullptr;
+        // Key of the configured vary headers and the one of the response Vary headers
+        QByteArray baseKey;
+        QByteArray key;
+        QByteArrayList responseVary;
+        // Set while this request refreshes a stale response
+        QByteArray lockKey;
+        std::optional<ResponseCacheEntry> stale;
+        QStringList tags;
+        // Releases the requests that missed the same key meanwhile
+        SingleFlight::Callback finish;
+        bool skip = false;
+    };
+
+    void beforePrepareAction(Context *c, bool *skipMethod);
+    void afterDispatch(Context *c);
+    void afterCoalesced(Context *c);
+
+    // Returns the entry of the request, setting the key of the pending state
+    [[nodiscard]] std::optional<ResponseCacheEntry> find(Context *c, Pending &pending);
+
+    [[nodiscard]] const ResponseCache::Policy *policy(const QString &path) const;
+    [[nodiscard]] static QByteArray baseKey(Context *c, const ResponseCache::Policy &policy);
+    [[nodiscard]] static QByteArray varyKey(const QByteArray &key,
+                                            Context *c,
+                                            const QByteArrayList &headers);
+    [[nodiscard]] static QByteArray tagKey(const QString &tag);
+
+    // Returns the entry at key if its tags were not invalidated
+    [[nodiscard]] std::optional<ResponseCacheEntry> lookup(const QByteArray &key);
+    [[nodiscard]] QHash<QByteArray, QByteArray> tagVersions(const QStringList &tags);
+    bool write(const QByteArray &key,
+               ResponseCacheEntry &entry,
+               std::chrono::seconds ttl,
+               const QStringList &tags);
+    void storeResponse(Context *c, const Pending &pending);
+    static void serve(Context *c, const ResponseCacheEntry &entry, qint64 now);
+
+    QVariantMap defaultConfig;
+    ResponseCache::Policy defaultPolicy;
+    // Sorted by length, longest first
+    std::vector<Path> paths;
+    std::unique_ptr<ResponseCacheStore> store;
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "responsecachememcachedstore.h"
+
+#include <Cutelyst/Plugins/Memcached/Memcached>
+
+using namespace Cutelyst;
+
+ResponseCacheMemcachedStore::ResponseCacheMemcachedStore(QObject *parent)
+    : ResponseCacheStore(parent)
+{
+}
+
+QByteArray ResponseCacheMemcachedStore::get(const QByteArray &key)
+{
+    return Memcached::get(key);
+}
+
+bool ResponseCacheMemcachedStore::set(const QByteArray &key,
+                                      const QByteArray &value,
+                                      std::chrono::seconds ttl)
+{
+    return Memcached::set(key, value, ttl);
+}
+
+bool ResponseCacheMemcachedStore::add(const QByteArray &key,
+                                      const QByteArray &value,
+                                      std::chrono::seconds ttl)
+{
+    return Memcached::add(key, value, ttl);
+}
+
+bool ResponseCacheMemcachedStore::remove(const QByteArray &key)
+{
+    return Memcached::remove(key);
+}
+
+#include "moc_responsecachememcachedstore.cpp"
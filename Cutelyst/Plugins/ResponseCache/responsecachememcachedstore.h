@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugins/ResponseCache/responsecache.h>
+
+namespace Cutelyst {
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/ResponseCache/ResponseCacheMemcachedStore>
+ * \brief Keeps cached responses in memcached.
+ *
+ * %ResponseCacheMemcachedStore uses the Memcached plugin, that has to be registered
+ * in the application, to share cached responses and tag versions among all processes
+ * and servers using the same memcached servers. Only available when the Memcached
+ * plugin was built, in which case \c CUTELYST_RESPONSECACHE_WITH_MEMCACHED is defined.
+ *
+ * \code{.cpp}
+ * bool MyApp::init()
+ * {
+ *     new Memcached(this);
+ *     auto cache = new ResponseCache(this);
+ *     cache->setStorage(std::make_unique<ResponseCacheMemcachedStore>());
+ * }
+ * \endcode
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_RESPONSECACHE_EXPORT ResponseCacheMemcachedStore : public ResponseCacheStore
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructs a new %ResponseCacheMemcachedStore object with the given \a parent.
+     */
+    explicit ResponseCacheMemcachedStore(QObject *parent = nullptr);
+
+    [[nodiscard]] QByteArray get(const QByteArray &key) override;
+
+    bool set(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) override;
+
+    bool add(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) override;
+
+    bool remove(const QByteArray &key) override;
+};
+
+} // namespace Cutelyst
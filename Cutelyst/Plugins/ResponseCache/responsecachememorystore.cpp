@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "responsecachememorystore.h"
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <optional>
+
+#include <QHash>
+#include <QMutex>
+
+using namespace Cutelyst;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t shardCount = 16;
+
+class Shard
+{
+public:
+    struct Node {
+        QByteArray key;
+        QByteArray value;
+        // Never expires if not set
+        std::optional<Clock::time_point> expires;
+    };
+
+    QByteArray get(const QByteArray &key);
+    bool set(const QByteArray &key,
+             const QByteArray &value,
+             std::chrono::seconds ttl,
+             bool onlyAdd,
+             qint64 maxCost);
+    bool remove(const QByteArray &key);
+    void clear();
+    qint64 totalCost();
+
+private:
+    // Must be called with the mutex locked
+    void erase(std::list<Node>::iterator it);
+
+    // Most recently used first
+    std::list<Node> lru;
+    QHash<QByteArray, std::list<Node>::iterator> index;
+    QMutex mutex;
+    qint64 cost = 0;
+};
+
+struct Storage {
+    std::array<Shard, shardCount> shards;
+    std::atomic<qint64> maxCost = 64 * 1024 * 1024;
+};
+
+Storage &storage()
+{
+    static Storage storage;
+    return storage;
+}
+
+Shard &shard(const QByteArray &key)
+{
+    return storage().shards[qHash(key) % shardCount];
+}
+
+QByteArray Shard::get(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    auto it = index.constFind(key);
+    if (it == index.cend()) {
+        return {};
+    }
+
+    auto node = *it;
+    if (node->expires && *node->expires <= Clock::now()) {
+        erase(node);
+        return {};
+    }
+
+    lru.splice(lru.begin(), lru, node);
+    return node->value;
+}
+
+bool Shard::set(const QByteArray &key,
+                const QByteArray &value,
+                std::chrono::seconds ttl,
+                bool onlyAdd,
+                qint64 maxCost)
+{
+    const auto now = Clock::now();
+
+    QMutexLocker locker(&mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        auto node = *it;
+        if (onlyAdd && !(node->expires && *node->expires <= now)) {
+            return false;
+        }
+        erase(node);
+    }
+
+    const qint64 nodeCost = key.size() + value.size();
+    if (nodeCost > maxCost) {
+        return false;
+    }
+
+    Node node{key, value, {}};
+    if (ttl.count() > 0) {
+        node.expires = now + ttl;
+    }
+    lru.push_front(std::move(node));
+    index.insert(key, lru.begin());
+    cost += nodeCost;
+
+    while (cost > maxCost) {
+        erase(std::prev(lru.end()));
+    }
+    return true;
+}
+
+bool Shard::remove(const QByteArray &key)
+{
+    QMutexLocker locker(&mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        return false;
+    }
+    erase(*it);
+    return true;
+}
+
+void Shard::clear()
+{
+    QMutexLocker locker(&mutex);
+    lru.clear();
+    index.clear();
+    cost = 0;
+}
+
+qint64 Shard::totalCost()
+{
+    QMutexLocker locker(&mutex);
+    return cost;
+}
+
+void Shard::erase(std::list<Node>::iterator it)
+{
+    cost -= it->key.size() + it->value.size();
+    index.remove(it->key);
+    lru.erase(it);
+}
+
+} // namespace
+
+ResponseCacheMemoryStore::ResponseCacheMemoryStore(QObject *parent)
+    : ResponseCacheStore(parent)
+{
+}
+
+QByteArray ResponseCacheMemoryStore::get(const QByteArray &key)
+{
+    return shard(key).get(key);
+}
+
+bool ResponseCacheMemoryStore::set(const QByteArray &key,
+                                   const QByteArray &value,
+                                   std::chrono::seconds ttl)
+{
+    return shard(key).set(key, value, ttl, false, maxCost() / qint64(shardCount));
+}
+
+bool ResponseCacheMemoryStore::add(const QByteArray &key,
+                                   const QByteArray &value,
+                                   std::chrono::seconds ttl)
+{
+    return shard(key).set(key, value, ttl, true, maxCost() / qint64(shardCount));
+}
+
+bool ResponseCacheMemoryStore::remove(const QByteArray &key)
+{
+    return shard(key).remove(key);
+}
+
+void ResponseCacheMemoryStore::clear()
+{
+    for (Shard &shard : storage().shards) {
+        shard.clear();
+    }
+}
+
+qint64 ResponseCacheMemoryStore::totalCost()
+{
+    qint64 cost = 0;
+    for (Shard &shard : storage().shards) {
+        cost += shard.totalCost();
+    }
+    return cost;
+}
+
+void ResponseCacheMemoryStore::setMaxCost(qint64 bytes)
+{
+    // Shards shrink on their next insertion
+    storage().maxCost = bytes;
+}
+
+qint64 ResponseCacheMemoryStore::maxCost()
+{
+    return storage().maxCost;
+}
+
+#include "moc_responsecachememorystore.cpp"
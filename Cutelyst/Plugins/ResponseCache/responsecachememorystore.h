@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugins/ResponseCache/responsecache.h>
+
+namespace Cutelyst {
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/ResponseCache/ResponseCacheMemoryStore>
+ * \brief Keeps cached responses in the memory of the process.
+ *
+ * All %ResponseCacheMemoryStore objects share a single least recently used cache that
+ * lives until the process exits, so responses stored by one worker thread are served
+ * by all others. The cache is split in 16 shards, each with its own lock and a share
+ * of maxCost(), so workers rarely wait for each other.
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_RESPONSECACHE_EXPORT ResponseCacheMemoryStore : public ResponseCacheStore
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructs a new %ResponseCacheMemoryStore object with the given \a parent.
+     */
+    explicit ResponseCacheMemoryStore(QObject *parent = nullptr);
+
+    [[nodiscard]] QByteArray get(const QByteArray &key) override;
+
+    bool set(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) override;
+
+    bool add(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) override;
+
+    bool remove(const QByteArray &key) override;
+
+    /**
+     * Removes all entries of the process.
+     */
+    static void clear();
+
+    /**
+     * Returns the number of bytes of the keys and values stored in the process.
+     */
+    [[nodiscard]] static qint64 totalCost();
+
+    /**
+     * Sets the maximum number of bytes stored in the process, the default is 64 MiB.
+     */
+    static void setMaxCost(qint64 bytes);
+
+    /**
+     * Returns the maximum number of bytes stored in the process.
+     */
+    [[nodiscard]] static qint64 maxCost();
+};
+
+} // namespace Cutelyst
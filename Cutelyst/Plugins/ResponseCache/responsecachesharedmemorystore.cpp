@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "responsecachesharedmemorystore.h"
+
+#include <Cutelyst/Plugins/Cache/SharedMemoryCache>
+
+using namespace Cutelyst;
+
+ResponseCacheSharedMemoryStore::ResponseCacheSharedMemoryStore(QObject *parent)
+    : ResponseCacheStore(parent)
+{
+}
+
+QByteArray ResponseCacheSharedMemoryStore::get(const QByteArray &key)
+{
+    return SharedMemoryCache::get(key);
+}
+
+bool ResponseCacheSharedMemoryStore::set(const QByteArray &key,
+                                         const QByteArray &value,
+                                         std::chrono::seconds ttl)
+{
+    return SharedMemoryCache::set(key, value, ttl);
+}
+
+bool ResponseCacheSharedMemoryStore::add(const QByteArray &key,
+                                         const QByteArray &value,
+                                         std::chrono::seconds ttl)
+{
+    return SharedMemoryCache::add(key, value, ttl);
+}
+
+bool ResponseCacheSharedMemoryStore::remove(const QByteArray &key)
+{
+    return SharedMemoryCache::remove(key);
+}
+
+#include "moc_responsecachesharedmemorystore.cpp"
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugins/ResponseCache/responsecache.h>
+
+namespace Cutelyst {
+
+/**
+ * \ingroup plugins
+ * \headerfile "" <Cutelyst/Plugins/ResponseCache/ResponseCacheSharedMemoryStore>
+ * \brief Keeps cached responses in memory shared by all worker processes.
+ *
+ * %ResponseCacheSharedMemoryStore uses the SharedMemoryCache plugin, that has to be
+ * registered in the application, to share cached responses and tag versions among the
+ * processes forked by the server. Only available on UNIX systems, in which case
+ * \c CUTELYST_RESPONSECACHE_WITH_SHAREDMEMORY is defined.
+ *
+ * \code{.cpp}
+ * bool MyApp::init()
+ * {
+ *     new SharedMemoryCache(this);
+ *     auto cache = new ResponseCache(this);
+ *     cache->setStorage(std::make_unique<ResponseCacheSharedMemoryStore>());
+ * }
+ * \endcode
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_RESPONSECACHE_EXPORT ResponseCacheSharedMemoryStore
+    : public ResponseCacheStore
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructs a new %ResponseCacheSharedMemoryStore object with the given \a parent.
+     */
+    explicit ResponseCacheSharedMemoryStore(QObject *parent = nullptr);
+
+    [[nodiscard]] QByteArray get(const QByteArray &key) override;
+
+    bool set(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) override;
+
+    bool add(const QByteArray &key, const QByteArray &value, std::chrono::seconds ttl) override;
+
+    bool remove(const QByteArray &key) override;
+};
+
+} // namespace Cutelyst
@@ -8,6 +8,7 @@
 
 #include <Cutelyst/Application>
 #include <Cutelyst/Context>
+#include <Cutelyst/ContextSlot>
 #include <Cutelyst/Engine>
 #include <Cutelyst/Response>
 
@@ -21,18 +22,18 @@ using namespace Qt::Literals::StringLiterals;
 
 Q_LOGGING_CATEGORY(C_SESSION, "cutelyst.plugin.session", QtWarningMsg)
 
-#define SESSION_VALUES u"_c_session_values"_s
-#define SESSION_EXPIRES u"_c_session_expires"_s
-#define SESSION_TRIED_LOADING_EXPIRES u"_c_session_tried_loading_expires"_s
-#define SESSION_EXTENDED_EXPIRES u"_c_session_extended_expires"_s
-#define SESSION_UPDATED u"_c_session_updated"_s
-#define SESSION_ID u"_c_session_id"_s
-#define SESSION_TRIED_LOADING_ID u"_c_session_tried_loading_id"_s
-#define SESSION_DELETED_ID u"_c_session_deleted_id"_s
-#define SESSION_DELETE_REASON u"_c_session_delete_reason"_s
-
 namespace {
 thread_local Session *m_instance = nullptr;
+
+ContextSlot<QVariantHash> valuesSlot;
+ContextSlot<qint64> expiresSlot;
+ContextSlot<bool> triedLoadingExpiresSlot;
+ContextSlot<qint64> extendedExpiresSlot;
+ContextSlot<bool> updatedSlot;
+ContextSlot<QByteArray> idSlot;
+ContextSlot<bool> triedLoadingIdSlot;
+ContextSlot<bool> deletedIdSlot;
+ContextSlot<QString> deleteReasonSlot;
 } // namespace
 
 Session::Session(Cutelyst::Application *parent)
@@ -79,7 +80,7 @@ bool Session::setup(Application *app)
         d->cookieSameSite = QNetworkCookie::SameSite::Strict;
     }
 
-    connect(app, &Application::afterDispatch, this, &SessionPrivate::_q_saveSession);
+    app->addAfterDispatchHook(this, &SessionPrivate::_q_saveSession);
     connect(app, &Application::postForked, this, [this] { m_instance = this; });
 
     if (!d->store) {
@@ -106,16 +107,15 @@ SessionStore *Session::storage() const
 QByteArray Session::id(Cutelyst::Context *c)
 {
     QByteArray ret;
-    const QVariant sid = c->stash(SESSION_ID);
-    if (sid.isNull()) {
+    if (const QByteArray *sid = idSlot.get(c)) {
+        ret = *sid;
+    } else {
         if (Q_UNLIKELY(!m_instance)) {
             qCCritical(C_SESSION) << "Session plugin not registered";
             return ret;
         }
 
         ret = SessionPrivate::loadSessionId(c, m_instance->d_ptr->sessionName);
-    } else {
-        ret = sid.toByteArray();
     }
 
     return ret;
@@ -123,9 +123,8 @@ QByteArray Session::id(Cutelyst::Context *c)
 
 qint64 Session::expires(Context *c)
 {
-    QVariant expires = c->stash(SESSION_EXTENDED_EXPIRES);
-    if (!expires.isNull()) {
-        return expires.toLongLong();
+    if (const qint64 *extended = extendedExpiresSlot.get(c)) {
+        return *extended;
     }
 
     if (Q_UNLIKELY(!m_instance)) {
@@ -133,7 +132,7 @@ qint64 Session::expires(Context *c)
         return 0;
     }
 
-    expires = SessionPrivate::loadSessionExpires(m_instance, c, id(c));
+    const QVariant expires = SessionPrivate::loadSessionExpires(m_instance, c, id(c));
     if (!expires.isNull()) {
         return SessionPrivate::extendSessionExpires(m_instance, c, expires.toLongLong());
     }
@@ -165,17 +164,17 @@ void Session::deleteSession(Context *c, const QString &reason)
 
 QString Session::deleteReason(Context *c)
 {
-    return c->stash(SESSION_DELETE_REASON).toString();
+    return deleteReasonSlot.value(c);
 }
 
 QVariant Session::value(Cutelyst::Context *c, const QString &key, const QVariant &defaultValue)
 {
-    QVariant ret     = defaultValue;
-    QVariant session = c->stash(SESSION_VALUES);
-    if (session.isNull()) {
-        session = SessionPrivate::loadSession(c);
+    if (const QVariantHash *values = valuesSlot.get(c)) {
+        return values->value(key, defaultValue);
     }
 
+    QVariant ret           = defaultValue;
+    const QVariant session = SessionPrivate::loadSession(c);
     if (!session.isNull()) {
         ret = session.toHash().value(key, defaultValue);
     }
@@ -185,76 +184,37 @@ QVariant Session::value(Cutelyst::Context *c, const QString &key, const QVariant
 
 void Session::setValue(Cutelyst::Context *c, const QString &key, const QVariant &value)
 {
-    QVariant session = c->stash(SESSION_VALUES);
-    if (session.isNull()) {
-        session = SessionPrivate::loadSession(c);
-        if (session.isNull()) {
-            if (Q_UNLIKELY(!m_instance)) {
-                qCCritical(C_SESSION) << "Session plugin not registered";
-                return;
-            }
-
-            SessionPrivate::createSessionIdIfNeeded(
-                m_instance, c, m_instance->d_ptr->sessionExpires);
-            session = SessionPrivate::initializeSessionData(m_instance, c);
-        }
+    QVariantHash *data = SessionPrivate::sessionValuesForUpdate(c);
+    if (!data) {
+        return;
     }
 
-    QVariantHash data = session.toHash();
-    data.insert(key, value);
-
-    c->setStash(SESSION_VALUES, data);
-    c->setStash(SESSION_UPDATED, true);
+    data->insert(key, value);
+    updatedSlot.set(c, true);
 }
 
 void Session::deleteValue(Context *c, const QString &key)
 {
-    QVariant session = c->stash(SESSION_VALUES);
-    if (session.isNull()) {
-        session = SessionPrivate::loadSession(c);
-        if (session.isNull()) {
-            if (Q_UNLIKELY(!m_instance)) {
-                qCCritical(C_SESSION) << "Session plugin not registered";
-                return;
-            }
-
-            SessionPrivate::createSessionIdIfNeeded(
-                m_instance, c, m_instance->d_ptr->sessionExpires);
-            session = SessionPrivate::initializeSessionData(m_instance, c);
-        }
+    QVariantHash *data = SessionPrivate::sessionValuesForUpdate(c);
+    if (!data) {
+        return;
     }
 
-    QVariantHash data = session.toHash();
-    data.remove(key);
-
-    c->setStash(SESSION_VALUES, data);
-    c->setStash(SESSION_UPDATED, true);
+    data->remove(key);
+    updatedSlot.set(c, true);
 }
 
 void Session::deleteValues(Context *c, const QStringList &keys)
 {
-    QVariant session = c->stash(SESSION_VALUES);
-    if (session.isNull()) {
-        session = SessionPrivate::loadSession(c);
-        if (session.isNull()) {
-            if (Q_UNLIKELY(!m_instance)) {
-                qCCritical(C_SESSION) << "Session plugin not registered";
-                return;
-            }
-
-            SessionPrivate::createSessionIdIfNeeded(
-                m_instance, c, m_instance->d_ptr->sessionExpires);
-            session = SessionPrivate::initializeSessionData(m_instance, c);
-        }
+    QVariantHash *data = SessionPrivate::sessionValuesForUpdate(c);
+    if (!data) {
+        return;
     }
 
-    QVariantHash data = session.toHash();
     for (const QString &key : keys) {
-        data.remove(key);
+        data->remove(key);
     }
-
-    c->setStash(SESSION_VALUES, data);
-    c->setStash(SESSION_UPDATED, true);
+    updatedSlot.set(c, true);
 }
 
 bool Session::isValid(Cutelyst::Context *c)
@@ -262,6 +222,26 @@ bool Session::isValid(Cutelyst::Context *c)
     return !SessionPrivate::loadSession(c).isNull();
 }
 
+QVariantHash *SessionPrivate::sessionValuesForUpdate(Context *c)
+{
+    if (QVariantHash *values = valuesSlot.get(c)) {
+        return values;
+    }
+
+    const QVariant session = SessionPrivate::loadSession(c);
+    if (!session.isNull()) {
+        return &valuesSlot.emplace(c, session.toHash());
+    }
+
+    if (Q_UNLIKELY(!m_instance)) {
+        qCCritical(C_SESSION) << "Session plugin not registered";
+        return nullptr;
+    }
+
+    SessionPrivate::createSessionIdIfNeeded(m_instance, c, m_instance->d_ptr->sessionExpires);
+    return &valuesSlot.emplace(c, SessionPrivate::initializeSessionData(m_instance, c).toHash());
+}
+
 QByteArray SessionPrivate::generateSessionId()
 {
     return QUuid::createUuid().toRfc4122().toHex();
@@ -270,10 +250,10 @@ QByteArray SessionPrivate::generateSessionId()
 QByteArray SessionPrivate::loadSessionId(Context *c, const QByteArray &sessionName)
 {
     QByteArray ret;
-    if (!c->stash(SESSION_TRIED_LOADING_ID).isNull()) {
+    if (triedLoadingIdSlot.value(c)) {
         return ret;
     }
-    c->setStash(SESSION_TRIED_LOADING_ID, true);
+    triedLoadingIdSlot.set(c, true);
 
     const QByteArray sid = getSessionId(c, sessionName);
     if (!sid.isEmpty()) {
@@ -282,7 +262,7 @@ QByteArray SessionPrivate::loadSessionId(Context *c, const QByteArray &sessionNa
             return ret;
         }
         ret = sid;
-        c->setStash(SESSION_ID, sid);
+        idSlot.set(c, sid);
     }
 
     return ret;
@@ -291,12 +271,11 @@ QByteArray SessionPrivate::loadSessionId(Context *c, const QByteArray &sessionNa
 QByteArray SessionPrivate::getSessionId(const Context *c, const QByteArray &sessionName)
 {
     QByteArray ret;
-    bool deleted = !c->stash(SESSION_DELETED_ID).isNull();
+    const bool deleted = deletedIdSlot.value(c);
 
     if (!deleted) {
-        const QVariant property = c->stash(SESSION_ID);
-        if (!property.isNull()) {
-            ret = property.toByteArray();
+        if (const QByteArray *sid = idSlot.get(c)) {
+            ret = *sid;
             return ret;
         }
 
@@ -313,9 +292,8 @@ QByteArray SessionPrivate::getSessionId(const Context *c, const QByteArray &sess
 QByteArray SessionPrivate::createSessionIdIfNeeded(Session *session, Context *c, qint64 expires)
 {
     QByteArray ret;
-    const QVariant sid = c->stash(SESSION_ID);
-    if (!sid.isNull()) {
-        ret = sid.toByteArray();
+    if (const QByteArray *sid = idSlot.get(c)) {
+        ret = *sid;
     } else {
         ret = createSessionId(session, c, expires);
     }
@@ -329,7 +307,7 @@ QByteArray SessionPrivate::createSessionId(Session *session, Context *c, qint64
 
     qCDebug(C_SESSION) << "Created session" << sid;
 
-    c->setStash(SESSION_ID, sid);
+    idSlot.set(c, sid);
     resetSessionExpires(session, c, sid);
     setSessionId(session, c, sid);
 
@@ -353,13 +331,13 @@ void SessionPrivate::_q_saveSession(Context *c)
     }
     saveSessionExpires(c);
 
-    if (!c->stash(SESSION_UPDATED).toBool()) {
+    if (!updatedSlot.value(c)) {
         return;
     }
-    QVariantHash sessionData = c->stash(SESSION_VALUES).toHash();
+    QVariantHash sessionData = valuesSlot.value(c);
     sessionData.insert(u"__updated"_s, QDateTime::currentSecsSinceEpoch());
 
-    const auto sid = c->stash(SESSION_ID).toByteArray();
+    const auto sid = idSlot.value(c);
     m_instance->d_ptr->store->storeSessionData(c, sid, u"session"_s, sessionData);
 }
 
@@ -367,9 +345,8 @@ void SessionPrivate::deleteSession(Session *session, Context *c, const QString &
 {
     qCDebug(C_SESSION) << "Deleting session" << reason;
 
-    const QVariant sidVar = c->stash(SESSION_ID).toString();
-    if (!sidVar.isNull()) {
-        const auto sid = sidVar.toByteArray();
+    if (idSlot.has(c)) {
+        const auto sid = idSlot.value(c);
         session->d_ptr->store->deleteSessionData(c, sid, u"session"_s);
         session->d_ptr->store->deleteSessionData(c, sid, u"expires"_s);
         session->d_ptr->store->deleteSessionData(c, sid, u"flash"_s);
@@ -378,16 +355,16 @@ void SessionPrivate::deleteSession(Session *session, Context *c, const QString &
     }
 
     // Reset the values in Context object
-    c->setStash(SESSION_VALUES, QVariant());
-    c->setStash(SESSION_ID, QVariant());
-    c->setStash(SESSION_EXPIRES, QVariant());
+    valuesSlot.reset(c);
+    idSlot.reset(c);
+    expiresSlot.reset(c);
 
-    c->setStash(SESSION_DELETE_REASON, reason);
+    deleteReasonSlot.set(c, reason);
 }
 
 void SessionPrivate::deleteSessionId(Session *session, Context *c, const QByteArray &sid)
 {
-    c->setStash(SESSION_DELETED_ID, true); // to prevent get_session_id from returning it
+    deletedIdSlot.set(c, true); // to prevent get_session_id from returning it
 
     updateSessionCookie(c, makeSessionCookie(session, c, sid, QDateTime::currentDateTimeUtc()));
 }
@@ -395,9 +372,8 @@ void SessionPrivate::deleteSessionId(Session *session, Context *c, const QByteAr
 QVariant SessionPrivate::loadSession(Context *c)
 {
     QVariant ret;
-    const QVariant property = c->stash(SESSION_VALUES);
-    if (!property.isNull()) {
-        ret = property.toHash();
+    if (const QVariantHash *values = valuesSlot.get(c)) {
+        ret = *values;
         return ret;
     }
 
@@ -412,7 +388,7 @@ QVariant SessionPrivate::loadSession(Context *c)
 
             const QVariantHash sessionData =
                 m_instance->d_ptr->store->getSessionData(c, sid, u"session"_s).toHash();
-            c->setStash(SESSION_VALUES, sessionData);
+            valuesSlot.set(c, sessionData);
 
             if (m_instance->d_ptr->verifyAddress) {
                 auto it = sessionData.constFind(u"__address"_s);
@@ -464,9 +440,9 @@ qint64 SessionPrivate::extendSessionExpires(Session *session, Context *c, qint64
         const qint64 cutoff  = current - threshold;
         const qint64 time    = QDateTime::currentSecsSinceEpoch();
 
-        if (!threshold || cutoff <= time || c->stash(SESSION_UPDATED).toBool()) {
+        if (!threshold || cutoff <= time || updatedSlot.value(c)) {
             qint64 updated = calculateInitialSessionExpires(session, c, sid);
-            c->setStash(SESSION_EXTENDED_EXPIRES, updated);
+            extendedExpiresSlot.set(c, updated);
             extendSessionId(session, c, sid, updated);
 
             return updated;
@@ -506,8 +482,7 @@ QVariant SessionPrivate::initializeSessionData(const Session *session, const Con
 
 void SessionPrivate::saveSessionExpires(Context *c)
 {
-    const QVariant expires = c->stash(SESSION_EXPIRES);
-    if (!expires.isNull()) {
+    if (expiresSlot.has(c)) {
         const auto sid = Session::id(c);
         if (!sid.isEmpty()) {
             if (Q_UNLIKELY(!m_instance)) {
@@ -528,17 +503,19 @@ QVariant
     SessionPrivate::loadSessionExpires(Session *session, Context *c, const QByteArray &sessionId)
 {
     QVariant ret;
-    if (c->stash(SESSION_TRIED_LOADING_EXPIRES).toBool()) {
-        ret = c->stash(SESSION_EXPIRES);
+    if (triedLoadingExpiresSlot.value(c)) {
+        if (const qint64 *expires = expiresSlot.get(c)) {
+            ret = *expires;
+        }
         return ret;
     }
-    c->setStash(SESSION_TRIED_LOADING_EXPIRES, true);
+    triedLoadingExpiresSlot.set(c, true);
 
     if (!sessionId.isEmpty()) {
         const qint64 expires = getStoredSessionExpires(session, c, sessionId);
 
         if (expires >= QDateTime::currentSecsSinceEpoch()) {
-            c->setStash(SESSION_EXPIRES, expires);
+            expiresSlot.set(c, expires);
             ret = expires;
         } else {
             deleteSession(session, c, u"session expired"_s);
@@ -569,12 +546,12 @@ qint64
 {
     const qint64 exp = calculateInitialSessionExpires(session, c, sessionId);
 
-    c->setStash(SESSION_EXPIRES, exp);
+    expiresSlot.set(c, exp);
 
     // since we're setting _session_expires directly, make loadSessionExpires
     // actually use that value.
-    c->setStash(SESSION_TRIED_LOADING_EXPIRES, true);
-    c->setStash(SESSION_EXTENDED_EXPIRES, exp);
+    triedLoadingExpiresSlot.set(c, true);
+    extendedExpiresSlot.set(c, exp);
 
     return exp;
 }
@@ -78,7 +78,8 @@ class SessionPrivate;
  * The %Session plugin manages user sessions and uses a SessionStore to store the session
  * data. %Cutelyst already ships with session stores to store sessions in the
  * @link SessionStoreFile filesystem@endlink and on @link MemcachedSessionStore memcached@endlink
- * servers. You can create your own session store by creating a new subclass of SessionStore
+ * servers, on UNIX systems SessionStoreSharedMemory keeps them in memory shared by all worker
+ * processes. You can create your own session store by creating a new subclass of SessionStore
  * and set it to this plugin using setStorage().
  *
  * By default, if no session store has been manually set, a SessionStoreFile will be used.
@@ -29,6 +29,7 @@ public:
     static void deleteSession(Session *session, Context *c, const QString &reason);
     static inline void deleteSessionId(Session *session, Context *c, const QByteArray &sid);
     static QVariant loadSession(Context *c);
+    static QVariantHash *sessionValuesForUpdate(Context *c);
     static bool validateSessionId(QByteArrayView id);
     static qint64 extendSessionExpires(Session *session, Context *c, qint64 expires);
     static qint64
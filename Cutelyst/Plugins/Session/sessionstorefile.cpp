@@ -6,6 +6,7 @@
 
 #include <Cutelyst/Application>
 #include <Cutelyst/Context>
+#include <Cutelyst/ContextSlot>
 
 #include <QCoreApplication>
 #include <QDataStream>
@@ -19,10 +20,10 @@ using namespace Qt::StringLiterals;
 
 Q_LOGGING_CATEGORY(C_SESSION_FILE, "cutelyst.plugin.sessionfile", QtWarningMsg)
 
-#define SESSION_STORE_FILE_SAVE u"_c_session_store_file_save"_s
-#define SESSION_STORE_FILE_DATA u"_c_session_store_file_data"_s
-
 namespace {
+ContextSlot<bool> saveSlot;
+ContextSlot<QVariantHash> dataSlot;
+
 QVariantHash loadSessionData(Context *c, const QByteArray &sid);
 
 inline QString rootPath()
@@ -60,8 +61,8 @@ bool SessionStoreFile::storeSessionData(Context *c,
     QVariantHash data = loadSessionData(c, sid);
 
     data.insert(key, value);
-    c->setStash(SESSION_STORE_FILE_DATA, data);
-    c->setStash(SESSION_STORE_FILE_SAVE, true);
+    dataSlot.set(c, std::move(data));
+    saveSlot.set(c, true);
 
     return true;
 }
@@ -71,8 +72,8 @@ bool SessionStoreFile::deleteSessionData(Context *c, const QByteArray &sid, cons
     QVariantHash data = loadSessionData(c, sid);
 
     data.remove(key);
-    c->setStash(SESSION_STORE_FILE_DATA, data);
-    c->setStash(SESSION_STORE_FILE_SAVE, true);
+    dataSlot.set(c, std::move(data));
+    saveSlot.set(c, true);
 
     return true;
 }
@@ -91,9 +92,8 @@ namespace {
 QVariantHash loadSessionData(Context *c, const QByteArray &sid)
 {
     QVariantHash data;
-    const QVariant sessionVariant = c->stash(SESSION_STORE_FILE_DATA);
-    if (!sessionVariant.isNull()) {
-        data = sessionVariant.toHash();
+    if (const QVariantHash *sessionData = dataSlot.get(c)) {
+        data = *sessionData;
         return data;
     }
 
@@ -111,13 +111,13 @@ QVariantHash loadSessionData(Context *c, const QByteArray &sid)
         }
     }
 
-    // Commit data when Context gets deleted
-    QObject::connect(c->app(), &Application::afterDispatch, c, [c, file] {
-        if (!c->stash(SESSION_STORE_FILE_SAVE).toBool()) {
+    // Commit data once the request was dispatched
+    c->addAfterDispatchHook([file](Context *c) {
+        if (!saveSlot.value(c)) {
             return;
         }
 
-        const QVariantHash data = c->stash(SESSION_STORE_FILE_DATA).toHash();
+        const QVariantHash data = dataSlot.value(c);
 
         if (data.isEmpty()) {
             QFile::remove(file->fileName());
@@ -150,7 +150,7 @@ QVariantHash loadSessionData(Context *c, const QByteArray &sid)
         lock.unlock();
     }
 
-    c->setStash(SESSION_STORE_FILE_DATA, data);
+    dataSlot.set(c, data);
 
     return data;
 }
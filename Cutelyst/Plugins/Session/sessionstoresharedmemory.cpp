@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "sessionstoresharedmemory.h"
+
+#include <Cutelyst/Context>
+#include <Cutelyst/ContextSlot>
+#include <Cutelyst/Plugins/Cache/SharedMemoryCache>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QLoggingCategory>
+
+using namespace Cutelyst;
+using namespace Qt::StringLiterals;
+
+Q_LOGGING_CATEGORY(C_SESSION_SHAREDMEMORY, "cutelyst.plugin.sessionsharedmemory", QtWarningMsg)
+
+namespace {
+ContextSlot<bool> saveSlot;
+ContextSlot<QVariantHash> dataSlot;
+
+QVariantHash loadSessionData(Context *c, const QByteArray &sid);
+} // namespace
+
+SessionStoreSharedMemory::SessionStoreSharedMemory(QObject *parent)
+    : SessionStore(parent)
+{
+}
+
+SessionStoreSharedMemory::~SessionStoreSharedMemory() = default;
+
+QVariant SessionStoreSharedMemory::getSessionData(Context *c,
+                                                  const QByteArray &sid,
+                                                  const QString &key,
+                                                  const QVariant &defaultValue)
+{
+    const QVariantHash data = loadSessionData(c, sid);
+
+    return data.value(key, defaultValue);
+}
+
+bool SessionStoreSharedMemory::storeSessionData(Context *c,
+                                                const QByteArray &sid,
+                                                const QString &key,
+                                                const QVariant &value)
+{
+    QVariantHash data = loadSessionData(c, sid);
+
+    data.insert(key, value);
+    dataSlot.set(c, std::move(data));
+    saveSlot.set(c, true);
+
+    return true;
+}
+
+bool SessionStoreSharedMemory::deleteSessionData(Context *c,
+                                                 const QByteArray &sid,
+                                                 const QString &key)
+{
+    QVariantHash data = loadSessionData(c, sid);
+
+    data.remove(key);
+    dataSlot.set(c, std::move(data));
+    saveSlot.set(c, true);
+
+    return true;
+}
+
+bool SessionStoreSharedMemory::deleteExpiredSessions(Context *c, quint64 expires)
+{
+    Q_UNUSED(c)
+    Q_UNUSED(expires)
+    return true;
+}
+
+namespace {
+QVariantHash loadSessionData(Context *c, const QByteArray &sid)
+{
+    QVariantHash data;
+    if (const QVariantHash *sessionData = dataSlot.get(c)) {
+        data = *sessionData;
+        return data;
+    }
+
+    const static QByteArray sessionPrefix =
+        QCoreApplication::applicationName().toLatin1() + "_sess_";
+    const QByteArray sessionKey = sessionPrefix + sid;
+
+    // Commit data once the request was dispatched
+    c->addAfterDispatchHook([sessionKey](Context *c) {
+        if (!saveSlot.value(c)) {
+            return;
+        }
+
+        const QVariantHash data = dataSlot.value(c);
+        const qint64 ttl =
+            data.value(u"expires"_s).toLongLong() - QDateTime::currentSecsSinceEpoch();
+
+        if (data.isEmpty() || ttl <= 0) {
+            SharedMemoryCache::remove(sessionKey);
+            return;
+        }
+
+        QByteArray value;
+        QDataStream out(&value, QIODevice::WriteOnly);
+        out << data;
+
+        if (!SharedMemoryCache::set(sessionKey, value, std::chrono::seconds{ttl})) {
+            qCWarning(C_SESSION_SHAREDMEMORY) << "Failed to store session" << sessionKey;
+        }
+    });
+
+    const QByteArray value = SharedMemoryCache::get(sessionKey);
+    if (!value.isNull()) {
+        QDataStream in(value);
+        in >> data;
+    }
+
+    dataSlot.set(c, data);
+
+    return data;
+}
+} // namespace
+
+#include "moc_sessionstoresharedmemory.cpp"
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/Plugins/Session/session.h>
+
+namespace Cutelyst {
+
+/**
+ * @ingroup plugins-session
+ * @headerfile "" <Cutelyst/Plugins/Session/sessionstoresharedmemory.h>
+ * @brief A session store that keeps user sessions in memory shared by all worker processes.
+ *
+ * This session store keeps the session data in the SharedMemoryCache plugin, that has to be
+ * registered in the application. Sessions are shared by all processes forked by the server
+ * and expire together with their session cookie, but they are lost when the server stops
+ * and might be evicted when the shared memory is full. Only available on UNIX systems.
+ *
+ * @code{.cpp}
+ * bool MyCutelystApp::init()
+ * {
+ *      new SharedMemoryCache(this);
+ *
+ *      auto sess = new Session(this);
+ *      sess->setStorage(std::make_unique<SessionStoreSharedMemory>(sess));
+ * }
+ * @endcode
+ *
+ * @logcat{plugin.sessionsharedmemory}
+ *
+ * @since Cutelyst 5.1.0
+ */
+class CUTELYST_PLUGIN_SESSION_EXPORT SessionStoreSharedMemory : public SessionStore
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructs a new %SessionStoreSharedMemory object with the given @p parent.
+     */
+    explicit SessionStoreSharedMemory(QObject *parent = nullptr);
+
+    /**
+     * Destroys the %SessionStoreSharedMemory object.
+     */
+    ~SessionStoreSharedMemory() override;
+
+    /**
+     * Reimplemented from SessionStore::getSessionData().
+     */
+    QVariant getSessionData(Context *c,
+                            const QByteArray &sid,
+                            const QString &key,
+                            const QVariant &defaultValue) final;
+
+    /**
+     * Reimplemented from SessionStore::storeSessionData().
+     */
+    bool storeSessionData(Context *c,
+                          const QByteArray &sid,
+                          const QString &key,
+                          const QVariant &value) final;
+
+    /**
+     * Reimplemented from SessionStore::deleteSessionData().
+     */
+    bool deleteSessionData(Context *c, const QByteArray &sid, const QString &key) final;
+
+    /**
+     * Reimplemented from SessionStore::deleteExpiredSessions(), entries expire by themselves.
+     */
+    bool deleteExpiredSessions(Context *c, quint64 expires) final;
+};
+
+} // namespace Cutelyst
@@ -4,6 +4,7 @@
  */
 
 #include "staticcompressed_p.h"
+#include "staticcompressedmanifest_p.h"
 
 #include <Cutelyst/Application>
 #include <Cutelyst/Context>
@@ -21,6 +22,7 @@
 #include <QLockFile>
 #include <QLoggingCategory>
 #include <QMimeDatabase>
+#include <QSaveFile>
 #include <QStandardPaths>
 
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_BROTLI
@@ -125,23 +127,18 @@ bool StaticCompressed::setup(Application *app)
                                  .toBool();
     qCInfo(C_STATICCOMPRESSED) << "Compress static files on the fly:" << d->onTheFlyCompression;
 
-    QStringList supportedCompressions{u"deflate"_s, u"gzip"_s};
-    d->loadZlibConfig(config);
+    if (Q_UNLIKELY(!d->loadCompressorConfig(config))) {
+        return false;
+    }
 
+    QStringList supportedCompressions{u"deflate"_s, u"gzip"_s};
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_ZOPFLI
-    d->loadZopfliConfig(config);
     qCInfo(C_STATICCOMPRESSED) << "Use Zopfli:" << d->useZopfli;
 #endif
-
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_BROTLI
-    d->loadBrotliConfig(config);
     supportedCompressions << u"br"_s;
 #endif
-
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_ZSTD
-    if (Q_UNLIKELY(!d->loadZstdConfig(config))) {
-        return false;
-    }
     supportedCompressions << u"zstd"_s;
 #endif
 
@@ -188,7 +185,19 @@ bool StaticCompressed::setup(Application *app)
                                << d->compressionFormatOrder.join(u',');
     qCInfo(C_STATICCOMPRESSED) << "Include paths:" << d->includePaths;
 
-    connect(app, &Application::beforePrepareAction, this, [d](Context *c, bool *skipMethod) {
+    const bool preCompress =
+        config.value(u"pre_compress"_s, d->defaultConfig.value(u"pre_compress"_s, false)).toBool();
+    qCInfo(C_STATICCOMPRESSED) << "Compress static files in the background:" << preCompress;
+    if (preCompress) {
+        d->backgroundCompression = true;
+        // Threads and the inotify descriptor don't survive a fork, each process needs its own,
+        // they share the cache directory where files already compressed by another are skipped
+        connect(app, &Application::postForked, this, [d, config] {
+            d->manifest = StaticCompressedManifest::instance(*d, config);
+        });
+    }
+
+    app->addBeforePrepareActionHook(this, [d](Context *c, bool *skipMethod) {
         d->beforePrepareAction(c, skipMethod);
     });
 
@@ -235,149 +244,179 @@ void StaticCompressedPrivate::beforePrepareAction(Context *c, bool *skipMethod)
 
 bool StaticCompressedPrivate::locateCompressedFile(Context *c, const QString &relPath) const
 {
+    if (manifest) {
+        if (const auto entry = manifest->entry(relPath)) {
+            if (!c->req()->headers().ifModifiedSince(entry->lastModified)) {
+                c->res()->setStatus(Response::NotModified);
+                return true;
+            }
+
+            const auto acceptEncoding = c->req()->header("Accept-Encoding");
+            for (const QString &format : std::as_const(compressionFormatOrder)) {
+                const auto variant = entry->variants.constFind(format);
+                if (variant != entry->variants.cend() &&
+                    acceptEncoding.contains(format.toLatin1())) {
+                    return serveFile(c,
+                                     entry->path,
+                                     entry->lastModified,
+                                     entry->contentType,
+                                     variant->path,
+                                     format.toLatin1());
+                }
+            }
+
+            if (serveFile(
+                    c, entry->path, entry->lastModified, entry->contentType, {}, {})) {
+                return true;
+            }
+            // The file is gone, the watcher will update the manifest
+        }
+    }
+
     for (const QDir &includePath : includePaths) {
         qCDebug(C_STATICCOMPRESSED)
             << "Trying to find" << relPath << "in" << includePath.absolutePath();
         const QString path = includePath.absoluteFilePath(relPath);
         const QFileInfo fileInfo(path);
         if (fileInfo.exists()) {
-            Response *res                   = c->res();
             const QDateTime currentDateTime = fileInfo.lastModified();
             if (!c->req()->headers().ifModifiedSince(currentDateTime)) {
-                res->setStatus(Response::NotModified);
+                c->res()->setStatus(Response::NotModified);
                 return true;
             }
 
-            static QMimeDatabase db;
-            // use the extension to match to be faster
-            const QMimeType mimeType = db.mimeTypeForFile(path, QMimeDatabase::MatchExtension);
+            const FileType type = fileType(path);
             QByteArray contentEncoding;
             QString compressedPath;
-            QByteArray _mimeTypeName;
 
-            if (mimeType.isValid()) {
+            if (type.compress) {
+                const auto acceptEncoding = c->req()->header("Accept-Encoding");
 
-                // QMimeDatabase might not find the correct mime type for some specific types
-                // especially for map files for CSS and JS
-                if (mimeType.isDefault()) {
-                    if (path.endsWith(u"css.map", Qt::CaseInsensitive) ||
-                        path.endsWith(u"js.map", Qt::CaseInsensitive)) {
-                        _mimeTypeName = "application/json"_ba;
+                for (const QString &format : std::as_const(compressionFormatOrder)) {
+                    const auto compression = compressionFor(format);
+                    if (!compression || !acceptEncoding.contains(format.toLatin1())) {
+                        continue;
                     }
-                }
 
-                if (mimeTypes.contains(mimeType.name(), Qt::CaseInsensitive) ||
-                    suffixes.contains(fileInfo.completeSuffix(), Qt::CaseInsensitive)) {
-
-                    const auto acceptEncoding = c->req()->header("Accept-Encoding");
-
-                    for (const QString &format : std::as_const(compressionFormatOrder)) {
-                        if (!acceptEncoding.contains(format.toLatin1())) {
-                            continue;
-                        }
-#ifdef CUTELYST_STATICCOMPRESSED_WITH_BROTLI
-                        if (format == u"br") {
-                            compressedPath = locateCacheFile(path, currentDateTime, Brotli);
-                            if (compressedPath.isEmpty()) {
-                                continue;
-                            } else {
-                                qCDebug(C_STATICCOMPRESSED)
-                                    << "Serving brotli compressed data from" << compressedPath;
-                                contentEncoding = "br"_ba;
-                                break;
-                            }
-                        } else
-#endif
-#ifdef CUTELYST_STATICCOMPRESSED_WITH_ZSTD
-                            if (format == u"zstd") {
-                            compressedPath = locateCacheFile(path, currentDateTime, Zstd);
-                            if (compressedPath.isEmpty()) {
-                                continue;
-                            } else {
-                                qCDebug(C_STATICCOMPRESSED)
-                                    << "Serving zstd compressed data from" << compressedPath;
-                                contentEncoding = "zstd"_ba;
-                                break;
-                            }
-                        } else
-#endif
-                            if (format == u"gzip") {
-                            compressedPath = locateCacheFile(
-                                path, currentDateTime, useZopfli ? ZopfliGzip : Gzip);
-                            if (compressedPath.isEmpty()) {
-                                continue;
-                            } else {
-                                qCDebug(C_STATICCOMPRESSED)
-                                    << "Serving" << (useZopfli ? "zopfli" : "default")
-                                    << "compressed gzip data from" << compressedPath;
-                                contentEncoding = "gzip"_ba;
-                                break;
-                            }
-                        } else if (format == u"deflate") {
-                            compressedPath = locateCacheFile(
-                                path, currentDateTime, useZopfli ? ZopfliDeflate : Deflate);
-                            if (compressedPath.isEmpty()) {
-                                continue;
-                            } else {
-                                qCDebug(C_STATICCOMPRESSED)
-                                    << "Serving" << (useZopfli ? "zopfli" : "default")
-                                    << "compressed deflate data from" << compressedPath;
-                                contentEncoding = "deflate"_ba;
-                                break;
-                            }
-                        }
+                    compressedPath = locateCacheFile(path, currentDateTime, *compression);
+                    if (!compressedPath.isEmpty()) {
+                        qCDebug(C_STATICCOMPRESSED)
+                            << "Serving" << format << "compressed data from" << compressedPath;
+                        contentEncoding = format.toLatin1();
+                        break;
                     }
                 }
             }
 
-            // Response::setBody() will take the ownership
-            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-            QFile *file = !compressedPath.isEmpty() ? new QFile(compressedPath) : new QFile(path);
-            if (file->open(QFile::ReadOnly)) {
-                qCDebug(C_STATICCOMPRESSED) << "Serving" << path;
-                Headers &headers = res->headers();
-
-                // set our open file
-                res->setBody(file);
-
-                // if we have a mime type determine from the extension,
-                // do not use the name from the mime database
-                if (!_mimeTypeName.isEmpty()) {
-                    headers.setContentType(_mimeTypeName);
-                } else if (mimeType.isValid()) {
-                    headers.setContentType(mimeType.name().toLatin1());
-                }
-                headers.setContentLength(file->size());
+            return serveFile(c,
+                             path,
+                             currentDateTime,
+                             type.contentType,
+                             compressedPath,
+                             contentEncoding);
+        }
+    }
 
-                headers.setLastModified(currentDateTime);
-                // Tell Firefox & friends its OK to cache, even over SSL
-                headers.setCacheControl("public"_ba);
+    qCWarning(C_STATICCOMPRESSED) << "File not found" << relPath;
+    return false;
+}
 
-                if (!contentEncoding.isEmpty()) {
-                    // serve correct encoding type
-                    headers.setContentEncoding(contentEncoding);
+bool StaticCompressedPrivate::serveFile(Context *c,
+                                        const QString &path,
+                                        const QDateTime &lastModified,
+                                        const QByteArray &contentType,
+                                        const QString &compressedPath,
+                                        const QByteArray &contentEncoding) const
+{
+    // Response::setBody() will take the ownership
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    QFile *file = !compressedPath.isEmpty() ? new QFile(compressedPath) : new QFile(path);
+    if (file->open(QFile::ReadOnly)) {
+        qCDebug(C_STATICCOMPRESSED) << "Serving" << path;
+        Response *res    = c->res();
+        Headers &headers = res->headers();
+
+        // set our open file
+        res->setBody(file);
+
+        if (!contentType.isEmpty()) {
+            headers.setContentType(contentType);
+        }
+        // The manifest might be older than the file, which can be replaced at any time
+        headers.setContentLength(file->size());
 
-                    qCDebug(C_STATICCOMPRESSED)
-                        << "Encoding:" << headers.contentEncoding() << "Size:" << file->size()
-                        << "Original Size:" << fileInfo.size();
+        headers.setLastModified(lastModified);
+        // Tell Firefox & friends its OK to cache, even over SSL
+        headers.setCacheControl("public"_ba);
 
-                    // force proxies to cache compressed and non-compressed files separately
-                    headers.pushHeader("Vary"_ba, "Accept-Encoding"_ba);
-                }
+        if (!contentEncoding.isEmpty()) {
+            // serve correct encoding type
+            headers.setContentEncoding(contentEncoding);
 
-                return true;
-            }
+            qCDebug(C_STATICCOMPRESSED) << "Encoding:" << headers.contentEncoding()
+                                        << "Size:" << headers.contentLength();
 
-            qCWarning(C_STATICCOMPRESSED) << "Could not serve" << path << file->errorString();
-            delete file;
-            return false;
+            // force proxies to cache compressed and non-compressed files separately
+            headers.pushHeader("Vary"_ba, "Accept-Encoding"_ba);
+        } else {
+            // Range requests are answered by EngineRequest
+            headers.setHeader("Accept-Ranges"_ba, "bytes"_ba);
         }
+
+        return true;
     }
 
-    qCWarning(C_STATICCOMPRESSED) << "File not found" << relPath;
+    qCWarning(C_STATICCOMPRESSED) << "Could not serve" << path << file->errorString();
+    delete file;
     return false;
 }
 
+StaticCompressedPrivate::FileType StaticCompressedPrivate::fileType(const QString &path) const
+{
+    static QMimeDatabase db;
+    // use the extension to match to be faster
+    const QMimeType mimeType = db.mimeTypeForFile(path, QMimeDatabase::MatchExtension);
+
+    FileType type;
+    if (mimeType.isValid()) {
+        type.contentType = mimeType.name().toLatin1();
+
+        // QMimeDatabase might not find the correct mime type for some specific types
+        // especially for map files for CSS and JS
+        if (mimeType.isDefault()) {
+            if (path.endsWith(u"css.map", Qt::CaseInsensitive) ||
+                path.endsWith(u"js.map", Qt::CaseInsensitive)) {
+                type.contentType = "application/json"_ba;
+            }
+        }
+
+        type.compress = mimeTypes.contains(mimeType.name(), Qt::CaseInsensitive) ||
+                        suffixes.contains(QFileInfo(path).completeSuffix(), Qt::CaseInsensitive);
+    }
+    return type;
+}
+
+std::optional<StaticCompressedPrivate::Compression>
+    StaticCompressedPrivate::compressionFor(QStringView format) const
+{
+#ifdef CUTELYST_STATICCOMPRESSED_WITH_BROTLI
+    if (format == u"br") {
+        return Brotli;
+    }
+#endif
+#ifdef CUTELYST_STATICCOMPRESSED_WITH_ZSTD
+    if (format == u"zstd") {
+        return Zstd;
+    }
+#endif
+    if (format == u"gzip") {
+        return useZopfli ? ZopfliGzip : Gzip;
+    } else if (format == u"deflate") {
+        return useZopfli ? ZopfliDeflate : Deflate;
+    }
+    return {};
+}
+
 QString StaticCompressedPrivate::locateCacheFile(const QString &origPath,
                                                  const QDateTime &origLastModified,
                                                  Compression compression) const
@@ -429,49 +468,60 @@ QString StaticCompressedPrivate::locateCacheFile(const QString &origPath,
         if (info.exists() && (info.lastModified() > origLastModified)) {
             compressedPath = path;
         } else {
+            if (backgroundCompression) {
+                // The manifest compresses it, the original is served meanwhile
+                return compressedPath;
+            }
+
             QLockFile lock(path + u".lock");
-            if (lock.tryLock(std::chrono::milliseconds{10})) {
-                switch (compression) {
+            if (lock.tryLock(lockTimeout)) {
+                // It might have been written while waiting for the lock
+                const QFileInfo locked(path);
+                if (locked.exists() && locked.lastModified() > origLastModified) {
+                    compressedPath = path;
+                } else {
+                    switch (compression) {
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_ZSTD
-                case Zstd:
-                    if (compressZstd(origPath, path)) {
-                        compressedPath = path;
-                    }
-                    break;
+                    case Zstd:
+                        if (compressZstd(origPath, path)) {
+                            compressedPath = path;
+                        }
+                        break;
 #endif
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_BROTLI
-                case Brotli:
-                    if (compressBrotli(origPath, path)) {
-                        compressedPath = path;
-                    }
-                    break;
+                    case Brotli:
+                        if (compressBrotli(origPath, path)) {
+                            compressedPath = path;
+                        }
+                        break;
 #endif
-                case ZopfliGzip:
+                    case ZopfliGzip:
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_ZOPFLI
-                    if (compressZopfli(origPath, path, ZopfliFormat::ZOPFLI_FORMAT_GZIP)) {
-                        compressedPath = path;
-                    }
-                    break;
+                        if (compressZopfli(origPath, path, ZopfliFormat::ZOPFLI_FORMAT_GZIP)) {
+                            compressedPath = path;
+                        }
+                        break;
 #endif
-                case Gzip:
-                    if (compressGzip(origPath, path, origLastModified)) {
-                        compressedPath = path;
-                    }
-                    break;
-                case ZopfliDeflate:
+                    case Gzip:
+                        if (compressGzip(origPath, path, origLastModified)) {
+                            compressedPath = path;
+                        }
+                        break;
+                    case ZopfliDeflate:
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_ZOPFLI
-                    if (compressZopfli(origPath, path, ZopfliFormat::ZOPFLI_FORMAT_ZLIB)) {
-                        compressedPath = path;
-                    }
-                    break;
+                        if (compressZopfli(origPath, path, ZopfliFormat::ZOPFLI_FORMAT_ZLIB)) {
+                            compressedPath = path;
+                        }
+                        break;
 #endif
-                case Deflate:
-                    if (compressDeflate(origPath, path)) {
-                        compressedPath = path;
+                    case Deflate:
+                        if (compressDeflate(origPath, path)) {
+                            compressedPath = path;
+                        }
+                        break;
+                    default:
+                        break;
                     }
-                    break;
-                default:
-                    break;
                 }
                 lock.unlock();
             }
@@ -481,6 +531,23 @@ QString StaticCompressedPrivate::locateCacheFile(const QString &origPath,
     return compressedPath;
 }
 
+bool StaticCompressedPrivate::loadCompressorConfig(const QVariantMap &conf)
+{
+    loadZlibConfig(conf);
+#ifdef CUTELYST_STATICCOMPRESSED_WITH_ZOPFLI
+    loadZopfliConfig(conf);
+#endif
+#ifdef CUTELYST_STATICCOMPRESSED_WITH_BROTLI
+    loadBrotliConfig(conf);
+#endif
+#ifdef CUTELYST_STATICCOMPRESSED_WITH_ZSTD
+    if (Q_UNLIKELY(!loadZstdConfig(conf))) {
+        return false;
+    }
+#endif
+    return true;
+}
+
 void StaticCompressedPrivate::loadZlibConfig(const QVariantMap &conf)
 {
     bool ok = false;
@@ -555,22 +622,17 @@ bool StaticCompressedPrivate::compressGzip(const QString &inputPath,
     QByteArray compressedData = qCompress(data, zlib.compressionLevel);
     input.close();
 
-    QFile output(outputPath);
-    if (Q_UNLIKELY(!output.open(QIODevice::WriteOnly))) {
+    if (Q_UNLIKELY(compressedData.isEmpty())) {
         qCWarning(C_STATICCOMPRESSED)
-            << "Can not open output file to compress with gzip:" << outputPath;
+            << "Failed to compress file with gzip, compressed data is empty:" << inputPath;
         return false;
     }
 
-    if (Q_UNLIKELY(compressedData.isEmpty())) {
+    // Only renamed over the output once complete, other processes might be serving it
+    QSaveFile output(outputPath);
+    if (Q_UNLIKELY(!output.open(QIODevice::WriteOnly))) {
         qCWarning(C_STATICCOMPRESSED)
-            << "Failed to compress file with gzip, compressed data is empty:" << inputPath;
-        if (output.exists()) {
-            if (Q_UNLIKELY(!output.remove())) {
-                qCWarning(C_STATICCOMPRESSED)
-                    << "Can not remove invalid compressed gzip file:" << outputPath;
-            }
-        }
+            << "Can not open output file to compress with gzip:" << outputPath;
         return false;
     }
 
@@ -611,7 +673,7 @@ bool StaticCompressedPrivate::compressGzip(const QString &inputPath,
                  << static_cast<quint8>((inSize >> 16) % 256)
                  << static_cast<quint8>((inSize >> 24) % 256);
 
-    if (Q_UNLIKELY(output.write(header + compressedData + footer) < 0)) {
+    if (Q_UNLIKELY(output.write(header + compressedData + footer) < 0 || !output.commit())) {
         qCCritical(C_STATICCOMPRESSED).nospace()
             << "Failed to write compressed gzip file " << inputPath << ": " << output.errorString();
         return false;
@@ -643,29 +705,24 @@ bool StaticCompressedPrivate::compressDeflate(const QString &inputPath,
     QByteArray compressedData = qCompress(data, zlib.compressionLevel);
     input.close();
 
-    QFile output(outputPath);
-    if (Q_UNLIKELY(!output.open(QIODevice::WriteOnly))) {
+    if (Q_UNLIKELY(compressedData.isEmpty())) {
         qCWarning(C_STATICCOMPRESSED)
-            << "Can not open output file to compress with deflate:" << outputPath;
+            << "Failed to compress file with deflate, compressed data is empty:" << inputPath;
         return false;
     }
 
-    if (Q_UNLIKELY(compressedData.isEmpty())) {
+    // Only renamed over the output once complete, other processes might be serving it
+    QSaveFile output(outputPath);
+    if (Q_UNLIKELY(!output.open(QIODevice::WriteOnly))) {
         qCWarning(C_STATICCOMPRESSED)
-            << "Failed to compress file with deflate, compressed data is empty:" << inputPath;
-        if (output.exists()) {
-            if (Q_UNLIKELY(!output.remove())) {
-                qCWarning(C_STATICCOMPRESSED)
-                    << "Can not remove invalid compressed deflate file:" << outputPath;
-            }
-        }
+            << "Can not open output file to compress with deflate:" << outputPath;
         return false;
     }
 
     // Strip the first four bytes (a 4-byte length header put on by qCompress)
     compressedData.remove(0, 4);
 
-    if (Q_UNLIKELY(output.write(compressedData) < 0)) {
+    if (Q_UNLIKELY(output.write(compressedData) < 0 || !output.commit())) {
         qCCritical(C_STATICCOMPRESSED).nospace() << "Failed to write compressed deflate file "
                                                  << inputPath << ": " << output.errorString();
         return false;
@@ -734,7 +791,7 @@ bool StaticCompressedPrivate::compressZopfli(const QString &inputPath,
         return false;
     }
 
-    QFile output{outputPath};
+    QSaveFile output{outputPath};
     if (Q_UNLIKELY(!output.open(QIODeviceBase::WriteOnly))) {
         qCWarning(C_STATICCOMPRESSED) << "Failed to open output file" << outputPath
                                       << "for zopfli compression:" << output.errorString();
@@ -742,13 +799,8 @@ bool StaticCompressedPrivate::compressZopfli(const QString &inputPath,
         return false;
     }
 
-    if (Q_UNLIKELY(output.write(reinterpret_cast<const char *>(out), outSize) < 0)) {
-        if (output.exists()) {
-            if (Q_UNLIKELY(!output.remove())) {
-                qCWarning(C_STATICCOMPRESSED)
-                    << "Can not remove invalid compressed zopfli file:" << outputPath;
-            }
-        }
+    if (Q_UNLIKELY(output.write(reinterpret_cast<const char *>(out), outSize) < 0 ||
+                   !output.commit())) {
         qCWarning(C_STATICCOMPRESSED) << "Failed to write zopfli compressed data to output file"
                                       << outputPath << ":" << output.errorString();
         free(out);
@@ -827,20 +879,14 @@ bool StaticCompressedPrivate::compressBrotli(const QString &inputPath,
 
     outData.resize(static_cast<qsizetype>(outSize));
 
-    QFile output{outputPath};
+    QSaveFile output{outputPath};
     if (Q_UNLIKELY(!output.open(QIODeviceBase::WriteOnly))) {
         qCWarning(C_STATICCOMPRESSED) << "Failed to open output file" << outputPath
                                       << "for brotli compression:" << output.errorString();
         return false;
     }
 
-    if (Q_UNLIKELY(output.write(outData) < 0)) {
-        if (output.exists()) {
-            if (Q_UNLIKELY(!output.remove())) {
-                qCWarning(C_STATICCOMPRESSED)
-                    << "Can not remove invalid compressed brotli file:" << outputPath;
-            }
-        }
+    if (Q_UNLIKELY(output.write(outData) < 0 || !output.commit())) {
         qCWarning(C_STATICCOMPRESSED) << "Failed to write brotli compressed data to output file"
                                       << outputPath << ":" << output.errorString();
         return false;
@@ -919,20 +965,14 @@ bool StaticCompressedPrivate::compressZstd(const QString &inputPath,
 
     outData.resize(static_cast<qsizetype>(outSize));
 
-    QFile output{outputPath};
+    QSaveFile output{outputPath};
     if (Q_UNLIKELY(!output.open(QIODeviceBase::WriteOnly))) {
         qCWarning(C_STATICCOMPRESSED) << "Failed to open output file" << outputPath
                                       << "for zstd compression:" << output.errorString();
         return false;
     }
 
-    if (Q_UNLIKELY(output.write(outData) < 0)) {
-        if (output.exists()) {
-            if (Q_UNLIKELY(!output.remove())) {
-                qCWarning(C_STATICCOMPRESSED)
-                    << "Can not remove invalid compressed zstd file:" << outputPath;
-            }
-        }
+    if (Q_UNLIKELY(output.write(outData) < 0 || !output.commit())) {
         qCWarning(C_STATICCOMPRESSED) << "Failed to write zstd compressed data to output file"
                                       << outputPath << ":" << output.errorString();
         return false;
@@ -70,6 +70,17 @@ class StaticCompressedPrivate;
  * will then be recompressed on the next request. On the fly compression can be disabled by setting
  * @c on_the_fly_compression to @c false in the configuration file.
  *
+ * <H3>Background compression</H3>
+ *
+ * Compressing a file on the fly blocks the worker that received the request, which can take
+ * hundreds of milliseconds with @a Zopfli or high @a Brotli levels. Set @c pre_compress to
+ * @c true (since %Cutelyst 5.1.0) to compress all files of the include paths in a background
+ * thread once the workers are forked instead. Files are then served from an in-memory manifest
+ * of their modification times, content types and compressed variants that is shared by the
+ * worker threads of a process, so requests don't check the file system. Changed files are
+ * picked up with QFileSystemWatcher, which uses inotify on Linux, and compressed again in the
+ * background, the uncompressed file is served meanwhile.
+ *
  * <H3>Pre-compressed files</H3>
  *
  * Beside the cached on the fly compression it is also possible to serve pre-compressed static
@@ -127,6 +138,11 @@ class StaticCompressedPrivate;
  * Enables or disables the compression on the fly.
  * @endconfigblock
  *
+ * @configblock{pre_compress,bool,false}
+ * Compresses the files in a background thread and serves them from an in-memory manifest
+ * (since %Cutelyst 5.1.0).
+ * @endconfigblock
+ *
  * @configblock{zlib_compression_level,integer,9}
  * Compression level for built in zlib based compression between 0 and 9, with 9 corresponding
  * to the best compression. Used for @a gzip and @a deflate compression format if @a use_zopfli
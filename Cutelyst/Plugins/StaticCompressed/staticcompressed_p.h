@@ -7,10 +7,15 @@
 
 #include "staticcompressed.h"
 
+#include <QDateTime>
 #include <QDir>
 #include <QRegularExpression>
 #include <QVector>
 
+#include <chrono>
+#include <memory>
+#include <optional>
+
 #ifdef CUTELYST_STATICCOMPRESSED_WITH_ZOPFLI
 #    include <zopfli.h>
 #endif
@@ -24,18 +29,36 @@ using namespace Qt::StringLiterals;
 namespace Cutelyst {
 
 class Context;
+class StaticCompressedManifest;
 
 class StaticCompressedPrivate
 {
 public:
     enum Compression { Gzip, ZopfliGzip, Brotli, Deflate, ZopfliDeflate, Zstd };
 
+    struct FileType {
+        QByteArray contentType;
+        bool compress = false;
+    };
+
     void beforePrepareAction(Context *c, bool *skipMethod);
     bool locateCompressedFile(Context *c, const QString &relPath) const;
     [[nodiscard]] QString locateCacheFile(const QString &origPath,
                                           const QDateTime &origLastModified,
                                           Compression compression) const;
 
+    // Sets the headers and the body, the length is taken from the opened file
+    bool serveFile(Context *c,
+                   const QString &path,
+                   const QDateTime &lastModified,
+                   const QByteArray &contentType,
+                   const QString &compressedPath,
+                   const QByteArray &contentEncoding) const;
+
+    [[nodiscard]] FileType fileType(const QString &path) const;
+    [[nodiscard]] std::optional<Compression> compressionFor(QStringView format) const;
+
+    [[nodiscard]] bool loadCompressorConfig(const QVariantMap &conf);
     void loadZlibConfig(const QVariantMap &conf);
 
     [[nodiscard]] bool compressGzip(const QString &inputPath,
@@ -98,9 +121,14 @@ public:
     QVariantMap defaultConfig;
     QRegularExpression re = QRegularExpression(u"\\.[^/]+$"_s);
     QDir cacheDir;
+    std::shared_ptr<StaticCompressedManifest> manifest;
+    // How long to wait for another thread or process compressing the same file
+    std::chrono::milliseconds lockTimeout{10};
     bool useZopfli{false};
     bool checkPreCompressed{true};
     bool onTheFlyCompression{true};
+    // Files are only compressed by the manifest, never while serving a request
+    bool backgroundCompression{false};
     bool serveDirsOnly{false};
 };
 
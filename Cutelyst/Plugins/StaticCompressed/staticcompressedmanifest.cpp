@@ -0,0 +1,248 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "staticcompressedmanifest_p.h"
+
+#include <QCoreApplication>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QLoggingCategory>
+#include <QMutex>
+
+using namespace Cutelyst;
+
+Q_DECLARE_LOGGING_CATEGORY(C_STATICCOMPRESSED)
+
+std::shared_ptr<StaticCompressedManifest>
+    StaticCompressedManifest::instance(const StaticCompressedPrivate &d, const QVariantMap &config)
+{
+    static QMutex mutex;
+    static QHash<QStringList, std::shared_ptr<StaticCompressedManifest>> manifests;
+
+    QStringList key{d.cacheDir.absolutePath()};
+    for (const QDir &includePath : d.includePaths) {
+        key.append(includePath.absolutePath());
+    }
+
+    QMutexLocker locker(&mutex);
+    auto &manifest = manifests[key];
+    if (!manifest) {
+        manifest.reset(new StaticCompressedManifest(d, config));
+    }
+    return manifest;
+}
+
+StaticCompressedManifest::StaticCompressedManifest(const StaticCompressedPrivate &d,
+                                                   const QVariantMap &config)
+    : m_watcher(new QFileSystemWatcher(this))
+{
+    m_compressor.defaultConfig = d.defaultConfig;
+    if (!m_compressor.loadCompressorConfig(config)) {
+        qCWarning(C_STATICCOMPRESSED) << "Background compression has no compressor";
+    }
+    m_compressor.mimeTypes              = d.mimeTypes;
+    m_compressor.suffixes               = d.suffixes;
+    m_compressor.compressionFormatOrder = d.compressionFormatOrder;
+    m_compressor.includePaths           = d.includePaths;
+    m_compressor.cacheDir               = d.cacheDir;
+    m_compressor.checkPreCompressed     = d.checkPreCompressed;
+    m_compressor.onTheFlyCompression    = d.onTheFlyCompression;
+
+    // Every process scans on start, the ones losing the race pick up the compressed files
+    m_compressor.lockTimeout = std::chrono::seconds{30};
+
+    m_pool.setMaxThreadCount(1);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &dir) {
+        m_pool.start([this, dir] { scanDirectory(dir, false); });
+    });
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
+        m_pool.start([this, path] {
+            const QFileInfo info(path);
+            if (info.exists()) {
+                QStringList watchPaths;
+                updateFile(info, watchPaths);
+                watch(watchPaths);
+            } else {
+                removeFile(path);
+            }
+        });
+    });
+
+    // Worker threads might go away before the process does
+    if (auto app = QCoreApplication::instance()) {
+        moveToThread(app->thread());
+        m_pool.moveToThread(app->thread());
+    }
+
+    m_pool.start([this] {
+        for (const QDir &includePath : std::as_const(m_compressor.includePaths)) {
+            if (includePath.exists()) {
+                scanDirectory(includePath.absolutePath(), true);
+            }
+        }
+        qCInfo(C_STATICCOMPRESSED) << "Background compression finished for"
+                                   << m_compressor.includePaths;
+    });
+}
+
+StaticCompressedManifest::~StaticCompressedManifest()
+{
+    m_stop = true;
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+std::optional<StaticCompressedManifest::Entry>
+    StaticCompressedManifest::entry(const QString &relPath) const
+{
+    QReadLocker locker(&m_lock);
+    auto it = m_entries.constFind(relPath);
+    if (it != m_entries.cend()) {
+        return *it;
+    }
+    return {};
+}
+
+void StaticCompressedManifest::scanDirectory(const QString &dir, bool recursive)
+{
+    if (!recursive) {
+        // Forget the files removed from this directory, or with it
+        const QString prefix = dir + u'/';
+        QStringList removed;
+        {
+            QReadLocker locker(&m_lock);
+            for (const Entry &entry : std::as_const(m_entries)) {
+                if (entry.path.startsWith(prefix) && !QFileInfo::exists(entry.path)) {
+                    removed.append(entry.path);
+                }
+            }
+        }
+        for (const QString &path : std::as_const(removed)) {
+            removeFile(path);
+        }
+
+        if (!QFileInfo::exists(dir)) {
+            // The watcher drops removed directories
+            m_watched.removeIf(
+                [&](const QString &path) { return path == dir || path.startsWith(prefix); });
+            return;
+        }
+    }
+
+    QStringList watchPaths;
+    if (!m_watched.contains(dir)) {
+        watchPaths.append(dir);
+    }
+
+    QDirIterator it(dir,
+                    QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                    recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+    while (!m_stop && it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (!info.isDir()) {
+            updateFile(info, watchPaths);
+        } else if (!m_watched.contains(info.absoluteFilePath())) {
+            if (recursive) {
+                watchPaths.append(info.absoluteFilePath());
+            } else {
+                // A new directory
+                scanDirectory(info.absoluteFilePath(), true);
+            }
+        }
+    }
+
+    watch(watchPaths);
+}
+
+void StaticCompressedManifest::updateFile(const QFileInfo &info, QStringList &watch)
+{
+    const QString path = info.absoluteFilePath();
+
+    int includePath = 0;
+    QString relPath;
+    for (const QDir &dir : std::as_const(m_compressor.includePaths)) {
+        const QString root = dir.absolutePath() + u'/';
+        if (path.startsWith(root)) {
+            relPath = path.mid(root.size());
+            break;
+        }
+        ++includePath;
+    }
+    if (relPath.isEmpty()) {
+        return;
+    }
+
+    if (!m_watched.contains(path)) {
+        watch.append(path);
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_entries.constFind(relPath);
+        if (it != m_entries.cend() &&
+            (it->includePath < includePath ||
+             (it->path == path && it->lastModified == info.lastModified() &&
+              it->size == info.size()))) {
+            return;
+        }
+    }
+
+    const StaticCompressedPrivate::FileType type = m_compressor.fileType(path);
+
+    Entry entry;
+    entry.path         = path;
+    entry.lastModified = info.lastModified();
+    entry.contentType  = type.contentType;
+    entry.size         = info.size();
+    entry.includePath  = includePath;
+
+    if (type.compress) {
+        for (const QString &format : std::as_const(m_compressor.compressionFormatOrder)) {
+            const auto compression = m_compressor.compressionFor(format);
+            if (m_stop || !compression) {
+                continue;
+            }
+
+            const QString compressedPath =
+                m_compressor.locateCacheFile(path, entry.lastModified, *compression);
+            if (!compressedPath.isEmpty()) {
+                entry.variants.insert(format, {compressedPath});
+            }
+        }
+    }
+
+    qCDebug(C_STATICCOMPRESSED) << "Manifest entry" << relPath << entry.variants.keys();
+
+    QWriteLocker locker(&m_lock);
+    m_entries.insert(relPath, entry);
+}
+
+void StaticCompressedManifest::removeFile(const QString &path)
+{
+    m_watched.remove(path);
+
+    QWriteLocker locker(&m_lock);
+    m_entries.removeIf([&path](const auto &it) { return it.value().path == path; });
+}
+
+void StaticCompressedManifest::watch(const QStringList &paths)
+{
+    if (paths.isEmpty()) {
+        return;
+    }
+
+    for (const QString &path : paths) {
+        m_watched.insert(path);
+    }
+
+    // QFileSystemWatcher must be used from the thread it lives in
+    QMetaObject::invokeMethod(m_watcher, [watcher = m_watcher, paths] {
+        watcher->addPaths(paths);
+    });
+}
+
+#include "moc_staticcompressedmanifest_p.cpp"
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "staticcompressed_p.h"
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QThreadPool>
+
+#include <atomic>
+
+class QFileInfo;
+class QFileSystemWatcher;
+
+namespace Cutelyst {
+
+/**
+ * Compresses the static files of the include paths in a background thread and keeps
+ * their content types, modification times and compressed variants in memory, so that
+ * requests neither stat nor compress files. It's created after the workers fork, shared by
+ * the plugins of every worker thread of a process that use the same directories, and follows
+ * file system changes with QFileSystemWatcher, which uses inotify on Linux.
+ */
+class StaticCompressedManifest final : public QObject
+{
+    Q_OBJECT
+public:
+    struct Variant {
+        QString path;
+    };
+
+    struct Entry {
+        QString path;
+        QDateTime lastModified;
+        QByteArray contentType;
+        qint64 size = -1;
+        // Keyed by the content encoding
+        QHash<QString, Variant> variants;
+        // Files in earlier include paths take precedence
+        int includePath = 0;
+    };
+
+    /**
+     * Returns the manifest of the include paths and cache directory of \a d, configured
+     * like \a d with \a config, it lives until the process exits.
+     */
+    static std::shared_ptr<StaticCompressedManifest> instance(const StaticCompressedPrivate &d,
+                                                              const QVariantMap &config);
+
+    ~StaticCompressedManifest() override;
+
+    /**
+     * Returns the entry of the file at \a relPath, which is empty if it wasn't found yet.
+     */
+    [[nodiscard]] std::optional<Entry> entry(const QString &relPath) const;
+
+private:
+    StaticCompressedManifest(const StaticCompressedPrivate &d, const QVariantMap &config);
+
+    // These run in the pool thread
+    void scanDirectory(const QString &dir, bool recursive);
+    void updateFile(const QFileInfo &info, QStringList &watch);
+    void removeFile(const QString &path);
+    void watch(const QStringList &paths);
+
+    StaticCompressedPrivate m_compressor;
+    QHash<QString, Entry> m_entries;
+    mutable QReadWriteLock m_lock;
+    // Only used in the pool thread
+    QSet<QString> m_watched;
+    QFileSystemWatcher *m_watcher;
+    std::atomic_bool m_stop = false;
+    // A single thread, the compressors are not thread safe
+    QThreadPool m_pool;
+};
+
+} // namespace Cutelyst
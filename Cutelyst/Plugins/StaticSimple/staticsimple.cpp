@@ -6,13 +6,11 @@
 #include "context.h"
 #include "request.h"
 #include "response.h"
+#include "staticfilecache.h"
 #include "staticsimple_p.h"
 
-#include <QDateTime>
 #include <QDir>
-#include <QFile>
 #include <QLoggingCategory>
-#include <QMimeDatabase>
 
 using namespace Cutelyst;
 using namespace Qt::Literals::StringLiterals;
@@ -55,7 +53,8 @@ void StaticSimple::setServeDirsOnly(bool dirsOnly)
 
 bool StaticSimple::setup(Cutelyst::Application *app)
 {
-    connect(app, &Application::beforePrepareAction, this, &StaticSimple::beforePrepareAction);
+    app->addBeforePrepareActionHook(
+        this, [this](Context *c, bool *skipMethod) { beforePrepareAction(c, skipMethod); });
     return true;
 }
 
@@ -103,42 +102,10 @@ bool StaticSimple::locateStaticFile(Context *c, const QString &relPath) const
     Q_D(const StaticSimple);
 
     for (const QDir &includePath : d->includePaths) {
-        QString path = includePath.absoluteFilePath(relPath);
-        QFileInfo fileInfo(path);
-        if (fileInfo.exists()) {
-            Response *res                   = c->res();
-            const QDateTime currentDateTime = fileInfo.lastModified();
-            if (!c->req()->headers().ifModifiedSince(currentDateTime)) {
-                res->setStatus(Response::NotModified);
-                return true;
-            }
-
-            // Response::setBody() will take the ownership
-            // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
-            auto file = new QFile(path);
-            if (file->open(QFile::ReadOnly)) {
-                qCDebug(C_STATICSIMPLE) << "Serving" << path;
-                Headers &headers = res->headers();
-
-                // set our open file
-                res->setBody(file);
-
-                static QMimeDatabase db;
-                // use the extension to match to be faster
-                QMimeType mimeType = db.mimeTypeForFile(path, QMimeDatabase::MatchExtension);
-                if (mimeType.isValid()) {
-                    headers.setContentType(mimeType.name().toLatin1());
-                }
-
-                headers.setLastModified(currentDateTime);
-                // Tell Firefox & friends its OK to cache, even over SSL
-                headers.setHeader("Cache-Control"_ba, "public"_ba);
-
-                return true;
-            }
-
-            qCWarning(C_STATICSIMPLE) << "Could not serve" << path << file->errorString();
-            return false;
+        const QString path = includePath.absoluteFilePath(relPath);
+        if (StaticFileCache::instance()->serve(c, path)) {
+            qCDebug(C_STATICSIMPLE) << "Serving" << path;
+            return true;
         }
     }
 
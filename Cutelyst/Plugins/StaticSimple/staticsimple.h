@@ -23,7 +23,10 @@ class StaticSimplePrivate;
  * will tried to be served by this plugin.
  *
  * Beside serving the file content this will also set the respective HTTP header fields
- * @c Content-Type, @c Content-Length, @c Last-Modified and @c Cache-Control=public.
+ * @c Content-Type, @c Content-Length, @c Last-Modified and @c Cache-Control=public, since
+ * %Cutelyst 5.1.0 the @c ETag header is set as well. Files are served through the
+ * StaticFileCache, which keeps hot files and their headers in memory and watches them for
+ * changes instead of checking them on every request.
  *
  * <h3>Only serve for specific request paths</h3>
  *
@@ -185,8 +185,7 @@ QNetworkReply *UA::forwardRequest(const Request *request, const QUrl &destinatio
 
     QNetworkRequest proxyReq(dest);
 
-    const auto headersData = request->headers().data();
-    for (const auto &[key, value] : headersData) {
+    for (const auto &[key, value] : request->headers().data()) {
         proxyReq.setRawHeader(key, value);
     }
 
@@ -26,7 +26,7 @@ Q_LOGGING_CATEGORY(C_LANGSELECT, "cutelyst.plugin.langselect", QtWarningMsg)
 using namespace Cutelyst;
 using namespace Qt::Literals::StringLiterals;
 
-const QString LangSelectPrivate::stashKeySelectionTried{u"_c_langselect_tried"_s};
+const ContextSlot<bool> LangSelectPrivate::contextSelectionTried;
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 namespace {
@@ -123,7 +123,7 @@ bool LangSelect::setup(Application *app)
             qCCritical(C_LANGSELECT) << "Invalid source.";
             return false;
         }
-        connect(app, &Application::beforePrepareAction, this, [d](Context *c, bool *skipMethod) {
+        app->addBeforePrepareActionHook(this, [d](Context *c, bool *skipMethod) {
             d->beforePrepareAction(c, skipMethod);
         });
     }
@@ -808,13 +808,13 @@ void LangSelectPrivate::beforePrepareAction(Context *c, bool *skipMethod) const
         return;
     }
 
-    if (!c->stash(LangSelectPrivate::stashKeySelectionTried).isNull()) {
+    if (LangSelectPrivate::contextSelectionTried.value(c)) {
         return;
     }
 
     detectLocale(c, source, skipMethod);
 
-    c->setStash(LangSelectPrivate::stashKeySelectionTried, true);
+    LangSelectPrivate::contextSelectionTried.set(c, true);
 }
 
 void LangSelectPrivate::_q_postFork(Application *app)
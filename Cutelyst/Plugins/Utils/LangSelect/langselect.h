@@ -30,8 +30,8 @@ class LangSelectPrivate;
  * is not supported, it will use a @link setFallbackLocale() fallback@endlink locale. As
  * another fallback it will try to get the locale from the @a Accept-Language header.
  *
- * Unless the plugin has been constructed with the manual mode constructor, it will be connected to
- * the Application::beforePrepareAction() signal to set the locale. If auto detection is disabled,
+ * Unless the plugin has been constructed with the manual mode constructor, it will add a hook with
+ * Application::addBeforePrepareActionHook() to set the locale. If auto detection is disabled,
  * you can manually set the locale by calling LangSelect::fromCookie(), LangSelect::fromDomain(),
  * LangSelect::fromPath(), LangSelect::fromSession(), LangSelect::fromUrlQuery() or
  * LangSelect::fromSubDomain() at appropriate places.
@@ -60,7 +60,7 @@ class LangSelectPrivate;
  *
  * <h3 id="modes-of-operation">Modes of operation</h3>
  * The plugin can either work automatically or manually. The auto detection mode hooks into the
- * Application::beforePrepareAction() signal to set the locale. The mode of operation is defined
+ * Application::addBeforePrepareActionHook() pipeline to set the locale. The mode of operation is defined
  * when constructing and registering the plugin. If auto detection is disabled, you can use one of
  * the static functions that get and set the locale. Note that you still have to set the list of
  * supported locales and might want to set some defaults for the sources like the session key, etc.
@@ -376,7 +376,7 @@ public:
      * Constructs a new %LangSelect object with the given @a parent and @a source in
      * <b>auto detection mode</b>.
      *
-     * The plugin will be connected to the Application::beforePrepareAction signal
+     * The plugin will add an Application::addBeforePrepareActionHook() hook
      * and will automatically set the appropriate locale extracted from @a source.
      *
      * This mode is good is good if you use the same approach to detect and set the locale
@@ -387,7 +387,7 @@ public:
     /**
      * Constructs a new %LangSelect object with the given @a parent in <b>manual mode</b>.
      *
-     * The plugin will @b not be connected to the Application::beforePrepareAction signal
+     * The plugin will @b not add an Application::addBeforePrepareActionHook() hook
      * so you have to use one of the static functions to set and store the locale.
      */
     explicit LangSelect(Application *parent);
@@ -668,8 +668,8 @@ protected:
     /**
      * Sets the plugin up and checks the plugin configuration. If the configuration contains errors,
      * it will return @c false, otherwise it will return @c true. If the plugin has been constructed
-     * with auto detection constructor, it will connect the plugin to the
-     * Application::beforePrepareAction() signal.
+     * with auto detection constructor, it will add the plugin hook with
+     * Application::addBeforePrepareActionHook().
      */
     bool setup(Application *app) override;
 
@@ -8,6 +8,8 @@
 
 #include "langselect.h"
 
+#include <Cutelyst/ContextSlot>
+
 #include <chrono>
 
 #include <QNetworkCookie>
@@ -36,7 +38,7 @@ public:
     void setFallback(Context *c) const;
     void setContentLanguage(Context *c) const;
 
-    static const QString stashKeySelectionTried;
+    static const ContextSlot<bool> contextSelectionTried;
 
     static constexpr std::chrono::months cookieDefaultExpiration{1};
 
@@ -4,6 +4,8 @@
  */
 #include "sql.h"
 
+#include <QCborStreamWriter>
+#include <QCborValue>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -17,6 +19,50 @@ Q_LOGGING_CATEGORY(C_SQL, "cutelyst.utils.sql", QtWarningMsg)
 
 using namespace Cutelyst;
 
+namespace {
+
+void appendCborValue(QCborStreamWriter &writer, const QVariant &value)
+{
+    // Databases return SQL NULL as a null variant of the column type
+    if (value.isNull()) {
+        writer.append(nullptr);
+        return;
+    }
+
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+        writer.append(value.toBool());
+        break;
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+    case QMetaType::Short:
+        writer.append(value.toLongLong());
+        break;
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+    case QMetaType::UShort:
+        writer.append(value.toULongLong());
+        break;
+    case QMetaType::Float:
+    case QMetaType::Double:
+        writer.append(value.toDouble());
+        break;
+    case QMetaType::QString:
+        writer.append(QStringView{*static_cast<const QString *>(value.constData())});
+        break;
+    case QMetaType::QByteArray:
+        writer.append(*static_cast<const QByteArray *>(value.constData()));
+        break;
+    default:
+        // Dates and driver specific types keep the QCborValue conversion
+        QCborValue::fromVariant(value).toCbor(writer);
+    }
+}
+
+} // namespace
+
 QVariantHash Sql::queryToHashObject(QSqlQuery &query)
 {
     QVariantHash ret;
@@ -148,6 +194,47 @@ QJsonArray Sql::queryToJsonArray(QSqlQuery &query)
     return ret;
 }
 
+void Sql::queryToCborMapArray(QSqlQuery &query, QCborStreamWriter &writer)
+{
+    const QSqlRecord record = query.record();
+    const int columns       = record.count();
+
+    // Keys are encoded once instead of once per row
+    QByteArrayList keys;
+    keys.reserve(columns);
+    for (int i = 0; i < columns; ++i) {
+        keys.append(record.fieldName(i).toUtf8());
+    }
+
+    // Forward only queries don't know their size
+    writer.startArray();
+    while (query.next()) {
+        writer.startMap(columns);
+        for (int i = 0; i < columns; ++i) {
+            const QByteArray &key = keys.at(i);
+            writer.appendTextString(key.constData(), key.size());
+            appendCborValue(writer, query.value(i));
+        }
+        writer.endMap();
+    }
+    writer.endArray();
+}
+
+void Sql::queryToCborArray(QSqlQuery &query, QCborStreamWriter &writer)
+{
+    const int columns = query.record().count();
+
+    writer.startArray();
+    while (query.next()) {
+        writer.startArray(columns);
+        for (int i = 0; i < columns; ++i) {
+            appendCborValue(writer, query.value(i));
+        }
+        writer.endArray();
+    }
+    writer.endArray();
+}
+
 QVariantHash Sql::queryToIndexedHash(QSqlQuery &query, const QString &key)
 {
     QVariantHash ret;
@@ -11,6 +11,8 @@
 #include <QtCore/QVariant>
 #include <QtSql/QSqlDatabase>
 
+class QCborStreamWriter;
+
 namespace Cutelyst {
 
 namespace Sql {
@@ -129,6 +131,25 @@ CUTELYST_PLUGIN_UTILS_SQL_EXPORT QVariantList queryToList(QSqlQuery &query);
  */
 CUTELYST_PLUGIN_UTILS_SQL_EXPORT QJsonArray queryToJsonArray(QSqlQuery &query);
 
+/**
+ * @ingroup plugins-utils-sql
+ * Writes an array of CBOR maps for all the rows in the \a query object to \a writer,
+ * each column name is a key in the map. Rows are encoded as they are fetched, which
+ * combined with CborWriter streams big results with flat memory usage.
+ * @since Cutelyst 5.1.0
+ */
+CUTELYST_PLUGIN_UTILS_SQL_EXPORT void queryToCborMapArray(QSqlQuery &query,
+                                                          QCborStreamWriter &writer);
+
+/**
+ * @ingroup plugins-utils-sql
+ * Writes an array of CBOR arrays for all the rows in the \a query object to \a writer,
+ * columns are indexed by it’s position instead of a map lookup.
+ * @since Cutelyst 5.1.0
+ */
+CUTELYST_PLUGIN_UTILS_SQL_EXPORT void queryToCborArray(QSqlQuery &query,
+                                                       QCborStreamWriter &writer);
+
 /**
  * @ingroup plugins-utils-sql
  * Returns a QVariantHash of QVariantHashes where the \a key parameter
@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "cache.h"
+
+#include <Cutelyst/Context>
+#include <cutelee/exception.h>
+#include <cutelee/parser.h>
+
+#include <QDebug>
+#include <QTextStream>
+
+#ifdef PLUGIN_RESPONSECACHE_ENABLED
+#    include <Cutelyst/Plugins/ResponseCache/ResponseCache>
+#endif
+
+using namespace Qt::StringLiterals;
+
+Cutelee::Node *CacheTag::getNode(const QString &tagContent, Cutelee::Parser *p) const
+{
+    QStringList parts = smartSplit(tagContent);
+
+    parts.removeFirst(); // Not interested in the name of the tag.
+    if (parts.size() < 2) {
+        throw Cutelee::Exception(Cutelee::TagSyntaxError,
+                                 u"c_cache requires the ttl and the fragment name"_s);
+    }
+
+    auto node = new CacheNode(parts.at(0), parts.at(1), parts.mid(2), p);
+    node->setNodeList(p->parse(node, {u"endc_cache"_s}));
+    p->removeNextToken();
+
+    return node;
+}
+
+CacheNode::CacheNode(const QString &ttl,
+                     const QString &name,
+                     const QStringList &vary,
+                     Cutelee::Parser *parser)
+    : Cutelee::Node(parser)
+    , m_ttl(ttl, parser)
+    , m_name(name, parser)
+{
+    for (const QString &expression : vary) {
+        m_varyExpressions.push_back(Cutelee::FilterExpression(expression, parser));
+    }
+}
+
+void CacheNode::setNodeList(const Cutelee::NodeList &list)
+{
+    m_list = list;
+}
+
+void CacheNode::render(Cutelee::OutputStream *stream, Cutelee::Context *gc) const
+{
+#ifdef PLUGIN_RESPONSECACHE_ENABLED
+    // In case cutelyst context is not set as "c"
+    auto c = gc->lookup(m_cutelystContext).value<Cutelyst::Context *>();
+    if (!c) {
+        const QVariantHash hash = gc->stackHash(0);
+        for (const auto &[key, value] : hash.asKeyValueRange()) {
+            if (value.userType() == qMetaTypeId<Cutelyst::Context *>()) {
+                c = value.value<Cutelyst::Context *>();
+                if (c) {
+                    m_cutelystContext = key;
+                    break;
+                }
+            }
+        }
+
+        if (!c) {
+            m_list.render(stream, gc);
+            return;
+        }
+    }
+
+    bool ok;
+    const qint64 ttl = m_ttl.resolve(gc).toLongLong(&ok);
+    if (!ok || ttl < 0) {
+        qWarning() << "c_cache TTL is not a valid number of seconds";
+        m_list.render(stream, gc);
+        return;
+    }
+
+    // Unit separators keep "a" "bc" apart from "ab" "c"
+    QString key = Cutelee::getSafeString(m_name.resolve(gc)).get();
+    for (const Cutelee::FilterExpression &exp : m_varyExpressions) {
+        key += u'\x1f' + Cutelee::getSafeString(exp.resolve(gc)).get();
+    }
+
+    if (const auto fragment = Cutelyst::ResponseCache::fragment(c, key)) {
+        *stream << QString::fromUtf8(*fragment);
+        return;
+    }
+
+    QString content;
+    QTextStream textStream(&content);
+    auto temp = stream->clone(&textStream);
+    m_list.render(temp.get(), gc);
+    textStream.flush();
+
+    Cutelyst::ResponseCache::setFragment(c, key, content.toUtf8(), std::chrono::seconds{ttl});
+    *stream << content;
+#else
+    qWarning("%s", "The ResponseCache plugin has not been built.");
+    m_list.render(stream, gc);
+#endif
+}
+
+#include "moc_cache.cpp"
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef CACHE_H
+#define CACHE_H
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#    include <cutelee/filter.h>
+#    include <cutelee/node.h>
+#    include <cutelee/safestring.h>
+#    include <cutelee/util.h>
+
+class CacheTag final : public Cutelee::AbstractNodeFactory
+{
+    Q_OBJECT
+public:
+    Cutelee::Node *getNode(const QString &tagContent, Cutelee::Parser *p) const override;
+};
+
+class CacheNode final : public Cutelee::Node
+{
+    Q_OBJECT
+public:
+    explicit CacheNode(const QString &ttl,
+                       const QString &name,
+                       const QStringList &vary,
+                       Cutelee::Parser *parser = nullptr);
+
+    void setNodeList(const Cutelee::NodeList &list);
+
+    void render(Cutelee::OutputStream *stream, Cutelee::Context *gc) const override;
+
+private:
+    mutable QString m_cutelystContext = QStringLiteral("c");
+    Cutelee::FilterExpression m_ttl;
+    Cutelee::FilterExpression m_name;
+    std::vector<Cutelee::FilterExpression> m_varyExpressions;
+    Cutelee::NodeList m_list;
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif // CACHE_H
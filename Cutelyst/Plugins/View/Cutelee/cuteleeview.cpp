@@ -8,16 +8,22 @@
 #include "context.h"
 #include "cuteleeview_p.h"
 #include "cutelystcutelee.h"
+#include "request.h"
 #include "response.h"
 
 #include <cutelee/metatype.h>
+#include <cutelee/outputstream.h>
 #include <cutelee/qtlocalizer.h>
 
+#include <QBuffer>
 #include <QDirIterator>
 #include <QString>
+#include <QTextStream>
 #include <QTranslator>
 #include <QtCore/QLoggingCategory>
 
+#include <optional>
+
 Q_LOGGING_CATEGORY(CUTELYST_CUTELEE, "cutelyst.view.cutelee", QtWarningMsg)
 
 using namespace Cutelyst;
@@ -193,19 +199,7 @@ QByteArray CuteleeView::render(Context *c) const
     qCDebug(CUTELYST_CUTELEE) << "Rendering template" << templateFile;
 
     Cutelee::Context gc(stash);
-
-    auto localizer = std::make_shared<Cutelee::QtLocalizer>(c->locale());
-
-    auto transIt = d->translators.constFind(c->locale());
-    if (transIt != d->translators.constEnd()) {
-        localizer->installTranslator(transIt.value(), transIt.key().name());
-    }
-
-    for (const auto &[key, value] : std::as_const(d->translationCatalogs).asKeyValueRange()) {
-        localizer->loadCatalog(value, key);
-    }
-
-    gc.setLocalizer(localizer);
+    gc.setLocalizer(d->localizer(c->locale()));
 
     Cutelee::Template tmpl = d->engine->loadByName(templateFile);
     if (tmpl->error() != Cutelee::NoError) {
@@ -215,41 +209,90 @@ QByteArray CuteleeView::render(Context *c) const
         return ret;
     }
 
-    QString content = tmpl->render(&gc);
-    if (tmpl->error() != Cutelee::NoError) {
-        c->res()->setBody(c->qtTrId("cutelyst-cuteleeview-err-internal-server"));
-        c->appendError(u"Error while rendering template: " + tmpl->errorString());
-        return ret;
-    }
-
+    Cutelee::Template wrapper;
     if (!d->wrapper.isEmpty()) {
-        Cutelee::Template wrapper = d->engine->loadByName(d->wrapper);
-        if (tmpl->error() != Cutelee::NoError) {
+        wrapper = d->engine->loadByName(d->wrapper);
+        if (wrapper->error() != Cutelee::NoError) {
             c->res()->setBody(c->qtTrId("cutelyst-cuteleeview-err-internal-server"));
-            c->appendError(u"Error while rendering template: " + tmpl->errorString());
+            c->appendError(u"Error while rendering template: " + wrapper->errorString());
             return ret;
         }
+    }
+
+    // QTextStream encodes to UTF-8 as it goes, the output is never held in a QString
+    QBuffer buffer(&ret);
+    std::optional<CuteleeStreamDevice> streamDevice;
+    QIODevice *device = &buffer;
+    if (d->streaming) {
+        device = &streamDevice.emplace(c->response(), c->request()->protocol() == "HTTP/1.1");
+    } else {
+        buffer.open(QIODevice::WriteOnly);
+    }
+
+    QTextStream textStream(device);
+    Cutelee::OutputStream outputStream(&textStream);
+
+    const auto failed = [&](const Cutelee::Template &failedTmpl) {
+        c->appendError(u"Error while rendering template: " + failedTmpl->errorString());
+        if (streamDevice) {
+            streamDevice->discard = true;
+            if (streamDevice->started) {
+                // What was sent can't be taken back, the client gets a truncated page
+                return;
+            }
+        }
+        ret.clear();
+        c->res()->setBody(c->qtTrId("cutelyst-cuteleeview-err-internal-server"));
+    };
 
-        Cutelee::SafeString safeContent(content, true);
-        gc.insert(u"content"_s, safeContent);
-        content = wrapper->render(&gc);
+    if (!wrapper) {
+        tmpl->render(&outputStream, &gc);
+        if (tmpl->error() != Cutelee::NoError) {
+            failed(tmpl);
+            return {};
+        }
+    } else {
+        // The wrapper writes the shared content straight to the output
+        const QString content = tmpl->render(&gc);
+        if (tmpl->error() != Cutelee::NoError) {
+            failed(tmpl);
+            return {};
+        }
 
+        gc.insert(u"content"_s, Cutelee::SafeString(content, true));
+        wrapper->render(&outputStream, &gc);
         if (wrapper->error() != Cutelee::NoError) {
-            c->res()->setBody(c->qtTrId("cutelyst-cuteleeview-err-internal-server"));
-            c->appendError(u"Error while rendering template: " + tmpl->errorString());
-            return ret;
+            failed(wrapper);
+            return {};
         }
     }
 
-    ret = content.toUtf8();
+    textStream.flush();
+    if (streamDevice && !streamDevice->started) {
+        return std::move(streamDevice->held);
+    }
     return ret;
 }
 
+bool CuteleeView::isStreaming() const
+{
+    Q_D(const CuteleeView);
+    return d->streaming;
+}
+
+void CuteleeView::setStreaming(bool enable)
+{
+    Q_D(CuteleeView);
+    d->streaming = enable;
+    Q_EMIT changed();
+}
+
 void CuteleeView::addTranslator(const QLocale &locale, QTranslator *translator)
 {
     Q_D(CuteleeView);
     Q_ASSERT_X(translator, "add translator to CuteleeView", "invalid QTranslator object");
     d->translators.insert(locale, translator);
+    d->localizers.clear();
 }
 
 void CuteleeView::addTranslator(const QString &locale, QTranslator *translator)
@@ -263,6 +306,7 @@ void CuteleeView::addTranslationCatalog(const QString &path, const QString &cata
     Q_ASSERT_X(!path.isEmpty(), "add translation catalog to CuteleeView", "empty path");
     Q_ASSERT_X(!catalog.isEmpty(), "add translation catalog to CuteleeView", "empty catalog name");
     d->translationCatalogs.insert(catalog, path);
+    d->localizers.clear();
 }
 
 void CuteleeView::addTranslationCatalogs(const QMultiHash<QString, QString> &catalogs)
@@ -270,6 +314,7 @@ void CuteleeView::addTranslationCatalogs(const QMultiHash<QString, QString> &cat
     Q_D(CuteleeView);
     Q_ASSERT_X(!catalogs.empty(), "add translation catalogs to GranteleeView", "empty QHash");
     d->translationCatalogs.unite(catalogs);
+    d->localizers.clear();
 }
 
 QVector<QLocale> CuteleeView::loadTranslationsFromDir(const QString &filename,
@@ -329,6 +374,65 @@ QVector<QLocale> CuteleeView::loadTranslationsFromDir(const QString &filename,
     return locales;
 }
 
+CuteleeStreamDevice::CuteleeStreamDevice(Response *response, bool chunked)
+    : response(response)
+    , chunked(chunked)
+{
+    open(QIODevice::WriteOnly);
+}
+
+qint64 CuteleeStreamDevice::readData(char *data, qint64 maxlen)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxlen)
+    return -1;
+}
+
+qint64 CuteleeStreamDevice::writeData(const char *data, qint64 len)
+{
+    if (discard) {
+        return len;
+    }
+
+    if (!started) {
+        held.append(data, len);
+        if (held.size() < holdSize) {
+            return len;
+        }
+
+        started = true;
+        if (chunked && !response->isFinalizedHeaders()) {
+            response->setHeader("Transfer-Encoding"_ba, "chunked"_ba);
+        }
+        const QByteArray block = std::exchange(held, {});
+        return response->write(block) == block.size() ? len : -1;
+    }
+
+    return response->write(data, len);
+}
+
+std::shared_ptr<Cutelee::QtLocalizer> CuteleeViewPrivate::localizer(const QLocale &locale) const
+{
+    auto it = localizers.constFind(locale);
+    if (it != localizers.constEnd()) {
+        return it.value();
+    }
+
+    auto localizer = std::make_shared<Cutelee::QtLocalizer>(locale);
+
+    auto transIt = translators.constFind(locale);
+    if (transIt != translators.constEnd()) {
+        localizer->installTranslator(transIt.value(), transIt.key().name());
+    }
+
+    for (const auto &[key, value] : translationCatalogs.asKeyValueRange()) {
+        localizer->loadCatalog(value, key);
+    }
+
+    localizers.insert(locale, localizer);
+    return localizer;
+}
+
 void CuteleeViewPrivate::initEngine()
 {
     // Set also the paths from CUTELYST_PLUGINS_DIR env variable as plugin paths of cutelee engine
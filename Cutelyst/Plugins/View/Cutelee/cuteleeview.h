@@ -201,10 +201,37 @@ public:
     /**
      * Sets if template caching should be done, this increases
      * performance at the cost of higher memory usage.
-     * \sa isCaching()
+     *
+     * Compiled templates are cached by each view, and as every worker thread has its own
+     * Application they are not shared among threads, since some tags like cycle and
+     * ifchanged keep state in the compiled template while rendering. Templates compiled
+     * by preloadTemplates() from Application::init() are shared in copy-on-write memory
+     * by processes forked after that, otherwise each worker compiles its own copy.
+     * \sa isCaching(), preloadTemplates()
      */
     void setCache(bool enable);
 
+    Q_PROPERTY(bool streaming READ isStreaming WRITE setStreaming NOTIFY changed)
+    /**
+     * Returns \c true if the rendered output is written directly to the Response.
+     * \sa setStreaming()
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] bool isStreaming() const;
+
+    /**
+     * When \a enable is \c true the rendered output is written to the Response in blocks
+     * as the template is rendered, using chunked transfer encoding on HTTP/1.1, instead of
+     * being returned by render(). Big pages reach the client sooner and are never held
+     * in memory as a whole. The first 64 KiB are held back, so smaller pages and templates
+     * failing before that are answered as usual, but once a block is sent an error in the
+     * template can no longer change the response, the client gets a truncated page and the
+     * error is only logged. Defaults to \c false.
+     * \sa isStreaming()
+     * \since Cutelyst 5.1.0
+     */
+    void setStreaming(bool enable);
+
     /**
      * Returns the Cutelee::Engine pointer that is used by this engine.
      */
@@ -10,15 +10,45 @@
 
 #include <cutelee/cachingloaderdecorator.h>
 #include <cutelee/engine.h>
+#include <cutelee/qtlocalizer.h>
 #include <cutelee/templateloader.h>
 
+#include <QIODevice>
+
 using namespace Qt::StringLiterals;
 
 namespace Cutelyst {
 
+class Response;
+
+// Forwards the rendered output to the response, dropping it once rendering fails
+class CuteleeStreamDevice final : public QIODevice
+{
+public:
+    CuteleeStreamDevice(Response *response, bool chunked);
+
+    bool isSequential() const override { return true; }
+
+    // Output is held until it reaches this size, so a template failing early still gets
+    // a clean error response, smaller pages are sent as a regular body
+    static constexpr qsizetype holdSize = 64 * 1024;
+
+    Response *response;
+    QByteArray held;
+    bool chunked;
+    bool started = false;
+    bool discard = false;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+};
+
 class CuteleeViewPrivate : public ViewPrivate
 {
 public:
+    std::shared_ptr<Cutelee::QtLocalizer> localizer(const QLocale &locale) const;
+
     QStringList includePaths;
     QString extension = u".html"_s;
     QString wrapper;
@@ -28,6 +58,9 @@ public:
     std::shared_ptr<Cutelee::CachingLoaderDecorator> cache;
     QHash<QLocale, QTranslator *> translators;
     QMultiHash<QString, QString> translationCatalogs;
+    // Loading the catalogs is expensive, each worker keeps the localizers it created
+    mutable QHash<QLocale, std::shared_ptr<Cutelee::QtLocalizer>> localizers;
+    bool streaming = false;
     void initEngine();
 };
 
@@ -4,6 +4,7 @@
  */
 #include "cutelystcutelee.h"
 
+#include "cache.h"
 #include "csrf.h"
 #include "urifor.h"
 
@@ -21,7 +22,8 @@ QHash<QString, Cutelee::AbstractNodeFactory *> CutelystCutelee::nodeFactories(co
     QHash<QString, Cutelee::AbstractNodeFactory *> ret{
         {u"c_uri_for"_s, new UriForTag()},
         {u"c_csrf_token"_s, new CSRFTag()},
-        {u"c_csrf_token_value"_s, new CSRFTokenTag()}};
+        {u"c_csrf_token_value"_s, new CSRFTokenTag()},
+        {u"c_cache"_s, new CacheTag()}};
 
     return ret;
 }
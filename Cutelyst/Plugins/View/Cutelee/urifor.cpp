@@ -111,7 +111,7 @@ void UriFor::render(Cutelee::OutputStream *stream, Cutelee::Context *gc) const
         }
     }
 
-    *stream << c->uriFor(path, args, queryValues).toString(QUrl::FullyEncoded);
+    *stream << c->uriForString(path, args, queryValues);
 }
 
 Cutelee::Node *UriForTag::getNode(const QString &tagContent, Cutelee::Parser *p) const
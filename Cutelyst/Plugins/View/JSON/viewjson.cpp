@@ -5,11 +5,15 @@
 #include "viewjson_p.h"
 
 #include <Cutelyst/context.h>
+#include <Cutelyst/jsonwriter.h>
 #include <Cutelyst/response.h>
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 
+#include <algorithm>
+#include <vector>
+
 using namespace Cutelyst;
 using namespace Qt::Literals::StringLiterals;
 
@@ -86,49 +90,65 @@ QByteArray ViewJson::render(Context *c) const
 {
     Q_D(const ViewJson);
 
-    QJsonObject obj;
-
-    const QVariantHash stash = c->stash();
+    const QVariantHash &stash = c->stash();
 
+    // Iterators to the exposed stash entries, sorted by key like QJsonObject does
+    std::vector<QVariantHash::const_iterator> exposed;
     switch (d->exposeMode) {
     case All:
-        obj = QJsonObject::fromVariantHash(stash);
+        exposed.reserve(stash.size());
+        for (auto it = stash.constBegin(); it != stash.constEnd(); ++it) {
+            exposed.push_back(it);
+        }
         break;
     case String:
     {
         auto it = stash.constFind(d->exposeKey);
         if (it != stash.constEnd()) {
-            obj.insert(d->exposeKey, QJsonValue::fromVariant(it.value()));
+            exposed.push_back(it);
         }
         break;
     }
     case StringList:
-    {
-        QVariantHash exposedStash;
-        for (const auto &[key, value] : stash.asKeyValueRange()) {
-            if (d->exposeKeys.contains(key)) {
-                exposedStash.insert(key, value);
+        for (auto it = stash.constBegin(); it != stash.constEnd(); ++it) {
+            if (d->exposeKeys.contains(it.key())) {
+                exposed.push_back(it);
             }
         }
-
-        obj = QJsonObject::fromVariantHash(exposedStash);
         break;
-    }
     case RegularExpression:
     {
         QRegularExpression re = d->exposeRE; // thread safety
 
-        QVariantHash exposedStash;
-        for (const auto &[key, value] : stash.asKeyValueRange()) {
-            if (re.match(key).hasMatch()) {
-                exposedStash.insert(key, value);
+        for (auto it = stash.constBegin(); it != stash.constEnd(); ++it) {
+            if (re.match(it.key()).hasMatch()) {
+                exposed.push_back(it);
             }
         }
-
-        obj = QJsonObject::fromVariantHash(exposedStash);
         break;
     }
     }
+    std::sort(exposed.begin(), exposed.end(), [](const auto &a, const auto &b) {
+        return a.key() < b.key();
+    });
+
+    QByteArray ret;
+    if (d->format == QJsonDocument::Compact) {
+        // Serialize the stash as it is, without building a QJsonObject copy of it
+        JsonWriter writer(ret);
+        writer.startObject();
+        for (const auto &it : exposed) {
+            writer.writeName(it.key());
+            writer.writeVariant(it.value());
+        }
+        writer.endObject();
+    } else {
+        QJsonObject obj;
+        for (const auto &it : exposed) {
+            obj.insert(it.key(), QJsonValue::fromVariant(it.value()));
+        }
+        ret = QJsonDocument(obj).toJson(d->format);
+    }
 
     Response *res = c->response();
     if (d->xJsonHeader && c->request()->headers().contains("X-Prototype-Version")) {
@@ -137,7 +157,7 @@ QByteArray ViewJson::render(Context *c) const
 
     res->setContentType("application/json"_ba);
 
-    return QJsonDocument(obj).toJson(d->format);
+    return ret;
 }
 
 #include "moc_viewjson.cpp"
@@ -270,13 +270,8 @@ void HPack::encodeHeaders(int status, const Headers &headers, QByteArray &buf, S
         buf.append(statusStr);
     }
 
-    bool hasDate           = false;
-    const auto headersData = headers.data();
-    for (const auto &[key, value] : headersData) {
-        if (!hasDate && key.compare("Date", Qt::CaseInsensitive) == 0) {
-            hasDate = true;
-        }
-
+    const bool hasDate = headers.contains(Headers::KnownHeader::Date);
+    for (const auto &[key, value] : headers.data()) {
         auto staticIt = HPackPrivate::hpackStaticHeadersCode.constFind(key);
         if (staticIt != HPackPrivate::hpackStaticHeadersCode.constEnd()) {
             buf.append(staticIt.value(), 2);
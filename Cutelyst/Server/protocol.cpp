@@ -7,6 +7,7 @@
 #include "server.h"
 #include "socket.h"
 
+#include <Cutelyst/MultiPartFormDataParser>
 #include <Cutelyst/Server/cutelyst_server_export.h>
 
 #include <QBuffer>
@@ -35,6 +36,7 @@ Cutelyst::Protocol::Protocol(const Cutelyst::Server *server)
     , m_postBuffering{server->postBuffering()}
     , m_postBuffer{new char[server->postBufferingBufsize()]}
     , m_bufferSize{server->bufferSize()}
+    , m_postStreamMultipart{server->postStreamMultipart()}
     , useStats{CUTELYST_SERVER_STATS().isDebugEnabled()}
 {
 }
@@ -49,10 +51,13 @@ Cutelyst::Protocol::Type Cutelyst::Protocol::type() const
     return Protocol::Type::Unknown;
 }
 
-QIODevice *Cutelyst::Protocol::createBody(qint64 contentLength) const
+QIODevice *Cutelyst::Protocol::createBody(qint64 contentLength, QByteArrayView contentType) const
 {
     QIODevice *body;
-    if (m_postBuffering && contentLength > m_postBuffering) {
+    if (m_postStreamMultipart && contentType.startsWith("multipart/form-data")) {
+        // Uploads are stored while the body arrives, so it's never buffered as a whole
+        body = new MultiPartFormDataStream(contentType);
+    } else if (m_postBuffering && contentLength > m_postBuffering) {
         auto temp = new QTemporaryFile;
         if (!temp->open()) {
             qCWarning(CUTELYST_SERVER_PROTO)
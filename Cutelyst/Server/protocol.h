@@ -85,12 +85,13 @@ public:
 
     virtual ProtocolData *createData(Socket *sock) const = 0;
 
-    QIODevice *createBody(qint64 contentLength) const;
+    QIODevice *createBody(qint64 contentLength, QByteArrayView contentType) const;
 
     qint64 m_postBufferSize;
     qint64 m_postBuffering;
     char *m_postBuffer;
     int m_bufferSize;
+    bool const m_postStreamMultipart;
     bool const useStats;
 };
 
@@ -282,7 +282,8 @@ int ProtocolFastCGI::processPacket(ProtoRequestFastCGI *request) const
 bool ProtocolFastCGI::writeBody(ProtoRequestFastCGI *request, char *buf, qint64 len) const
 {
     if (!request->body) {
-        request->body = createBody(request->contentLength);
+        request->body = createBody(request->contentLength,
+                                   request->headers.header(Headers::KnownHeader::ContentType));
         if (!request->body) {
             return false;
         }
@@ -420,14 +421,8 @@ bool ProtoRequestFastCGI::writeHeaders(quint16 status, const Cutelyst::Headers &
     headerBuffer.resize(0);
     headerBuffer.append(QByteArrayLiteral("Status: ") + QByteArray::number(status));
 
-    const auto headersData = headers.data();
-
-    bool hasDate = false;
-    for (const auto &[key, value] : headersData) {
-        if (!hasDate && key.compare("Date", Qt::CaseInsensitive) == 0) {
-            hasDate = true;
-        }
-
+    const bool hasDate = headers.contains(Headers::KnownHeader::Date);
+    for (const auto &[key, value] : headers.data()) {
         headerBuffer.append("\r\n");
         headerBuffer.append(key);
         headerBuffer.append(": ");
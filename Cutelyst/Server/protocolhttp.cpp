@@ -142,7 +142,9 @@ void ProtocolHttp::parse(Socket *sock, QIODevice *io) const
                 } else {
                     if (protoRequest->contentLength > 0) {
                         protoRequest->connState = ProtoRequestHttp::ContentBody;
-                        protoRequest->body      = createBody(protoRequest->contentLength);
+                        protoRequest->body      = createBody(
+                            protoRequest->contentLength,
+                            protoRequest->headers.header(Headers::KnownHeader::ContentType));
                         if (!protoRequest->body) {
                             qCWarning(C_SERVER_HTTP) << "error while creating body, closing socket";
                             sock->connectionClose();
@@ -347,25 +349,22 @@ bool ProtoRequestHttp::writeHeaders(quint16 status, const Cutelyst::Headers &hea
 
     QByteArray data = http11StatusMessage(status);
 
-    const auto headersData                                = headers.data();
     ProtoRequestHttp::HeaderConnection fallbackConnection = headerConnection;
     headerConnection = ProtoRequestHttp::HeaderConnection::NotSet;
 
-    bool hasDate = false;
-    for (const auto &[key, value] : headersData) {
-        if (headerConnection == ProtoRequestHttp::HeaderConnection::NotSet &&
-            key.compare("Connection", Qt::CaseInsensitive) == 0) {
-            if (value.compare("close") == 0) {
-                headerConnection = ProtoRequestHttp::HeaderConnection::Close;
-            } else if (value.compare("Upgrade") == 0) {
-                headerConnection = ProtoRequestHttp::HeaderConnection::Upgrade;
-            } else {
-                headerConnection = ProtoRequestHttp::HeaderConnection::Keep;
-            }
-        } else if (!hasDate && key.compare("Date", Qt::CaseInsensitive) == 0) {
-            hasDate = true;
+    if (headers.contains(Headers::KnownHeader::Connection)) {
+        const QByteArray connection = headers.header(Headers::KnownHeader::Connection);
+        if (connection.compare("close") == 0) {
+            headerConnection = ProtoRequestHttp::HeaderConnection::Close;
+        } else if (connection.compare("Upgrade") == 0) {
+            headerConnection = ProtoRequestHttp::HeaderConnection::Upgrade;
+        } else {
+            headerConnection = ProtoRequestHttp::HeaderConnection::Keep;
         }
+    }
+    const bool hasDate = headers.contains(Headers::KnownHeader::Date);
 
+    for (const auto &[key, value] : headers.data()) {
         data.append("\r\n");
         data.append(key);
         data.append(": ");
@@ -363,7 +363,8 @@ int ProtocolHttp2::parseData(ProtoRequestHttp2 *request, QIODevice *io, const H2
     //    "content-length" << stream->contentLength;
 
     if (!stream->body) {
-        stream->body = createBody(request->contentLength);
+        stream->body = createBody(request->contentLength,
+                                  stream->headers.header(Headers::KnownHeader::ContentType));
         if (!stream->body) {
             // Failed to create body to store data
             return sendGoAway(io, request->maxStreamId, ErrorInternalError);
@@ -805,7 +806,7 @@ bool ProtocolHttp2::upgradeH2C(Socket *socket,
 
             auto stream            = new H2Stream(1, 65535, protoRequest);
             stream->method         = request.method;
-            stream->path           = request.path;
+            stream->pathUtf8       = request.pathUtf8;
             stream->query          = request.query;
             stream->remoteUser     = request.remoteUser;
             stream->headers        = request.headers;
@@ -229,6 +229,14 @@ void Server::parseCommandLine(const QStringList &arguments)
         qtTrId("cutelystd-opt-value-bytes"));
     parser.addOption(postBufferingBufsizeOpt);
 
+    QCommandLineOption postStreamMultipartOpt(
+        u"post-stream-multipart"_s,
+        //: CLI option description
+        //% "Parse multipart/form-data bodies while they are received, "
+        //% "storing uploads directly on temporary files."
+        qtTrId("cutelystd-opt-post-stream-multipart-desc"));
+    parser.addOption(postStreamMultipartOpt);
+
     QCommandLineOption httpSocketOpt({u"http-socket"_s, u"h1"_s},
                                      //: CLI option description
                                      //% "Bind to the specified TCP socket using the HTTP protocol."
@@ -599,6 +607,10 @@ void Server::parseCommandLine(const QStringList &arguments)
         }
     }
 
+    if (parser.isSet(postStreamMultipartOpt)) {
+        setPostStreamMultipart(true);
+    }
+
     if (parser.isSet(applicationOpt)) {
         setApplication(parser.value(applicationOpt));
     }
@@ -1469,6 +1481,19 @@ qint64 Server::postBufferingBufsize() const
     return d->postBufferingBufsize;
 }
 
+void Server::setPostStreamMultipart(bool enable)
+{
+    Q_D(Server);
+    d->postStreamMultipart = enable;
+    Q_EMIT changed();
+}
+
+bool Server::postStreamMultipart() const
+{
+    Q_D(const Server);
+    return d->postStreamMultipart;
+}
+
 void Server::setTcpNodelay(bool enable)
 {
     Q_D(Server);
@@ -399,6 +399,19 @@ public:
     void setPostBufferingBufsize(qint64 size);
     [[nodiscard]] qint64 postBufferingBufsize() const;
 
+    /**
+     * Parses multipart/form-data requests while they are received, storing each upload
+     * on its own temporary file and each form field in memory, so the body is not
+     * buffered and parsed again. Request::body() has no data for such requests.
+     * Default value: \c false.
+     * @accessors postStreamMultipart(), setPostStreamMultipart()
+     * \since Cutelyst 5.1.0
+     */
+    Q_PROPERTY(bool post_stream_multipart READ postStreamMultipart WRITE setPostStreamMultipart
+                   NOTIFY changed)
+    void setPostStreamMultipart(bool enable);
+    [[nodiscard]] bool postStreamMultipart() const;
+
     /**
      * Enable TCP NODELAY on each request.
      * @accessors tcpNodelay(), setTcpNodelay()
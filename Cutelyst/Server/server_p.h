@@ -107,6 +107,7 @@ public:
     bool master                 = false;
     bool autoReload             = false;
     bool tcpNodelay             = false;
+    bool postStreamMultipart    = false;
     bool soKeepalive            = false;
     bool threadBalancer         = false;
     bool userEventLoop          = false;
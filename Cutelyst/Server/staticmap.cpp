@@ -9,9 +9,9 @@
 #include <Cutelyst/Application>
 #include <Cutelyst/Request>
 #include <Cutelyst/Response>
+#include <Cutelyst/StaticFileCache>
 
 #include <QDir>
-#include <QFile>
 #include <QLoggingCategory>
 
 Q_LOGGING_CATEGORY(C_SERVER_SM, "cutelyst.server.staticmap", QtWarningMsg)
@@ -26,8 +26,9 @@ StaticMap::StaticMap(Cutelyst::Application *parent)
 
 bool StaticMap::setup(Cutelyst::Application *app)
 {
-    connect(
-        app, &Cutelyst::Application::beforePrepareAction, this, &StaticMap::beforePrepareAction);
+    app->addBeforePrepareActionHook(this, [this](Cutelyst::Context *c, bool *skipMethod) {
+        beforePrepareAction(c, skipMethod);
+    });
     return true;
 }
 
@@ -74,46 +75,11 @@ bool StaticMap::tryToServeFile(Cutelyst::Context *c, const MountPoint &mp, const
     }
 
     QDir dir(mp.path);
-    QString absFilePath = dir.absoluteFilePath(localPath);
-    if (!QFile::exists(absFilePath)) {
-        return false;
-    }
-
-    return serveFile(c, absFilePath);
-}
-
-bool StaticMap::serveFile(Cutelyst::Context *c, const QString &filename)
-{
-    auto res                        = c->response();
-    const QDateTime currentDateTime = QFileInfo(filename).lastModified();
-    if (!c->request()->headers().ifModifiedSince(currentDateTime)) {
-        res->setStatus(Response::NotModified);
+    const QString absFilePath = dir.absoluteFilePath(localPath);
+    if (StaticFileCache::instance()->serve(c, absFilePath)) {
+        qCDebug(C_SERVER_SM) << "Serving" << absFilePath;
         return true;
     }
-
-    auto file = new QFile(filename);
-    if (file->open(QFile::ReadOnly)) {
-        qCDebug(C_SERVER_SM) << "Serving" << filename;
-        Headers &headers = res->headers();
-
-        // set our open file
-        res->setBody(file);
-
-        // use the extension to match to be faster
-        QMimeType mimeType = m_db.mimeTypeForFile(filename, QMimeDatabase::MatchExtension);
-        if (mimeType.isValid()) {
-            headers.setContentType(mimeType.name().toLatin1());
-        }
-
-        headers.setLastModified(currentDateTime);
-        // Tell Firefox & friends its OK to cache, even over SSL
-        headers.setHeader("Cache-Control"_ba, "public"_ba);
-
-        return true;
-    }
-
-    qCWarning(C_SERVER_SM) << "Could not serve" << filename << file->errorString();
-    delete file;
     return false;
 }
 
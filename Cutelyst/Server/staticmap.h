@@ -9,7 +9,6 @@
 #include <Cutelyst/Plugin>
 #include <vector>
 
-#include <QMimeDatabase>
 #include <QString>
 
 struct MountPoint {
@@ -34,9 +33,6 @@ private:
 
     bool tryToServeFile(Cutelyst::Context *c, const MountPoint &mp, const QString &path);
 
-    bool serveFile(Cutelyst::Context *c, const QString &filename);
-
-    QMimeDatabase m_db;
     std::vector<MountPoint> m_staticMaps;
 };
 
@@ -256,6 +256,9 @@ bool Application::setup(Engine *engine)
     d->engine   = engine;
     d->config   = engine->config(u"Cutelyst"_s);
 
+    d->bodyDataLimit = d->config.value(u"body_data_limit"_s, -1).toLongLong();
+    d->autoETag      = d->config.value(u"auto_etag"_s, false).toBool();
+
     d->setupHome();
 
     // Call the virtual application init
@@ -374,13 +377,16 @@ void Application::handleRequest(EngineRequest *request)
     priv->request       = new Request(request);
     priv->locale        = d->defaultLocale;
 
+    priv->request->d_ptr->bodyDataLimit = d->bodyDataLimit;
+    priv->response->setAutoETag(d->autoETag);
+
     if (d->useStats) {
         priv->stats = new Stats(request);
     }
 
     // Process request
     bool skipMethod = false;
-    Q_EMIT beforePrepareAction(c, &skipMethod);
+    d->beforePrepareAction(c, &skipMethod);
 
     if (!skipMethod) {
         static bool log = CUTELYST_REQUEST().isEnabled(QtDebugMsg);
@@ -390,7 +396,7 @@ void Application::handleRequest(EngineRequest *request)
 
         d->dispatcher->prepareAction(c);
 
-        Q_EMIT beforeDispatch(c);
+        d->beforeDispatch(c);
 
         d->dispatcher->dispatch(c);
 
@@ -398,12 +404,32 @@ void Application::handleRequest(EngineRequest *request)
             return;
         }
 
-        Q_EMIT afterDispatch(c);
+        d->afterDispatch(c);
     }
 
     c->finalize();
 }
 
+void Application::addBeforePrepareActionHook(QObject *receiver,
+                                             PrepareActionHook hook,
+                                             int priority)
+{
+    Q_D(Application);
+    d->addHook(d->beforePrepareActionHooks, receiver, std::move(hook), priority);
+}
+
+void Application::addBeforeDispatchHook(QObject *receiver, DispatchHook hook, int priority)
+{
+    Q_D(Application);
+    d->addHook(d->beforeDispatchHooks, receiver, std::move(hook), priority);
+}
+
+void Application::addAfterDispatchHook(QObject *receiver, DispatchHook hook, int priority)
+{
+    Q_D(Application);
+    d->addHook(d->afterDispatchHooks, receiver, std::move(hook), priority);
+}
+
 bool Application::enginePostFork()
 {
     Q_D(Application);
@@ -688,6 +714,113 @@ void ApplicationPrivate::setupChildren(const QObjectList &children)
     }
 }
 
+template <typename Hook>
+void ApplicationPrivate::addHook(HookList<Hook> &hooks,
+                                 QObject *receiver,
+                                 Hook &&hook,
+                                 int priority)
+{
+    Q_ASSERT(receiver);
+
+    auto list = hooks ? std::make_shared<std::vector<HookEntry<Hook>>>(*hooks)
+                      : std::make_shared<std::vector<HookEntry<Hook>>>();
+
+    // Keep the vector sorted by priority, new hooks go after the ones with the same priority
+    auto it = std::ranges::find_if(
+        *list, [priority](const HookEntry<Hook> &entry) { return entry.priority < priority; });
+    list->insert(it,
+                 HookEntry<Hook>{
+                     .hook     = std::move(hook),
+                     .receiver = receiver,
+                     .priority = priority,
+                 });
+    hooks = std::move(list);
+
+    if (!hookReceivers.contains(receiver)) {
+        hookReceivers.insert(receiver);
+        QObject::connect(receiver, &QObject::destroyed, q_ptr, [this, receiver] {
+            removeHooks(receiver);
+        });
+    }
+}
+
+namespace {
+
+template <typename Hook>
+void removeReceiverHooks(ApplicationPrivate::HookList<Hook> &hooks, const QObject *receiver)
+{
+    if (!hooks) {
+        return;
+    }
+
+    // The destroyed receiver was already cleared from its QPointer
+    auto list = std::make_shared<std::vector<ApplicationPrivate::HookEntry<Hook>>>(*hooks);
+    std::erase_if(*list, [receiver](const auto &entry) {
+        return !entry.receiver || entry.receiver.data() == receiver;
+    });
+    hooks = std::move(list);
+}
+
+} // namespace
+
+void ApplicationPrivate::removeHooks(const QObject *receiver)
+{
+    removeReceiverHooks(beforePrepareActionHooks, receiver);
+    removeReceiverHooks(beforeDispatchHooks, receiver);
+    removeReceiverHooks(afterDispatchHooks, receiver);
+    hookReceivers.remove(receiver);
+}
+
+void ApplicationPrivate::beforePrepareAction(Context *c, bool *skipMethod)
+{
+    // Iterates a snapshot, hooks of receivers destroyed by a previous hook are skipped
+    if (const auto hooks = beforePrepareActionHooks) {
+        for (const auto &entry : *hooks) {
+            if (!entry.receiver) {
+                continue;
+            }
+            entry.hook(c, skipMethod);
+            if (*skipMethod) {
+                break;
+            }
+        }
+    }
+
+    Q_EMIT q_ptr->beforePrepareAction(c, skipMethod);
+}
+
+void ApplicationPrivate::beforeDispatch(Context *c)
+{
+    if (const auto hooks = beforeDispatchHooks) {
+        for (const auto &entry : *hooks) {
+            if (entry.receiver) {
+                entry.hook(c);
+            }
+        }
+    }
+
+    Q_EMIT q_ptr->beforeDispatch(c);
+}
+
+void ApplicationPrivate::afterDispatch(Context *c)
+{
+    if (const auto hooks = afterDispatchHooks) {
+        for (const auto &entry : *hooks) {
+            if (entry.receiver) {
+                entry.hook(c);
+            }
+        }
+    }
+
+    // One shot hooks of this request, taken so they can't run twice
+    const auto contextHooks = std::exchange(c->d_ptr->afterDispatchHooks, {});
+    for (const auto &hook : contextHooks) {
+        hook(c);
+    }
+
+    Q_EMIT q_ptr->afterDispatch(c);
+}
+
 void Cutelyst::ApplicationPrivate::logRequest(const Request *req)
 {
     QString path = req->path();
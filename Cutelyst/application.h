@@ -12,6 +12,8 @@
 #include <QtCore/QVariant>
 #include <QtCore/QVector>
 
+#include <functional>
+
 class QTranslator;
 
 namespace Cutelyst {
@@ -60,6 +62,22 @@ class ApplicationPrivate;
  * default), it will be populated as directory \c "root" below \c "home".
  * @endconfigblock
  *
+ * @configblock{body_data_limit,integer,-1}
+ * Maximum size in bytes of request bodies that are parsed into memory by Request::bodyData(),
+ * Request::bodyParameters(), Request::bodyJsonDocument() and Request::bodyCbor(). Bigger bodies
+ * are left unparsed so they can be processed with JsonStreamReader or QCborStreamReader.
+ * Sequential bodies, whose size is not known up front, stop being read once they exceed the
+ * limit. Multipart bodies are not affected. A negative value (the default) disables the limit.
+ * Available since %Cutelyst 5.1.0.
+ * @endconfigblock
+ *
+ * @configblock{auto_etag,bool,false}
+ * If enabled, successful GET and HEAD responses with a QByteArray body get a strong ETag with
+ * the hash of their body, answering matching If-None-Match requests with 304 Not Modified and
+ * no body. It can be changed per request with Response::setAutoETag().
+ * Available since %Cutelyst 5.1.0.
+ * @endconfigblock
+ *
  * \logcat{core}
  */
 class CUTELYST_EXPORT Application : public QObject
@@ -403,6 +421,58 @@ public:
      */
     void setDefaultLocale(const QLocale &locale);
 
+    /**
+     * Function called by the beforePrepareAction hooks, it has the same
+     * arguments of the beforePrepareAction() signal.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    using PrepareActionHook = std::function<void(Cutelyst::Context *c, bool *skipMethod)>;
+
+    /**
+     * Function called by the beforeDispatch and afterDispatch hooks.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    using DispatchHook = std::function<void(Cutelyst::Context *c)>;
+
+    /**
+     * Adds a \a hook that is called before the Dispatcher is called to find an action,
+     * like the beforePrepareAction() signal but without going through the meta object
+     * system, which makes it the preferred way for plugins to take part of every request.
+     *
+     * Hooks with a higher \a priority are called first, the ones with the same
+     * priority are called in the order they were added. Once a hook sets \a skipMethod
+     * to \c true the remaining hooks are not called, the beforePrepareAction() signal
+     * is emitted after all hooks.
+     *
+     * The hook is removed when \a receiver is destroyed.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void addBeforePrepareActionHook(QObject *receiver, PrepareActionHook hook, int priority = 0);
+
+    /**
+     * Adds a \a hook that is called right after the Dispatcher returns the Action that
+     * will be executed, before the beforeDispatch() signal is emitted.
+     *
+     * \sa addBeforePrepareActionHook() for the meaning of \a receiver and \a priority.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void addBeforeDispatchHook(QObject *receiver, DispatchHook hook, int priority = 0);
+
+    /**
+     * Adds a \a hook that is called right after the Action found by the dispatcher got
+     * executed, before the hooks added with Context::addAfterDispatchHook() and the
+     * afterDispatch() signal.
+     *
+     * \sa addBeforePrepareActionHook() for the meaning of \a receiver and \a priority.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void addAfterDispatchHook(QObject *receiver, DispatchHook hook, int priority = 0);
+
 protected:
     /**
      * Do your application initialization here, if your
@@ -497,18 +567,28 @@ Q_SIGNALS:
      * Always check \a skipMethod and return if it’s \c true.
      * In case you want to stop further processing set
      * \a skipMethod to \c true.
+     *
+     * \note Since %Cutelyst 5.1.0 this signal is emitted after the hooks added with
+     * addBeforePrepareActionHook(), plugins that moved to hooks, like StaticSimple and
+     * ResponseCache, now run before the slots connected to this signal.
      */
     void beforePrepareAction(Cutelyst::Context *c, bool *skipMethod);
 
     /**
      * This signal is emitted right after the Dispatcher
      * returns the Action that will be executed.
+     *
+     * \note Since %Cutelyst 5.1.0 this signal is emitted after the hooks added with
+     * addBeforeDispatchHook().
      */
     void beforeDispatch(Cutelyst::Context *c);
 
     /**
      * This signal is emitted right after the Action
      * found by the dispatcher got executed.
+     *
+     * \note Since %Cutelyst 5.1.0 this signal is emitted after the hooks added with
+     * addAfterDispatchHook() and Context::addAfterDispatchHook().
      */
     void afterDispatch(Cutelyst::Context *c);
 
@@ -12,6 +12,12 @@
 #include "engine.h"
 #include "plugin.h"
 
+#include <QPointer>
+#include <QSet>
+
+#include <memory>
+#include <vector>
+
 namespace Cutelyst {
 
 class ApplicationPrivate
@@ -27,6 +33,25 @@ public:
     Component *
         createComponentPlugin(const QString &name, QObject *parent, const QString &directory);
 
+    template <typename Hook>
+    struct HookEntry {
+        Hook hook;
+        QPointer<QObject> receiver;
+        int priority;
+    };
+
+    // Replaced instead of changed so hooks can add or remove hooks while they are iterated
+    template <typename Hook>
+    using HookList = std::shared_ptr<const std::vector<HookEntry<Hook>>>;
+
+    template <typename Hook>
+    void addHook(HookList<Hook> &hooks, QObject *receiver, Hook &&hook, int priority);
+    void removeHooks(const QObject *receiver);
+
+    inline void beforePrepareAction(Context *c, bool *skipMethod);
+    inline void beforeDispatch(Context *c);
+    void afterDispatch(Context *c);
+
     Application *q_ptr;
     Dispatcher *dispatcher;
     QVector<Plugin *> plugins;
@@ -34,10 +59,16 @@ public:
     QVector<Controller *> controllers;
     QHash<QStringView, View *> views;
     QVector<DispatchType *> dispatchers;
+    HookList<Application::PrepareActionHook> beforePrepareActionHooks;
+    HookList<Application::DispatchHook> beforeDispatchHooks;
+    HookList<Application::DispatchHook> afterDispatchHooks;
+    QSet<const QObject *> hookReceivers;
     QMap<QString, ComponentFactory *> factories;
     Headers headers;
     QVariantMap config;
     Engine *engine;
+    qint64 bodyDataLimit = -1;
+    bool autoETag        = false;
     bool useStats;
     bool init = false;
     QHash<QLocale, QVector<QTranslator *>> translators;
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "cborwriter_p.h"
+#include "context.h"
+#include "request.h"
+#include "response.h"
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+QIODevice *prepareResponse(Context *c)
+{
+    Response *res = c->response();
+    if (!res->isFinalizedHeaders()) {
+        res->setContentType("application/cbor"_ba);
+        // HTTP/2 frames the body by itself, while HTTP/1.0 can only close the connection
+        if (c->request()->protocol() == "HTTP/1.1") {
+            res->setHeader("Transfer-Encoding"_ba, "chunked"_ba);
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+CborBlockDevice::CborBlockDevice(QIODevice *target, qsizetype flushSize)
+    : target(target)
+    , flushSize(flushSize)
+{
+    buffer.reserve(flushSize + 1024);
+    open(QIODevice::WriteOnly);
+}
+
+void CborBlockDevice::flush()
+{
+    if (!buffer.isEmpty()) {
+        target->write(buffer);
+        // Keeps the capacity for the next block
+        buffer.resize(0);
+    }
+}
+
+qint64 CborBlockDevice::readData(char *data, qint64 maxlen)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxlen)
+    return -1;
+}
+
+qint64 CborBlockDevice::writeData(const char *data, qint64 len)
+{
+    buffer.append(data, len);
+    if (buffer.size() >= flushSize) {
+        flush();
+    }
+    return len;
+}
+
+CborWriterPrivate::CborWriterPrivate(QIODevice *target, qsizetype flushSize)
+    : device(target, flushSize)
+    , stream(&device)
+{
+}
+
+CborWriter::CborWriter(QIODevice *device, qsizetype flushSize)
+    : d_ptr(new CborWriterPrivate(device, flushSize))
+{
+}
+
+CborWriter::CborWriter(Context *c, qsizetype flushSize)
+    : d_ptr(new CborWriterPrivate(prepareResponse(c), flushSize))
+{
+}
+
+CborWriter::~CborWriter()
+{
+    d_ptr->device.flush();
+    delete d_ptr;
+}
+
+QCborStreamWriter &CborWriter::stream()
+{
+    Q_D(CborWriter);
+    return d->stream;
+}
+
+void CborWriter::append(const QCborValue &value)
+{
+    Q_D(CborWriter);
+    value.toCbor(d->stream);
+}
+
+void CborWriter::flush()
+{
+    Q_D(CborWriter);
+    d->device.flush();
+}
+
+qsizetype CborWriter::flushSize() const noexcept
+{
+    Q_D(const CborWriter);
+    return d->device.flushSize;
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+
+#include <QtCore/QCborStreamWriter>
+#include <QtCore/QCborValue>
+
+class QIODevice;
+
+namespace Cutelyst {
+
+class Context;
+class CborWriterPrivate;
+
+/**
+ * \ingroup core
+ * \class CborWriter cborwriter.h Cutelyst/CborWriter
+ * \brief Streams CBOR items to a device in blocks.
+ *
+ * %CborWriter gives access to a QCborStreamWriter whose output is buffered and written
+ * to the device every time flushSize() bytes are available, so big results can be sent
+ * to the client as they are produced without building a QCborValue tree first, and
+ * without a tiny write for each item.
+ *
+ * When constructed with a Context it writes to the Response, setting the content type
+ * to \c application/cbor and using chunked transfer encoding on HTTP/1.1 connections,
+ * HTTP/2 sends the blocks as DATA frames.
+ *
+ * \code{.cpp}
+ * void Items::list(Context *c)
+ * {
+ *     QSqlQuery query = CPreparedSqlQueryThreadFO(u"SELECT id, name FROM items"_s);
+ *     if (query.exec()) {
+ *         CborWriter writer(c);
+ *         Sql::queryToCborMapArray(query, writer.stream());
+ *     }
+ * }
+ * \endcode
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT CborWriter
+{
+    Q_DECLARE_PRIVATE(CborWriter) // cppcheck-suppress unusedPrivateFunction
+    Q_DISABLE_COPY(CborWriter)
+public:
+    /**
+     * Constructs a writer that writes to \a device every time \a flushSize bytes
+     * are buffered.
+     */
+    explicit CborWriter(QIODevice *device, qsizetype flushSize = 16 * 1024);
+
+    /**
+     * Constructs a writer that streams to the Response of \a c.
+     */
+    explicit CborWriter(Context *c, qsizetype flushSize = 16 * 1024);
+
+    /**
+     * Destroys the writer, writing any buffered data to the device.
+     */
+    ~CborWriter();
+
+    /**
+     * Returns the stream writer, the items appended to it are written to the
+     * device in blocks.
+     */
+    [[nodiscard]] QCborStreamWriter &stream();
+
+    /**
+     * Appends the encoded \a value.
+     */
+    void append(const QCborValue &value);
+
+    /**
+     * Writes buffered data to the device.
+     */
+    void flush();
+
+    /**
+     * Returns the number of bytes buffered before writing to the device.
+     */
+    [[nodiscard]] qsizetype flushSize() const noexcept;
+
+protected:
+    CborWriterPrivate *d_ptr;
+};
+
+} // namespace Cutelyst
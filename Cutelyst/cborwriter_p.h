@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "cborwriter.h"
+
+#include <QIODevice>
+
+namespace Cutelyst {
+
+// Collects the small writes of QCborStreamWriter and forwards them in blocks
+class CborBlockDevice final : public QIODevice
+{
+public:
+    CborBlockDevice(QIODevice *target, qsizetype flushSize);
+
+    void flush();
+
+    bool isSequential() const override { return true; }
+
+    QIODevice *target;
+    QByteArray buffer;
+    qsizetype flushSize;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+};
+
+class CborWriterPrivate
+{
+public:
+    CborWriterPrivate(QIODevice *target, qsizetype flushSize);
+
+    CborBlockDevice device;
+    QCborStreamWriter stream;
+};
+
+} // namespace Cutelyst
@@ -21,5 +21,6 @@ Q_DECLARE_LOGGING_CATEGORY(CUTELYST_RESPONSE)
 Q_DECLARE_LOGGING_CATEGORY(CUTELYST_STATS)
 Q_DECLARE_LOGGING_CATEGORY(CUTELYST_COMPONENT)
 Q_DECLARE_LOGGING_CATEGORY(CUTELYST_ASYNC)
+Q_DECLARE_LOGGING_CATEGORY(CUTELYST_STATICFILECACHE)
 
 #endif // COMMON_H
@@ -3,25 +3,36 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include "action.h"
-#include "application.h"
+#include "application_p.h"
 #include "common.h"
 #include "config.h"
 #include "context_p.h"
 #include "controller.h"
-#include "dispatcher.h"
+#include "dispatcher_p.h"
 #include "enginerequest.h"
 #include "request.h"
-#include "response.h"
+#include "response_p.h"
 #include "stats.h"
 
 #include <QBuffer>
 #include <QCoreApplication>
+#include <QMutex>
 #include <QUrl>
 #include <QUrlQuery>
 
+#include <atomic>
+
 using namespace Cutelyst;
 using namespace Qt::StringLiterals;
 
+namespace {
+// ContextSlot registry, slots are usually static objects so
+// registration happens while libraries are loaded
+QBasicMutex slotMutex;
+std::atomic<quint32> slotCount{0};
+std::atomic<quint32> slotArenaSize{0};
+} // namespace
+
 Context::Context(ContextPrivate *priv)
     : d_ptr(priv)
 {
@@ -329,6 +340,81 @@ QUrl Context::uriForAction(QStringView path,
     return uri;
 }
 
+void Context::addAfterDispatchHook(std::function<void(Context *)> hook)
+{
+    Q_D(Context);
+    d->afterDispatchHooks.push_back(std::move(hook));
+}
+
+QString Context::uriForString(const QString &path,
+                              const QStringList &args,
+                              const ParamsMultiMap &queryValues) const
+{
+    Q_D(const Context);
+
+    static thread_local QByteArray buffer;
+    buffer.resize(0);
+    buffer.append(d->encodedBase());
+
+    if (path.isEmpty()) {
+        // ns must NOT return a leading slash
+        buffer.append('/');
+        UriTemplate::appendEncoded(buffer, d->action->controller()->ns(), UriTemplate::Path);
+    } else {
+        if (!path.startsWith(u'/')) {
+            buffer.append('/');
+        }
+        UriTemplate::appendEncoded(buffer, path, UriTemplate::Path);
+    }
+
+    const bool isRoot = buffer.size() == d->encodedBase().size() + 1;
+    UriTemplate::appendArgs(buffer, args, isRoot);
+    UriTemplate::appendQuery(buffer, queryValues);
+
+    return QString::fromLatin1(buffer);
+}
+
+QString Context::uriForString(Action *action,
+                              const QStringList &captures,
+                              const QStringList &args,
+                              const ParamsMultiMap &queryValues) const
+{
+    static thread_local QByteArray buffer;
+    buffer.resize(0);
+    if (!appendUriFor(buffer, action, captures, args, queryValues)) {
+        return {};
+    }
+    return QString::fromLatin1(buffer);
+}
+
+bool Context::appendUriFor(QByteArray &out,
+                           Action *action,
+                           const QStringList &captures,
+                           const QStringList &args,
+                           const ParamsMultiMap &queryValues) const
+{
+    Q_D(const Context);
+
+    if (action == nullptr) {
+        action = d->action;
+    }
+
+    const UriTemplate &uriTemplate = d->dispatcher->d_ptr->uriTemplate(action);
+    if (!uriTemplate.isValid()) {
+        qCWarning(CUTELYST_CORE) << "Can not find action for" << action << captures;
+        return false;
+    }
+
+    const qsizetype size = out.size();
+    out.append(d->encodedBase());
+    if (!uriTemplate.expand(out, captures, args, queryValues)) {
+        out.truncate(size);
+        qCWarning(CUTELYST_CORE) << "Can not find action for" << action << captures;
+        return false;
+    }
+    return true;
+}
+
 bool Context::detached() const noexcept
 {
     Q_D(const Context);
@@ -385,7 +471,7 @@ void Context::attachAsync()
             }
         }
 
-        Q_EMIT d->app->afterDispatch(this);
+        d->app->d_ptr->afterDispatch(this);
 
         finalize();
     }
@@ -500,7 +586,15 @@ void Context::finalize()
         return;
     }
 
+    // Filters the body before the Content-Length is known
+    auto response            = d->response->d_func();
+    const QString filterName = response->finishFilter(d->response, error());
+
     if (d->stats) {
+        if (!filterName.isEmpty()) {
+            d->stats->profileDuration(u"-> "_s + filterName, response->filterTime);
+        }
+
         qCDebug(CUTELYST_STATS,
                 "Response Code: %d; Content-Type: %s; Content-Length: %s",
                 d->response->status(),
@@ -554,6 +648,15 @@ QString ContextPrivate::statsStartExecute(Component *code)
     return actionName;
 }
 
+const QByteArray &ContextPrivate::encodedBase() const
+{
+    if (uriBase.isEmpty()) {
+        uriBase = request->uri().toEncoded(QUrl::RemovePath | QUrl::RemoveQuery |
+                                           QUrl::RemoveFragment);
+    }
+    return uriBase;
+}
+
 void ContextPrivate::statsFinishExecute(const QString &statsInfo)
 {
     stats->profileEnd(statsInfo);
@@ -566,5 +669,91 @@ void Context::stash(const QVariantHash &unite)
     d->stash.insert(unite);
 }
 
+ContextSlotBase::ContextSlotBase(std::size_t size, std::size_t alignment, DestroyFn destroy)
+    : m_destroy(destroy)
+    , m_size(quint32(size))
+{
+    QMutexLocker locker(&slotMutex);
+    m_index  = slotCount.fetch_add(1, std::memory_order_relaxed);
+    m_offset = (slotArenaSize.load(std::memory_order_relaxed) + quint32(alignment) - 1) &
+               ~(quint32(alignment) - 1);
+    slotArenaSize.store(m_offset + m_size, std::memory_order_release);
+}
+
+void ContextSlotBase::reset(Context *c) const
+{
+    auto &entries = c->d_ptr->slotStorage.entries;
+    if (m_index < quint32(entries.size())) {
+        auto &entry = entries[m_index];
+        if (entry.destroy) {
+            entry.destroy(entry.storage);
+            entry.destroy = nullptr;
+        }
+    }
+}
+
+void *ContextSlotBase::data(const Context *c) const noexcept
+{
+    const auto &entries = c->d_ptr->slotStorage.entries;
+    if (m_index < quint32(entries.size())) {
+        const auto &entry = entries[m_index];
+        return entry.destroy ? entry.storage : nullptr;
+    }
+    return nullptr;
+}
+
+void *ContextSlotBase::reserve(Context *c) const
+{
+    ContextSlotStorage &storage = c->d_ptr->slotStorage;
+    if (m_index >= quint32(storage.entries.size())) {
+        storage.entries.resize(std::max(m_index + 1, slotCount.load(std::memory_order_relaxed)));
+    }
+
+    auto &entry = storage.entries[m_index];
+    if (entry.storage) {
+        return entry.storage;
+    }
+
+    if (!storage.arena) {
+        storage.arenaSize = slotArenaSize.load(std::memory_order_acquire);
+        if (storage.arenaSize <= sizeof(storage.inlineArena)) {
+            storage.arena = storage.inlineArena;
+        } else {
+            storage.arena = new std::max_align_t[(storage.arenaSize + sizeof(std::max_align_t) - 1) /
+                                                 sizeof(std::max_align_t)];
+        }
+    }
+
+    if (m_offset + m_size <= storage.arenaSize) {
+        entry.storage = reinterpret_cast<char *>(storage.arena) + m_offset;
+    } else {
+        // Registered after the arena of this context was created
+        entry.storage = ::operator new(m_size);
+        entry.heap    = true;
+    }
+    return entry.storage;
+}
+
+void ContextSlotBase::commit(Context *c) const noexcept
+{
+    c->d_ptr->slotStorage.entries[m_index].destroy = m_destroy;
+}
+
+ContextSlotStorage::~ContextSlotStorage()
+{
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (it->destroy) {
+            it->destroy(it->storage);
+        }
+        if (it->heap) {
+            ::operator delete(it->storage);
+        }
+    }
+
+    if (arena != inlineArena) {
+        delete[] arena;
+    }
+}
+
 #include "moc_context.cpp"
 #include "moc_context_p.cpp"
@@ -14,6 +14,8 @@
 #include <QtCore/QUrl>
 #include <QtCore/QVariant>
 
+#include <functional>
+
 namespace Cutelyst {
 
 class Action;
@@ -262,6 +264,9 @@ public:
      * it cannot be used for persistent storage
      * (for this you must use a session; see \ref plugins-session
      * for a complete system integrated with %Cutelyst).
+     *
+     * Plugins keeping internal per request state should prefer a ContextSlot,
+     * which avoids hashing the key and boxing the value.
      */
     [[nodiscard]] QVariantHash &stash();
 
@@ -388,6 +393,63 @@ public:
     [[nodiscard]] inline QUrl uriForAction(QStringView path,
                                            const ParamsMultiMap &queryValues) const;
 
+    /**
+     * Returns the same URI as uriFor() with a \a path, but as a fully encoded string,
+     * which is what templates usually want.
+     *
+     * This is built directly from the base URI, that is cached for the request,
+     * without the QUrl and QUrlQuery round trips of uriFor().
+     *
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] QString uriForString(const QString &path               = {},
+                                       const QStringList &args           = {},
+                                       const ParamsMultiMap &queryValues = {}) const;
+
+    /**
+     * Returns the same URI as uriFor() with an \a action, but as a fully encoded string.
+     *
+     * The public path of each action is compiled once into a template, so this does
+     * not need to resolve the action on each call, only the \a captures, \a args and
+     * \a queryValues are encoded. An empty string is returned if there is no URI
+     * for \a action.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] QString uriForString(Action *action,
+                                       const QStringList &captures       = {},
+                                       const QStringList &args           = {},
+                                       const ParamsMultiMap &queryValues = {}) const;
+
+    /**
+     * Appends the fully encoded URI for \a action to \a out, this allows writing it
+     * straight into the response body without a temporary string:
+     * \code{.cpp}
+     * c->appendUriFor(c->response()->body(), c->dispatcher()->getActionByPath(u"users/list"));
+     * \endcode
+     *
+     * If \a action is a \c nullptr, the URI for the current action is appended.
+     * Returns \c false and leaves \a out unchanged if there is no URI for \a action.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    bool appendUriFor(QByteArray &out,
+                      Action *action,
+                      const QStringList &captures       = {},
+                      const QStringList &args           = {},
+                      const ParamsMultiMap &queryValues = {}) const;
+
+    /**
+     * Adds a \a hook that is called a single time after the Action of this request got
+     * executed, right after the hooks added with Application::addAfterDispatchHook().
+     *
+     * Unlike connecting to Application::afterDispatch() from within a request, the hook
+     * is not called for other requests and it's dropped together with this context.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void addAfterDispatchHook(std::function<void(Cutelyst::Context *c)> hook);
+
     /**
      * Returns \c true if the last executed Action requested
      * that the processing be escaped.
@@ -625,6 +687,7 @@ protected:
     explicit Context(ContextPrivate *priv);
 
     friend class Application;
+    friend class ApplicationPrivate;
     friend class Action;
     friend class ActionREST;
     friend class ActionChain;
@@ -633,6 +696,7 @@ protected:
     friend class Engine;
     friend class Controller;
     friend class Async;
+    friend class ContextSlotBase;
     ContextPrivate *d_ptr;
 
 private:
@@ -6,6 +6,7 @@
 #define CUTELYST_P_H
 
 #include "context.h"
+#include "contextslot.h"
 #include "enginerequest.h"
 #include "plugin.h"
 #include "request_p.h"
@@ -13,12 +14,38 @@
 
 #include <QQueue>
 #include <QStack>
+#include <QVarLengthArray>
 #include <QVariantHash>
 
+#include <vector>
+
 class QEventLoop;
 namespace Cutelyst {
 
 class Stats;
+
+class ContextSlotStorage
+{
+    Q_DISABLE_COPY_MOVE(ContextSlotStorage)
+public:
+    ContextSlotStorage() = default;
+    ~ContextSlotStorage();
+
+    struct Entry {
+        void *storage                      = nullptr;
+        ContextSlotBase::DestroyFn destroy = nullptr; // set while a value is alive
+        bool heap                          = false;
+    };
+
+    // Indexed by the slot registration order
+    QVarLengthArray<Entry, 16> entries;
+    // Slots registered before the first access share this arena,
+    // it is only heap allocated if they don't fit in the inline buffer
+    std::max_align_t *arena = nullptr;
+    quint32 arenaSize       = 0;
+    std::max_align_t inlineArena[16];
+};
+
 class ContextPrivate
 {
 public:
@@ -35,9 +62,14 @@ public:
 
     QString statsStartExecute(Component *code);
     void statsFinishExecute(const QString &statsInfo);
+    const QByteArray &encodedBase() const;
 
+    // Fully encoded scheme and authority used by uriForString()
+    mutable QByteArray uriBase;
     QStringList error;
     QVariantHash stash;
+    ContextSlotStorage slotStorage;
+    std::vector<std::function<void(Context *)>> afterDispatchHooks;
     QLocale locale{QLocale::English, QLocale::LatinScript, QLocale::UnitedStates};
     QStack<Component *> stack;
     QVector<Plugin *> plugins;
@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include <QtCore/QtGlobal>
+
+namespace Cutelyst {
+
+class Context;
+
+/**
+ * \ingroup core
+ * \class ContextSlotBase contextslot.h Cutelyst/ContextSlot
+ * \brief Untyped base of ContextSlot.
+ *
+ * This class reserves the storage of a slot and manages its lifetime inside a Context,
+ * use ContextSlot instead.
+ */
+class CUTELYST_EXPORT ContextSlotBase
+{
+public:
+    using DestroyFn = void (*)(void *value);
+
+    ContextSlotBase(const ContextSlotBase &)            = delete;
+    ContextSlotBase &operator=(const ContextSlotBase &) = delete;
+
+    /**
+     * Returns \c true if this slot holds a value for the context \p c.
+     */
+    [[nodiscard]] bool has(const Context *c) const noexcept { return data(c) != nullptr; }
+
+    /**
+     * Destroys the value this slot holds for the context \p c, if any.
+     */
+    void reset(Context *c) const;
+
+protected:
+    ContextSlotBase(std::size_t size, std::size_t alignment, DestroyFn destroy);
+
+    /**
+     * Returns the address of the live value or \c nullptr.
+     */
+    [[nodiscard]] void *data(const Context *c) const noexcept;
+
+    /**
+     * Returns uninitialized storage for this slot, commit() must be called
+     * once a value was constructed on it.
+     */
+    [[nodiscard]] void *reserve(Context *c) const;
+    void commit(Context *c) const noexcept;
+
+private:
+    DestroyFn m_destroy;
+    quint32 m_index;
+    quint32 m_offset;
+    quint32 m_size;
+};
+
+/**
+ * \ingroup core
+ * \class ContextSlot contextslot.h Cutelyst/ContextSlot
+ * \brief Typed per request storage.
+ *
+ * A %ContextSlot is a key registered once, usually as a static object in a plugin,
+ * that gives typed access to a value stored inside each Context. Values live in
+ * an array owned by the Context, thus accessing them does not hash a string or
+ * box the value in a QVariant like Context::stash() does, and they are destroyed
+ * together with the Context.
+ *
+ * The stash is still the place for data meant to be used by templates.
+ *
+ * Values never move once constructed, so references returned by ref() and
+ * emplace() remain valid until the value is reset or the Context is destroyed.
+ *
+ * \code{.cpp}
+ * namespace {
+ * ContextSlot<QByteArray> sessionId;
+ * }
+ *
+ * void MyPlugin::load(Context *c)
+ * {
+ *     if (!sessionId.has(c)) {
+ *         sessionId.set(c, c->request()->cookie("sid"));
+ *     }
+ *     qDebug() << sessionId.value(c);
+ * }
+ * \endcode
+ *
+ * \since Cutelyst 5.1.0
+ */
+template <typename T>
+class ContextSlot : public ContextSlotBase
+{
+public:
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned types are not supported in ContextSlot");
+
+    ContextSlot()
+        : ContextSlotBase(sizeof(T), alignof(T), &destroy)
+    {
+    }
+
+    /**
+     * Returns a pointer to the value of the context \p c or \c nullptr if none was set.
+     */
+    [[nodiscard]] T *get(const Context *c) const noexcept { return static_cast<T *>(data(c)); }
+
+    /**
+     * Returns a copy of the value of the context \p c or \p defaultValue if none was set.
+     */
+    [[nodiscard]] T value(const Context *c, const T &defaultValue = T{}) const
+    {
+        if (const T *ret = get(c)) {
+            return *ret;
+        }
+        return defaultValue;
+    }
+
+    /**
+     * Returns a reference to the value of the context \p c, a default constructed
+     * value is created if none was set.
+     */
+    T &ref(Context *c) const
+    {
+        if (T *ret = get(c)) {
+            return *ret;
+        }
+        return emplace(c);
+    }
+
+    /**
+     * Replaces the value of the context \p c with one constructed from \p args.
+     */
+    template <typename... Args>
+    T &emplace(Context *c, Args &&...args) const
+    {
+        reset(c);
+        T *ret = new (reserve(c)) T(std::forward<Args>(args)...);
+        commit(c);
+        return *ret;
+    }
+
+    /**
+     * Sets the value of the context \p c to \p value.
+     */
+    template <typename U = T>
+    void set(Context *c, U &&value) const
+    {
+        if (T *current = get(c)) {
+            *current = std::forward<U>(value);
+        } else {
+            emplace(c, std::forward<U>(value));
+        }
+    }
+
+private:
+    static void destroy(void *value) { static_cast<T *>(value)->~T(); }
+};
+
+} // namespace Cutelyst
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include "action.h"
+#include "actionchain.h"
 #include "application.h"
 #include "common.h"
 #include "context.h"
@@ -166,7 +167,7 @@ void Dispatcher::prepareAction(Context *c)
     Q_D(Dispatcher);
 
     const Request *request = c->request();
-    d->prepareAction(c, request->path());
+    d->prepareAction(c, request->pathUtf8());
 
     static const bool log = CUTELYST_DISPATCHER().isDebugEnabled();
     if (log) {
@@ -180,7 +181,7 @@ void Dispatcher::prepareAction(Context *c)
     }
 }
 
-void DispatcherPrivate::prepareAction(Context *c, QStringView path) const
+void DispatcherPrivate::prepareAction(Context *c, QByteArrayView path) const
 {
     QStringList args;
 
@@ -193,7 +194,7 @@ void DispatcherPrivate::prepareAction(Context *c, QStringView path) const
         // Check out the dispatch types to see if any
         // will handle the path at this level
         bool matched = std::ranges::any_of(dispatchers, [&](const DispatchType *type) {
-            return type->match(c, path, args) == DispatchType::ExactMatch;
+            return type->matchUtf8(c, path, args) == DispatchType::ExactMatch;
         });
         if (matched) {
             return;
@@ -204,9 +205,9 @@ void DispatcherPrivate::prepareAction(Context *c, QStringView path) const
             break;
         }
 
-        int pos = path.lastIndexOf(u'/');
+        const qsizetype pos = path.lastIndexOf('/');
 
-        args.emplaceFront(path.mid(pos + 1).toString());
+        args.emplaceFront(QString::fromUtf8(path.sliced(pos + 1)));
 
         if (pos == 0) {
             path.truncate(pos + 1);
@@ -321,6 +322,22 @@ QVector<DispatchType *> Dispatcher::dispatchers() const
     return d->dispatchers;
 }
 
+const UriTemplate &DispatcherPrivate::uriTemplate(Action *action) const
+{
+    // Chains are created for every request and deleted with their context, they have
+    // the URI of their registered end point which is what the cache can keep
+    if (auto chain = qobject_cast<ActionChain *>(action)) {
+        action = chain->chain().last();
+    }
+
+    auto it = uriTemplates.constFind(action);
+    if (it == uriTemplates.constEnd()) {
+        Q_Q(const Dispatcher);
+        it = uriTemplates.insert(action, UriTemplate::compile(q, action));
+    }
+    return *it;
+}
+
 void DispatcherPrivate::printActions() const
 {
     QVector<QStringList> table;
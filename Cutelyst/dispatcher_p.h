@@ -6,6 +6,7 @@
 #define CUTELYST_DISPATCHER_P_H
 
 #include "dispatcher.h"
+#include "uritemplate_p.h"
 
 namespace Cutelyst {
 
@@ -18,7 +19,7 @@ public:
     {
     }
 
-    inline void prepareAction(Context *c, QStringView path) const;
+    inline void prepareAction(Context *c, QByteArrayView path) const;
 
     void printActions() const;
     inline ActionList getContainers(QStringView ns) const;
@@ -29,6 +30,11 @@ public:
 
     static inline QString actionRel2Abs(const Context *c, QStringView path);
 
+    /**
+     * Returns the URI template of \p action, compiling it on first use.
+     */
+    const UriTemplate &uriTemplate(Action *action) const;
+
     struct ActionReplacement {
         QString name;
         Action *action = nullptr;
@@ -47,6 +53,8 @@ public:
     };
     QMap<QStringView, NameController> controllers;
     QVector<DispatchType *> dispatchers;
+    // Keyed by registered actions only, never by a per request ActionChain
+    mutable QHash<const Action *, UriTemplate> uriTemplates;
     Dispatcher *q_ptr;
 };
 
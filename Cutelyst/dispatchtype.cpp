@@ -17,6 +17,12 @@ DispatchType::~DispatchType()
 {
 }
 
+DispatchType::MatchType
+    DispatchType::matchUtf8(Context *c, QByteArrayView path, const QStringList &args) const
+{
+    return match(c, QString::fromUtf8(path), args);
+}
+
 Action *DispatchType::expandAction(const Context *c, Action *action) const
 {
     Q_UNUSED(c)
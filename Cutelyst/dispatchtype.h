@@ -56,6 +56,18 @@ public:
     [[nodiscard]] virtual MatchType
         match(Context *c, QStringView path, const QStringList &args) const = 0;
 
+    /**
+     * Returns the MatchType for the given UTF-8 encoded \a path and \a args.
+     *
+     * This is what the Dispatcher calls, the default implementation converts
+     * \a path to UTF-16 and calls match(), dispatch types able to match on the
+     * raw bytes should reimplement it to avoid that conversion.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] virtual MatchType
+        matchUtf8(Context *c, QByteArrayView path, const QStringList &args) const;
+
     /**
      * Returns an uri for an \a action with given \a captures.
      * Has to be implemented by subclasses.
@@ -194,6 +194,17 @@ DispatchType::MatchType
     return ExactMatch;
 }
 
+DispatchType::MatchType
+    DispatchTypeChained::matchUtf8(Context *c, QByteArrayView path, const QStringList &args) const
+{
+    // Chained actions only match the full path, so only convert it when there are no args
+    if (!args.isEmpty()) {
+        return NoMatch;
+    }
+
+    return match(c, QString::fromUtf8(path), args);
+}
+
 bool DispatchTypeChained::registerAction(Action *action)
 {
     Q_D(DispatchTypeChained);
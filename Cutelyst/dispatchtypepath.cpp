@@ -33,14 +33,19 @@ QByteArray DispatchTypePath::list() const
 
     QVector<QStringList> table;
 
-    auto keys = d->paths.keys();
-
-    std::ranges::sort(
-        keys, [](QStringView a, QStringView b) { return a.compare(b, Qt::CaseInsensitive) < 0; });
-    for (const auto &path : std::as_const(keys)) {
-        const auto paths = d->paths.value(path);
-        for (Action *action : paths.actions) {
-            QString _path = u'/' + path;
+    std::vector<const DispatchTypePathReplacement *> replacements;
+    replacements.reserve(d->paths.size());
+    for (const auto &entry : d->paths) {
+        replacements.push_back(&entry);
+    }
+
+    std::ranges::sort(replacements,
+                      [](const DispatchTypePathReplacement *a, const DispatchTypePathReplacement *b) {
+        return a->name.compare(b->name, Qt::CaseInsensitive) < 0;
+    });
+    for (const auto *replacement : std::as_const(replacements)) {
+        for (Action *action : replacement->actions) {
+            QString _path = u'/' + replacement->name;
             if (action->attribute(u"Args"_s).isEmpty()) {
                 _path.append(u"/...");
             } else {
@@ -69,10 +74,16 @@ QByteArray DispatchTypePath::list() const
 
 Cutelyst::DispatchType::MatchType
     DispatchTypePath::match(Context *c, QStringView path, const QStringList &args) const
+{
+    return matchUtf8(c, path.toUtf8(), args);
+}
+
+Cutelyst::DispatchType::MatchType
+    DispatchTypePath::matchUtf8(Context *c, QByteArrayView path, const QStringList &args) const
 {
     Q_D(const DispatchTypePath);
 
-    auto it = d->paths.constFind(path);
+    auto it = d->paths.constFind(QByteArray::fromRawData(path.data(), path.size()));
     if (it == d->paths.constEnd()) {
         return NoMatch;
     }
@@ -155,7 +166,8 @@ bool DispatchTypePathPrivate::registerPath(const QString &path, Action *action)
         _path.prepend(u'/');
     }
 
-    auto it = paths.find(_path);
+    const QByteArray key = _path.toUtf8();
+    auto it              = paths.find(key);
     if (it != paths.end()) {
         qint8 actionNumberOfArgs = action->numberOfArgs();
         auto &actions            = it->actions;
@@ -179,7 +191,7 @@ bool DispatchTypePathPrivate::registerPath(const QString &path, Action *action)
             return a->numberOfArgs() < b->numberOfArgs();
         });
     } else {
-        paths.insert(_path,
+        paths.insert(key,
                      DispatchTypePathReplacement{
                          .name    = _path,
                          .actions = {action},
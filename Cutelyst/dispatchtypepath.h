@@ -37,6 +37,8 @@ public:
 
     MatchType match(Context *c, QStringView path, const QStringList &args) const override;
 
+    MatchType matchUtf8(Context *c, QByteArrayView path, const QStringList &args) const override;
+
     bool registerAction(Action *action) override;
 
     bool inUse() override;
@@ -14,7 +14,8 @@ struct DispatchTypePathReplacement {
     QString name;
     Actions actions;
 };
-typedef QHash<QStringView, DispatchTypePathReplacement> StringActionsMap;
+// Keyed by the UTF-8 encoded path so requests can be matched on their raw bytes
+typedef QHash<QByteArray, DispatchTypePathReplacement> StringActionsMap;
 
 class DispatchTypePathPrivate
 {
@@ -30,7 +30,11 @@ void EngineRequest::finalizeBody()
         Response *response    = context->response();
         QIODevice *bodyDevice = response->bodyDevice();
 
-        if (bodyDevice) {
+        if (!response->d_ptr->ranges.isEmpty()) {
+            if (!response->d_ptr->writeRanges()) {
+                qCWarning(CUTELYST_ENGINEREQUEST) << "Failed to write body ranges";
+            }
+        } else if (bodyDevice) {
             if (!bodyDevice->isSequential()) {
                 bodyDevice->seek(0);
             }
@@ -106,10 +110,13 @@ bool EngineRequest::finalizeHeaders()
     Response *response  = context->response();
     Headers &headersRef = response->headers();
 
-    // Set content length if we have a valid one
+    // Might turn the response into a 304 without a body
+    response->d_ptr->finalizeETag(this);
+
+    // Set content length if we have a valid one, which might be of the requested ranges
     const qint64 size = response->size();
     if (size >= 0) {
-        headersRef.setContentLength(size);
+        headersRef.setContentLength(response->d_ptr->selectRanges(this, size));
     }
 
     finalizeCookies();
@@ -202,7 +209,7 @@ bool EngineRequest::webSocketHandshakeDo(const QByteArray &key,
 void EngineRequest::setPath(char *rawPath, const int len)
 {
     if (len == 0) {
-        path = u"/"_s;
+        pathUtf8 = "/"_ba;
         return;
     }
 
@@ -210,7 +217,6 @@ void EngineRequest::setPath(char *rawPath, const int len)
     const char *inputPtr = data;
 
     bool lastSlash = false;
-    bool skipUtf8  = true;
     int outlen     = 0;
     for (int i = 0; i < len; ++i, ++outlen) {
         const char c = inputPtr[i];
@@ -234,8 +240,7 @@ void EngineRequest::setPath(char *rawPath, const int len)
                 b = b - 'A' + 10;
             }
 
-            *data++  = char((a << 4) | b);
-            skipUtf8 = false;
+            *data++ = char((a << 4) | b);
         } else if (c == '+') {
             *data++ = ' ';
         } else if (c == '/') {
@@ -253,14 +258,12 @@ void EngineRequest::setPath(char *rawPath, const int len)
         lastSlash = false;
     }
 
-    if (skipUtf8) {
-        path = QString::fromLatin1(rawPath, outlen);
+    if (rawPath[0] == '/') {
+        pathUtf8 = QByteArray(rawPath, outlen);
     } else {
-        path = QString::fromUtf8(rawPath, outlen);
-    }
-
-    if (!path.startsWith(u'/')) {
-        path.prepend(u'/');
+        pathUtf8.clear();
+        pathUtf8.reserve(outlen + 1);
+        pathUtf8.append('/').append(rawPath, outlen);
     }
 }
 
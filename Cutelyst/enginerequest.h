@@ -128,6 +128,9 @@ public:
      * This method sets the path and already does the decoding so that it is
      * done a single time.
      *
+     * The decoded path is kept as UTF-8 so that the dispatcher can route on it
+     * directly, Request::path() only converts it to UTF-16 when asked.
+     *
      * The path requested by the user agent '/index', MUST have a leading slash
      */
     void setPath(char *rawPath, int len);
@@ -141,9 +144,19 @@ public:
     /** The method used (GET, POST...) */
     QByteArray method;
 
-    /** Call setPath() instead */
+    /**
+     * \deprecated Engines should call setPath() which fills pathUtf8, this is only
+     * used by Request when pathUtf8 is empty.
+     */
     QString path;
 
+    /**
+     * The decoded UTF-8 path, call setPath() instead
+     *
+     * \since Cutelyst 5.1.0
+     */
+    QByteArray pathUtf8;
+
     /** The query string requested by the user agent 'foo=bar&baz' */
     QByteArray query;
 
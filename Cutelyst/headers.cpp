@@ -7,6 +7,8 @@
 #include "common.h"
 #include "engine.h"
 
+#include <algorithm>
+
 #include <QStringList>
 #include <QTimeZone>
 
@@ -41,32 +43,157 @@ inline static Headers::Authorization decodeBasicAuthPair(const QByteArray &auth)
     return ret;
 }
 
-static QVector<Headers::HeaderKeyValue>::const_iterator
-    findHeaderConst(const QVector<Headers::HeaderKeyValue> &headers, QAnyStringView key) noexcept
+namespace {
+
+constexpr std::array<QLatin1StringView, std::size_t(Headers::KnownHeader::Unknown)> knownNames = {
+    "Accept"_L1,
+    "Accept-Encoding"_L1,
+    "Accept-Language"_L1,
+    "Allow"_L1,
+    "Authorization"_L1,
+    "Cache-Control"_L1,
+    "Connection"_L1,
+    "Content-Disposition"_L1,
+    "Content-Encoding"_L1,
+    "Content-Language"_L1,
+    "Content-Length"_L1,
+    "Content-Type"_L1,
+    "Cookie"_L1,
+    "Date"_L1,
+    "ETag"_L1,
+    "Expires"_L1,
+    "Host"_L1,
+    "If-Match"_L1,
+    "If-Modified-Since"_L1,
+    "If-None-Match"_L1,
+    "If-Range"_L1,
+    "Last-Modified"_L1,
+    "Location"_L1,
+    "Origin"_L1,
+    "Proxy-Authenticate"_L1,
+    "Proxy-Authorization"_L1,
+    "Range"_L1,
+    "Referer"_L1,
+    "Server"_L1,
+    "Set-Cookie"_L1,
+    "Transfer-Encoding"_L1,
+    "Upgrade"_L1,
+    "User-Agent"_L1,
+    "Vary"_L1,
+    "Www-Authenticate"_L1,
+    "X-Forwarded-For"_L1,
+    "X-Forwarded-Host"_L1,
+    "X-Forwarded-Proto"_L1,
+};
+
+constexpr char16_t foldChar(char ch) noexcept
+{
+    return char16_t(uchar(ch));
+}
+
+constexpr char16_t foldChar(char8_t ch) noexcept
+{
+    return char16_t(ch);
+}
+
+constexpr char16_t foldChar(QChar ch) noexcept
+{
+    return ch.unicode();
+}
+
+// FNV-1a over the ASCII lower cased key, header names are tokens so non ASCII
+// code units are skipped, this keeps UTF-8 and UTF-16 keys hashing the same
+template <typename View>
+constexpr quint32 foldHash(View view) noexcept
+{
+    quint32 hash = 2166136261u;
+    for (const auto ch : view) {
+        char16_t c = foldChar(ch);
+        if (c >= 0x80) {
+            continue;
+        }
+        if (c >= u'A' && c <= u'Z') {
+            c += 0x20;
+        }
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+quint32 keyHash(QAnyStringView key) noexcept
 {
-    return std::ranges::find_if(headers, [key](Headers::HeaderKeyValue entry) {
-        return QAnyStringView::compare(key, entry.key, Qt::CaseInsensitive) == 0;
-    });
+    return key.visit([](auto view) { return foldHash(view); });
 }
 
+using KnownHash = std::pair<quint32, Headers::KnownHeader>;
+
+constexpr auto knownHashes = [] {
+    std::array<KnownHash, knownNames.size()> ret{};
+    for (std::size_t i = 0; i < knownNames.size(); ++i) {
+        ret[i] = {foldHash(knownNames[i]), Headers::KnownHeader(i)};
+    }
+    std::ranges::sort(ret, {}, &KnownHash::first);
+    return ret;
+}();
+
+static_assert(std::ranges::adjacent_find(knownHashes, {}, &KnownHash::first) == knownHashes.end(),
+              "Known header names must have distinct hashes");
+
+Headers::KnownHeader knownHeaderFor(quint32 hash, QAnyStringView key) noexcept
+{
+    const auto it = std::ranges::lower_bound(knownHashes, hash, {}, &KnownHash::first);
+    if (it != knownHashes.end() && it->first == hash &&
+        QAnyStringView::compare(key, knownNames[std::size_t(it->second)], Qt::CaseInsensitive) ==
+            0) {
+        return it->second;
+    }
+    return Headers::KnownHeader::Unknown;
+}
+
+// Checks an If-Match or If-None-Match list of entity tags, weak ones included
+bool matchesETag(QByteArrayView value, QAnyStringView etag)
+{
+    while (!value.isEmpty()) {
+        const qsizetype comma = value.indexOf(',');
+        QByteArrayView tag    = (comma == -1 ? value : value.first(comma)).trimmed();
+        value                 = comma == -1 ? QByteArrayView{} : value.sliced(comma + 1);
+
+        if (tag == "*") {
+            return true;
+        }
+        if (tag.startsWith("W/")) {
+            tag = tag.sliced(2);
+        }
+        if (tag.size() >= 2 && tag.startsWith('"') && tag.endsWith('"') &&
+            QAnyStringView::equal(QLatin1StringView{tag.sliced(1, tag.size() - 2)}, etag)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 Headers::Headers(const Headers &other) noexcept
     : m_data(other.m_data)
+    , m_meta(other.m_meta)
+    , m_known(other.m_known)
 {
 }
 
 QByteArray Headers::contentDisposition() const noexcept
 {
-    return header("Content-Disposition");
+    return header(KnownHeader::ContentDisposition);
 }
 
 void Headers::setCacheControl(const QByteArray &value)
 {
-    setHeader("Cache-Control"_ba, value);
+    setHeader(KnownHeader::CacheControl, value);
 }
 
 void Headers::setContentDisposition(const QByteArray &contentDisposition)
 {
-    setHeader("Content-Disposition"_ba, contentDisposition);
+    setHeader(KnownHeader::ContentDisposition, contentDisposition);
 }
 
 void Headers::setContentDispositionAttachment(const QByteArray &filename)
@@ -80,17 +207,17 @@ void Headers::setContentDispositionAttachment(const QByteArray &filename)
 
 QByteArray Headers::contentEncoding() const noexcept
 {
-    return header("Content-Encoding");
+    return header(KnownHeader::ContentEncoding);
 }
 
 void Headers::setContentEncoding(const QByteArray &encoding)
 {
-    setHeader("Content-Encoding"_ba, encoding);
+    setHeader(KnownHeader::ContentEncoding, encoding);
 }
 
 QByteArray Headers::contentType() const
 {
-    QByteArray ret = header("Content-Type");
+    QByteArray ret = header(KnownHeader::ContentType);
     if (!ret.isEmpty()) {
         ret = ret.mid(0, ret.indexOf(';')).toLower();
     }
@@ -99,13 +226,13 @@ QByteArray Headers::contentType() const
 
 void Headers::setContentType(const QByteArray &contentType)
 {
-    setHeader("Content-Type"_ba, contentType);
+    setHeader(KnownHeader::ContentType, contentType);
 }
 
 QByteArray Headers::contentTypeCharset() const
 {
     QByteArray ret;
-    const QByteArray _contentType = header("Content-Type");
+    const QByteArray _contentType = header(KnownHeader::ContentType);
     if (!_contentType.isEmpty()) {
         int pos = _contentType.indexOf("charset=", 0);
         if (pos != -1) {
@@ -119,13 +246,13 @@ QByteArray Headers::contentTypeCharset() const
 
 void Headers::setContentTypeCharset(const QByteArray &charset)
 {
-    auto result = findHeaderConst(m_data, "Content-Type");
-    if (result == m_data.end() || (result->value.isEmpty() && !charset.isEmpty())) {
+    const qint32 index = m_known[std::size_t(KnownHeader::ContentType)];
+    if (index == -1 || (m_data[index].value.isEmpty() && !charset.isEmpty())) {
         setContentType("charset=" + charset);
         return;
     }
 
-    QByteArray _contentType = result->value;
+    QByteArray _contentType = m_data[index].value;
     int pos                 = _contentType.indexOf("charset=", 0);
     if (pos != -1) {
         int endPos = _contentType.indexOf(';', pos);
@@ -133,7 +260,7 @@ void Headers::setContentTypeCharset(const QByteArray &charset)
             if (charset.isEmpty()) {
                 int lastPos = _contentType.lastIndexOf(';', pos);
                 if (lastPos == -1) {
-                    removeHeader("Content-Type");
+                    removeHeader(KnownHeader::ContentType);
                     return;
                 } else {
                     _contentType.remove(lastPos, _contentType.length() - lastPos);
@@ -152,7 +279,7 @@ void Headers::setContentTypeCharset(const QByteArray &charset)
 
 bool Headers::contentIsText() const
 {
-    return header("Content-Type").startsWith("text/");
+    return header(KnownHeader::ContentType).startsWith("text/");
 }
 
 bool Headers::contentIsHtml() const
@@ -177,7 +304,7 @@ bool Headers::contentIsXml() const
 
 bool Headers::contentIsJson() const
 {
-    auto value = header("Content-Type");
+    auto value = header(KnownHeader::ContentType);
     if (!value.isEmpty()) {
         return value.compare("application/json") == 0;
     }
@@ -186,7 +313,7 @@ bool Headers::contentIsJson() const
 
 qint64 Headers::contentLength() const
 {
-    auto value = header("Content-Length");
+    auto value = header(KnownHeader::ContentLength);
     if (!value.isEmpty()) {
         return value.toLongLong();
     }
@@ -195,7 +322,7 @@ qint64 Headers::contentLength() const
 
 void Headers::setContentLength(qint64 value)
 {
-    setHeader("Content-Length"_ba, QByteArray::number(value));
+    setHeader(KnownHeader::ContentLength, QByteArray::number(value));
 }
 
 QByteArray Headers::setDateWithDateTime(const QDateTime &date)
@@ -204,14 +331,14 @@ QByteArray Headers::setDateWithDateTime(const QDateTime &date)
     // and follow RFC 822
     QByteArray dt =
         QLocale::c().toString(date.toUTC(), u"ddd, dd MMM yyyy hh:mm:ss 'GMT").toLatin1();
-    setHeader("Date"_ba, dt);
+    setHeader(KnownHeader::Date, dt);
     return dt;
 }
 
 QDateTime Headers::date() const
 {
     QDateTime ret;
-    auto value = header("Date");
+    auto value = header(KnownHeader::Date);
     if (!value.isEmpty()) {
         if (value.endsWith(" GMT")) {
             ret = QLocale::c().toDateTime(QString::fromLatin1(value.left(value.size() - 4)),
@@ -228,13 +355,13 @@ QDateTime Headers::date() const
 
 QByteArray Headers::ifModifiedSince() const noexcept
 {
-    return header("If-Modified-Since");
+    return header(KnownHeader::IfModifiedSince);
 }
 
 QDateTime Headers::ifModifiedSinceDateTime() const
 {
     QDateTime ret;
-    auto value = header("If-Modified-Since");
+    auto value = header(KnownHeader::IfModifiedSince);
     if (!value.isEmpty()) {
         if (value.endsWith(" GMT")) {
             ret = QLocale::c().toDateTime(QString::fromLatin1(value.left(value.size() - 4)),
@@ -251,7 +378,7 @@ QDateTime Headers::ifModifiedSinceDateTime() const
 
 bool Headers::ifModifiedSince(const QDateTime &lastModified) const
 {
-    auto value = header("If-Modified-Since");
+    auto value = header(KnownHeader::IfModifiedSince);
     if (!value.isEmpty()) {
         return value != QLocale::c()
                             .toString(lastModified.toUTC(), u"ddd, dd MMM yyyy hh:mm:ss 'GMT")
@@ -262,39 +389,28 @@ bool Headers::ifModifiedSince(const QDateTime &lastModified) const
 
 bool Headers::ifMatch(QAnyStringView etag) const
 {
-    auto value = header("If-Match");
-    if (!value.isEmpty()) {
-        const auto clientETag = QByteArrayView(value);
-        return clientETag.sliced(1, clientETag.size() - 2) == etag ||
-               clientETag.sliced(3, clientETag.size() - 4) == etag; // Weak ETag
-    }
-    return true;
+    auto value = header(KnownHeader::IfMatch);
+    return value.isEmpty() || matchesETag(value, etag);
 }
 
 bool Headers::ifNoneMatch(QAnyStringView etag) const
 {
-    auto value = header("If-None-Match");
-    if (!value.isEmpty()) {
-        const auto clientETag = QByteArrayView(value);
-        return clientETag.sliced(1, clientETag.size() - 2) == etag ||
-               clientETag.sliced(3, clientETag.size() - 4) == etag; // Weak ETag
-    }
-    return false;
+    return matchesETag(header(KnownHeader::IfNoneMatch), etag);
 }
 
 void Headers::setETag(const QByteArray &etag)
 {
-    setHeader("ETag"_ba, '"' + etag + '"');
+    setHeader(KnownHeader::ETag, '"' + etag + '"');
 }
 
 QByteArray Headers::lastModified() const noexcept
 {
-    return header("Last-Modified");
+    return header(KnownHeader::LastModified);
 }
 
 void Headers::setLastModified(const QByteArray &value)
 {
-    setHeader("Last-Modified"_ba, value);
+    setHeader(KnownHeader::LastModified, value);
 }
 
 QString Headers::setLastModified(const QDateTime &lastModified)
@@ -308,32 +424,32 @@ QString Headers::setLastModified(const QDateTime &lastModified)
 
 QByteArray Headers::server() const noexcept
 {
-    return header("Server");
+    return header(KnownHeader::Server);
 }
 
 void Headers::setServer(const QByteArray &value)
 {
-    setHeader("Server"_ba, value);
+    setHeader(KnownHeader::Server, value);
 }
 
 QByteArray Headers::connection() const noexcept
 {
-    return header("Connection");
+    return header(KnownHeader::Connection);
 }
 
 QByteArray Headers::host() const noexcept
 {
-    return header("Host");
+    return header(KnownHeader::Host);
 }
 
 QByteArray Headers::userAgent() const noexcept
 {
-    return header("User-Agent");
+    return header(KnownHeader::UserAgent);
 }
 
 QByteArray Headers::referer() const noexcept
 {
-    return header("Referer");
+    return header(KnownHeader::Referer);
 }
 
 void Headers::setReferer(const QByteArray &uri)
@@ -341,25 +457,25 @@ void Headers::setReferer(const QByteArray &uri)
     int fragmentPos = uri.indexOf('#');
     if (fragmentPos != -1) {
         // Strip fragment per RFC 2616, section 14.36.
-        setHeader("Referer"_ba, uri.mid(0, fragmentPos));
+        setHeader(KnownHeader::Referer, uri.mid(0, fragmentPos));
     } else {
-        setHeader("Referer"_ba, uri);
+        setHeader(KnownHeader::Referer, uri);
     }
 }
 
 void Headers::setWwwAuthenticate(const QByteArray &value)
 {
-    setHeader("Www-Authenticate"_ba, value);
+    setHeader(KnownHeader::WwwAuthenticate, value);
 }
 
 void Headers::setProxyAuthenticate(const QByteArray &value)
 {
-    setHeader("Proxy-Authenticate"_ba, value);
+    setHeader(KnownHeader::ProxyAuthenticate, value);
 }
 
 QByteArray Headers::authorization() const noexcept
 {
-    return header("Authorization");
+    return header(KnownHeader::Authorization);
 }
 
 QByteArray Headers::authorizationBearer() const
@@ -394,13 +510,13 @@ QByteArray Headers::setAuthorizationBasic(const QString &username, const QString
 
     const QString result = username + u':' + password;
     ret                  = "Basic " + result.toLatin1().toBase64();
-    setHeader("Authorization"_ba, ret);
+    setHeader(KnownHeader::Authorization, ret);
     return ret;
 }
 
 QByteArray Headers::proxyAuthorization() const noexcept
 {
-    return header("Proxy-Authorization");
+    return header(KnownHeader::ProxyAuthorization);
 }
 
 QByteArray Headers::proxyAuthorizationBasic() const
@@ -415,8 +531,8 @@ Headers::Authorization Headers::proxyAuthorizationBasicObject() const
 
 QByteArray Headers::header(QAnyStringView key) const noexcept
 {
-    if (auto result = findHeaderConst(m_data, key); result != m_data.end()) {
-        return result->value;
+    if (const auto index = indexOf(key); index != -1) {
+        return m_data[index].value;
     }
     return {};
 }
@@ -428,16 +544,16 @@ QString Headers::headerAsString(QAnyStringView key) const
 
 QByteArray Headers::header(QAnyStringView key, const QByteArray &defaultValue) const noexcept
 {
-    if (auto result = findHeaderConst(m_data, key); result != m_data.end()) {
-        return result->value;
+    if (const auto index = indexOf(key); index != -1) {
+        return m_data[index].value;
     }
     return defaultValue;
 }
 
 QString Headers::headerAsString(QAnyStringView key, const QString &defaultValue) const
 {
-    if (auto result = findHeaderConst(m_data, key); result != m_data.end()) {
-        return QString::fromLatin1(result->value);
+    if (const auto index = indexOf(key); index != -1) {
+        return QString::fromLatin1(m_data[index].value);
     }
     return defaultValue;
 }
@@ -445,8 +561,17 @@ QString Headers::headerAsString(QAnyStringView key, const QString &defaultValue)
 QByteArrayList Headers::headers(QAnyStringView key) const
 {
     QByteArrayList ret;
-    for (auto result = findHeaderConst(m_data, key); result != m_data.end(); ++result) {
-        ret.append(result->value);
+    const quint32 hash = keyHash(key);
+    const auto first   = indexOf(hash, knownHeaderFor(hash, key), key);
+    if (first == -1) {
+        return ret;
+    }
+
+    for (auto index = first; index < m_data.size(); ++index) {
+        if (m_meta[index].hash == hash &&
+            QAnyStringView::compare(key, m_data[index].key, Qt::CaseInsensitive) == 0) {
+            ret.append(m_data[index].value);
+        }
     }
     return ret;
 }
@@ -454,27 +579,38 @@ QByteArrayList Headers::headers(QAnyStringView key) const
 QStringList Headers::headersAsStrings(QAnyStringView key) const
 {
     QStringList ret;
-    for (auto result = findHeaderConst(m_data, key); result != m_data.end(); ++result) {
-        ret.append(QString::fromLatin1(result->value));
+    const auto values = headers(key);
+    ret.reserve(values.size());
+    for (const auto &value : values) {
+        ret.append(QString::fromLatin1(value));
     }
     return ret;
 }
 
 void Headers::setHeader(const QByteArray &key, const QByteArray &value)
 {
-    const auto matchKey = [key](const Headers::HeaderKeyValue &entry) {
-        return key.compare(entry.key, Qt::CaseInsensitive) == 0;
-    };
+    const quint32 hash = keyHash(key);
+    const auto id      = knownHeaderFor(hash, key);
+    const auto index   = indexOf(hash, id, key);
+    if (index == -1) {
+        append(hash, id, key, value);
+        return;
+    }
 
-    if (auto result = std::ranges::find_if(m_data, matchKey); result != m_data.end()) {
-        result->value = value;
-        ++result;
+    m_data[index].value = value;
 
-        QVector<HeaderKeyValue>::ConstIterator begin =
-            std::remove_if(result, m_data.end(), matchKey);
-        m_data.erase(begin, m_data.cend());
-    } else {
-        m_data.emplace_back(HeaderKeyValue{.key = key, .value = value});
+    // Drop any other occurrence of this field
+    bool removed = false;
+    for (qsizetype i = m_data.size() - 1; i > index; --i) {
+        if (m_meta[i].hash == hash && key.compare(m_data[i].key, Qt::CaseInsensitive) == 0) {
+            m_data.removeAt(i);
+            m_meta.removeAt(i);
+            removed = true;
+        }
+    }
+
+    if (removed) {
+        rebuildKnownIndex();
     }
 }
 
@@ -485,35 +621,125 @@ void Headers::setHeader(const QByteArray &field, const QByteArrayList &values)
 
 void Headers::pushHeader(const QByteArray &key, const QByteArray &value)
 {
-    m_data.emplace_back(HeaderKeyValue{.key = key, .value = value});
+    const quint32 hash = keyHash(key);
+    append(hash, knownHeaderFor(hash, key), key, value);
 }
 
 void Headers::pushHeader(const QByteArray &key, const QByteArrayList &values)
 {
-    m_data.emplace_back(HeaderKeyValue{.key = key, .value = values.join(", ")});
+    pushHeader(key, values.join(", "));
 }
 
 void Headers::removeHeader(QAnyStringView key)
 {
-    m_data.removeIf([key](HeaderKeyValue entry) {
-        return QAnyStringView::compare(key, entry.key, Qt::CaseInsensitive) == 0;
-    });
+    const quint32 hash = keyHash(key);
+    bool removed       = false;
+    for (qsizetype i = m_data.size() - 1; i >= 0; --i) {
+        if (m_meta[i].hash == hash &&
+            QAnyStringView::compare(key, m_data[i].key, Qt::CaseInsensitive) == 0) {
+            m_data.removeAt(i);
+            m_meta.removeAt(i);
+            removed = true;
+        }
+    }
+
+    if (removed) {
+        rebuildKnownIndex();
+    }
+}
+
+QByteArray Headers::header(KnownHeader id) const noexcept
+{
+    if (const qint32 index = m_known[std::size_t(id)]; index != -1) {
+        return m_data[index].value;
+    }
+    return {};
+}
+
+void Headers::setHeader(KnownHeader id, const QByteArray &value)
+{
+    const qint32 index = m_known[std::size_t(id)];
+    if (index == -1) {
+        const QLatin1StringView name = knownNames[std::size_t(id)];
+        append(foldHash(name), id, QByteArray::fromRawData(name.data(), name.size()), value);
+        return;
+    }
+
+    m_data[index].value = value;
+
+    bool removed = false;
+    for (qsizetype i = m_data.size() - 1; i > index; --i) {
+        if (m_meta[i].id == id) {
+            m_data.removeAt(i);
+            m_meta.removeAt(i);
+            removed = true;
+        }
+    }
+
+    if (removed) {
+        rebuildKnownIndex();
+    }
+}
+
+void Headers::removeHeader(KnownHeader id)
+{
+    if (m_known[std::size_t(id)] == -1) {
+        return;
+    }
+
+    for (qsizetype i = m_data.size() - 1; i >= 0; --i) {
+        if (m_meta[i].id == id) {
+            m_data.removeAt(i);
+            m_meta.removeAt(i);
+        }
+    }
+    rebuildKnownIndex();
+}
+
+bool Headers::contains(KnownHeader id) const noexcept
+{
+    return m_known[std::size_t(id)] != -1;
+}
+
+Headers::KnownHeader Headers::knownHeader(QAnyStringView key) noexcept
+{
+    return knownHeaderFor(keyHash(key), key);
+}
+
+QByteArray Headers::knownHeaderName(KnownHeader id) noexcept
+{
+    if (id == KnownHeader::Unknown) {
+        return {};
+    }
+    const QLatin1StringView name = knownNames[std::size_t(id)];
+    return QByteArray::fromRawData(name.data(), name.size());
+}
+
+void Headers::clear() noexcept
+{
+    m_data.clear();
+    m_meta.clear();
+    m_known = emptyKnownIndex();
 }
 
 bool Headers::contains(QAnyStringView key) const noexcept
 {
-    auto result = findHeaderConst(m_data, key);
-    return result != m_data.end();
+    return indexOf(key) != -1;
 }
 
 QByteArrayList Headers::keys() const
 {
     QByteArrayList ret;
 
-    for (const auto &_header : m_data) {
-        const bool exists = std::ranges::any_of(ret, [&](const QByteArray &key) {
-            return _header.key.compare(key, Qt::CaseInsensitive) == 0;
-        });
+    for (qsizetype i = 0; i < m_data.size(); ++i) {
+        const auto &_header = m_data[i];
+        const quint32 hash  = m_meta[i].hash;
+
+        bool exists = false;
+        for (qsizetype j = 0; j < i && !exists; ++j) {
+            exists = m_meta[j].hash == hash &&
+                     m_data[j].key.compare(_header.key, Qt::CaseInsensitive) == 0;
+        }
 
         if (!exists) {
             ret.append(_header.key);
@@ -530,7 +756,7 @@ QByteArray Headers::operator[](QAnyStringView key) const noexcept
 
 bool Headers::operator==(const Headers &other) const noexcept
 {
-    const auto otherData = other.data();
+    const auto &otherData = other.data();
     if (m_data.size() != otherData.size()) {
         return false;
     }
@@ -539,9 +765,50 @@ bool Headers::operator==(const Headers &other) const noexcept
         m_data, [otherData](const auto &myValue) { return otherData.contains(myValue); });
 }
 
+qsizetype Headers::indexOf(QAnyStringView key) const noexcept
+{
+    const quint32 hash = keyHash(key);
+    return indexOf(hash, knownHeaderFor(hash, key), key);
+}
+
+qsizetype Headers::indexOf(quint32 hash, KnownHeader id, QAnyStringView key) const noexcept
+{
+    if (id != KnownHeader::Unknown) {
+        return m_known[std::size_t(id)];
+    }
+
+    for (qsizetype i = 0; i < m_meta.size(); ++i) {
+        if (m_meta[i].hash == hash &&
+            QAnyStringView::compare(key, m_data[i].key, Qt::CaseInsensitive) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void Headers::append(quint32 hash, KnownHeader id, const QByteArray &key, const QByteArray &value)
+{
+    if (id != KnownHeader::Unknown && m_known[std::size_t(id)] == -1) {
+        m_known[std::size_t(id)] = qint32(m_data.size());
+    }
+    m_data.emplace_back(HeaderKeyValue{.key = key, .value = value});
+    m_meta.append(HeaderMeta{.hash = hash, .id = id});
+}
+
+void Headers::rebuildKnownIndex() noexcept
+{
+    m_known = emptyKnownIndex();
+    for (qsizetype i = 0; i < m_meta.size(); ++i) {
+        const auto id = m_meta[i].id;
+        if (id != KnownHeader::Unknown && m_known[std::size_t(id)] == -1) {
+            m_known[std::size_t(id)] = qint32(i);
+        }
+    }
+}
+
 QDebug operator<<(QDebug debug, const Headers &headers)
 {
-    const auto data       = headers.data();
+    const auto &data      = headers.data();
     const bool oldSetting = debug.autoInsertSpaces();
     debug.nospace() << "Headers[";
     for (auto it = data.begin(); it != data.end(); ++it) {
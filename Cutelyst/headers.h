@@ -6,8 +6,11 @@
 
 #include <Cutelyst/cutelyst_export.h>
 
+#include <array>
+
 #include <QtCore/QDateTime>
 #include <QtCore/QMetaType>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/QVariant>
 
 namespace Cutelyst {
@@ -19,10 +22,65 @@ namespace Cutelyst {
  *
  * %Headers is a container for HTTP headers that also implements helper methods to set and
  * get specific headers.
+ *
+ * Header names are matched case-insensitively. Well-known header fields, listed in
+ * KnownHeader, are tagged when inserted and have a dedicated slot pointing to their
+ * first occurrence, so looking them up does not require scanning the container. Any other
+ * field is located by comparing a precomputed case-folded hash of its name before comparing
+ * the name itself.
  */
 class CUTELYST_EXPORT Headers
 {
 public:
+    /**
+     * Well-known header fields that have an O(1) lookup slot.
+     *
+     * The string based methods automatically detect these names, the overloads taking a
+     * KnownHeader skip the name hashing altogether.
+     * \since Cutelyst 5.1.0
+     */
+    enum class KnownHeader : quint8 {
+        Accept,
+        AcceptEncoding,
+        AcceptLanguage,
+        Allow,
+        Authorization,
+        CacheControl,
+        Connection,
+        ContentDisposition,
+        ContentEncoding,
+        ContentLanguage,
+        ContentLength,
+        ContentType,
+        Cookie,
+        Date,
+        ETag,
+        Expires,
+        Host,
+        IfMatch,
+        IfModifiedSince,
+        IfNoneMatch,
+        IfRange,
+        LastModified,
+        Location,
+        Origin,
+        ProxyAuthenticate,
+        ProxyAuthorization,
+        Range,
+        Referer,
+        Server,
+        SetCookie,
+        TransferEncoding,
+        Upgrade,
+        UserAgent,
+        Vary,
+        WwwAuthenticate,
+        XForwardedFor,
+        XForwardedHost,
+        XForwardedProto,
+        Unknown, // must be the last entry
+    };
+
     struct HeaderKeyValue {
         QByteArray key;
         QByteArray value;
@@ -52,7 +110,7 @@ public:
                  list.begin();
              it != list.end();
              ++it) {
-            m_data.emplace_back(HeaderKeyValue{it->first, it->second});
+            pushHeader(it->first, it->second);
         }
     }
 
@@ -196,8 +254,9 @@ public:
     /**
      * Checks for If-Match header usually used on POST to avoid mid-air collisions, making sure
      * the content has not changed while the client changes it.
-     * Returns true if the etag value matches the value between double quotes of the client header
-     * or if the client did not provide the If-Match header.
+     * Returns true if the etag value matches the value between double quotes of one of the
+     * entity tags of the client header, if it is \c * or if the client did not provide the
+     * If-Match header.
      *
      * In case of false client should usually discard posted data and return
      * status code of 412 - Response::PreconditionFailed.
@@ -207,7 +266,8 @@ public:
     /**
      * Checks for If-None-Match header to see if the client has the most recent
      * version of a cached resource.
-     * Returns true if the etag value matches the value between double quotes of the client header.
+     * Returns true if the etag value matches the value between double quotes of one of the
+     * entity tags of the client header, weak ones included, or if it is \c *.
      *
      * In case of true client should usually return an empty body along with a
      * status code of 304 - Response::NotModified.
@@ -409,15 +469,52 @@ public:
      */
     void removeHeader(QAnyStringView key);
 
+    /**
+     * Returns the value of the well-known header \p id.
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] QByteArray header(KnownHeader id) const noexcept;
+
+    /**
+     * Sets the well-known header \p id to \p value, using its canonical field name.
+     * \since Cutelyst 5.1.0
+     */
+    void setHeader(KnownHeader id, const QByteArray &value);
+
+    /**
+     * Removes all fields of the well-known header \p id.
+     * \since Cutelyst 5.1.0
+     */
+    void removeHeader(KnownHeader id);
+
+    /**
+     * Returns \c true if the well-known header \p id is defined.
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] bool contains(KnownHeader id) const noexcept;
+
+    /**
+     * Returns the KnownHeader matching \p key case-insensitively, or KnownHeader::Unknown.
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] static KnownHeader knownHeader(QAnyStringView key) noexcept;
+
+    /**
+     * Returns the canonical field name of \p id, e.g. "Content-Type".
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] static QByteArray knownHeaderName(KnownHeader id) noexcept;
+
     /**
      * Clears all headers.
      */
-    inline void clear() { m_data.clear(); }
+    void clear() noexcept;
 
     /**
      * Returns the internal structure of headers, to be used by Engine subclasses.
+     * The returned reference is invalidated when this object is modified.
      */
-    [[nodiscard]] inline QVector<HeaderKeyValue> data() const { return m_data; }
+    [[nodiscard]] inline const QVector<HeaderKeyValue> &data() const noexcept { return m_data; }
 
     /**
      * Returns \c true if the header field specified by \a key is defined.
@@ -436,7 +533,9 @@ public:
      */
     inline Headers &operator=(const Headers &other) noexcept
     {
-        m_data = other.m_data;
+        m_data  = other.m_data;
+        m_meta  = other.m_meta;
+        m_known = other.m_known;
         return *this;
     }
 
@@ -446,7 +545,30 @@ public:
     bool operator==(const Headers &other) const noexcept;
 
 private:
+    struct HeaderMeta {
+        quint32 hash;
+        KnownHeader id;
+    };
+
+    static constexpr auto KnownHeaderCount = std::size_t(KnownHeader::Unknown);
+
+    static constexpr std::array<qint32, KnownHeaderCount> emptyKnownIndex() noexcept
+    {
+        std::array<qint32, KnownHeaderCount> ret{};
+        ret.fill(-1);
+        return ret;
+    }
+
+    qsizetype indexOf(QAnyStringView key) const noexcept;
+    qsizetype indexOf(quint32 hash, KnownHeader id, QAnyStringView key) const noexcept;
+    void append(quint32 hash, KnownHeader id, const QByteArray &key, const QByteArray &value);
+    void rebuildKnownIndex() noexcept;
+
     QVector<HeaderKeyValue> m_data;
+    // Parallel to m_data, holds the case-folded key hash and KnownHeader tag of each entry
+    QVarLengthArray<HeaderMeta, 16> m_meta;
+    // Index in m_data of the first occurrence of each KnownHeader, -1 when missing
+    std::array<qint32, KnownHeaderCount> m_known = emptyKnownIndex();
 };
 
 } // namespace Cutelyst
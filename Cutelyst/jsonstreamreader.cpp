@@ -0,0 +1,655 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "jsonstreamreader_p.h"
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonObject>
+
+using namespace Cutelyst;
+using namespace Qt::StringLiterals;
+
+namespace {
+
+constexpr qsizetype readBlockSize = 64 * 1024;
+
+// Bounds the recursion of JsonStreamReader::readValue()
+constexpr size_t maxDepth = 512;
+
+// Numbers are kept as text, nothing valid gets near this
+constexpr qsizetype maxNumberSize = 1024;
+
+constexpr char32_t replacementCharacter = 0xFFFD;
+
+inline bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+inline bool isDigit(int ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+inline bool isNumberChar(char ch)
+{
+    return isDigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+inline bool isHighSurrogate(char32_t ch)
+{
+    return ch >= 0xD800 && ch <= 0xDBFF;
+}
+
+inline bool isLowSurrogate(char32_t ch)
+{
+    return ch >= 0xDC00 && ch <= 0xDFFF;
+}
+
+int hexValue(int ch)
+{
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    } else if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    } else if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * Validates \p number against the JSON number grammar, the reader collects
+ * any character that may be part of a number.
+ */
+bool isValidNumber(QByteArrayView number)
+{
+    const qsizetype size = number.size();
+    qsizetype i          = 0;
+
+    auto digits = [&] {
+        const qsizetype start = i;
+        while (i < size && isDigit(number.at(i))) {
+            ++i;
+        }
+        return i > start;
+    };
+
+    if (i < size && number.at(i) == '-') {
+        ++i;
+    }
+
+    if (i < size && number.at(i) == '0') {
+        ++i;
+    } else if (!digits()) {
+        return false;
+    }
+
+    if (i < size && number.at(i) == '.') {
+        ++i;
+        if (!digits()) {
+            return false;
+        }
+    }
+
+    if (i < size && (number.at(i) == 'e' || number.at(i) == 'E')) {
+        ++i;
+        if (i < size && (number.at(i) == '+' || number.at(i) == '-')) {
+            ++i;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+
+    return i == size;
+}
+
+} // namespace
+
+JsonStreamReader::JsonStreamReader(QIODevice *device)
+    : d_ptr(new JsonStreamReaderPrivate)
+{
+    Q_D(JsonStreamReader);
+    d->device = device;
+}
+
+JsonStreamReader::~JsonStreamReader()
+{
+    delete d_ptr;
+}
+
+JsonStreamReader::TokenType JsonStreamReader::readNext()
+{
+    Q_D(JsonStreamReader);
+    if (d->type == Invalid || d->type == EndDocument) {
+        return d->type;
+    }
+
+    for (;;) {
+        const int ch = d->nextNonSpace();
+        if (d->type == Invalid) {
+            return Invalid;
+        }
+
+        switch (d->expect) {
+        case JsonStreamReaderPrivate::ExpectCommaOrEnd:
+            if (d->containers.empty()) {
+                if (ch == -1) {
+                    return d->type = EndDocument;
+                }
+                return d->setError(u"Unexpected data after the document"_s);
+            }
+
+            if (ch == ',') {
+                ++d->pos;
+                d->expect = d->containers.back() == '{' ? JsonStreamReaderPrivate::ExpectName
+                                                        : JsonStreamReaderPrivate::ExpectValue;
+                continue;
+            }
+            return d->closeContainer(ch);
+        case JsonStreamReaderPrivate::ExpectNameOrEnd:
+            if (ch == '}') {
+                return d->closeContainer(ch);
+            }
+            [[fallthrough]];
+        case JsonStreamReaderPrivate::ExpectName:
+            if (ch != '"') {
+                return d->setError(u"Expected an object member name"_s);
+            }
+            ++d->pos;
+            if (!d->readString()) {
+                return Invalid;
+            }
+
+            if (d->nextNonSpace() != ':') {
+                return d->type == Invalid ? Invalid
+                                          : d->setError(u"Expected ':' after a member name"_s);
+            }
+            ++d->pos;
+            d->expect = JsonStreamReaderPrivate::ExpectValue;
+            return d->type = Name;
+        case JsonStreamReaderPrivate::ExpectValueOrEnd:
+            if (ch == ']') {
+                return d->closeContainer(ch);
+            }
+            [[fallthrough]];
+        case JsonStreamReaderPrivate::ExpectValue:
+            return d->readValueToken(ch);
+        }
+    }
+}
+
+JsonStreamReader::TokenType JsonStreamReader::tokenType() const noexcept
+{
+    Q_D(const JsonStreamReader);
+    return d->type;
+}
+
+QString JsonStreamReader::text() const
+{
+    Q_D(const JsonStreamReader);
+    if (d->type == Name || d->type == String) {
+        return QString::fromUtf8(d->token);
+    }
+    return {};
+}
+
+double JsonStreamReader::toDouble() const
+{
+    Q_D(const JsonStreamReader);
+    return d->type == Number ? d->token.toDouble() : 0;
+}
+
+qint64 JsonStreamReader::toInteger(bool *ok) const
+{
+    Q_D(const JsonStreamReader);
+    if (d->type == Number) {
+        return d->token.toLongLong(ok);
+    }
+
+    if (ok) {
+        *ok = false;
+    }
+    return 0;
+}
+
+bool JsonStreamReader::toBool() const noexcept
+{
+    Q_D(const JsonStreamReader);
+    return d->type == Bool && d->boolean;
+}
+
+QJsonValue JsonStreamReader::readValue()
+{
+    Q_D(JsonStreamReader);
+    switch (d->type) {
+    case String:
+        return text();
+    case Number:
+    {
+        bool isInteger;
+        const qint64 integer = d->token.toLongLong(&isInteger);
+        return isInteger ? QJsonValue(integer) : QJsonValue(d->token.toDouble());
+    }
+    case Bool:
+        return d->boolean;
+    case Null:
+        return QJsonValue::Null;
+    case StartArray:
+    {
+        QJsonArray array;
+        while (readNext() != EndArray) {
+            const QJsonValue value = readValue();
+            if (d->type == Invalid) {
+                return QJsonValue::Undefined;
+            }
+            array.append(value);
+        }
+        return array;
+    }
+    case StartObject:
+    {
+        QJsonObject object;
+        while (readNext() == Name) {
+            const QString name = text();
+            readNext();
+            const QJsonValue value = readValue();
+            if (d->type == Invalid) {
+                return QJsonValue::Undefined;
+            }
+            object.insert(name, value);
+        }
+
+        if (d->type != EndObject) {
+            return QJsonValue::Undefined;
+        }
+        return object;
+    }
+    default:
+        break;
+    }
+    return QJsonValue::Undefined;
+}
+
+void JsonStreamReader::skipValue()
+{
+    Q_D(JsonStreamReader);
+    if (d->type != StartObject && d->type != StartArray) {
+        return;
+    }
+
+    const size_t depth = d->containers.size();
+    while (readNext() != Invalid && d->containers.size() >= depth) {
+    }
+}
+
+qsizetype JsonStreamReader::depth() const noexcept
+{
+    Q_D(const JsonStreamReader);
+    return qsizetype(d->containers.size());
+}
+
+qint64 JsonStreamReader::offset() const noexcept
+{
+    Q_D(const JsonStreamReader);
+    return d->consumed + d->pos;
+}
+
+void JsonStreamReader::setMaxSize(qint64 bytes)
+{
+    Q_D(JsonStreamReader);
+    d->maxSize = bytes;
+}
+
+qint64 JsonStreamReader::maxSize() const noexcept
+{
+    Q_D(const JsonStreamReader);
+    return d->maxSize;
+}
+
+bool JsonStreamReader::hasError() const noexcept
+{
+    Q_D(const JsonStreamReader);
+    return d->type == Invalid;
+}
+
+QString JsonStreamReader::errorString() const
+{
+    Q_D(const JsonStreamReader);
+    return d->error;
+}
+
+JsonStreamReader::TokenType JsonStreamReaderPrivate::readValueToken(int ch)
+{
+    switch (ch) {
+    case '{':
+    case '[':
+        if (containers.size() >= maxDepth) {
+            return setError(u"Document is nested too deep"_s);
+        }
+        ++pos;
+        containers.push_back(char(ch));
+        if (ch == '{') {
+            expect = ExpectNameOrEnd;
+            return type = JsonStreamReader::StartObject;
+        }
+        expect = ExpectValueOrEnd;
+        return type = JsonStreamReader::StartArray;
+    case '"':
+        ++pos;
+        if (!readString()) {
+            return JsonStreamReader::Invalid;
+        }
+        expect = ExpectCommaOrEnd;
+        return type = JsonStreamReader::String;
+    case 't':
+    case 'f':
+        if (!readLiteral(ch == 't' ? "true" : "false")) {
+            return JsonStreamReader::Invalid;
+        }
+        boolean = ch == 't';
+        expect  = ExpectCommaOrEnd;
+        return type = JsonStreamReader::Bool;
+    case 'n':
+        if (!readLiteral("null")) {
+            return JsonStreamReader::Invalid;
+        }
+        expect = ExpectCommaOrEnd;
+        return type = JsonStreamReader::Null;
+    case -1:
+        return setError(u"Unexpected end of the document"_s);
+    default:
+        break;
+    }
+
+    if (ch == '-' || isDigit(ch)) {
+        if (!readNumber()) {
+            return JsonStreamReader::Invalid;
+        }
+        expect = ExpectCommaOrEnd;
+        return type = JsonStreamReader::Number;
+    }
+    return setError(u"Unexpected character"_s);
+}
+
+JsonStreamReader::TokenType JsonStreamReaderPrivate::closeContainer(int ch)
+{
+    const char open = containers.back();
+    if ((open == '{' && ch == '}') || (open == '[' && ch == ']')) {
+        ++pos;
+        containers.pop_back();
+        expect = ExpectCommaOrEnd;
+        return type = open == '{' ? JsonStreamReader::EndObject : JsonStreamReader::EndArray;
+    }
+
+    if (ch == -1) {
+        return setError(u"Unexpected end of the document"_s);
+    }
+    return setError(open == '{' ? u"Expected ',' or '}'"_s : u"Expected ',' or ']'"_s);
+}
+
+int JsonStreamReaderPrivate::nextNonSpace()
+{
+    for (;;) {
+        if (pos == len && !fill()) {
+            return -1;
+        }
+
+        while (pos < len) {
+            const char ch = buffer.at(pos);
+            if (!isSpace(ch)) {
+                return static_cast<unsigned char>(ch);
+            }
+            ++pos;
+        }
+    }
+}
+
+int JsonStreamReaderPrivate::peek()
+{
+    if (pos == len && !fill()) {
+        return -1;
+    }
+    return static_cast<unsigned char>(buffer.at(pos));
+}
+
+bool JsonStreamReaderPrivate::fill()
+{
+    consumed += len;
+    pos = 0;
+    len = 0;
+    if (type == JsonStreamReader::Invalid) {
+        return false;
+    }
+
+    qint64 toRead = readBlockSize;
+    if (maxSize >= 0) {
+        toRead = qMin(toRead, maxSize - consumed);
+        if (toRead <= 0) {
+            char probe;
+            if (device->read(&probe, 1) == 1) {
+                setError(u"Document is bigger than %1 bytes"_s.arg(maxSize));
+            }
+            return false;
+        }
+    }
+
+    if (buffer.size() < readBlockSize) {
+        buffer.resize(readBlockSize);
+    }
+
+    const qint64 read = device->read(buffer.data(), toRead);
+    if (read < 0) {
+        setError(u"Failed to read the document: "_s + device->errorString());
+        return false;
+    }
+    len = read;
+    return read > 0;
+}
+
+bool JsonStreamReaderPrivate::readString()
+{
+    token.clear();
+
+    // A high surrogate waits for the escaped low surrogate that follows it
+    char32_t highSurrogate = 0;
+    auto flushSurrogate = [&] {
+        if (highSurrogate) {
+            appendCodePoint(replacementCharacter);
+            highSurrogate = 0;
+        }
+    };
+
+    auto readHex = [this](char32_t &codeUnit) {
+        codeUnit = 0;
+        for (int i = 0; i < 4; ++i) {
+            const int value = hexValue(peek());
+            if (value == -1) {
+                setError(u"Invalid unicode escape sequence"_s);
+                return false;
+            }
+            ++pos;
+            codeUnit = (codeUnit << 4) | char32_t(value);
+        }
+        return true;
+    };
+
+    for (;;) {
+        if (pos == len && !fill()) {
+            if (type != JsonStreamReader::Invalid) {
+                setError(u"Unterminated string"_s);
+            }
+            return false;
+        }
+
+        const char *data = buffer.constData();
+        qsizetype run    = pos;
+        while (run < len) {
+            const auto ch = static_cast<unsigned char>(data[run]);
+            if (ch == '"' || ch == '\\' || ch < 0x20) {
+                break;
+            }
+            ++run;
+        }
+
+        if (run > pos) {
+            flushSurrogate();
+            token.append(data + pos, run - pos);
+            pos = run;
+        }
+
+        if (pos == len) {
+            continue;
+        }
+
+        const auto ch = static_cast<unsigned char>(data[pos++]);
+        if (ch == '"') {
+            flushSurrogate();
+            return true;
+        } else if (ch < 0x20) {
+            setError(u"Control character in string"_s);
+            return false;
+        }
+
+        const int escape = peek();
+        if (escape == -1) {
+            if (type != JsonStreamReader::Invalid) {
+                setError(u"Unterminated string"_s);
+            }
+            return false;
+        }
+        ++pos;
+
+        if (escape != 'u') {
+            flushSurrogate();
+        }
+
+        switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+            token.append(char(escape));
+            break;
+        case 'b':
+            token.append('\b');
+            break;
+        case 'f':
+            token.append('\f');
+            break;
+        case 'n':
+            token.append('\n');
+            break;
+        case 'r':
+            token.append('\r');
+            break;
+        case 't':
+            token.append('\t');
+            break;
+        case 'u':
+        {
+            char32_t codeUnit;
+            if (!readHex(codeUnit)) {
+                return false;
+            }
+
+            if (highSurrogate && isLowSurrogate(codeUnit)) {
+                appendCodePoint(0x10000 + ((highSurrogate - 0xD800) << 10) + (codeUnit - 0xDC00));
+                highSurrogate = 0;
+            } else {
+                flushSurrogate();
+                if (isHighSurrogate(codeUnit)) {
+                    highSurrogate = codeUnit;
+                } else {
+                    appendCodePoint(isLowSurrogate(codeUnit) ? replacementCharacter : codeUnit);
+                }
+            }
+            break;
+        }
+        default:
+            setError(u"Invalid escape sequence"_s);
+            return false;
+        }
+    }
+}
+
+bool JsonStreamReaderPrivate::readNumber()
+{
+    token.clear();
+    for (;;) {
+        if (pos == len && !fill()) {
+            break;
+        }
+
+        const char *data = buffer.constData();
+        qsizetype run    = pos;
+        while (run < len && isNumberChar(data[run])) {
+            ++run;
+        }
+        token.append(data + pos, run - pos);
+        pos = run;
+
+        if (token.size() > maxNumberSize) {
+            setError(u"Number is too long"_s);
+            return false;
+        }
+
+        if (pos < len) {
+            break;
+        }
+    }
+
+    if (type == JsonStreamReader::Invalid) {
+        return false;
+    } else if (!isValidNumber(token)) {
+        setError(u"Invalid number"_s);
+        return false;
+    }
+    return true;
+}
+
+bool JsonStreamReaderPrivate::readLiteral(const char *literal)
+{
+    for (const char *ch = literal; *ch; ++ch) {
+        if (peek() != *ch) {
+            if (type != JsonStreamReader::Invalid) {
+                setError(u"Invalid literal"_s);
+            }
+            return false;
+        }
+        ++pos;
+    }
+    return true;
+}
+
+void JsonStreamReaderPrivate::appendCodePoint(char32_t codePoint)
+{
+    if (codePoint < 0x80) {
+        token.append(char(codePoint));
+    } else if (codePoint < 0x800) {
+        const char utf8[] = {char(0xC0 | (codePoint >> 6)), char(0x80 | (codePoint & 0x3F))};
+        token.append(utf8, 2);
+    } else if (codePoint < 0x10000) {
+        const char utf8[] = {char(0xE0 | (codePoint >> 12)),
+                             char(0x80 | ((codePoint >> 6) & 0x3F)),
+                             char(0x80 | (codePoint & 0x3F))};
+        token.append(utf8, 3);
+    } else {
+        const char utf8[] = {char(0xF0 | (codePoint >> 18)),
+                             char(0x80 | ((codePoint >> 12) & 0x3F)),
+                             char(0x80 | ((codePoint >> 6) & 0x3F)),
+                             char(0x80 | (codePoint & 0x3F))};
+        token.append(utf8, 4);
+    }
+}
+
+JsonStreamReader::TokenType JsonStreamReaderPrivate::setError(const QString &reason)
+{
+    error = u"%1 at offset %2"_s.arg(reason).arg(consumed + pos);
+    type  = JsonStreamReader::Invalid;
+    return type;
+}
+
+#include "moc_jsonstreamreader.cpp"
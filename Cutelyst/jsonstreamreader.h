@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+
+#include <QtCore/QJsonValue>
+#include <QtCore/QObject>
+
+class QIODevice;
+
+namespace Cutelyst {
+
+class JsonStreamReaderPrivate;
+
+/**
+ * \ingroup core
+ * \class JsonStreamReader jsonstreamreader.h Cutelyst/JsonStreamReader
+ * \brief Pull parser for JSON documents stored on a device.
+ *
+ * %JsonStreamReader reads a JSON document token by token from a QIODevice, in the
+ * same spirit of QXmlStreamReader and QCborStreamReader, so big request bodies can be
+ * processed without having the whole document in memory. readValue() builds the
+ * QJsonValue of the current token, which allows reading a huge array one element
+ * at a time:
+ *
+ * \code{.cpp}
+ * void Ingest::items(Context *c)
+ * {
+ *     JsonStreamReader reader(c->request()->body());
+ *     reader.setMaxSize(512 * 1024 * 1024);
+ *
+ *     if (reader.readNext() == JsonStreamReader::StartArray) {
+ *         while (reader.readNext() == JsonStreamReader::StartObject) {
+ *             store(reader.readValue().toObject());
+ *         }
+ *     }
+ *
+ *     if (reader.hasError()) {
+ *         c->response()->setStatus(Response::BadRequest);
+ *         c->response()->setBody(reader.errorString());
+ *     }
+ * }
+ * \endcode
+ *
+ * For CBOR bodies QCborStreamReader can be used directly on Request::body().
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT JsonStreamReader
+{
+    Q_GADGET
+    Q_DECLARE_PRIVATE(JsonStreamReader) // cppcheck-suppress unusedPrivateFunction
+    Q_DISABLE_COPY(JsonStreamReader)
+public:
+    enum TokenType {
+        NoToken,
+        Invalid,
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Name,
+        String,
+        Number,
+        Bool,
+        Null,
+        EndDocument,
+    };
+    Q_ENUM(TokenType)
+
+    /**
+     * Constructs a reader of the document available on \a device from it's
+     * current position.
+     */
+    explicit JsonStreamReader(QIODevice *device);
+    ~JsonStreamReader();
+
+    /**
+     * Reads the next token and returns it's type, once Invalid or EndDocument
+     * is returned subsequent calls return the same.
+     */
+    TokenType readNext();
+
+    /**
+     * Returns the type of the current token.
+     */
+    [[nodiscard]] TokenType tokenType() const noexcept;
+
+    /**
+     * Returns the text of Name and String tokens.
+     */
+    [[nodiscard]] QString text() const;
+
+    /**
+     * Returns the value of Number tokens.
+     */
+    [[nodiscard]] double toDouble() const;
+
+    /**
+     * Returns the value of Number tokens that are integers, \a ok is set
+     * to \c false if the number does not fit a qint64.
+     */
+    [[nodiscard]] qint64 toInteger(bool *ok = nullptr) const;
+
+    /**
+     * Returns the value of Bool tokens.
+     */
+    [[nodiscard]] bool toBool() const noexcept;
+
+    /**
+     * Returns the value that starts at the current token, reading objects and arrays
+     * until their end token, which becomes the current token.
+     *
+     * QJsonValue::Undefined is returned if the current token does not start a value
+     * or if an error happens.
+     */
+    QJsonValue readValue();
+
+    /**
+     * Skips the object or array that starts at the current token.
+     */
+    void skipValue();
+
+    /**
+     * Returns the number of objects and arrays the current token is in.
+     */
+    [[nodiscard]] qsizetype depth() const noexcept;
+
+    /**
+     * Returns the number of bytes of the document that were parsed.
+     */
+    [[nodiscard]] qint64 offset() const noexcept;
+
+    /**
+     * Sets the maximum size in bytes of the document, the reader fails once
+     * more data is found. A negative value (the default) disables the limit.
+     */
+    void setMaxSize(qint64 bytes);
+    [[nodiscard]] qint64 maxSize() const noexcept;
+
+    /**
+     * Returns \c true if the document is not valid JSON or the device failed.
+     */
+    [[nodiscard]] bool hasError() const noexcept;
+
+    /**
+     * Returns a description of the error.
+     */
+    [[nodiscard]] QString errorString() const;
+
+protected:
+    JsonStreamReaderPrivate *d_ptr;
+};
+
+} // namespace Cutelyst
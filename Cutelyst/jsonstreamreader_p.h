@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "jsonstreamreader.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+namespace Cutelyst {
+
+class JsonStreamReaderPrivate
+{
+public:
+    // What the grammar accepts after the current token
+    enum Expect : quint8 {
+        ExpectValue,
+        ExpectValueOrEnd,
+        ExpectName,
+        ExpectNameOrEnd,
+        ExpectCommaOrEnd,
+    };
+
+    JsonStreamReader::TokenType readValueToken(int ch);
+    JsonStreamReader::TokenType closeContainer(int ch);
+
+    // Returns the next character skipping white space, -1 at the end
+    int nextNonSpace();
+    int peek();
+    bool fill();
+
+    bool readString();
+    bool readNumber();
+    bool readLiteral(const char *literal);
+    void appendCodePoint(char32_t codePoint);
+
+    JsonStreamReader::TokenType setError(const QString &reason);
+
+    QIODevice *device;
+    QByteArray buffer;
+    // Scalar contents, UTF-8 for strings and the raw text of numbers
+    QByteArray token;
+    QString error;
+    std::vector<char> containers;
+    qsizetype pos    = 0;
+    qsizetype len    = 0;
+    qint64 consumed  = 0;
+    qint64 maxSize   = -1;
+    JsonStreamReader::TokenType type = JsonStreamReader::NoToken;
+    Expect expect    = ExpectValue;
+    bool boolean     = false;
+};
+
+} // namespace Cutelyst
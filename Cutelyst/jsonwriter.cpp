@@ -0,0 +1,525 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "jsonwriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+
+using namespace Cutelyst;
+
+namespace {
+
+// Largest integer a double holds exactly, QJsonDocument writes integers up to it without exponent
+constexpr double maxExactInteger = 9007199254740992.0;
+
+inline bool isPlainAscii(char16_t ch) noexcept
+{
+    return ch >= 0x20 && ch < 0x80 && ch != u'"' && ch != u'\\';
+}
+
+inline bool isPlainUtf8(unsigned char ch) noexcept
+{
+    return ch >= 0x20 && ch != '"' && ch != '\\';
+}
+
+void appendEscaped(QByteArray &out, char16_t ch)
+{
+    switch (ch) {
+    case u'"':
+        out.append("\\\"", 2);
+        break;
+    case u'\\':
+        out.append("\\\\", 2);
+        break;
+    case u'\b':
+        out.append("\\b", 2);
+        break;
+    case u'\f':
+        out.append("\\f", 2);
+        break;
+    case u'\n':
+        out.append("\\n", 2);
+        break;
+    case u'\r':
+        out.append("\\r", 2);
+        break;
+    case u'\t':
+        out.append("\\t", 2);
+        break;
+    default:
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+        const char escaped[]        = {'\\',
+                                       'u',
+                                       hex[(ch >> 12) & 0xF],
+                                       hex[(ch >> 8) & 0xF],
+                                       hex[(ch >> 4) & 0xF],
+                                       hex[ch & 0xF]};
+        out.append(escaped, 6);
+    }
+    }
+}
+
+// Appends valid UTF-8, bytes above ASCII are copied as they are
+void appendUtf8String(QByteArray &out, QByteArrayView value)
+{
+    out.reserve(out.size() + value.size() + 2);
+    out.append('"');
+
+    const char *data     = value.data();
+    const qsizetype size = value.size();
+    qsizetype from       = 0;
+    for (qsizetype i = 0; i < size; ++i) {
+        const auto ch = static_cast<unsigned char>(data[i]);
+        if (!isPlainUtf8(ch)) {
+            out.append(data + from, i - from);
+            appendEscaped(out, ch);
+            from = i + 1;
+        }
+    }
+    out.append(data + from, size - from);
+
+    out.append('"');
+}
+
+void appendInteger(QByteArray &out, qint64 value)
+{
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    char *p   = end;
+
+    // Negate on the unsigned type so the minimum value doesn't overflow
+    quint64 abs = value < 0 ? 0 - quint64(value) : quint64(value);
+    do {
+        *--p = char('0' + abs % 10);
+        abs /= 10;
+    } while (abs);
+    if (value < 0) {
+        *--p = '-';
+    }
+    out.append(p, end - p);
+}
+
+void appendDouble(QByteArray &out, double value)
+{
+    if (!std::isfinite(value)) {
+        // JSON has no representation for them, same as QJsonDocument
+        out.append("null", 4);
+    } else if (value == std::trunc(value) && std::abs(value) < maxExactInteger) {
+        appendInteger(out, qint64(value));
+    } else {
+        out.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    }
+}
+
+void appendJsonObject(QByteArray &out, const QJsonObject &object)
+{
+    out.append('{');
+    bool first = true;
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        if (!first) {
+            out.append(',');
+        }
+        first = false;
+        JsonWriter::appendString(out, it.key());
+        out.append(':');
+        JsonWriter::appendJson(out, it.value());
+    }
+    out.append('}');
+}
+
+void appendJsonArray(QByteArray &out, const QJsonArray &array)
+{
+    out.append('[');
+    bool first = true;
+    for (const auto &value : array) {
+        if (!first) {
+            out.append(',');
+        }
+        first = false;
+        JsonWriter::appendJson(out, value);
+    }
+    out.append(']');
+}
+
+template <typename Map>
+void appendVariantMap(QByteArray &out, const Map &map)
+{
+    out.append('{');
+    bool first = true;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        if (!first) {
+            out.append(',');
+        }
+        first = false;
+        JsonWriter::appendString(out, it.key());
+        out.append(':');
+        JsonWriter::appendVariant(out, it.value());
+    }
+    out.append('}');
+}
+
+void appendVariantHash(QByteArray &out, const QVariantHash &hash)
+{
+    // QJsonObject keeps the keys sorted, the output must not depend on the hash seed
+    std::vector<QVariantHash::const_iterator> members;
+    members.reserve(hash.size());
+    for (auto it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        members.push_back(it);
+    }
+    std::sort(members.begin(), members.end(), [](const auto &a, const auto &b) {
+        return a.key() < b.key();
+    });
+
+    out.append('{');
+    bool first = true;
+    for (const auto &it : members) {
+        if (!first) {
+            out.append(',');
+        }
+        first = false;
+        JsonWriter::appendString(out, it.key());
+        out.append(':');
+        JsonWriter::appendVariant(out, it.value());
+    }
+    out.append('}');
+}
+
+template <typename T>
+inline const T &variantRef(const QVariant &value)
+{
+    return *static_cast<const T *>(value.constData());
+}
+
+} // namespace
+
+JsonWriter::JsonWriter(QByteArray &buffer)
+    : m_out(buffer)
+{
+}
+
+JsonWriter::JsonWriter(QIODevice *device, qsizetype flushSize)
+    : m_out(m_ownBuffer)
+    , m_device(device)
+    , m_flushSize(flushSize)
+{
+    m_ownBuffer.reserve(flushSize + 1024);
+}
+
+JsonWriter::~JsonWriter()
+{
+    flush();
+}
+
+void JsonWriter::beforeValue()
+{
+    if (m_needsSeparator) {
+        m_out.append(',');
+    }
+}
+
+void JsonWriter::afterValue()
+{
+    m_needsSeparator = true;
+    if (m_device && m_out.size() >= m_flushSize) {
+        flush();
+    }
+}
+
+void JsonWriter::startObject()
+{
+    beforeValue();
+    m_out.append('{');
+    m_needsSeparator = false;
+}
+
+void JsonWriter::endObject()
+{
+    m_out.append('}');
+    afterValue();
+}
+
+void JsonWriter::startArray()
+{
+    beforeValue();
+    m_out.append('[');
+    m_needsSeparator = false;
+}
+
+void JsonWriter::endArray()
+{
+    m_out.append(']');
+    afterValue();
+}
+
+void JsonWriter::writeName(QStringView name)
+{
+    beforeValue();
+    appendString(m_out, name);
+    m_out.append(':');
+    m_needsSeparator = false;
+}
+
+void JsonWriter::writeString(QStringView value)
+{
+    beforeValue();
+    appendString(m_out, value);
+    afterValue();
+}
+
+void JsonWriter::writeInteger(qint64 value)
+{
+    beforeValue();
+    appendInteger(m_out, value);
+    afterValue();
+}
+
+void JsonWriter::writeDouble(double value)
+{
+    beforeValue();
+    appendDouble(m_out, value);
+    afterValue();
+}
+
+void JsonWriter::writeBool(bool value)
+{
+    beforeValue();
+    if (value) {
+        m_out.append("true", 4);
+    } else {
+        m_out.append("false", 5);
+    }
+    afterValue();
+}
+
+void JsonWriter::writeNull()
+{
+    beforeValue();
+    m_out.append("null", 4);
+    afterValue();
+}
+
+void JsonWriter::writeVariant(const QVariant &value)
+{
+    beforeValue();
+    appendVariant(m_out, value);
+    afterValue();
+}
+
+void JsonWriter::writeJson(const QJsonValue &value)
+{
+    beforeValue();
+    appendJson(m_out, value);
+    afterValue();
+}
+
+void JsonWriter::flush()
+{
+    if (m_device && !m_out.isEmpty()) {
+        m_device->write(m_out);
+        // Keeps the capacity for the next block
+        m_out.resize(0);
+    }
+}
+
+void JsonWriter::appendVariant(QByteArray &out, const QVariant &value)
+{
+    switch (value.typeId()) {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+        out.append("null", 4);
+        break;
+    case QMetaType::Bool:
+        if (variantRef<bool>(value)) {
+            out.append("true", 4);
+        } else {
+            out.append("false", 5);
+        }
+        break;
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        appendInteger(out, value.toLongLong());
+        break;
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+    {
+        const quint64 number = value.toULongLong();
+        if (number <= quint64(std::numeric_limits<qint64>::max())) {
+            appendInteger(out, qint64(number));
+        } else {
+            appendDouble(out, double(number));
+        }
+        break;
+    }
+    case QMetaType::Float:
+    case QMetaType::Double:
+        appendDouble(out, value.toDouble());
+        break;
+    case QMetaType::QString:
+        appendString(out, variantRef<QString>(value));
+        break;
+    case QMetaType::QByteArray:
+    {
+        const auto &bytes = variantRef<QByteArray>(value);
+        if (QByteArrayView(bytes).isValidUtf8()) {
+            appendUtf8String(out, bytes);
+        } else {
+            appendString(out, QString::fromUtf8(bytes));
+        }
+        break;
+    }
+    case QMetaType::QStringList:
+    {
+        out.append('[');
+        bool first = true;
+        for (const auto &str : variantRef<QStringList>(value)) {
+            if (!first) {
+                out.append(',');
+            }
+            first = false;
+            appendString(out, str);
+        }
+        out.append(']');
+        break;
+    }
+    case QMetaType::QVariantList:
+    {
+        out.append('[');
+        bool first = true;
+        for (const auto &item : variantRef<QVariantList>(value)) {
+            if (!first) {
+                out.append(',');
+            }
+            first = false;
+            appendVariant(out, item);
+        }
+        out.append(']');
+        break;
+    }
+    case QMetaType::QVariantMap:
+        appendVariantMap(out, variantRef<QVariantMap>(value));
+        break;
+    case QMetaType::QVariantHash:
+        appendVariantHash(out, variantRef<QVariantHash>(value));
+        break;
+    case QMetaType::QJsonValue:
+        appendJson(out, variantRef<QJsonValue>(value));
+        break;
+    case QMetaType::QJsonObject:
+        appendJsonObject(out, variantRef<QJsonObject>(value));
+        break;
+    case QMetaType::QJsonArray:
+        appendJsonArray(out, variantRef<QJsonArray>(value));
+        break;
+    case QMetaType::QJsonDocument:
+    {
+        const auto &doc = variantRef<QJsonDocument>(value);
+        if (doc.isArray()) {
+            appendJsonArray(out, doc.array());
+        } else {
+            appendJsonObject(out, doc.object());
+        }
+        break;
+    }
+    default:
+        // Urls, uuids, CBOR and custom types, rare enough to take the Qt conversion
+        appendJson(out, QJsonValue::fromVariant(value));
+    }
+}
+
+void JsonWriter::appendJson(QByteArray &out, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        if (value.toBool()) {
+            out.append("true", 4);
+        } else {
+            out.append("false", 5);
+        }
+        break;
+    case QJsonValue::Double:
+        appendDouble(out, value.toDouble());
+        break;
+    case QJsonValue::String:
+        appendString(out, value.toString());
+        break;
+    case QJsonValue::Array:
+        appendJsonArray(out, value.toArray());
+        break;
+    case QJsonValue::Object:
+        appendJsonObject(out, value.toObject());
+        break;
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        out.append("null", 4);
+    }
+}
+
+void JsonWriter::appendString(QByteArray &out, QStringView value)
+{
+    // Most strings are ASCII, which takes a single byte per character
+    out.reserve(out.size() + value.size() + 2);
+    out.append('"');
+
+    const char16_t *p   = value.utf16();
+    const char16_t *end = p + value.size();
+    while (p < end) {
+        // Copy the longest run that needs no escaping, a loop compilers vectorize
+        const char16_t *run = p;
+        while (run < end && isPlainAscii(*run)) {
+            ++run;
+        }
+        if (run != p) {
+            const qsizetype size = out.size();
+            out.resize(size + (run - p));
+            char *dst = out.data() + size;
+            while (p < run) {
+                *dst++ = char(*p++);
+            }
+            if (p == end) {
+                break;
+            }
+        }
+
+        const char16_t ch = *p++;
+        if (ch < 0x80) {
+            appendEscaped(out, ch);
+        } else if (ch < 0x800) {
+            const char utf8[] = {char(0xC0 | (ch >> 6)), char(0x80 | (ch & 0x3F))};
+            out.append(utf8, 2);
+        } else if (QChar::isHighSurrogate(ch) && p < end && QChar::isLowSurrogate(*p)) {
+            const char32_t ucs4 = QChar::surrogateToUcs4(ch, *p++);
+            const char utf8[]   = {char(0xF0 | (ucs4 >> 18)),
+                                   char(0x80 | ((ucs4 >> 12) & 0x3F)),
+                                   char(0x80 | ((ucs4 >> 6) & 0x3F)),
+                                   char(0x80 | (ucs4 & 0x3F))};
+            out.append(utf8, 4);
+        } else if (QChar::isSurrogate(ch)) {
+            // A lone surrogate can't be encoded as UTF-8
+            appendEscaped(out, ch);
+        } else {
+            const char utf8[] = {
+                char(0xE0 | (ch >> 12)), char(0x80 | ((ch >> 6) & 0x3F)), char(0x80 | (ch & 0x3F))};
+            out.append(utf8, 3);
+        }
+    }
+
+    out.append('"');
+}
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonValue>
+#include <QtCore/QVariant>
+
+class QIODevice;
+
+namespace Cutelyst {
+
+/**
+ * \ingroup core
+ * \class JsonWriter jsonwriter.h Cutelyst/JsonWriter
+ * \brief Writes compact JSON straight to a buffer or device.
+ *
+ * %JsonWriter serializes QVariant and QJsonValue trees without converting them
+ * to a QJsonDocument first, the output is the same compact JSON QJsonDocument
+ * produces, including the sorted keys of QVariantHash values.
+ *
+ * When constructed with a device the output is written in blocks of flushSize()
+ * bytes, which allows streaming big arrays in the Response:
+ *
+ * \code{.cpp}
+ * void Items::list(Context *c)
+ * {
+ *     c->response()->setContentType("application/json"_ba);
+ *
+ *     JsonWriter writer(c->response());
+ *     writer.startArray();
+ *     while (query.next()) {
+ *         writer.startObject();
+ *         writer.writeName(u"id");
+ *         writer.writeInteger(query.value(0).toLongLong());
+ *         writer.writeName(u"name");
+ *         writer.writeString(query.value(1).toString());
+ *         writer.endObject();
+ *     }
+ *     writer.endArray();
+ * }
+ * \endcode
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT JsonWriter
+{
+    Q_DISABLE_COPY(JsonWriter)
+public:
+    /**
+     * Constructs a writer that appends to \a buffer.
+     */
+    explicit JsonWriter(QByteArray &buffer);
+
+    /**
+     * Constructs a writer that writes to \a device every time \a flushSize bytes
+     * are buffered.
+     */
+    explicit JsonWriter(QIODevice *device, qsizetype flushSize = 16 * 1024);
+
+    /**
+     * Destroys the writer, writing any buffered data to the device.
+     */
+    ~JsonWriter();
+
+    void startObject();
+    void endObject();
+    void startArray();
+    void endArray();
+
+    /**
+     * Writes the \a name of the next object member.
+     */
+    void writeName(QStringView name);
+
+    void writeString(QStringView value);
+    void writeInteger(qint64 value);
+    void writeDouble(double value);
+    void writeBool(bool value);
+    void writeNull();
+
+    /**
+     * Writes \a value converted the same way QJsonValue::fromVariant() does.
+     */
+    void writeVariant(const QVariant &value);
+
+    /**
+     * Writes the JSON \a value.
+     */
+    void writeJson(const QJsonValue &value);
+
+    /**
+     * Writes buffered data to the device.
+     */
+    void flush();
+
+    /**
+     * Returns the number of bytes buffered before writing to the device.
+     */
+    [[nodiscard]] qsizetype flushSize() const noexcept { return m_flushSize; }
+
+    /**
+     * Appends \a value converted the same way QJsonValue::fromVariant() does to \a out.
+     */
+    static void appendVariant(QByteArray &out, const QVariant &value);
+
+    /**
+     * Appends the JSON \a value to \a out.
+     */
+    static void appendJson(QByteArray &out, const QJsonValue &value);
+
+    /**
+     * Appends \a value as an escaped JSON string to \a out.
+     */
+    static void appendString(QByteArray &out, QStringView value);
+
+private:
+    inline void beforeValue();
+    inline void afterValue();
+
+    QByteArray m_ownBuffer;
+    QByteArray &m_out;
+    QIODevice *m_device   = nullptr;
+    qsizetype m_flushSize = 0;
+    bool m_needsSeparator = false;
+};
+
+} // namespace Cutelyst
@@ -6,8 +6,32 @@
 #include "multipartformdataparser_p.h"
 #include "upload_p.h"
 
+#include <cstring>
+#include <utility>
+
+#include <QBuffer>
+#include <QTemporaryFile>
+
 using namespace Cutelyst;
 
+namespace {
+
+// Limits the headers of each part, they are kept in memory while being parsed
+constexpr qint64 maxPartHeadersSize = 16 * 1024;
+
+/**
+ * Returns how many bytes at the end of \p data could be the start of a delimiter
+ * that continues on the next write, they all begin with "\r\n".
+ */
+qsizetype delimiterTailSize(const char *data, qsizetype len, qsizetype delimiterSize)
+{
+    const qsizetype window = qMin(len, delimiterSize - 1);
+    auto cr = static_cast<const char *>(memchr(data + len - window, '\r', size_t(window)));
+    return cr ? data + len - cr : 0;
+}
+
+} // namespace
+
 Uploads MultiPartFormDataParser::parse(QIODevice *body, QByteArrayView contentType, int bufferSize)
 {
     Uploads ret;
@@ -16,18 +40,37 @@ Uploads MultiPartFormDataParser::parse(QIODevice *body, QByteArrayView contentTy
         return ret;
     }
 
-    int start = contentType.indexOf("boundary=");
-    if (start == -1) {
+    const QByteArray boundary = MultiPartFormDataParserPrivate::boundary(contentType);
+    if (boundary.isEmpty()) {
         qCWarning(CUTELYST_MULTIPART) << "No boundary match" << contentType;
         return ret;
     }
 
+    if (bufferSize < 1024) {
+        bufferSize = 1024;
+    }
+    char *buffer = new char[bufferSize];
+
+    ret = MultiPartFormDataParserPrivate::execute(buffer, bufferSize, body, boundary);
+
+    delete[] buffer;
+
+    return ret;
+}
+
+QByteArray MultiPartFormDataParserPrivate::boundary(QByteArrayView contentType)
+{
+    QByteArray ret;
+    qsizetype start = contentType.indexOf("boundary=");
+    if (start == -1) {
+        return ret;
+    }
+
     start += 9;
-    QByteArray boundary;
-    const int len = contentType.length();
-    boundary.reserve(contentType.length() - start + 2);
+    const qsizetype len = contentType.length();
+    ret.reserve(len - start + 2);
 
-    for (int i = start, quotes = 0; i < len; ++i) {
+    for (qsizetype i = start, quotes = 0; i < len; ++i) {
         const char ch = contentType.at(i);
         if (ch == '\"') {
             if (quotes == 0 && i > start) {
@@ -38,25 +81,13 @@ Uploads MultiPartFormDataParser::parse(QIODevice *body, QByteArrayView contentTy
         } else if (ch == ';') {
             break;
         } else {
-            boundary.append(ch);
+            ret.append(ch);
         }
     }
 
-    if (boundary.isEmpty()) {
-        qCWarning(CUTELYST_MULTIPART) << "Boundary match was empty" << contentType;
-        return ret;
+    if (!ret.isEmpty()) {
+        ret.prepend("--", 2);
     }
-    boundary.prepend("--", 2);
-
-    if (bufferSize < 1024) {
-        bufferSize = 1024;
-    }
-    char *buffer = new char[bufferSize];
-
-    ret = MultiPartFormDataParserPrivate::execute(buffer, bufferSize, body, boundary);
-
-    delete[] buffer;
-
     return ret;
 }
 
@@ -195,4 +226,328 @@ int MultiPartFormDataParserPrivate::findBoundary(char *buffer,
     return len;
 }
 
+MultiPartFormDataStream::MultiPartFormDataStream(QByteArrayView contentType, QObject *parent)
+    : QIODevice(parent)
+    , d_ptr(new MultiPartFormDataStreamPrivate)
+{
+    Q_D(MultiPartFormDataStream);
+    const QByteArray boundary = MultiPartFormDataParserPrivate::boundary(contentType);
+    if (boundary.isEmpty()) {
+        qCWarning(CUTELYST_MULTIPART) << "No boundary match" << contentType;
+        d->state = MultiPartFormDataStreamPrivate::Error;
+    } else {
+        d->delimiter = "\r\n" + boundary;
+        // The first boundary has no preceding line break
+        d->pending = QByteArrayLiteral("\r\n");
+    }
+    open(QIODevice::ReadWrite | QIODevice::Unbuffered);
+}
+
+MultiPartFormDataStream::~MultiPartFormDataStream()
+{
+    qDeleteAll(d_ptr->uploads);
+    delete d_ptr;
+}
+
+void MultiPartFormDataStream::setMemoryLimit(qint64 bytes)
+{
+    Q_D(MultiPartFormDataStream);
+    d->memoryLimit = bytes;
+}
+
+qint64 MultiPartFormDataStream::memoryLimit() const noexcept
+{
+    Q_D(const MultiPartFormDataStream);
+    return d->memoryLimit;
+}
+
+bool MultiPartFormDataStream::isFinished() const noexcept
+{
+    Q_D(const MultiPartFormDataStream);
+    return d->state == MultiPartFormDataStreamPrivate::Epilogue;
+}
+
+bool MultiPartFormDataStream::hasError() const noexcept
+{
+    Q_D(const MultiPartFormDataStream);
+    return d->state == MultiPartFormDataStreamPrivate::Error;
+}
+
+Uploads MultiPartFormDataStream::takeUploads()
+{
+    Q_D(MultiPartFormDataStream);
+    return std::exchange(d->uploads, {});
+}
+
+bool MultiPartFormDataStream::isSequential() const
+{
+    return false;
+}
+
+qint64 MultiPartFormDataStream::size() const
+{
+    Q_D(const MultiPartFormDataStream);
+    return d->written;
+}
+
+qint64 MultiPartFormDataStream::readData(char *data, qint64 maxlen)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxlen)
+    // The raw body is not kept
+    return 0;
+}
+
+qint64 MultiPartFormDataStream::writeData(const char *data, qint64 len)
+{
+    Q_D(MultiPartFormDataStream);
+    d->written += len;
+
+    qint64 pos = 0;
+    while (pos < len) {
+        pos += d->feed(this, data + pos, len - pos);
+    }
+
+    // Malformed bodies are still consumed so engines keep reading the request
+    return len;
+}
+
+qint64 MultiPartFormDataStreamPrivate::feed(MultiPartFormDataStream *q,
+                                            const char *data,
+                                            qint64 len)
+{
+    switch (state) {
+    case Preamble:
+    case PartData:
+        return feedData(q, data, len);
+    case AfterBoundary:
+    {
+        // "\r\n" starts another part while "--" closes the body
+        const qint64 take = qMin(len, qint64(2 - pending.size()));
+        pending.append(data, take);
+        if (pending.size() == 2) {
+            if (pending == "\r\n") {
+                state       = PartHeaders;
+                headersSize = 0;
+                pending.clear();
+            } else if (pending == "--") {
+                state = Epilogue;
+                pending.clear();
+            } else {
+                setError("Invalid data after boundary");
+            }
+        }
+        return take;
+    }
+    case PartHeaders:
+        return feedHeaders(q, data, len);
+    case Epilogue:
+    case Error:
+        break;
+    }
+    return len;
+}
+
+qint64 MultiPartFormDataStreamPrivate::feedData(MultiPartFormDataStream *q,
+                                                const char *data,
+                                                qint64 len)
+{
+    const qsizetype delimiterSize = delimiter.size();
+
+    // Preamble data is discarded
+    auto flush = [this, q](const char *ptr, qint64 size) {
+        if (state == PartData && size) {
+            writePart(q, ptr, size);
+        }
+    };
+
+    auto boundaryFound = [this, q] {
+        if (state == PartData) {
+            finishPart();
+        }
+        if (state != Error) {
+            state = AfterBoundary;
+        }
+    };
+
+    if (!pending.isEmpty()) {
+        // A delimiter might have started on the previous write, look at it
+        // together with enough new bytes to complete it
+        const qsizetype previous = pending.size();
+        const qint64 take        = qMin(len, qint64(delimiterSize - 1));
+        pending.append(data, take);
+
+        const qsizetype index = findDelimiter(pending.constData(), pending.size(), delimiter);
+        if (index != -1) {
+            flush(pending.constData(), index);
+            pending.clear();
+            boundaryFound();
+            return index + delimiterSize - previous;
+        }
+
+        if (take < delimiterSize - 1) {
+            // Still can't tell, keep only what might be a delimiter
+            const qsizetype keep =
+                delimiterTailSize(pending.constData(), pending.size(), delimiterSize);
+            flush(pending.constData(), pending.size() - keep);
+            pending.remove(0, pending.size() - keep);
+            return len;
+        }
+
+        flush(pending.constData(), previous);
+        pending.clear();
+    }
+
+    const qsizetype index = findDelimiter(data, len, delimiter);
+    if (index != -1) {
+        flush(data, index);
+        boundaryFound();
+        return index + delimiterSize;
+    }
+
+    const qsizetype keep = delimiterTailSize(data, len, delimiterSize);
+    flush(data, len - keep);
+    pending.append(data + len - keep, keep);
+    return len;
+}
+
+qint64 MultiPartFormDataStreamPrivate::feedHeaders(MultiPartFormDataStream *q,
+                                                   const char *data,
+                                                   qint64 len)
+{
+    auto lf           = static_cast<const char *>(memchr(data, '\n', size_t(len)));
+    const qint64 size = lf ? lf - data + 1 : len;
+
+    headersSize += size;
+    if (headersSize > maxPartHeadersSize) {
+        setError("Part headers are too big");
+        return len;
+    }
+
+    // Incomplete header lines are kept on pending
+    pending.append(data, lf ? size - 1 : size);
+    if (!lf) {
+        return size;
+    }
+
+    if (pending.endsWith('\r')) {
+        pending.chop(1);
+    }
+
+    if (pending.isEmpty()) {
+        startPart(q);
+        return size;
+    }
+
+    const qsizetype dotdot = pending.indexOf(':');
+    if (dotdot == -1) {
+        setError("Invalid part header");
+        return size;
+    }
+
+    headers.setHeader(pending.left(dotdot),
+                      QByteArrayView{pending}.sliced(dotdot + 1).trimmed().toByteArray());
+    pending.clear();
+    return size;
+}
+
+void MultiPartFormDataStreamPrivate::startPart(MultiPartFormDataStream *q)
+{
+    // Same rule Request uses to tell form fields from uploads
+    const QByteArray disposition = headers.header(Headers::KnownHeader::ContentDisposition);
+    const qsizetype filename     = disposition.indexOf("filename=\"");
+    const bool hasFilename =
+        filename != -1 && disposition.indexOf('"', filename + 10) > filename + 10;
+    const bool isFile =
+        hasFilename || !headers.header(Headers::KnownHeader::ContentType).isEmpty();
+
+    if (isFile) {
+        auto temp = new QTemporaryFile(q);
+        if (!temp->open()) {
+            qCWarning(CUTELYST_MULTIPART)
+                << "Failed to open temporary file to store upload" << temp->errorString();
+            delete temp;
+            setError("Failed to store upload");
+            return;
+        }
+        sink = temp;
+    } else {
+        memory = new QBuffer(q);
+        memory->open(QIODevice::ReadWrite);
+        sink = memory;
+    }
+
+    partSize = 0;
+    state    = PartData;
+}
+
+bool MultiPartFormDataStreamPrivate::writePart(MultiPartFormDataStream *q,
+                                               const char *data,
+                                               qint64 len)
+{
+    if (memory && partSize + len > memoryLimit) {
+        // Big fields are moved out of memory
+        auto temp = new QTemporaryFile(q);
+        if (!temp->open() || temp->write(memory->data()) != partSize) {
+            qCWarning(CUTELYST_MULTIPART)
+                << "Failed to move form field to a temporary file" << temp->errorString();
+            delete temp;
+            setError("Failed to store form field");
+            return false;
+        }
+        delete memory;
+        memory = nullptr;
+        sink   = temp;
+    }
+
+    if (sink->write(data, len) != len) {
+        qCWarning(CUTELYST_MULTIPART) << "Failed to write upload data" << sink->errorString();
+        setError("Failed to store upload");
+        return false;
+    }
+    partSize += len;
+    return true;
+}
+
+void MultiPartFormDataStreamPrivate::finishPart()
+{
+    auto upload = new Upload(new UploadPrivate(sink, headers, 0, partSize));
+    sink->setParent(upload);
+    uploads.append(upload);
+
+    sink    = nullptr;
+    memory  = nullptr;
+    headers = Headers();
+}
+
+void MultiPartFormDataStreamPrivate::setError(const char *reason)
+{
+    qCWarning(CUTELYST_MULTIPART) << "Failed to parse multipart body:" << reason;
+    state = Error;
+    pending.clear();
+}
+
+qsizetype MultiPartFormDataStreamPrivate::findDelimiter(const char *data,
+                                                        qsizetype len,
+                                                        QByteArrayView delimiter)
+{
+    // memchr() is vectorized by the C library, delimiters only match on a '\r'
+    // which is rare enough on most uploads to skip large blocks at once
+    const qsizetype delimiterSize = delimiter.size();
+    const char *pos               = data;
+    const char *end               = data + len;
+    while (end - pos >= delimiterSize) {
+        pos = static_cast<const char *>(memchr(pos, '\r', size_t(end - pos - delimiterSize + 1)));
+        if (!pos) {
+            return -1;
+        }
+        if (memcmp(pos + 1, delimiter.data() + 1, size_t(delimiterSize - 1)) == 0) {
+            return pos - data;
+        }
+        ++pos;
+    }
+    return -1;
+}
+
+#include "moc_multipartformdataparser.cpp"
 #include "moc_multipartformdataparser_p.cpp"
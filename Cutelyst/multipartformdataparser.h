@@ -9,6 +9,8 @@
 
 namespace Cutelyst {
 
+class MultiPartFormDataStreamPrivate;
+
 class CUTELYST_EXPORT MultiPartFormDataParser
 {
 public:
@@ -22,4 +24,88 @@ public:
         parse(QIODevice *body, QByteArrayView contentType, int bufferSize = 4096);
 };
 
+/**
+ * \ingroup core
+ * \class MultiPartFormDataStream multipartformdataparser.h Cutelyst/MultiPartFormDataParser
+ * \brief Incremental parser for multipart/form-data.
+ *
+ * %MultiPartFormDataStream is a write only device that parses a multipart/form-data
+ * body while it is written, engines can use it as the request body so parts are
+ * stored as bytes arrive from the socket instead of buffering the whole body and
+ * parsing it again.
+ *
+ * Each part with a file name or a content type is written to its own temporary file,
+ * while form fields are kept in memory unless they grow bigger than memoryLimit().
+ *
+ * Once the whole body was written the parts are available with takeUploads(),
+ * Request::uploads() takes them without parsing the body again. As the raw body
+ * is not kept reading from this device returns no data.
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT MultiPartFormDataStream final : public QIODevice
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(MultiPartFormDataStream)
+public:
+    /**
+     * Constructs a new stream that parses a body of \a contentType, which can
+     * be the whole HTTP Content-Type header or just it's value.
+     *
+     * If no boundary is found hasError() returns \c true and writes are discarded.
+     */
+    explicit MultiPartFormDataStream(QByteArrayView contentType, QObject *parent = nullptr);
+
+    /**
+     * Destroys the stream and any Upload that wasn't taken.
+     */
+    ~MultiPartFormDataStream() override;
+
+    /**
+     * Sets the maximum size in bytes a form field is kept in memory before moving
+     * it to a temporary file. Default value: \c 65536.
+     */
+    void setMemoryLimit(qint64 bytes);
+    [[nodiscard]] qint64 memoryLimit() const noexcept;
+
+    /**
+     * Returns \c true if the closing boundary was found.
+     */
+    [[nodiscard]] bool isFinished() const noexcept;
+
+    /**
+     * Returns \c true if the body is malformed or a part could not be stored, parts
+     * that were completely parsed before the error are still available.
+     */
+    [[nodiscard]] bool hasError() const noexcept;
+
+    /**
+     * Returns the parts parsed so far, the caller takes ownership of them.
+     */
+    [[nodiscard]] Uploads takeUploads();
+
+    /**
+     * Reimplemented from QIODevice::isSequential().
+     */
+    bool isSequential() const override;
+
+    /**
+     * Reimplemented from QIODevice::size(), returns the number of bytes written.
+     */
+    qint64 size() const override;
+
+protected:
+    /**
+     * Reimplemented from QIODevice::readData().
+     */
+    qint64 readData(char *data, qint64 maxlen) override;
+
+    /**
+     * Reimplemented from QIODevice::writeData().
+     */
+    qint64 writeData(const char *data, qint64 len) override;
+
+    MultiPartFormDataStreamPrivate *d_ptr;
+};
+
 } // namespace Cutelyst
@@ -9,6 +9,8 @@
 
 #include <QByteArrayMatcher>
 
+class QBuffer;
+
 namespace Cutelyst {
 
 class MultiPartFormDataParserPrivate
@@ -27,6 +29,11 @@ public:
     };
     Q_ENUM(ParserState)
 
+    /**
+     * Returns the boundary of \p contentType prefixed with "--" or an empty array.
+     */
+    static QByteArray boundary(QByteArrayView contentType);
+
     static Uploads
         execute(char *buffer, int bufferSize, QIODevice *body, const QByteArray &boundary);
     static inline int findBoundary(char *buffer,
@@ -36,6 +43,44 @@ public:
                                    ParserState &state);
 };
 
+class MultiPartFormDataStreamPrivate
+{
+public:
+    enum State {
+        Preamble,
+        AfterBoundary,
+        PartHeaders,
+        PartData,
+        Epilogue,
+        Error,
+    };
+
+    qint64 feed(MultiPartFormDataStream *q, const char *data, qint64 len);
+    qint64 feedData(MultiPartFormDataStream *q, const char *data, qint64 len);
+    qint64 feedHeaders(MultiPartFormDataStream *q, const char *data, qint64 len);
+    bool headerLine(MultiPartFormDataStream *q);
+    void startPart(MultiPartFormDataStream *q);
+    bool writePart(MultiPartFormDataStream *q, const char *data, qint64 len);
+    void finishPart();
+    void setError(const char *reason);
+
+    static qsizetype findDelimiter(const char *data, qsizetype len, QByteArrayView delimiter);
+
+    // "\r\n--boundary", the body is parsed as if it started with "\r\n"
+    QByteArray delimiter;
+    // Bytes of a possible delimiter spanning two writes, or an incomplete header line
+    QByteArray pending;
+    Headers headers;
+    Uploads uploads;
+    QIODevice *sink     = nullptr;
+    QBuffer *memory     = nullptr;
+    qint64 partSize     = 0;
+    qint64 written      = 0;
+    qint64 memoryLimit  = 64 * 1024;
+    qint64 headersSize  = 0;
+    State state         = Preamble;
+};
+
 } // namespace Cutelyst
 
 #endif // MULTIPARTFORMDATA_P_H
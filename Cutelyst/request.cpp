@@ -9,6 +9,8 @@
 #include "request_p.h"
 #include "utils.h"
 
+#include <QBuffer>
+#include <QCborStreamReader>
 #include <QHostInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -96,7 +98,7 @@ QUrl Request::uri() const
 
         // if the path does not start with a slash it cleans the uri
         // TODO check if engines will always set a slash
-        uri.setPath(d->engineRequest->path);
+        uri.setPath(path());
 
         if (!d->engineRequest->query.isEmpty()) {
             uri.setQuery(QString::fromLatin1(d->engineRequest->query));
@@ -131,7 +133,25 @@ QString Request::base() const
 QString Request::path() const noexcept
 {
     Q_D(const Request);
-    return d->engineRequest->path;
+    if (!(d->parserStatus & RequestPrivate::PathParsed)) {
+        if (d->engineRequest->pathUtf8.isEmpty()) {
+            // Engines that still set the deprecated QString path
+            d->path = d->engineRequest->path;
+        } else {
+            d->path = QString::fromUtf8(d->engineRequest->pathUtf8);
+        }
+        d->parserStatus |= RequestPrivate::PathParsed;
+    }
+    return d->path;
+}
+
+QByteArray Request::pathUtf8() const noexcept
+{
+    Q_D(const Request);
+    if (d->engineRequest->pathUtf8.isEmpty()) {
+        return d->engineRequest->path.toUtf8();
+    }
+    return d->engineRequest->pathUtf8;
 }
 
 QString Request::match() const noexcept
@@ -193,22 +213,30 @@ QVariant Request::bodyData() const
 
 QCborValue Request::bodyCbor() const
 {
-    return bodyData().value<QCborValue>();
+    Q_D(const Request);
+    if (!(d->parserStatus & RequestPrivate::BodyParsed)) {
+        d->parseBody();
+    }
+    return d->bodyCbor;
 }
 
 QJsonDocument Request::bodyJsonDocument() const
 {
-    return bodyData().toJsonDocument();
+    Q_D(const Request);
+    if (!(d->parserStatus & RequestPrivate::BodyParsed)) {
+        d->parseBody();
+    }
+    return d->bodyJson;
 }
 
 QJsonObject Request::bodyJsonObject() const
 {
-    return bodyData().toJsonDocument().object();
+    return bodyJsonDocument().object();
 }
 
 QJsonArray Request::bodyJsonArray() const
 {
-    return bodyData().toJsonDocument().array();
+    return bodyJsonDocument().array();
 }
 
 QVariantMap Request::bodyParametersVariant() const
@@ -479,22 +507,36 @@ void RequestPrivate::parseBody() const
     }
 
     const QByteArray contentType = engineRequest->headers.header("Content-Type");
-    if (contentType.startsWith("application/x-www-form-urlencoded")) {
+    // The size of sequential bodies is not known, readBodyData() enforces the limit on them
+    const bool tooBig = bodyDataLimit >= 0 && !sequencial && body->size() > bodyDataLimit;
+    if (tooBig && !contentType.startsWith("multipart/form-data")) {
+        // Such bodies can still be read with JsonStreamReader or QCborStreamReader
+        qCWarning(CUTELYST_REQUEST) << "Not parsing body bigger than body_data_limit"
+                                    << body->size() << contentType;
+    } else if (contentType.startsWith("application/x-www-form-urlencoded")) {
         // Parse the query (BODY) of type "application/x-www-form-urlencoded"
         // parameters ie "?foo=bar&bar=baz"
         if (posOrig) {
             body->seek(0);
         }
 
-        QByteArray line = body->readAll();
-        bodyParam       = Utils::decodePercentEncoding(line.data(), line.size());
-        bodyData        = QVariant::fromValue(bodyParam);
+        QByteArray line;
+        if (readBodyData(line)) {
+            bodyParam = Utils::decodePercentEncoding(line.data(), line.size());
+            bodyData  = QVariant::fromValue(bodyParam);
+        }
     } else if (contentType.startsWith("multipart/form-data")) {
-        if (posOrig) {
-            body->seek(0);
+        Uploads ups;
+        if (auto stream = qobject_cast<MultiPartFormDataStream *>(body)) {
+            // Parts were already stored while the body was received
+            ups = stream->takeUploads();
+        } else {
+            if (posOrig) {
+                body->seek(0);
+            }
+            ups = MultiPartFormDataParser::parse(body, contentType);
         }
 
-        const Uploads ups = MultiPartFormDataParser::parse(body, contentType);
         for (Upload *upload : ups) {
             if (upload->filename().isEmpty() &&
                 upload->headers().header("Content-Type").isEmpty()) {
@@ -510,13 +552,31 @@ void RequestPrivate::parseBody() const
             body->seek(0);
         }
 
-        bodyData = QVariant::fromValue(QCborValue::fromCbor(body->readAll()));
+        if (sequencial && bodyDataLimit >= 0) {
+            QByteArray data;
+            if (readBodyData(data)) {
+                bodyCbor = QCborValue::fromCbor(data);
+                bodyData = QVariant::fromValue(bodyCbor);
+            }
+        } else {
+            // Decoded straight from the device instead of a copy of the body
+            QCborStreamReader reader(body);
+            bodyCbor = QCborValue::fromCbor(reader);
+            bodyData = QVariant::fromValue(bodyCbor);
+        }
     } else if (contentType.startsWith("application/json")) {
         if (posOrig) {
             body->seek(0);
         }
 
-        bodyData = QJsonDocument::fromJson(body->readAll());
+        // Buffered bodies are parsed without being copied
+        if (auto buffer = qobject_cast<QBuffer *>(body)) {
+            bodyJson = QJsonDocument::fromJson(buffer->data());
+            bodyData = bodyJson;
+        } else if (QByteArray data; readBodyData(data)) {
+            bodyJson = QJsonDocument::fromJson(data);
+            bodyData = bodyJson;
+        }
     }
 
     if (!sequencial) {
@@ -526,6 +586,35 @@ void RequestPrivate::parseBody() const
     parserStatus |= RequestPrivate::BodyParsed;
 }
 
+bool RequestPrivate::readBodyData(QByteArray &data) const
+{
+    if (bodyDataLimit < 0) {
+        data = body->readAll();
+        return true;
+    }
+
+    // Reads in blocks so a body without a known size stops at body_data_limit + 1 bytes
+    constexpr qint64 blockSize = 16 * 1024;
+    qint64 size                = 0;
+    while (size <= bodyDataLimit) {
+        data.resize(std::min(size + blockSize, bodyDataLimit + 1));
+        const qint64 len = body->read(data.data() + size, data.size() - size);
+        if (len <= 0) {
+            break;
+        }
+        size += len;
+    }
+
+    if (size > bodyDataLimit) {
+        qCWarning(CUTELYST_REQUEST) << "Not parsing body bigger than body_data_limit"
+                                    << engineRequest->headers.header("Content-Type");
+        data.clear();
+        return false;
+    }
+    data.resize(size);
+    return true;
+}
+
 namespace {
 inline bool isSlit(char c)
 {
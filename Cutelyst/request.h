@@ -119,6 +119,15 @@ public:
      */
     [[nodiscard]] QString path() const noexcept;
 
+    /**
+     * Returns the decoded path of the current request as UTF-8 bytes, the same as
+     * path() but without converting it to a QString, which path() only does the
+     * first time it's called.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] QByteArray pathUtf8() const noexcept;
+
     /**
      * This contains the matching part of a Regex action.
      * Otherwise it returns the same as 'action' (not a pointer but it's private name),
@@ -200,18 +209,25 @@ public:
      *
      * If the POSTed content type does not match an available data handler,
      * this will also return a null QVariant.
+     *
+     * Bodies bigger than the \c body_data_limit \ref configfile "config entry" are
+     * not parsed, JsonStreamReader and QCborStreamReader can process them from body().
      */
     [[nodiscard]] QVariant bodyData() const;
 
     /**
      * When request Content-Type is 'application/cbor' this will
      * contain the parsed CBOR value.
+     *
+     * The body is parsed once, further calls return the same value.
      */
     [[nodiscard]] QCborValue bodyCbor() const;
 
     /**
      * When request Content-Type is 'application/json' this will
      * contain the parsed JSON representation document.
+     *
+     * The body is parsed once, further calls return the same document.
      */
     [[nodiscard]] QJsonDocument bodyJsonDocument() const;
 
@@ -9,6 +9,8 @@
 #include "request.h"
 #include "upload.h"
 
+#include <QtCore/QCborValue>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QStringList>
 #include <QtCore/QUrl>
 #include <QtCore/QUrlQuery>
@@ -27,12 +29,14 @@ public:
         BaseParsed    = 0x02,
         CookiesParsed = 0x04,
         QueryParsed   = 0x08,
-        BodyParsed    = 0x10
+        BodyParsed    = 0x10,
+        PathParsed    = 0x20,
     };
     Q_DECLARE_FLAGS(ParserStatus, ParserStatusFlag)
 
     inline void parseUrlQuery() const;
     inline void parseBody() const;
+    inline bool readBodyData(QByteArray &data) const;
     inline void parseCookies() const;
 
     static inline QVariantMap paramsMultiMapToVariantMap(const ParamsMultiMap &params);
@@ -49,15 +53,19 @@ public:
 
     mutable QUrl url;
     mutable QString base;
+    mutable QString path;
     mutable QMultiMap<QAnyStringView, Request::Cookie> cookies;
     mutable ParamsMultiMap queryParam;
     mutable QString queryKeywords;
     mutable ParamsMultiMap bodyParam;
     mutable QVariant bodyData;
+    mutable QJsonDocument bodyJson;
+    mutable QCborValue bodyCbor;
     mutable QString remoteHostname;
     mutable QMultiMap<QAnyStringView, Upload *> uploadsMap;
     mutable QVector<Upload *> uploads;
     mutable ParserStatus parserStatus = NotParsed;
+    qint64 bodyDataLimit              = -1;
 };
 
 } // namespace Cutelyst
@@ -6,13 +6,19 @@
 #include "context_p.h"
 #include "engine.h"
 #include "enginerequest.h"
+#include "jsonwriter.h"
 #include "response_p.h"
+#include "responsefilter.h"
 
 #include <QCryptographicHash>
 #include <QEventLoop>
 #include <QJsonArray>
 #include <QJsonObject>
-#include <QtCore/QJsonDocument>
+#include <QRandomGenerator>
+
+#ifdef CUTELYST_WITH_XXHASH
+#    include <xxhash.h>
+#endif
 
 using namespace Cutelyst;
 using namespace Qt::Literals::StringLiterals;
@@ -53,15 +59,34 @@ qint64 Response::writeData(const char *data, qint64 len)
         d->bodyIODevice = nullptr;
         d->bodyData     = QByteArray();
 
+        // The filter changes the headers of what is about to be written
+        if (d->filter && !d->filter->start(this)) {
+            delete d->filter;
+            d->filter = nullptr;
+        }
+
         d->engineRequest->finalizeHeaders();
     }
 
+    if (d->filter) {
+        const auto begin     = std::chrono::steady_clock::now();
+        const QByteArray out = d->filter->write(QByteArrayView{data, qsizetype(len)});
+        d->filterTime += std::chrono::steady_clock::now() - begin;
+
+        // An empty chunk would end the body
+        if (!out.isEmpty() && d->engineRequest->write(out.constData(), out.size()) != out.size()) {
+            return -1;
+        }
+        return len;
+    }
+
     return d->engineRequest->write(data, len);
 }
 
 Response::~Response()
 {
     delete d_ptr->bodyIODevice;
+    delete d_ptr->filter;
     delete d_ptr;
 }
 
@@ -123,6 +148,21 @@ void Response::setBody(const QByteArray &body)
     d->setBodyData(body);
 }
 
+void Response::setFilter(ResponseFilter *filter)
+{
+    Q_D(Response);
+    if (d->filter != filter) {
+        delete d->filter;
+        d->filter = filter;
+    }
+}
+
+ResponseFilter *Response::filter() const noexcept
+{
+    Q_D(const Response);
+    return d->filter;
+}
+
 void Response::setCborBody(const QByteArray &cbor)
 {
     Q_D(Response);
@@ -144,12 +184,16 @@ void Response::setJsonBody(const QByteArray &json)
 
 void Response::setJsonObjectBody(const QJsonObject &obj)
 {
-    setJsonBody(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    QByteArray json;
+    JsonWriter::appendJson(json, obj);
+    setJsonBody(json);
 }
 
 void Response::setJsonArrayBody(const QJsonArray &array)
 {
-    setJsonBody(QJsonDocument(array).toJson(QJsonDocument::Compact));
+    QByteArray json;
+    JsonWriter::appendJson(json, array);
+    setJsonBody(json);
 }
 
 QByteArray Response::contentEncoding() const noexcept
@@ -187,6 +231,32 @@ QByteArray Response::contentTypeCharset() const
     return d->headers.contentTypeCharset();
 }
 
+void Response::setAutoETag(bool enable)
+{
+    Q_D(Response);
+    d->autoETag = enable;
+}
+
+bool Response::autoETag() const noexcept
+{
+    Q_D(const Response);
+    return d->autoETag;
+}
+
+bool Response::setETagVersion(QByteArrayView version)
+{
+    Q_D(Response);
+    const QByteArray etag = ResponsePrivate::etagHash(version);
+    d->headers.setETag(etag);
+
+    const QByteArray &method = d->engineRequest->method;
+    if ((method == "GET" || method == "HEAD") && d->engineRequest->headers.ifNoneMatch(etag)) {
+        d->status = NotModified;
+        return true;
+    }
+    return false;
+}
+
 QVariant Response::cookie(const QByteArray &name) const
 {
     Q_D(const Response);
@@ -356,6 +426,226 @@ bool Response::webSocketClose(quint16 code, const QString &reason)
     return d->engineRequest->webSocketClose(code, reason);
 }
 
+QString ResponsePrivate::finishFilter(Response *q, bool error)
+{
+    if (!filter) {
+        return {};
+    }
+
+    QString name;
+    if (engineRequest->status & EngineRequest::IOWrite) {
+        // Started by the first write
+        const auto begin     = std::chrono::steady_clock::now();
+        const QByteArray out = filter->finish();
+        filterTime += std::chrono::steady_clock::now() - begin;
+
+        if (!out.isEmpty()) {
+            engineRequest->write(out.constData(), out.size());
+        }
+        name = filter->name();
+    } else if (!error && !bodyIODevice && !bodyData.isEmpty() && filter->start(q)) {
+        const auto begin = std::chrono::steady_clock::now();
+        QByteArray out   = filter->write(bodyData);
+        out.append(filter->finish());
+        filterTime += std::chrono::steady_clock::now() - begin;
+
+        bodyData = out;
+        name     = filter->name();
+    }
+
+    delete filter;
+    filter = nullptr;
+    return name;
+}
+
+ResponseFilter::~ResponseFilter() = default;
+
+QByteArray ResponsePrivate::etagHash(QByteArrayView data)
+{
+#ifdef CUTELYST_WITH_XXHASH
+    const XXH128_hash_t hash = XXH3_128bits(data.data(), size_t(data.size()));
+    XXH128_canonical_t canonical;
+    XXH128_canonicalFromHash(&canonical, hash);
+    return QByteArray(reinterpret_cast<const char *>(canonical.digest), sizeof(canonical.digest))
+        .toHex();
+#else
+    return QCryptographicHash::hash(data, QCryptographicHash::Blake2b_128).toHex();
+#endif
+}
+
+void ResponsePrivate::finalizeETag(const EngineRequest *request)
+{
+    // Only a QByteArray body is known as a whole at this point
+    if (!autoETag || status != Response::OK || bodyIODevice ||
+        (request->status & EngineRequest::IOWrite) ||
+        (request->method != "GET" && request->method != "HEAD") ||
+        headers.contains(Headers::KnownHeader::ETag)) {
+        return;
+    }
+
+    // The filter already ran, so the hash is of the bytes that are sent
+    const QByteArray etag = etagHash(bodyData);
+    headers.setETag(etag);
+    if (request->headers.ifNoneMatch(etag)) {
+        status = Response::NotModified;
+        bodyData.clear();
+    }
+}
+
+qint64 ResponsePrivate::selectRanges(const EngineRequest *request, qint64 size)
+{
+    // Range handling is only defined for GET
+    if (status != Response::OK || request->method != "GET" ||
+        (bodyIODevice && bodyIODevice->isSequential()) ||
+        headers.header("Accept-Ranges") != "bytes") {
+        return size;
+    }
+
+    const QByteArray range = request->headers.header(Headers::KnownHeader::Range);
+    if (range.size() < 6 ||
+        QByteArrayView(range).first(6).compare("bytes=", Qt::CaseInsensitive) != 0) {
+        return size;
+    }
+
+    // A changed representation is sent as a whole, weak validators never match
+    const QByteArray ifRange = request->headers.header(Headers::KnownHeader::IfRange);
+    if (!ifRange.isEmpty()) {
+        if (ifRange.startsWith('"')) {
+            if (ifRange != headers.header(Headers::KnownHeader::ETag)) {
+                return size;
+            }
+        } else if (ifRange != headers.header(Headers::KnownHeader::LastModified)) {
+            return size;
+        }
+    }
+
+    const QByteArrayList specs = range.mid(6).split(',');
+    // So many ranges are more likely an attack than a media player
+    if (specs.size() > 32) {
+        return size;
+    }
+
+    QVector<ByteRange> selected;
+    for (const QByteArray &spec : specs) {
+        const QByteArray trimmed = spec.trimmed();
+        const qsizetype dash     = trimmed.indexOf('-');
+        if (dash == -1) {
+            return size;
+        }
+
+        // Invalid ranges make the whole header ignored
+        bool ok;
+        ByteRange byteRange;
+        if (dash == 0) {
+            const qint64 suffix = trimmed.mid(1).toLongLong(&ok);
+            if (!ok || suffix < 0) {
+                return size;
+            } else if (suffix == 0) {
+                continue;
+            }
+            byteRange.first = qMax(qint64(0), size - suffix);
+            byteRange.last  = size - 1;
+        } else {
+            byteRange.first = trimmed.left(dash).toLongLong(&ok);
+            if (!ok || byteRange.first < 0) {
+                return size;
+            }
+
+            if (dash + 1 == trimmed.size()) {
+                byteRange.last = size - 1;
+            } else {
+                byteRange.last = trimmed.mid(dash + 1).toLongLong(&ok);
+                if (!ok || byteRange.last < byteRange.first) {
+                    return size;
+                }
+                byteRange.last = qMin(byteRange.last, size - 1);
+            }
+        }
+
+        if (byteRange.first < size) {
+            selected.append(byteRange);
+        }
+    }
+
+    const auto contentRange = [size](const ByteRange &byteRange) {
+        return "bytes " + QByteArray::number(byteRange.first) + '-' +
+               QByteArray::number(byteRange.last) + '/' + QByteArray::number(size);
+    };
+
+    if (selected.isEmpty()) {
+        status = Response::RequestedRangeNotSatisfiable;
+        headers.setHeader("Content-Range"_ba, "bytes */" + QByteArray::number(size));
+
+        delete bodyIODevice;
+        bodyIODevice = nullptr;
+        bodyData     = {};
+        return 0;
+    }
+
+    status = Response::PartialContent;
+    if (selected.size() == 1) {
+        const ByteRange &byteRange = selected.constFirst();
+        headers.setHeader("Content-Range"_ba, contentRange(byteRange));
+        ranges = selected;
+        return byteRange.last - byteRange.first + 1;
+    }
+
+    const QByteArray boundary =
+        QByteArray::number(QRandomGenerator::global()->generate64(), 16).rightJustified(16, '0');
+    const QByteArray contentType = headers.header(Headers::KnownHeader::ContentType);
+
+    qint64 total = 0;
+    for (ByteRange &byteRange : selected) {
+        byteRange.header = "\r\n--" + boundary + "\r\n";
+        if (!contentType.isEmpty()) {
+            byteRange.header.append("Content-Type: " + contentType + "\r\n");
+        }
+        byteRange.header.append("Content-Range: " + contentRange(byteRange) + "\r\n\r\n");
+        total += byteRange.header.size() + byteRange.last - byteRange.first + 1;
+    }
+    rangesEnd = "\r\n--" + boundary + "--\r\n";
+    total += rangesEnd.size();
+
+    headers.setContentType("multipart/byteranges; boundary=" + boundary);
+    ranges = selected;
+    return total;
+}
+
+bool ResponsePrivate::writeRanges()
+{
+    char block[64 * 1024];
+    for (const ByteRange &byteRange : std::as_const(ranges)) {
+        if (!byteRange.header.isEmpty() &&
+            engineRequest->write(byteRange.header.constData(), byteRange.header.size()) !=
+                byteRange.header.size()) {
+            return false;
+        }
+
+        qint64 remaining = byteRange.last - byteRange.first + 1;
+        if (!bodyIODevice) {
+            if (engineRequest->write(bodyData.constData() + byteRange.first, remaining) !=
+                remaining) {
+                return false;
+            }
+            continue;
+        }
+
+        if (!bodyIODevice->seek(byteRange.first)) {
+            return false;
+        }
+        while (remaining > 0) {
+            const qint64 in = bodyIODevice->read(block, qMin(remaining, qint64(sizeof(block))));
+            if (in <= 0 || engineRequest->write(block, in) != in) {
+                return false;
+            }
+            remaining -= in;
+        }
+    }
+
+    return rangesEnd.isEmpty() ||
+           engineRequest->write(rangesEnd.constData(), rangesEnd.size()) == rangesEnd.size();
+}
+
 void ResponsePrivate::setBodyData(const QByteArray &body)
 {
     if (!(engineRequest->status & EngineRequest::IOWrite)) {
@@ -16,6 +16,7 @@ namespace Cutelyst {
 class Context;
 class Engine;
 class EngineRequest;
+class ResponseFilter;
 class ResponsePrivate;
 /**
  * @ingroup core
@@ -24,6 +25,13 @@ class ResponsePrivate;
  *
  * A %Cutelyst response contains the data created by your application that should be
  * send back to the \link Request requesting\endlink client.
+ *
+ * Responses that set the \c Accept-Ranges header to \c bytes answer \c GET requests with
+ * a \c Range header by sending only the requested parts of their body, as a single
+ * \c 206 Partial Content or a \c multipart/byteranges one, or \c 416 if none of them
+ * is satisfiable. The \c If-Range header is checked against the \c ETag and
+ * \c Last-Modified headers, this only works when the body is a QByteArray or a seekable
+ * QIODevice, since %Cutelyst 5.1.0.
  */
 class CUTELYST_EXPORT Response final : public QIODevice
 {
@@ -157,6 +165,21 @@ public:
      */
     inline void setBody(QStringView body);
 
+    /**
+     * Sets the \a filter that transforms the body before it is sent, like
+     * compressing it, the response takes ownership of it and deletes any previous filter.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void setFilter(ResponseFilter *filter);
+
+    /**
+     * Returns the filter of the body, if any.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] ResponseFilter *filter() const noexcept;
+
     /**
      * Sets a \a CBOR data as the response body,
      * this method is provided for convenience as it sets the content-type to application/cbor.
@@ -235,6 +258,51 @@ public:
      */
     QByteArray contentTypeCharset() const;
 
+    /**
+     * Enables the automatic ETag of this response. When enabled, a successful GET or HEAD
+     * response with a QByteArray body and no ETag gets a strong ETag with the hash of the body
+     * that is sent, if it matches the If-None-Match header of the request the status is changed
+     * to 304 - Response::NotModified and the body is not sent.
+     *
+     * The default value comes from the \c auto_etag key of the \c Cutelyst configuration group.
+     *
+     * This saves bandwidth but the body is still rendered, use setETagVersion() to avoid that.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void setAutoETag(bool enable);
+
+    /**
+     * Returns true if the automatic ETag is enabled.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    [[nodiscard]] bool autoETag() const noexcept;
+
+    /**
+     * Sets a strong ETag made of the hash of \a version, a cheap value that changes whenever
+     * the content changes, like the update time of a database row, it must also change if the
+     * same URL can have a different representation.
+     *
+     * Returns true if the request is a GET or HEAD and the If-None-Match header matches the
+     * ETag, in which case the status is set to 304 - Response::NotModified and the action can
+     * return without rendering anything:
+     * \code{.cpp}
+     * void Articles::view(Context *c, const QString &id)
+     * {
+     *     const Article article = Article::find(id);
+     *     const QByteArray version = article.updatedAt().toString(Qt::ISODateWithMs).toLatin1();
+     *     if (c->res()->setETagVersion(version)) {
+     *         return;
+     *     }
+     *     // render the article
+     * }
+     * \endcode
+     *
+     * \since Cutelyst 5.1.0
+     */
+    bool setETagVersion(QByteArrayView version);
+
     /**
      * Returns the first QNetworkCookie matching the \a name
      * or a null QVariant if not found.
@@ -421,6 +489,7 @@ protected:
     friend class Application;
     friend class Engine;
     friend class EngineConnection;
+    friend class EngineRequest;
     friend class Context;
     friend class ContextPrivate;
 };
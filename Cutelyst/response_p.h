@@ -9,9 +9,12 @@
 
 #include <QtCore/QMap>
 #include <QtCore/QUrl>
+#include <QtCore/QVector>
 #include <QtCore/QVariant>
 #include <QtNetwork/QNetworkCookie>
 
+#include <chrono>
+
 namespace Cutelyst {
 
 class Context;
@@ -25,15 +28,45 @@ public:
         , engineRequest(er)
     {
     }
+    struct ByteRange {
+        qint64 first = 0;
+        qint64 last  = 0;
+        // The part header of multipart/byteranges
+        QByteArray header;
+    };
+
     inline void setBodyData(const QByteArray &body);
 
+    // Runs the filter on a QByteArray body or flushes it when the body was written,
+    // returns the filter name if it was used
+    QString finishFilter(Response *q, bool error);
+
+    // Selects the parts of the body of size bytes asked by the Range header of the request,
+    // returns the size of what will be sent
+    qint64 selectRanges(const EngineRequest *request, qint64 size);
+
+    // Writes the selected parts of the body, returns false on failure
+    bool writeRanges();
+
+    // Sets the automatic ETag of a QByteArray body and answers If-None-Match with a 304
+    void finalizeETag(const EngineRequest *request);
+
+    // Returns the hex hash used for ETags
+    [[nodiscard]] static QByteArray etagHash(QByteArrayView data);
+
     Headers headers;
     QMap<QByteArray, QNetworkCookie> cookies;
     QByteArray bodyData;
     QUrl location;
     QIODevice *bodyIODevice = nullptr;
+    ResponseFilter *filter  = nullptr;
+    std::chrono::steady_clock::duration filterTime{};
+    QVector<ByteRange> ranges;
+    // The closing boundary of multipart/byteranges
+    QByteArray rangesEnd;
     EngineRequest *engineRequest;
     quint16 status = Response::OK;
+    bool autoETag  = false;
 };
 
 } // namespace Cutelyst
@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+namespace Cutelyst {
+
+class Response;
+
+/**
+ * \ingroup core
+ * \class ResponseFilter responsefilter.h Cutelyst/ResponseFilter
+ * \brief Transforms the response body before it is sent.
+ *
+ * A filter set with Response::setFilter() sees every response body, either as a whole
+ * when the body is a QByteArray, or piece by piece when the response is written to
+ * with QIODevice::write(). Bodies that are a QIODevice set with Response::setBody()
+ * are left untouched.
+ *
+ * start() is called right before the headers are sent, so the filter can change them
+ * or refuse the response, then write() is called for the body data and finish() once
+ * the body ended. The time spent in write() and finish() is shown in the stats report.
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT ResponseFilter
+{
+public:
+    virtual ~ResponseFilter();
+
+    /**
+     * Returns the name shown in the stats report.
+     */
+    [[nodiscard]] virtual QString name() const = 0;
+
+    /**
+     * Called before the headers of \a response are sent, the body is not set yet
+     * when the response is being written to. Returning \c false removes the filter.
+     */
+    virtual bool start(Response *response) = 0;
+
+    /**
+     * Returns the filtered \a data, which might be empty if the filter needs more input.
+     */
+    virtual QByteArray write(QByteArrayView data) = 0;
+
+    /**
+     * Returns the remaining filtered data once the body ended.
+     */
+    virtual QByteArray finish() = 0;
+};
+
+} // namespace Cutelyst
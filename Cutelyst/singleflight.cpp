@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "singleflight.h"
+
+#include "application.h"
+#include "async.h"
+#include "context.h"
+
+#include <vector>
+
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+
+using namespace Cutelyst;
+using namespace Qt::StringLiterals;
+
+namespace {
+
+struct Waiter {
+    QPointer<Context> c;
+    // Lives on the thread of the context, where the callback is called
+    QPointer<Application> app;
+    SingleFlight::Callback callback;
+    ASync async;
+};
+
+struct Flight {
+    std::vector<Waiter> waiters;
+    bool finished = false;
+};
+
+QString droppedError()
+{
+    return u"The loader did not finish"_s;
+}
+
+QBasicMutex flightsMutex;
+QHash<QByteArray, std::shared_ptr<Flight>> flights;
+
+void finishFlight(const QByteArray &key, Flight *flight, const SingleFlight::Result &result)
+{
+    std::vector<Waiter> waiters;
+    {
+        QMutexLocker locker(&flightsMutex);
+        if (flight->finished) {
+            return;
+        }
+        flight->finished = true;
+        flights.remove(key);
+        waiters = std::move(flight->waiters);
+    }
+
+    for (Waiter &waiter : waiters) {
+        if (waiter.app.isNull()) {
+            continue;
+        }
+
+        auto resume = [c        = waiter.c,
+                       callback = std::move(waiter.callback),
+                       async    = std::move(waiter.async),
+                       result] {
+            if (c) {
+                callback(result);
+            }
+        };
+
+        // Always queued so waiters on this thread do not run inside the loader
+        QMetaObject::invokeMethod(waiter.app.data(), std::move(resume), Qt::QueuedConnection);
+    }
+}
+
+// Finishes the load with an error if the loader drops it
+class Leader
+{
+public:
+    Leader(const QByteArray &key, std::shared_ptr<Flight> flight)
+        : m_key(key)
+        , m_flight(std::move(flight))
+    {
+    }
+
+    ~Leader() { finishFlight(m_key, m_flight.get(), {{}, droppedError()}); }
+
+    void finish(const SingleFlight::Result &result) const
+    {
+        finishFlight(m_key, m_flight.get(), result);
+    }
+
+private:
+    QByteArray m_key;
+    std::shared_ptr<Flight> m_flight;
+};
+
+// The done function given to the loader by run(), calls the callback of the leader
+// once, with an error if the loader drops it
+class LeaderDone
+{
+public:
+    LeaderDone(Context *c, SingleFlight::Callback finish, SingleFlight::Callback callback)
+        : m_c(c)
+        , m_finish(std::move(finish))
+        , m_callback(std::move(callback))
+        , m_async(c)
+    {
+    }
+
+    ~LeaderDone()
+    {
+        if (!m_called) {
+            done({{}, droppedError()});
+        }
+    }
+
+    void done(const SingleFlight::Result &result)
+    {
+        if (std::exchange(m_called, true)) {
+            return;
+        }
+
+        m_finish(result);
+        if (m_c) {
+            m_callback(result);
+        }
+    }
+
+private:
+    QPointer<Context> m_c;
+    SingleFlight::Callback m_finish;
+    SingleFlight::Callback m_callback;
+    ASync m_async;
+    bool m_called = false;
+};
+
+} // namespace
+
+void SingleFlight::run(Context *c, const QByteArray &key, Loader loader, Callback callback)
+{
+    Callback finish = join(c, key, callback);
+    if (!finish) {
+        return;
+    }
+
+    auto leader = std::make_shared<LeaderDone>(c, std::move(finish), std::move(callback));
+    loader([leader](const Result &result) { leader->done(result); });
+}
+
+AwaitedSingleFlight SingleFlight::coRun(Context *c, const QByteArray &key, Loader loader)
+{
+    AwaitedSingleFlight awaited;
+    run(c, key, std::move(loader), [state = awaited.m_state](const Result &result) {
+        state->result    = result;
+        state->hasResult = true;
+        if (state->handle) {
+            state->handle.resume();
+        }
+    });
+    return awaited;
+}
+
+SingleFlight::Callback SingleFlight::join(Context *c, const QByteArray &key, Callback callback)
+{
+    QMutexLocker locker(&flightsMutex);
+
+    auto it = flights.constFind(key);
+    if (it != flights.constEnd()) {
+        it.value()->waiters.push_back({c, c->app(), std::move(callback), ASync{c}});
+        return {};
+    }
+
+    auto flight = std::make_shared<Flight>();
+    flights.insert(key, flight);
+    locker.unlock();
+
+    auto leader = std::make_shared<Leader>(key, std::move(flight));
+    return [leader](const Result &result) { leader->finish(result); };
+}
+
+bool SingleFlight::isRunning(const QByteArray &key)
+{
+    QMutexLocker locker(&flightsMutex);
+    return flights.contains(key);
+}
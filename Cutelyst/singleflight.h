@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+#include <coroutine>
+#include <functional>
+#include <memory>
+
+#include <QtCore/QVariant>
+
+namespace Cutelyst {
+
+class Context;
+class AwaitedSingleFlight;
+
+/**
+ * \ingroup core
+ * \class SingleFlight singleflight.h Cutelyst/SingleFlight
+ * \brief Coalesces concurrent loads of the same key.
+ *
+ * When a popular cache entry expires, every request that needs it misses at the same
+ * time and runs the same expensive work. %SingleFlight runs the loader of a key only
+ * for the first Context asking for it, the Contexts on any worker thread that ask for
+ * the same key while it is running are detached and resumed on their own thread with
+ * the shared result, or the shared error, once the loader finishes.
+ *
+ * \code{.cpp}
+ * void Users::view(Context *c, const QString &id)
+ * {
+ *     SingleFlight::run(c, "user_" + id.toLatin1(),
+ *         [id](SingleFlight::Callback done) {
+ *             done({loadUser(id), {}});
+ *         },
+ *         [c](const SingleFlight::Result &result) {
+ *             if (result.hasError()) {
+ *                 c->appendError(result.error);
+ *                 return;
+ *             }
+ *             c->response()->setJsonBody(result.value.toByteArray());
+ *         });
+ * }
+ *
+ * CoroContext Users::edit(Context *c, const QString &id)
+ * {
+ *     const auto result = co_await SingleFlight::coRun(c, "user_" + id.toLatin1(), loader);
+ *     // ...
+ * }
+ * \endcode
+ *
+ * Loading is only coalesced while the loader runs, results are not kept, so it is
+ * usually combined with a cache that the loader fills, like Memcached::getOrLoad()
+ * does.
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT SingleFlight
+{
+public:
+    /**
+     * The outcome of a loader.
+     */
+    struct Result {
+        /** The loaded value. */
+        QVariant value;
+        /** Describes why the value could not be loaded, empty on success. */
+        QString error;
+
+        /**
+         * Returns \c true if the loader failed.
+         */
+        [[nodiscard]] bool hasError() const noexcept { return !error.isEmpty(); }
+    };
+
+    /**
+     * Receives the result of a load.
+     */
+    using Callback = std::function<void(const Result &result)>;
+
+    /**
+     * Loads a value and calls \a done with it, either before returning or later on the
+     * thread it was called from. If every copy of \a done is destroyed without being
+     * called the load fails.
+     */
+    using Loader = std::function<void(Callback done)>;
+
+    /**
+     * Calls \a loader for \a key if no load of \a key is running, keeping \a c detached
+     * until it finishes, otherwise waits for the running one. The \a callback is called
+     * with the result on the thread of \a c, unless \a c was destroyed.
+     */
+    static void run(Context *c, const QByteArray &key, Loader loader, Callback callback);
+
+    /**
+     * Like run(), but returns an awaitable for the result to be used in a CoroContext.
+     */
+    [[nodiscard]] static AwaitedSingleFlight
+        coRun(Context *c, const QByteArray &key, Loader loader);
+
+    /**
+     * Lower level building block of run() for loads that do not fit in a function.
+     *
+     * If no load of \a key is running starts one and returns the function that finishes
+     * it, which must be called with the result to release the Contexts waiting for it,
+     * \a callback is not used. Otherwise detaches \a c until the running load finishes,
+     * calls \a callback with its result on the thread of \a c and returns an empty function.
+     */
+    [[nodiscard]] static Callback join(Context *c, const QByteArray &key, Callback callback);
+
+    /**
+     * Returns \c true if a load of \a key is running.
+     */
+    [[nodiscard]] static bool isRunning(const QByteArray &key);
+};
+
+/**
+ * \ingroup core
+ * \class AwaitedSingleFlight singleflight.h Cutelyst/SingleFlight
+ * \brief Coroutine awaitable for SingleFlight::coRun().
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT AwaitedSingleFlight
+{
+public:
+    /**
+     * Constructs an awaitable that is ready with \a result, for values found without
+     * running a load.
+     */
+    explicit AwaitedSingleFlight(SingleFlight::Result result)
+        : m_state(std::make_shared<State>(std::move(result), std::coroutine_handle<>{}, true))
+    {
+    }
+
+    bool await_ready() const noexcept { return m_state->hasResult; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        m_state->handle = h;
+        return !await_ready();
+    }
+
+    SingleFlight::Result await_resume() { return m_state->result; }
+
+private:
+    friend class SingleFlight;
+
+    struct State {
+        SingleFlight::Result result;
+        std::coroutine_handle<> handle;
+        bool hasResult = false;
+    };
+
+    AwaitedSingleFlight()
+        : m_state(std::make_shared<State>())
+    {
+    }
+
+    // Shared with the callback, which might be called before the coroutine is suspended
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,397 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "common.h"
+#include "context.h"
+#include "request.h"
+#include "response.h"
+#include "staticfilecache_p.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QLocale>
+
+#ifdef Q_OS_UNIX
+#    include <cerrno>
+#    include <unistd.h>
+#endif
+
+Q_LOGGING_CATEGORY(CUTELYST_STATICFILECACHE, "cutelyst.staticfilecache", QtWarningMsg)
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+StaticFileDevice::StaticFileDevice(std::shared_ptr<const StaticFile> file)
+    : m_file(std::move(file))
+{
+    // Unbuffered so that pos() is where readData() must read from
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+qint64 StaticFileDevice::readData(char *data, qint64 maxlen)
+{
+#ifdef Q_OS_UNIX
+    // Reads at an explicit offset, the shared descriptor position is never used
+    qint64 ret;
+    do {
+        ret = ::pread(m_file->file.handle(), data, size_t(maxlen), off_t(pos()));
+    } while (ret == -1 && errno == EINTR);
+    return ret;
+#else
+    if (!m_fallback.isOpen()) {
+        m_fallback.setFileName(m_file->path);
+        if (!m_fallback.open(QFile::ReadOnly)) {
+            return -1;
+        }
+    }
+    if (!m_fallback.seek(pos())) {
+        return -1;
+    }
+    return m_fallback.read(data, maxlen);
+#endif
+}
+
+qint64 StaticFileDevice::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(len)
+    return -1;
+}
+
+std::shared_ptr<const StaticFile> StaticFileCachePrivate::lookup(const QString &path)
+{
+    QMutexLocker locker(&mutex);
+    auto it = index.constFind(path);
+    if (it == index.cend()) {
+        return {};
+    }
+
+    // Splicing keeps the iterators valid
+    lru.splice(lru.begin(), lru, *it);
+    return lru.front().file;
+}
+
+std::shared_ptr<const StaticFile> StaticFileCachePrivate::load(const QString &path)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return {};
+    }
+
+    auto file = std::make_shared<StaticFile>();
+    file->file.setFileName(path);
+    if (!file->file.open(QFile::ReadOnly)) {
+        qCWarning(CUTELYST_STATICFILECACHE)
+            << "Could not serve" << path << file->file.errorString();
+        return {};
+    }
+
+    file->path             = path;
+    file->size             = file->file.size();
+    file->lastModifiedTime = info.lastModified();
+    // ALL dates must be in GMT timezone and follow RFC 822
+    file->lastModified = QLocale::c()
+                             .toString(file->lastModifiedTime.toUTC(),
+                                       u"ddd, dd MMM yyyy hh:mm:ss 'GMT")
+                             .toLatin1();
+    file->etag = '"' + QByteArray::number(file->lastModifiedTime.toSecsSinceEpoch(), 16) + '-' +
+                 QByteArray::number(file->size, 16) + '"';
+
+    // use the extension to match to be faster
+    const QMimeType mimeType = db.mimeTypeForFile(path, QMimeDatabase::MatchExtension);
+    if (mimeType.isValid()) {
+        file->contentType = mimeType.name().toLatin1();
+    }
+
+    qint64 inMemorySize;
+    {
+        QMutexLocker locker(&mutex);
+        inMemorySize = maxFileSize;
+    }
+
+    if (file->size <= inMemorySize) {
+        file->data = file->file.readAll();
+        file->file.close();
+        file->size     = file->data.size();
+        file->inMemory = true;
+    }
+
+    return file;
+}
+
+void StaticFileCachePrivate::insert(const std::shared_ptr<const StaticFile> &file)
+{
+    QStringList evicted;
+    {
+        QMutexLocker locker(&mutex);
+        if (!watcher || (file->inMemory ? file->size > maxCost : maxOpenFiles < 1)) {
+            return;
+        }
+
+        auto it = index.find(file->path);
+        if (it != index.end()) {
+            erase(*it);
+        }
+
+        lru.push_front({file->path, file});
+        index.insert(file->path, lru.begin());
+        if (file->inMemory) {
+            cost += file->size;
+        } else {
+            ++openFiles;
+        }
+        evict(evicted);
+    }
+
+    qCDebug(CUTELYST_STATICFILECACHE) << "Cached" << file->path << file->size;
+
+    QMetaObject::invokeMethod(watcher,
+                              [this,
+                               evicted,
+                               path         = file->path,
+                               size         = file->size,
+                               lastModified = file->lastModifiedTime] {
+        unwatch(evicted);
+        watch(path, size, lastModified);
+    });
+}
+
+void StaticFileCachePrivate::remove(const QString &path)
+{
+    QMutexLocker locker(&mutex);
+    auto it = index.find(path);
+    if (it != index.end()) {
+        erase(*it);
+    }
+}
+
+void StaticFileCachePrivate::erase(std::list<Node>::iterator it)
+{
+    if (it->file->inMemory) {
+        cost -= it->file->size;
+    } else {
+        --openFiles;
+    }
+    index.remove(it->path);
+    // Responses still serving it keep the file alive
+    lru.erase(it);
+}
+
+void StaticFileCachePrivate::evict(QStringList &evicted)
+{
+    while (!lru.empty() && (cost > maxCost || openFiles > maxOpenFiles)) {
+        auto it = std::prev(lru.end());
+        evicted.append(it->path);
+        erase(it);
+    }
+}
+
+void StaticFileCachePrivate::watch(const QString &path, qint64 size, const QDateTime &lastModified)
+{
+    if (!watched.contains(path)) {
+        if (!watcher->addPath(path)) {
+            qCWarning(CUTELYST_STATICFILECACHE) << "Could not watch" << path;
+            remove(path);
+            return;
+        }
+        watched.insert(path);
+    }
+
+    // The file might have changed before it was watched
+    const QFileInfo info(path);
+    if (!info.exists() || info.size() != size || info.lastModified() != lastModified) {
+        remove(path);
+    }
+}
+
+void StaticFileCachePrivate::unwatch(const QStringList &paths)
+{
+    for (const QString &path : paths) {
+        bool cached;
+        {
+            QMutexLocker locker(&mutex);
+            cached = index.contains(path);
+        }
+
+        if (!cached && watched.remove(path)) {
+            watcher->removePath(path);
+        }
+    }
+}
+
+StaticFileCache::StaticFileCache()
+    : d_ptr(new StaticFileCachePrivate)
+{
+    Q_D(StaticFileCache);
+
+    auto app = QCoreApplication::instance();
+    if (!app) {
+        qCWarning(CUTELYST_STATICFILECACHE)
+            << "No QCoreApplication instance, static files will not be cached";
+        return;
+    }
+
+    // QFileSystemWatcher must be used from the thread it lives in, worker
+    // threads might go away before the process does
+    d->watcher = new QFileSystemWatcher;
+    d->watcher->moveToThread(app->thread());
+    QObject::connect(
+        d->watcher, &QFileSystemWatcher::fileChanged, d->watcher, [d](const QString &path) {
+        qCDebug(CUTELYST_STATICFILECACHE) << "Changed" << path;
+        d->watched.remove(path);
+        d->watcher->removePath(path);
+        d->remove(path);
+    });
+}
+
+StaticFileCache::~StaticFileCache()
+{
+    delete d_ptr->watcher;
+    delete d_ptr;
+}
+
+StaticFileCache *StaticFileCache::instance()
+{
+    static StaticFileCache cache;
+    return &cache;
+}
+
+bool StaticFileCache::serve(Context *c, const QString &path)
+{
+    Q_D(StaticFileCache);
+
+    std::shared_ptr<const StaticFile> file = d->lookup(path);
+    if (!file) {
+        file = d->load(path);
+        if (!file) {
+            return false;
+        }
+        d->insert(file);
+    }
+
+    Response *res    = c->response();
+    Headers &headers = res->headers();
+    headers.setHeader(Headers::KnownHeader::LastModified, file->lastModified);
+    headers.setHeader(Headers::KnownHeader::ETag, file->etag);
+    // Tell Firefox & friends its OK to cache, even over SSL
+    headers.setHeader(Headers::KnownHeader::CacheControl, "public"_ba);
+
+    // If-None-Match takes precedence over If-Modified-Since, the etag is stored with its quotes
+    const Headers &reqHeaders = c->request()->headers();
+    if (reqHeaders.header(Headers::KnownHeader::IfNoneMatch).isEmpty()
+            ? !reqHeaders.ifModifiedSince(file->lastModifiedTime)
+            : reqHeaders.ifNoneMatch(
+                  QLatin1StringView{file->etag}.sliced(1, file->etag.size() - 2))) {
+        res->setStatus(Response::NotModified);
+        return true;
+    }
+
+    if (!file->contentType.isEmpty()) {
+        headers.setHeader(Headers::KnownHeader::ContentType, file->contentType);
+    }
+    // Range requests are answered by EngineRequest
+    headers.setHeader("Accept-Ranges"_ba, "bytes"_ba);
+
+    if (file->inMemory) {
+        res->setBody(file->data);
+    } else {
+        // Response::setBody() will take the ownership
+        // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+        res->setBody(new StaticFileDevice(file));
+    }
+
+    return true;
+}
+
+void StaticFileCache::clear()
+{
+    Q_D(StaticFileCache);
+
+    QStringList paths;
+    {
+        QMutexLocker locker(&d->mutex);
+        paths = d->index.keys();
+        d->lru.clear();
+        d->index.clear();
+        d->cost      = 0;
+        d->openFiles = 0;
+    }
+
+    if (d->watcher) {
+        QMetaObject::invokeMethod(d->watcher, [d, paths] { d->unwatch(paths); });
+    }
+}
+
+qsizetype StaticFileCache::count() const
+{
+    Q_D(const StaticFileCache);
+    QMutexLocker locker(&d->mutex);
+    return d->index.size();
+}
+
+qint64 StaticFileCache::totalCost() const
+{
+    Q_D(const StaticFileCache);
+    QMutexLocker locker(&d->mutex);
+    return d->cost;
+}
+
+void StaticFileCache::setMaxCost(qint64 bytes)
+{
+    Q_D(StaticFileCache);
+    QStringList evicted;
+    {
+        QMutexLocker locker(&d->mutex);
+        d->maxCost = bytes;
+        d->evict(evicted);
+    }
+
+    if (d->watcher && !evicted.isEmpty()) {
+        QMetaObject::invokeMethod(d->watcher, [d, evicted] { d->unwatch(evicted); });
+    }
+}
+
+qint64 StaticFileCache::maxCost() const
+{
+    Q_D(const StaticFileCache);
+    QMutexLocker locker(&d->mutex);
+    return d->maxCost;
+}
+
+void StaticFileCache::setMaxFileSize(qint64 bytes)
+{
+    Q_D(StaticFileCache);
+    QMutexLocker locker(&d->mutex);
+    d->maxFileSize = bytes;
+}
+
+qint64 StaticFileCache::maxFileSize() const
+{
+    Q_D(const StaticFileCache);
+    QMutexLocker locker(&d->mutex);
+    return d->maxFileSize;
+}
+
+void StaticFileCache::setMaxOpenFiles(qsizetype count)
+{
+    Q_D(StaticFileCache);
+    QStringList evicted;
+    {
+        QMutexLocker locker(&d->mutex);
+        d->maxOpenFiles = count;
+        d->evict(evicted);
+    }
+
+    if (d->watcher && !evicted.isEmpty()) {
+        QMetaObject::invokeMethod(d->watcher, [d, evicted] { d->unwatch(evicted); });
+    }
+}
+
+qsizetype StaticFileCache::maxOpenFiles() const
+{
+    Q_D(const StaticFileCache);
+    QMutexLocker locker(&d->mutex);
+    return d->maxOpenFiles;
+}
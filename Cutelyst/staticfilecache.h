@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <Cutelyst/cutelyst_export.h>
+
+#include <QtCore/QString>
+
+namespace Cutelyst {
+
+class Context;
+class StaticFileCachePrivate;
+
+/**
+ * \ingroup core
+ * \class StaticFileCache staticfilecache.h Cutelyst/StaticFileCache
+ * \brief Keeps hot static files and their headers in memory.
+ *
+ * %StaticFileCache is a process wide least recently used cache of the static files
+ * served by StaticSimple and the server's static maps. Files up to maxFileSize()
+ * are kept in memory, bounded by maxCost() bytes in total, larger ones keep up to
+ * maxOpenFiles() file descriptors open that are shared by every request. The
+ * \c Content-Type, \c Last-Modified and \c ETag headers are computed once when a
+ * file enters the cache.
+ *
+ * Cached files are not checked on each request, instead they are watched with
+ * QFileSystemWatcher, which uses inotify on Linux, and removed from the cache once
+ * they change, so serving a cached file needs no file system calls besides reading
+ * the ones that are not in memory.
+ *
+ * Setting both maxCost() and maxOpenFiles() to zero disables the cache.
+ *
+ * \since Cutelyst 5.1.0
+ */
+class CUTELYST_EXPORT StaticFileCache
+{
+    Q_DECLARE_PRIVATE(StaticFileCache) // cppcheck-suppress unusedPrivateFunction
+    Q_DISABLE_COPY(StaticFileCache)
+public:
+    /**
+     * Returns the cache of the process, it lives until the process exits.
+     */
+    [[nodiscard]] static StaticFileCache *instance();
+
+    /**
+     * Serves the file at the absolute \a path on the response of \a c, replying with
+     * \c 304 Not Modified when the \c If-None-Match or \c If-Modified-Since request
+     * headers match it. Returns \c false if the file does not exist or can't be read.
+     */
+    bool serve(Context *c, const QString &path);
+
+    /**
+     * Removes all files from the cache.
+     */
+    void clear();
+
+    /**
+     * Returns the number of files in the cache.
+     */
+    [[nodiscard]] qsizetype count() const;
+
+    /**
+     * Returns the number of bytes of the files kept in memory.
+     */
+    [[nodiscard]] qint64 totalCost() const;
+
+    /**
+     * Sets the maximum number of bytes of the files kept in memory, the default
+     * is 32 MiB.
+     */
+    void setMaxCost(qint64 bytes);
+
+    /**
+     * Returns the maximum number of bytes of the files kept in memory.
+     */
+    [[nodiscard]] qint64 maxCost() const;
+
+    /**
+     * Sets the size up to which files are kept in memory, the default is 64 KiB.
+     */
+    void setMaxFileSize(qint64 bytes);
+
+    /**
+     * Returns the size up to which files are kept in memory.
+     */
+    [[nodiscard]] qint64 maxFileSize() const;
+
+    /**
+     * Sets the maximum number of larger files that are kept open, the default is 64.
+     */
+    void setMaxOpenFiles(qsizetype count);
+
+    /**
+     * Returns the maximum number of larger files that are kept open.
+     */
+    [[nodiscard]] qsizetype maxOpenFiles() const;
+
+protected:
+    StaticFileCachePrivate *d_ptr;
+
+private:
+    StaticFileCache();
+    ~StaticFileCache();
+};
+
+} // namespace Cutelyst
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "staticfilecache.h"
+
+#include <list>
+#include <memory>
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMimeDatabase>
+#include <QMutex>
+#include <QSet>
+
+class QFileSystemWatcher;
+
+namespace Cutelyst {
+
+// Immutable once created, shared by the cache and the responses serving it
+class StaticFile
+{
+public:
+    QString path;
+    QByteArray contentType;
+    // Formatted header values
+    QByteArray lastModified;
+    QByteArray etag;
+    QDateTime lastModifiedTime;
+    qint64 size = 0;
+    // The whole content of small files
+    QByteArray data;
+    bool inMemory = false;
+    // Larger files are read by every response from the same descriptor, with pread()
+    QFile file;
+};
+
+// Reads a shared StaticFile from its own position
+class StaticFileDevice final : public QIODevice
+{
+public:
+    explicit StaticFileDevice(std::shared_ptr<const StaticFile> file);
+
+    bool isSequential() const override { return false; }
+    qint64 size() const override { return m_file->size; }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 writeData(const char *data, qint64 len) override;
+
+private:
+    std::shared_ptr<const StaticFile> m_file;
+#ifndef Q_OS_UNIX
+    // Without pread() each response opens the file
+    QFile m_fallback;
+#endif
+};
+
+class StaticFileCachePrivate
+{
+public:
+    struct Node {
+        QString path;
+        std::shared_ptr<const StaticFile> file;
+    };
+
+    [[nodiscard]] std::shared_ptr<const StaticFile> lookup(const QString &path);
+    [[nodiscard]] std::shared_ptr<const StaticFile> load(const QString &path);
+    void insert(const std::shared_ptr<const StaticFile> &file);
+    void remove(const QString &path);
+    // Must be called with the mutex locked
+    void erase(std::list<Node>::iterator it);
+    void evict(QStringList &evicted);
+
+    // These run in the thread of the watcher
+    void watch(const QString &path, qint64 size, const QDateTime &lastModified);
+    void unwatch(const QStringList &paths);
+
+    QMimeDatabase db;
+    // Most recently used first
+    std::list<Node> lru;
+    QHash<QString, std::list<Node>::iterator> index;
+    mutable QMutex mutex;
+    qint64 cost            = 0;
+    qsizetype openFiles    = 0;
+    qint64 maxCost         = 32 * 1024 * 1024;
+    qint64 maxFileSize     = 64 * 1024;
+    qsizetype maxOpenFiles = 64;
+    // Lives in the main thread, without it nothing is cached
+    QFileSystemWatcher *watcher = nullptr;
+    // Only used in the thread of the watcher
+    QSet<QString> watched;
+};
+
+} // namespace Cutelyst
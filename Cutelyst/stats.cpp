@@ -48,6 +48,16 @@ void Stats::profileEnd(const QString &action)
     }
 }
 
+void Stats::profileDuration(const QString &action, std::chrono::steady_clock::duration duration)
+{
+    Q_D(Stats);
+    StatsAction stat;
+    stat.action = action;
+    stat.end    = std::chrono::steady_clock::now();
+    stat.begin  = stat.end.value() - duration;
+    d->actions.push_back(stat);
+}
+
 QByteArray Stats::report()
 {
     Q_D(const Stats);
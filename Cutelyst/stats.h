@@ -9,6 +9,8 @@
 
 #include <QObject>
 
+#include <chrono>
+
 namespace Cutelyst {
 
 class EngineRequest;
@@ -35,6 +37,13 @@ public:
      */
     virtual void profileEnd(const QString &action);
 
+    /**
+     * Adds an \a action that took \a duration and just ended.
+     *
+     * \since Cutelyst 5.1.0
+     */
+    void profileDuration(const QString &action, std::chrono::steady_clock::duration duration);
+
     /**
      * Returns a text report of collected timmings
      */
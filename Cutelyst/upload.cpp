@@ -10,9 +10,161 @@
 #include <QFileInfo>
 #include <QTemporaryFile>
 
+#ifdef Q_OS_UNIX
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#    include <cerrno>
+#    include <sys/sendfile.h>
+#endif
+
 using namespace Cutelyst;
 using namespace Qt::StringLiterals;
 
+namespace {
+
+// Block size used when the kernel can't copy between the files
+constexpr qsizetype copyBlockSize = 256 * 1024;
+
+#ifdef Q_OS_LINUX
+/**
+ * Copies \p len bytes at \p offset of \p in to the current position of \p out
+ * without passing through user space, copy_file_range() may even share the
+ * extents on file systems that support it.
+ */
+bool kernelCopy(int in, loff_t offset, int out, qint64 len)
+{
+    bool useSendfile = false;
+    while (len > 0) {
+        ssize_t copied;
+        if (useSendfile) {
+            off_t sendOffset = offset;
+            copied           = sendfile(out, in, &sendOffset, size_t(len));
+            offset           = sendOffset;
+        } else {
+            copied = copy_file_range(in, &offset, out, nullptr, size_t(len), 0);
+            if (copied == -1 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                                 errno == EOPNOTSUPP)) {
+                // Older kernels can't copy_file_range() across file systems
+                useSendfile = true;
+                continue;
+            }
+        }
+
+        if (copied == -1 && errno == EINTR) {
+            continue;
+        } else if (copied <= 0) {
+            return false;
+        }
+        len -= copied;
+    }
+    return true;
+}
+#endif
+
+#ifdef Q_OS_UNIX
+/**
+ * Returns the file mode creation mask of the process, it's read when needed as
+ * the server may change it after the library is loaded.
+ */
+mode_t processUmask()
+{
+#    ifdef Q_OS_LINUX
+    // Reading it from the kernel doesn't change it for the other threads
+    QFile status(u"/proc/self/status"_s);
+    if (status.open(QIODevice::ReadOnly)) {
+        while (!status.atEnd()) {
+            const QByteArray line = status.readLine();
+            if (line.startsWith("Umask:")) {
+                bool ok          = false;
+                const uint value = line.mid(6).trimmed().toUInt(&ok, 8);
+                if (ok) {
+                    return mode_t(value);
+                }
+                break;
+            }
+        }
+    }
+#    endif
+    const mode_t mask = ::umask(0);
+    ::umask(mask);
+    return mask;
+}
+#endif
+
+} // namespace
+
+bool UploadPrivate::linkTo(const QString &newName)
+{
+#ifdef Q_OS_UNIX
+    auto file = qobject_cast<QFile *>(device);
+    if (!file || startOffset != 0) {
+        return false;
+    }
+
+    file->flush();
+    const QString fileName = file->fileName();
+    if (fileName.isEmpty() || endOffset != file->size()) {
+        return false;
+    }
+
+    if (::link(QFile::encodeName(fileName).constData(), QFile::encodeName(newName).constData()) !=
+        0) {
+        return false;
+    }
+
+    // Temporary files are only readable by their owner, give the new name the
+    // same mode a newly created file would get
+    ::chmod(QFile::encodeName(newName).constData(), 0666 & ~processUmask());
+    return true;
+#else
+    Q_UNUSED(newName)
+    return false;
+#endif
+}
+
+bool UploadPrivate::copyTo(Upload *q, QFileDevice *out)
+{
+#ifdef Q_OS_LINUX
+    auto file = qobject_cast<QFileDevice *>(device);
+    if (file && file->handle() != -1 && out->handle() != -1) {
+        // Buffered writes must reach the file before the kernel reads it
+        file->flush();
+        out->flush();
+        const qint64 outPos = out->pos();
+        if (kernelCopy(file->handle(), startOffset, out->handle(), endOffset - startOffset)) {
+            return out->seek(outPos + endOffset - startOffset);
+        }
+
+        // Discard a partial copy and let read() and write() try
+        if (!out->resize(outPos) || !out->seek(outPos)) {
+            return false;
+        }
+    }
+#endif
+
+    const qint64 posOrig = pos;
+    q->seek(0);
+
+    bool ret = true;
+    QByteArray block(copyBlockSize, Qt::Uninitialized);
+    while (!q->atEnd()) {
+        const qint64 in = q->read(block.data(), block.size());
+        if (in <= 0) {
+            break;
+        }
+        if (in != out->write(block.constData(), in)) {
+            ret = false;
+            break;
+        }
+    }
+
+    q->seek(posOrig);
+    return ret;
+}
+
 QString Upload::filename() const
 {
     Q_D(const Upload);
@@ -35,6 +187,11 @@ bool Upload::save(const QString &newName)
 {
     Q_D(Upload);
 
+    // Uploads stored on their own file get a new name without copying
+    if (d->linkTo(newName)) {
+        return true;
+    }
+
     bool error           = false;
     QString fileTemplate = u"%1/qt_temp.XXXXXX"_s;
     QFile out(fileTemplate.arg(QFileInfo(newName).path()));
@@ -47,25 +204,10 @@ bool Upload::save(const QString &newName)
         setErrorString(u"Failed to open file for saving: " + out.errorString());
         qCWarning(CUTELYST_UPLOAD) << errorString();
     } else {
-        qint64 posOrig = d->pos;
-        seek(0);
-
-        char block[4096];
-        while (!atEnd()) {
-            qint64 in = read(block, sizeof(block));
-            if (in <= 0) {
-                break;
-            }
-            if (in != out.write(block, in)) {
-                setErrorString(u"Failure to write block"_s);
-                qCWarning(CUTELYST_UPLOAD) << errorString();
-                error = true;
-                break;
-            }
-        }
-
-        if (error) {
-            out.remove();
+        if (!d->copyTo(this, &out)) {
+            setErrorString(u"Failure to write block"_s);
+            qCWarning(CUTELYST_UPLOAD) << errorString();
+            error = true;
         }
 
         if (!error && !out.rename(newName)) {
@@ -76,7 +218,6 @@ bool Upload::save(const QString &newName)
         if (error) {
             out.remove();
         }
-        seek(posOrig);
     }
 
     return !error;
@@ -95,30 +236,12 @@ std::unique_ptr<QTemporaryFile> Upload::createTemporaryFile(const QString &templ
     }
 
     if (ret->open()) {
-        bool error     = false;
-        qint64 posOrig = d->pos;
-        seek(0);
-
-        char block[4096];
-        while (!atEnd()) {
-            qint64 in = read(block, sizeof(block));
-            if (in <= 0) {
-                break;
-            }
-
-            if (in != ret->write(block, in)) {
-                setErrorString(u"Failure to write block"_s);
-                qCWarning(CUTELYST_UPLOAD) << errorString();
-                error = true;
-                break;
-            }
-        }
-
-        if (error) {
+        if (!d->copyTo(this, ret.get())) {
+            setErrorString(u"Failure to write block"_s);
+            qCWarning(CUTELYST_UPLOAD) << errorString();
             ret->remove();
         }
         ret->seek(0);
-        seek(posOrig);
 
         return ret;
     } else {
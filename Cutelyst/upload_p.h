@@ -9,6 +9,8 @@
 
 #include <QMultiHash>
 
+class QFileDevice;
+
 namespace Cutelyst {
 
 class UploadPrivate
@@ -22,6 +24,18 @@ public:
     {
     }
 
+    /**
+     * Creates \p newName as a hard link to the device file, only possible when
+     * the upload is the whole file and it's on the same file system.
+     */
+    bool linkTo(const QString &newName);
+
+    /**
+     * Appends the contents of the upload to \p out, letting the kernel copy
+     * between files when possible.
+     */
+    bool copyTo(Upload *q, QFileDevice *out);
+
     Headers headers;
     QString name;
     QString filename;
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "action.h"
+#include "dispatcher.h"
+#include "uritemplate_p.h"
+
+#include <array>
+#include <string_view>
+
+using namespace Cutelyst;
+
+namespace {
+
+using CharTable = std::array<bool, 128>;
+
+constexpr CharTable allowedChars(std::string_view extra)
+{
+    CharTable ret{};
+    for (unsigned char c = 'a'; c <= 'z'; ++c) {
+        ret[c] = true;
+    }
+    for (unsigned char c = 'A'; c <= 'Z'; ++c) {
+        ret[c] = true;
+    }
+    for (unsigned char c = '0'; c <= '9'; ++c) {
+        ret[c] = true;
+    }
+    for (char c : std::string_view{"-._~"}) {
+        ret[static_cast<unsigned char>(c)] = true;
+    }
+    for (char c : extra) {
+        ret[static_cast<unsigned char>(c)] = true;
+    }
+    return ret;
+}
+
+// Same characters QUrl and QUrlQuery leave untouched on QUrl::FullyEncoded
+constexpr CharTable pathChars       = allowedChars("!$&'()*+,;=:@/");
+constexpr CharTable queryKeyChars   = allowedChars("!$'()*+,;:@/?");
+constexpr CharTable queryValueChars = allowedChars("!$'()*+,;=:@/?");
+
+// Unicode non characters never show up in action paths, so they mark the captures
+constexpr char16_t placeholderBase = 0xFDD0;
+constexpr int maxPlaceholders      = 32;
+
+inline void appendByte(QByteArray &out, unsigned char c, const CharTable &allowed)
+{
+    static constexpr char hex[] = "0123456789ABCDEF";
+    if (c < 0x80 && allowed[c]) {
+        out.append(char(c));
+    } else {
+        const char encoded[] = {'%', hex[c >> 4], hex[c & 0xF]};
+        out.append(encoded, 3);
+    }
+}
+
+} // namespace
+
+UriTemplate UriTemplate::compile(const Dispatcher *dispatcher, Action *action)
+{
+    UriTemplate ret;
+
+    // Chained actions are expanded to know how many captures the whole chain takes,
+    // without a context the ActionChain has no parent and is ours to delete
+    const Action *expanded = dispatcher->expandAction(nullptr, action);
+    const int captures     = expanded->numberOfCaptures();
+    if (expanded != action) {
+        delete expanded;
+    }
+
+    if (captures > maxPlaceholders) {
+        return ret;
+    }
+
+    QStringList placeholders;
+    placeholders.reserve(captures);
+    for (int i = 0; i < captures; ++i) {
+        placeholders.append(QString(QChar(char16_t(placeholderBase + i))));
+    }
+
+    const QString path = dispatcher->uriForAction(action, placeholders);
+    if (path.isEmpty()) {
+        return ret;
+    }
+
+    QByteArrayList literals;
+    QByteArray current;
+    int next       = 0;
+    qsizetype from = 0;
+    for (qsizetype i = 0; i < path.size(); ++i) {
+        const char16_t ch = path.at(i).unicode();
+        if (ch < placeholderBase || ch >= placeholderBase + maxPlaceholders) {
+            continue;
+        }
+
+        // A dispatch type that reorders or changes captures can't be templated
+        if (ch - placeholderBase != next++) {
+            return ret;
+        }
+        appendEncoded(current, QStringView{path}.sliced(from, i - from), Path);
+        literals.append(current);
+        current.clear();
+        from = i + 1;
+    }
+
+    if (next != captures) {
+        return ret;
+    }
+    appendEncoded(current, QStringView{path}.sliced(from), Path);
+    literals.append(current);
+
+    ret.m_literals = literals;
+    return ret;
+}
+
+bool UriTemplate::expand(QByteArray &out,
+                         const QStringList &captures,
+                         const QStringList &args,
+                         const ParamsMultiMap &queryValues) const
+{
+    const qsizetype needed = numberOfCaptures();
+
+    if (needed == 0) {
+        // Actions without captures take them as arguments
+        out.append(m_literals.constFirst());
+        const bool isRoot = m_literals.constFirst() == "/";
+        if (!captures.isEmpty()) {
+            appendArgs(out, captures, isRoot);
+            if (!args.isEmpty()) {
+                appendArgs(out, args, false);
+            }
+        } else if (!args.isEmpty()) {
+            appendArgs(out, args, isRoot);
+        }
+        appendQuery(out, queryValues);
+        return true;
+    }
+
+    if (captures.size() > needed || captures.size() + args.size() < needed) {
+        return false;
+    }
+
+    out.append(m_literals.constFirst());
+    const qsizetype fromArgs = needed - captures.size();
+    for (qsizetype i = 0; i < needed; ++i) {
+        const QString &capture =
+            i < captures.size() ? captures.at(i) : args.at(i - captures.size());
+        appendEncoded(out, capture, Path);
+        out.append(m_literals.at(i + 1));
+    }
+
+    if (args.size() > fromArgs) {
+        appendArgs(out, args.mid(fromArgs), false);
+    }
+    appendQuery(out, queryValues);
+    return true;
+}
+
+void UriTemplate::appendArgs(QByteArray &out, const QStringList &args, bool isRoot)
+{
+    bool first = true;
+    for (const QString &arg : args) {
+        if (!first || !isRoot) {
+            out.append('/');
+        }
+        first = false;
+        appendEncoded(out, arg, Path);
+    }
+}
+
+void UriTemplate::appendQuery(QByteArray &out, const ParamsMultiMap &queryValues)
+{
+    if (queryValues.isEmpty()) {
+        return;
+    }
+
+    out.append('?');
+
+    // Same order Context::uriFor() gives to QUrlQuery
+    bool first = true;
+    auto it    = queryValues.constEnd();
+    while (it != queryValues.constBegin()) {
+        --it;
+        if (!first) {
+            out.append('&');
+        }
+        first = false;
+        appendEncoded(out, it.key(), QueryKey);
+        out.append('=');
+        appendEncoded(out, it.value(), QueryValue);
+    }
+}
+
+void UriTemplate::appendEncoded(QByteArray &out, QStringView value, Encoding encoding)
+{
+    const CharTable &allowed = encoding == Path       ? pathChars
+                               : encoding == QueryKey ? queryKeyChars
+                                                      : queryValueChars;
+
+    for (qsizetype i = 0; i < value.size(); ++i) {
+        const char16_t ch = value.at(i).unicode();
+        if (ch < 0x80) {
+            appendByte(out, static_cast<unsigned char>(ch), allowed);
+        } else {
+            // Leave the ASCII fast path and encode the remaining as UTF-8
+            const QByteArray utf8 = value.sliced(i).toUtf8();
+            for (const char c : utf8) {
+                appendByte(out, static_cast<unsigned char>(c), allowed);
+            }
+            return;
+        }
+    }
+}
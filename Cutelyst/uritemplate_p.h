@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2026 Daniel Nicoletti <dantti12@gmail.com>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include "paramsmultimap.h"
+
+#include <QByteArrayList>
+#include <QStringList>
+
+namespace Cutelyst {
+
+class Action;
+class Dispatcher;
+
+/**
+ * Precompiled URI of an Action.
+ *
+ * It holds the already percent encoded literal parts of the public path of an
+ * action, captures are placed between them, so building an URI only needs to
+ * encode the captures, arguments and query values the user passed.
+ */
+class UriTemplate
+{
+public:
+    enum Encoding {
+        Path,
+        QueryKey,
+        QueryValue,
+    };
+
+    /**
+     * Compiles the template of \p action, an invalid template is returned if the
+     * dispatcher has no URI for it.
+     */
+    static UriTemplate compile(const Dispatcher *dispatcher, Action *action);
+
+    [[nodiscard]] bool isValid() const noexcept { return !m_literals.isEmpty(); }
+
+    [[nodiscard]] qsizetype numberOfCaptures() const noexcept { return m_literals.size() - 1; }
+
+    /**
+     * Appends the encoded path and query to \p out, following the same rules
+     * of Context::uriFor() to move \p args into missing \p captures.
+     *
+     * Returns \c false if the captures don't match this template.
+     */
+    bool expand(QByteArray &out,
+                const QStringList &captures,
+                const QStringList &args,
+                const ParamsMultiMap &queryValues) const;
+
+    /**
+     * Appends \p args to a path already written to \p out, \p isRoot tells if
+     * the path was just "/".
+     */
+    static void appendArgs(QByteArray &out, const QStringList &args, bool isRoot);
+
+    /**
+     * Appends the query string, including the leading '?' if \p queryValues is not empty.
+     */
+    static void appendQuery(QByteArray &out, const ParamsMultiMap &queryValues);
+
+    /**
+     * Appends \p value percent encoded as QUrl::FullyEncoded would do for the
+     * URI component \p encoding.
+     */
+    static void appendEncoded(QByteArray &out, QStringView value, Encoding encoding);
+
+private:
+    QByteArrayList m_literals;
+};
+
+} // namespace Cutelyst
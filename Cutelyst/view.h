@@ -55,6 +55,8 @@ public:
      * When @p minSize is not negative and view render output is larger than @p minSize,
      * if ACCEPT_ENCODING contains 'deflate', then deflate view render output.
      * To disable Deflate, set @p minSize to a negative integer.
+     * It's not used when the response has a ResponseFilter, like the one installed by
+     * the Compression plugin which negotiates the best encoding.
      */
     void setMinimalSizeToDeflate(qint32 minSize = -1);
 
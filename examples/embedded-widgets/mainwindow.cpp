@@ -118,7 +118,7 @@ void MainWindow::indexCalled(Cutelyst::Context *c)
     }
 
     m_serverReceivedHeaders->clear();
-    const auto headersData = c->request()->headers().data();
+    const auto &headersData = c->request()->headers().data();
     auto hIt               = headersData.begin();
     while (hIt != headersData.end()) {
         auto keyItem   = new QStandardItem(QString::fromLatin1(hIt->key));
@@ -241,6 +241,32 @@ public:
             c->response()->setBody(uri.toString());
         }
     }
+
+    C_ATTR(uriForString, :Global :AutoArgs)
+    void uriForString(Context *c, const QStringList &args)
+    {
+        auto query   = c->request()->queryParameters();
+        QString path = query.take(QStringLiteral("path"));
+        c->response()->setBody(c->uriForString(path, args, query));
+    }
+
+    C_ATTR(appendUriFor, :Global :AutoArgs)
+    void appendUriFor(Context *c, const QStringList &args)
+    {
+        auto query = c->request()->queryParameters();
+
+        QStringList captures =
+            query.take(QStringLiteral("captures")).split(u'/', Qt::SkipEmptyParts);
+        Action *action = c->dispatcher()->getActionByPath(query.take(QStringLiteral("action")));
+        if (!action || !c->appendUriFor(c->response()->body(), action, captures, args, query)) {
+            c->response()->setBody(QByteArray("appendUriFor not found"));
+        } else {
+            // Both must give the same URI
+            c->response()->body().append(';');
+            c->response()->body().append(
+                c->uriForString(action, captures, args, query).toLatin1());
+        }
+    }
 };
 
 class TestApplication : public Application
@@ -0,0 +1,376 @@
+#ifndef TESTCACHE_H
+#define TESTCACHE_H
+
+#include "coverageobject.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Plugins/Cache/Cache>
+#include <thread>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#    include <Cutelyst/Controller>
+#    include <Cutelyst/Plugins/Cache/SharedMemoryCache>
+#    include <Cutelyst/Plugins/Session/Session>
+#    include <Cutelyst/Plugins/Session/sessionstoresharedmemory.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+#include <QTest>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+using namespace std::chrono_literals;
+
+class TestCache : public CoverageObject
+{
+    Q_OBJECT
+public:
+    explicit TestCache(QObject *parent = nullptr)
+        : CoverageObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+
+    void testSetGet();
+    void testContainerCost();
+    void testExpiration();
+    void testLru();
+    void testTinyLfu();
+    void testThreads();
+#ifdef Q_OS_UNIX
+    void testSharedSetGet();
+    void testSharedIncrement();
+    void testSharedExpiration();
+    void testSharedEviction();
+    void testSharedFork();
+    void testSharedSession();
+#endif
+
+    void cleanupTestCase();
+
+private:
+    TestEngine *m_engine = nullptr;
+
+    TestEngine *getEngine();
+};
+
+#ifdef Q_OS_UNIX
+class SessionTest : public Controller
+{
+    Q_OBJECT
+public:
+    explicit SessionTest(QObject *parent)
+        : Controller(parent)
+    {
+    }
+
+    C_ATTR(store, :Local :AutoArgs)
+    void store(Context *c)
+    {
+        Session::setValue(c, u"value"_s, c->req()->queryParam(u"value"_s));
+        c->res()->setBody("stored"_ba);
+    }
+
+    C_ATTR(read, :Local :AutoArgs)
+    void read(Context *c)
+    {
+        c->res()->setBody(Session::value(c, u"value"_s).toString().toUtf8());
+    }
+
+    C_ATTR(remove, :Local :AutoArgs)
+    void remove(Context *c)
+    {
+        Session::deleteValue(c, u"value"_s);
+        c->res()->setBody("removed"_ba);
+    }
+};
+#endif
+
+void TestCache::initTestCase()
+{
+    m_engine = getEngine();
+    QVERIFY(m_engine);
+    QCOMPARE(Cache::shardStats().size(), qsizetype(4));
+}
+
+TestEngine *TestCache::getEngine()
+{
+    auto app    = new TestApplication;
+    auto engine = new TestEngine(app, {});
+    new Cache(app, {{u"shards"_s, 4}, {u"max_cost"_s, 4 * 1000}});
+#ifdef Q_OS_UNIX
+    new SharedMemoryCache(app,
+                          {{u"size"_s, 256 * 1024}, {u"shards"_s, 2}, {u"slot_size"_s, 128}});
+
+    auto session = new Session(app);
+    session->setStorage(std::make_unique<SessionStoreSharedMemory>(session));
+    new SessionTest(app);
+#endif
+    if (!engine->init()) {
+        return nullptr;
+    }
+    return engine;
+}
+
+void TestCache::init()
+{
+    Cache::clear();
+    Cache::resetStats();
+    Cache::setMaxCost(4 * 1000);
+    Cache::setEviction(Cache::Eviction::LRU);
+#ifdef Q_OS_UNIX
+    SharedMemoryCache::clear();
+#endif
+}
+
+void TestCache::cleanupTestCase()
+{
+    delete m_engine;
+    m_engine = nullptr;
+}
+
+void TestCache::testSetGet()
+{
+    QVERIFY(Cache::get("key"_ba).isNull());
+    QVERIFY(Cache::set("key"_ba, u"value"_s));
+    QCOMPARE(Cache::get("key"_ba), QVariant(u"value"_s));
+    QVERIFY(!Cache::add("key"_ba, 1, 0s));
+    QCOMPARE(Cache::get("key"_ba), QVariant(u"value"_s));
+    QVERIFY(Cache::set("key"_ba, 2, 0s));
+    QCOMPARE(Cache::get("key"_ba), QVariant(2));
+    QVERIFY(Cache::remove("key"_ba));
+    QVERIFY(!Cache::remove("key"_ba));
+    QVERIFY(Cache::add("key"_ba, 3, 0s));
+
+    // Bigger than a shard
+    QVERIFY(!Cache::set("big"_ba, QByteArray(1000, 'x')));
+
+    const Cache::Stats stats = Cache::stats();
+    QCOMPARE(stats.hits, quint64(3));
+    QCOMPARE(stats.misses, quint64(1));
+    QCOMPARE(stats.rejections, quint64(1));
+    QCOMPARE(stats.count, qint64(1));
+    QVERIFY(stats.cost > 0);
+}
+
+void TestCache::testContainerCost()
+{
+    // Containers are charged for their contents, these don't fit in a shard
+    QVERIFY(!Cache::set("map"_ba, QVariantMap{{u"a"_s, QByteArray(1000, 'x')}}));
+    QVERIFY(!Cache::set("hash"_ba, QVariantHash{{u"a"_s, QString(500, u'x')}}));
+    QVERIFY(!Cache::set("list"_ba, QVariantList{QVariantList{QByteArray(1000, 'x')}}));
+    QVERIFY(!Cache::set("strings"_ba, QStringList{QString(500, u'x')}));
+    QCOMPARE(Cache::stats().rejections, quint64(4));
+
+    QVERIFY(Cache::set("small"_ba, QVariantMap{{u"a"_s, 1}}));
+    QCOMPARE(Cache::get("small"_ba), QVariant(QVariantMap{{u"a"_s, 1}}));
+}
+
+void TestCache::testExpiration()
+{
+    QVERIFY(Cache::set("short"_ba, 1, 20ms));
+    QVERIFY(Cache::set("long"_ba, 2, 1h));
+    QCOMPARE(Cache::get("short"_ba), QVariant(1));
+
+    std::this_thread::sleep_for(50ms);
+    QVERIFY(Cache::get("short"_ba).isNull());
+    QCOMPARE(Cache::get("long"_ba), QVariant(2));
+
+    // Expired entries can be added again
+    QVERIFY(Cache::set("short"_ba, 1, 20ms));
+    std::this_thread::sleep_for(50ms);
+    QVERIFY(Cache::add("short"_ba, 3, 0s));
+    QCOMPARE(Cache::get("short"_ba), QVariant(3));
+
+    QCOMPARE(Cache::stats().expirations, quint64(2));
+}
+
+void TestCache::testLru()
+{
+    // Each shard keeps about three of these entries
+    QVERIFY(Cache::set("hot"_ba, 0, 0s, 200));
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(Cache::set("key" + QByteArray::number(i), i, 0s, 200));
+        QCOMPARE(Cache::get("hot"_ba), QVariant(0));
+    }
+
+    const Cache::Stats stats = Cache::stats();
+    QVERIFY(stats.evictions > 0);
+    QVERIFY(stats.cost <= Cache::maxCost());
+    QCOMPARE(stats.rejections, quint64(0));
+    QCOMPARE(Cache::get("key99"_ba), QVariant(99));
+    QVERIFY(Cache::get("key0"_ba).isNull());
+}
+
+void TestCache::testTinyLfu()
+{
+    Cache::setEviction(Cache::Eviction::TinyLFU);
+    QCOMPARE(Cache::eviction(), Cache::Eviction::TinyLFU);
+
+    QVERIFY(Cache::set("hot"_ba, 0, 0s, 200));
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(Cache::get("hot"_ba), QVariant(0));
+    }
+
+    // A scan of keys used only once does not evict the popular one
+    for (int i = 0; i < 100; ++i) {
+        Cache::set("scan" + QByteArray::number(i), i, 0s, 200);
+    }
+    QCOMPARE(Cache::get("hot"_ba), QVariant(0));
+
+    const Cache::Stats stats = Cache::stats();
+    QVERIFY(stats.rejections > 0);
+    QVERIFY(stats.cost <= Cache::maxCost());
+}
+
+void TestCache::testThreads()
+{
+    Cache::setMaxCost(64 * 1024 * 1024);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 1000; ++i) {
+                const QByteArray key = QByteArray::number(t) + '_' + QByteArray::number(i);
+                Cache::set(key, i);
+                if (Cache::get(key) != QVariant(i) || !Cache::get("shared"_ba).isNull()) {
+                    return;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const Cache::Stats stats = Cache::stats();
+    QCOMPARE(stats.count, qint64(8000));
+    QCOMPARE(stats.hits, quint64(8000));
+    QCOMPARE(stats.misses, quint64(8000));
+}
+
+#ifdef Q_OS_UNIX
+void TestCache::testSharedSetGet()
+{
+    QVERIFY(SharedMemoryCache::isAvailable());
+    QCOMPARE(SharedMemoryCache::shardStats().size(), qsizetype(2));
+
+    QVERIFY(SharedMemoryCache::get("key"_ba).isNull());
+    QVERIFY(SharedMemoryCache::set("key"_ba, "value"_ba));
+    QCOMPARE(SharedMemoryCache::get("key"_ba), "value"_ba);
+    QVERIFY(!SharedMemoryCache::add("key"_ba, "other"_ba));
+    QVERIFY(SharedMemoryCache::set("key"_ba, "other"_ba));
+    QCOMPARE(SharedMemoryCache::get("key"_ba), "other"_ba);
+    QVERIFY(SharedMemoryCache::remove("key"_ba));
+    QVERIFY(!SharedMemoryCache::remove("key"_ba));
+    QVERIFY(SharedMemoryCache::add("key"_ba, ""_ba));
+    QVERIFY(!SharedMemoryCache::get("key"_ba).isNull());
+
+    // Values bigger than a slot use a chain of them
+    QByteArray big(5000, Qt::Uninitialized);
+    for (int i = 0; i < big.size(); ++i) {
+        big[i] = char(i % 251);
+    }
+    QVERIFY(SharedMemoryCache::set("big"_ba, big));
+    QCOMPARE(SharedMemoryCache::get("big"_ba), big);
+
+    // Bigger than half a shard
+    QVERIFY(!SharedMemoryCache::set("huge"_ba, QByteArray(100 * 1024, 'x')));
+
+    const Cache::Stats stats = SharedMemoryCache::stats();
+    QCOMPARE(stats.count, qint64(2));
+    QVERIFY(stats.rejections > 0);
+    QVERIFY(stats.cost > big.size());
+}
+
+void TestCache::testSharedIncrement()
+{
+    QCOMPARE(SharedMemoryCache::increment("counter"_ba, 1), std::optional<qint64>(1));
+    QCOMPARE(SharedMemoryCache::increment("counter"_ba, 5), std::optional<qint64>(6));
+    QCOMPARE(SharedMemoryCache::increment("counter"_ba, -10), std::optional<qint64>(-4));
+
+    QVERIFY(SharedMemoryCache::set("text"_ba, "text"_ba));
+    QVERIFY(!SharedMemoryCache::increment("text"_ba, 1).has_value());
+}
+
+void TestCache::testSharedExpiration()
+{
+    QVERIFY(SharedMemoryCache::set("short"_ba, "1"_ba, 20ms));
+    QVERIFY(SharedMemoryCache::set("long"_ba, "2"_ba, 1h));
+    QCOMPARE(SharedMemoryCache::increment("window"_ba, 1, 20ms), std::optional<qint64>(1));
+    QCOMPARE(SharedMemoryCache::get("short"_ba), "1"_ba);
+
+    std::this_thread::sleep_for(50ms);
+    QVERIFY(SharedMemoryCache::get("short"_ba).isNull());
+    QCOMPARE(SharedMemoryCache::get("long"_ba), "2"_ba);
+    QVERIFY(SharedMemoryCache::add("short"_ba, "3"_ba));
+
+    // An expired counter starts a new window
+    QCOMPARE(SharedMemoryCache::increment("window"_ba, 1, 20ms), std::optional<qint64>(1));
+}
+
+void TestCache::testSharedEviction()
+{
+    QVERIFY(SharedMemoryCache::set("hot"_ba, "0"_ba));
+    for (int i = 0; i < 2000; ++i) {
+        QVERIFY(SharedMemoryCache::set("key" + QByteArray::number(i), QByteArray(300, 'x')));
+        QCOMPARE(SharedMemoryCache::get("hot"_ba), "0"_ba);
+    }
+
+    const Cache::Stats stats = SharedMemoryCache::stats();
+    QVERIFY(stats.evictions > 0);
+    QCOMPARE(SharedMemoryCache::get("key1999"_ba), QByteArray(300, 'x'));
+    QVERIFY(SharedMemoryCache::get("key0"_ba).isNull());
+}
+
+void TestCache::testSharedFork()
+{
+    QVERIFY(SharedMemoryCache::set("parent"_ba, "1"_ba));
+
+    const pid_t pid = fork();
+    QVERIFY(pid >= 0);
+    if (pid == 0) {
+        const bool ok = SharedMemoryCache::get("parent"_ba) == "1"_ba &&
+                        SharedMemoryCache::set("child"_ba, "2"_ba) &&
+                        SharedMemoryCache::increment("counter"_ba, 1).has_value();
+        _exit(ok ? 0 : 1);
+    }
+
+    int status = 0;
+    QCOMPARE(waitpid(pid, &status, 0), pid);
+    QVERIFY(WIFEXITED(status));
+    QCOMPARE(WEXITSTATUS(status), 0);
+    QCOMPARE(SharedMemoryCache::get("child"_ba), "2"_ba);
+    QCOMPARE(SharedMemoryCache::increment("counter"_ba, 1), std::optional<qint64>(2));
+}
+
+void TestCache::testSharedSession()
+{
+    const auto stored =
+        m_engine->createRequest("GET", u"/session/test/store"_s, "value=foo"_ba, {}, nullptr);
+    QCOMPARE(stored.body, "stored"_ba);
+    QVERIFY(stored.headers.contains("Set-Cookie"));
+    QCOMPARE(SharedMemoryCache::stats().count, qint64(1));
+
+    Headers headers;
+    headers.setHeader("Cookie"_ba, stored.headers.header("Set-Cookie"));
+    const QString read = u"/session/test/read"_s;
+    QCOMPARE(m_engine->createRequest("GET", read, {}, headers, nullptr).body, "foo"_ba);
+    QVERIFY(m_engine->createRequest("GET", read, {}, {}, nullptr).body.isEmpty());
+
+    const QString remove = u"/session/test/remove"_s;
+    QCOMPARE(m_engine->createRequest("GET", remove, {}, headers, nullptr).body, "removed"_ba);
+    QVERIFY(m_engine->createRequest("GET", read, {}, headers, nullptr).body.isEmpty());
+}
+#endif
+
+QTEST_MAIN(TestCache)
+
+#include "testcache.moc"
+
+#endif // TESTCACHE_H
@@ -0,0 +1,230 @@
+#ifndef TESTCOMPRESSION_H
+#define TESTCOMPRESSION_H
+
+#include "coverageobject.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Controller>
+#include <Cutelyst/Plugins/Compression/Compression>
+
+#include <zlib.h>
+
+#include <QTest>
+#include <QtEndian>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+class TestCompression : public CoverageObject
+{
+    Q_OBJECT
+public:
+    explicit TestCompression(QObject *parent = nullptr)
+        : CoverageObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testNegotiate_data();
+    void testNegotiate();
+
+    void testCompress_data();
+    void testCompress();
+
+    void cleanupTestCase();
+
+private:
+    TestEngine *m_engine = nullptr;
+
+    TestEngine *getEngine();
+};
+
+static const QByteArray text =
+    QByteArray("Nisi et et fugiat debitis impedit. Sint officiis optio quas beatae facilis "
+               "laudantium accusantium voluptatem. Fugit et asperiores quia accusantium est. "
+               "Rerum sunt est temporibus. Sit esse dolore quaerat vero et. Dicta quia "
+               "assumenda ad beatae ut.\n")
+        .repeated(8);
+
+// Decodes a whole gzip member, returns a null QByteArray on errors
+static QByteArray gunzip(const QByteArray &data)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        return {};
+    }
+
+    QByteArray ret;
+    char buffer[4096];
+    stream.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = uInt(data.size());
+    int status;
+    do {
+        stream.next_out  = reinterpret_cast<Bytef *>(buffer);
+        stream.avail_out = sizeof(buffer);
+        status           = inflate(&stream, Z_NO_FLUSH);
+        ret.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (status == Z_OK);
+    inflateEnd(&stream);
+
+    return status == Z_STREAM_END && stream.avail_in == 0 ? ret : QByteArray();
+}
+
+class CompressionTest : public Controller
+{
+    Q_OBJECT
+public:
+    explicit CompressionTest(QObject *parent)
+        : Controller(parent)
+    {
+    }
+
+    C_ATTR(body, :Local :AutoArgs)
+    void body(Context *c)
+    {
+        c->res()->setContentType("text/html; charset=utf-8"_ba);
+        c->res()->setBody(text);
+    }
+
+    C_ATTR(stream, :Local :AutoArgs)
+    void stream(Context *c)
+    {
+        c->res()->setContentType("text/plain"_ba);
+        for (qsizetype i = 0; i < text.size(); i += 100) {
+            c->res()->write(text.mid(i, 100));
+        }
+    }
+
+    C_ATTR(small, :Local :AutoArgs)
+    void small(Context *c)
+    {
+        c->res()->setContentType("text/html"_ba);
+        c->res()->setBody("small"_ba);
+    }
+
+    C_ATTR(binary, :Local :AutoArgs)
+    void binary(Context *c)
+    {
+        c->res()->setContentType("application/octet-stream"_ba);
+        c->res()->setBody(text);
+    }
+
+    C_ATTR(encoded, :Local :AutoArgs)
+    void encoded(Context *c)
+    {
+        c->res()->setContentType("text/html"_ba);
+        c->res()->headers().setContentEncoding("identity"_ba);
+        c->res()->setBody(text);
+    }
+};
+
+void TestCompression::initTestCase()
+{
+    m_engine = getEngine();
+    QVERIFY(m_engine);
+}
+
+TestEngine *TestCompression::getEngine()
+{
+    auto app    = new TestApplication;
+    auto engine = new TestEngine(app, {});
+    new Compression(app, {{u"encodings"_s, u"gzip,deflate"_s}});
+    new CompressionTest(app);
+    if (!engine->init()) {
+        return nullptr;
+    }
+    return engine;
+}
+
+void TestCompression::cleanupTestCase()
+{
+    delete m_engine;
+    m_engine = nullptr;
+}
+
+void TestCompression::testNegotiate_data()
+{
+    QTest::addColumn<QByteArray>("acceptEncoding");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("empty") << QByteArray() << QByteArray();
+    QTest::newRow("server-order") << "gzip, deflate, br"_ba << "br"_ba;
+    QTest::newRow("q-values") << "br;q=0.5, gzip;q=0.8, deflate"_ba << "deflate"_ba;
+    QTest::newRow("q-zero") << "gzip;q=0"_ba << QByteArray();
+    QTest::newRow("identity") << "identity"_ba << QByteArray();
+    QTest::newRow("any") << "*"_ba << "br"_ba;
+    QTest::newRow("any-excluded") << "br;q=0, *"_ba << "zstd"_ba;
+    QTest::newRow("any-lower") << "*;q=0.1, gzip"_ba << "gzip"_ba;
+    QTest::newRow("x-gzip") << "x-gzip"_ba << "gzip"_ba;
+    QTest::newRow("case") << "GZIP; Q=0.8 , Deflate ;q=0.8"_ba << "gzip"_ba;
+    QTest::newRow("invalid-q") << "zstd;q=abc, deflate;q=0.001"_ba << "deflate"_ba;
+}
+
+void TestCompression::testNegotiate()
+{
+    QFETCH(QByteArray, acceptEncoding);
+    QFETCH(QByteArray, expected);
+
+    const QByteArrayList encodings{"br"_ba, "zstd"_ba, "gzip"_ba, "deflate"_ba};
+    QCOMPARE(Compression::negotiate(acceptEncoding, encodings), expected);
+}
+
+void TestCompression::testCompress_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QByteArray>("acceptEncoding");
+    QTest::addColumn<QByteArray>("contentEncoding");
+
+    QTest::newRow("body-deflate") << u"/compression/test/body"_s << "deflate"_ba << "deflate"_ba;
+    QTest::newRow("body-gzip") << u"/compression/test/body"_s << "gzip, deflate"_ba << "gzip"_ba;
+    QTest::newRow("body-identity") << u"/compression/test/body"_s << QByteArray() << QByteArray();
+    QTest::newRow("stream-deflate")
+        << u"/compression/test/stream"_s << "br, deflate"_ba << "deflate"_ba;
+    QTest::newRow("stream-gzip") << u"/compression/test/stream"_s << "gzip"_ba << "gzip"_ba;
+    QTest::newRow("small") << u"/compression/test/small"_s << "deflate"_ba << QByteArray();
+    QTest::newRow("binary") << u"/compression/test/binary"_s << "deflate"_ba << QByteArray();
+    QTest::newRow("encoded") << u"/compression/test/encoded"_s << "deflate"_ba << "identity"_ba;
+}
+
+void TestCompression::testCompress()
+{
+    QFETCH(QString, path);
+    QFETCH(QByteArray, acceptEncoding);
+    QFETCH(QByteArray, contentEncoding);
+
+    Headers headers;
+    if (!acceptEncoding.isEmpty()) {
+        headers.setHeader("Accept-Encoding"_ba, acceptEncoding);
+    }
+
+    const auto result = m_engine->createRequest("GET", path, {}, headers, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.headers.contentEncoding(), contentEncoding);
+
+    if (contentEncoding == "deflate") {
+        QCOMPARE(result.headers.header("Vary"), "Accept-Encoding"_ba);
+
+        // qUncompress() expects the uncompressed size before the zlib stream
+        QByteArray data(4, Qt::Uninitialized);
+        qToBigEndian(quint32(text.size()), data.data());
+        data.append(result.body);
+        QCOMPARE(qUncompress(data), text);
+    } else if (contentEncoding == "gzip") {
+        QCOMPARE(result.headers.header("Vary"), "Accept-Encoding"_ba);
+        QVERIFY(result.body.startsWith("\x1f\x8b"));
+        QVERIFY(result.body.size() < text.size());
+        QCOMPARE(gunzip(result.body), text);
+    } else if (path.endsWith(u"/small")) {
+        QCOMPARE(result.body, "small"_ba);
+    } else {
+        QCOMPARE(result.body, text);
+    }
+}
+
+QTEST_MAIN(TestCompression)
+
+#include "testcompression.moc"
+
+#endif // TESTCOMPRESSION_H
@@ -5,10 +5,12 @@
 #include "headers.h"
 
 #include <Cutelyst/application.h>
+#include <Cutelyst/contextslot.h>
 #include <Cutelyst/controller.h>
 #include <Cutelyst/headers.h>
 
 #include <QObject>
+#include <QPointer>
 #include <QTest>
 #include <QUrlQuery>
 
@@ -39,6 +41,11 @@ private:
     void doTest();
 };
 
+namespace {
+ContextSlot<int> counterSlot;
+ContextSlot<QString> stringSlot;
+} // namespace
+
 class ContextGetActionsTest : public Controller
 {
     Q_OBJECT
@@ -51,6 +58,27 @@ public:
 
     C_ATTR(actionName, :Local :AutoArgs)
     void actionName(Context *c) { c->response()->setBody(c->actionName()); }
+
+    C_ATTR(contextSlot, :Local :AutoArgs)
+    void contextSlot(Context *c)
+    {
+        QString ret = counterSlot.has(c) ? u"leaked"_s : u"empty"_s;
+        counterSlot.ref(c) += 2;
+        counterSlot.ref(c) += 3;
+        stringSlot.set(c, c->request()->queryParam(u"value"_s));
+        ret += u';' + QString::number(counterSlot.value(c)) + u';' + stringSlot.value(c);
+
+        stringSlot.reset(c);
+        ret += u';' + stringSlot.value(c, u"reset"_s);
+        c->response()->setBody(ret);
+    }
+
+    C_ATTR(hooks, :Local :AutoArgs)
+    void hooks(Context *c)
+    {
+        c->response()->setBody("action"_ba);
+        c->addAfterDispatchHook([](Context *c) { c->response()->body().append(";context"); });
+    }
 };
 
 class ContextTest_NS : public Controller
@@ -137,6 +165,26 @@ TestEngine *TestContext::getEngine()
     auto engine = new TestEngine(app, QVariantMap());
     new ContextGetActionsTest(app);
     new ContextTest_NS(app);
+
+    auto appendHook = [](const QByteArray &name) {
+        return [name](Context *c) {
+            if (c->actionName() == u"hooks") {
+                c->response()->body().append(';' + name);
+            }
+        };
+    };
+    app->addAfterDispatchHook(app, appendHook("low"_ba));
+    app->addAfterDispatchHook(app, appendHook("high"_ba), 10);
+    app->addAfterDispatchHook(app, appendHook("low2"_ba));
+
+    // A hook destroying the receiver of a later hook while they are called
+    auto doomed = new QObject(app);
+    app->addAfterDispatchHook(doomed, appendHook("doomed"_ba), 1);
+    app->addAfterDispatchHook(
+        app, [doomed = QPointer<QObject>(doomed)](Context *) { delete doomed.data(); }, 5);
+
+    // Signals are emitted after the hooks
+    QObject::connect(app, &Application::afterDispatch, app, appendHook("signal"_ba));
     if (!engine->init()) {
         return nullptr;
     }
@@ -366,6 +414,71 @@ void TestContext::testController_data()
         << u"/uriForAction/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
         << QByteArrayLiteral("uriForAction not found");
 
+    // UriForString
+    query.clear();
+    query.addQueryItem(u"path"_s, u"/root"_s);
+    QTest::newRow("uriforstring-test00")
+        << u"/uriForString/a space/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("http://127.0.0.1/root/a%20space/b/c");
+
+    query.clear();
+    query.addQueryItem(u"path"_s, u""_s); // empty path to test controller->ns()
+    query.addQueryItem(u"foo"_s, u"bar"_s);
+    query.addQueryItem(u"encoded"_s, u"ç€¢ &"_s);
+    QTest::newRow("uriforstring-test01")
+        << u"/uriForString/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("http://127.0.0.1/test/controller/a/b/"
+                             "c?foo=bar&encoded=%C3%A7%E2%82%AC%C2%A2%20%26");
+
+    query.clear();
+    query.addQueryItem(u"path"_s, u"/"_s);
+    QTest::newRow("uriforstring-test02")
+        << u"/uriForString/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("http://127.0.0.1/a/b/c");
+
+    // AppendUriFor
+    query.clear();
+    query.addQueryItem(u"action"_s, u"/root"_s);
+    QTest::newRow("appendurifor-test00")
+        << u"/appendUriFor?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("appendUriFor not found");
+
+    query.clear();
+    query.addQueryItem(u"action"_s, u"/test/controller/rootItem"_s);
+    query.addQueryItem(u"foo"_s, u"bar"_s);
+    QTest::newRow("appendurifor-test01")
+        << u"/appendUriFor/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("http://127.0.0.1/root/item/a/b/c?foo=bar;"
+                             "http://127.0.0.1/root/item/a/b/c?foo=bar");
+
+    query.clear();
+    query.addQueryItem(u"action"_s, u"/test/controller/midleEnd"_s);
+    query.addQueryItem(u"captures"_s, u"1"_s);
+    QTest::newRow("appendurifor-test02")
+        << u"/appendUriFor/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("http://127.0.0.1/chain/midle/1/a/end/b/c;"
+                             "http://127.0.0.1/chain/midle/1/a/end/b/c");
+
+    query.clear();
+    query.addQueryItem(u"action"_s, u"/test/controller/midleEnd"_s);
+    query.addQueryItem(u"captures"_s, u"1/2 3"_s);
+    QTest::newRow("appendurifor-test03")
+        << u"/appendUriFor/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("http://127.0.0.1/chain/midle/1/2%203/end/a/b/c;"
+                             "http://127.0.0.1/chain/midle/1/2%203/end/a/b/c");
+
+    query.clear();
+    query.addQueryItem(u"action"_s, u"/test/controller/midleEnd"_s);
+    query.addQueryItem(u"captures"_s, u"1/2/3"_s); // too many captures
+    QTest::newRow("appendurifor-test04")
+        << u"/appendUriFor/a/b/c?"_s + query.toString(QUrl::FullyEncoded)
+        << QByteArrayLiteral("appendUriFor not found");
+
+    QTest::newRow("hooks-test00")
+        << u"/context/hooks"_s << QByteArrayLiteral("action;high;low;low2;context;signal");
+    QTest::newRow("hooks-test01")
+        << u"/context/hooks"_s << QByteArrayLiteral("action;high;low;low2;context;signal");
+
     QTest::newRow("context-test00")
         << u"/context/test_ns/actionName"_s << QByteArrayLiteral("actionName");
     QTest::newRow("context-test01")
@@ -517,6 +630,12 @@ void TestContext::testController_data()
     QTest::newRow("getactions-test00")
         << u"/context/test_ns/getActions?"_s + query.toString(QUrl::FullyEncoded)
         << QByteArrayLiteral("context/test_ns/ns;");
+
+    // ContextSlot values must not leak between requests
+    QTest::newRow("contextslot-test00")
+        << u"/context/contextSlot?value=foo"_s << QByteArrayLiteral("empty;5;foo;reset");
+    QTest::newRow("contextslot-test01")
+        << u"/context/contextSlot?value=bar"_s << QByteArrayLiteral("empty;5;bar;reset");
 }
 
 QTEST_MAIN(TestContext)
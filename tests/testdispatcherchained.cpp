@@ -28,6 +28,8 @@ private Q_SLOTS:
     void testController_data();
     void testController() { doTest(); }
 
+    void testUriForChain();
+
     void cleanupTestCase();
 
 private:
@@ -38,6 +40,33 @@ private:
     void doTest();
 };
 
+class ChainedUriTest : public Controller
+{
+    Q_OBJECT
+public:
+    explicit ChainedUriTest(QObject *parent)
+        : Controller(parent)
+    {
+    }
+
+    C_ATTR(item, :Chained("/") :PathPart("chained/uri") :CaptureArgs(1))
+    void item(Context *) {}
+
+    C_ATTR(show, :Chained("item") :PathPart("show") :Args(0))
+    void show(Context *c) { uriForAction(c); }
+
+    C_ATTR(edit, :Chained("item") :PathPart("edit") :Args(0))
+    void edit(Context *c) { uriForAction(c); }
+
+private:
+    static void uriForAction(Context *c)
+    {
+        // The action of the context is the chain created for this request
+        c->response()->setBody(
+            c->uriFor(c->action(), c->request()->captures()).toString().toLatin1());
+    }
+};
+
 void TestDispatcherChained::initTestCase()
 {
     m_engine = getEngine();
@@ -48,6 +77,7 @@ TestEngine *TestDispatcherChained::getEngine()
 {
     auto app    = new TestApplication;
     auto engine = new TestEngine(app, QVariantMap());
+    new ChainedUriTest(app);
     if (!engine->init()) {
         return nullptr;
     }
@@ -98,6 +128,18 @@ void TestDispatcherChained::testController_data()
                                     << QByteArrayLiteral("/chain/midle/TWO/ONE/end/1/2/3/4/5");
 }
 
+void TestDispatcherChained::testUriForChain()
+{
+    // Each request creates and deletes its own chain, the addresses of old chains get
+    // reused and must not return the URI of another chain
+    for (int i = 0; i < 20; ++i) {
+        const QString action = i % 2 ? u"edit"_s : u"show"_s;
+        const QString path   = u"/chained/uri/"_s + QString::number(i) + u'/' + action;
+        const auto result    = m_engine->createRequest("GET", path, {}, Headers(), nullptr);
+        QCOMPARE(result.body, (u"http://127.0.0.1"_s + path).toLatin1());
+    }
+}
+
 QTEST_MAIN(TestDispatcherChained)
 
 #include "testdispatcherchained.moc"
@@ -15,6 +15,9 @@ class TestHeaders : public CoverageObject
     Q_OBJECT
 private Q_SLOTS:
     void testCombining();
+    void testKnownHeaders();
+    void testETagMatch_data();
+    void testETagMatch();
 };
 
 void TestHeaders::testCombining()
@@ -184,6 +187,84 @@ void TestHeaders::testCombining()
     }
 }
 
+void TestHeaders::testKnownHeaders()
+{
+    QCOMPARE(Headers::knownHeader("content-type"), Headers::KnownHeader::ContentType);
+    QCOMPARE(Headers::knownHeader(u"ACCEPT-ENCODING"), Headers::KnownHeader::AcceptEncoding);
+    QCOMPARE(Headers::knownHeader(u8"Host"), Headers::KnownHeader::Host);
+    QCOMPARE(Headers::knownHeader("x-hbn-foo"), Headers::KnownHeader::Unknown);
+    QCOMPARE(Headers::knownHeaderName(Headers::KnownHeader::ContentLength), "Content-Length"_ba);
+    QCOMPARE(Headers::knownHeaderName(Headers::KnownHeader::Unknown), QByteArray{});
+
+    Headers headers;
+    headers.pushHeader("x-hbn-foo"_ba, "1"_ba);
+    headers.pushHeader("cOOkie"_ba, "a=1"_ba);
+    headers.pushHeader("X-HBN-FOO"_ba, "2"_ba);
+    headers.pushHeader("Cookie"_ba, "b=2"_ba);
+
+    QVERIFY(headers.contains(Headers::KnownHeader::Cookie));
+    QCOMPARE(headers.header(Headers::KnownHeader::Cookie), "a=1"_ba);
+    QCOMPARE(headers.header("COOKIE"), "a=1"_ba);
+    QCOMPARE(headers.headers("cookie"), QByteArrayList({"a=1"_ba, "b=2"_ba}));
+    QCOMPARE(headers.headers(u"x-hbn-foo"), QByteArrayList({"1"_ba, "2"_ba}));
+    QCOMPARE(headers.keys(), QByteArrayList({"x-hbn-foo"_ba, "cOOkie"_ba}));
+
+    // Removing an entry before the known one must keep its slot valid
+    headers.removeHeader("x-hbn-foo");
+    QCOMPARE(headers.data().size(), 2);
+    QCOMPARE(headers.header(Headers::KnownHeader::Cookie), "a=1"_ba);
+
+    headers.setHeader(Headers::KnownHeader::Cookie, "c=3"_ba);
+    QCOMPARE(headers.headers("cookie"), QByteArrayList({"c=3"_ba}));
+
+    headers.setHeader(Headers::KnownHeader::ContentType, "text/plain"_ba);
+    QCOMPARE(headers.data().last().key, "Content-Type"_ba);
+    QCOMPARE(headers.contentType(), "text/plain"_ba);
+
+    headers.removeHeader(Headers::KnownHeader::Cookie);
+    QVERIFY(!headers.contains("Cookie"));
+    QVERIFY(!headers.contains(Headers::KnownHeader::Cookie));
+    QCOMPARE(headers.header(Headers::KnownHeader::ContentType), "text/plain"_ba);
+
+    Headers copy = headers;
+    QCOMPARE(copy.header(Headers::KnownHeader::ContentType), "text/plain"_ba);
+
+    headers.clear();
+    QVERIFY(!headers.contains(Headers::KnownHeader::ContentType));
+    QVERIFY(copy.contains(Headers::KnownHeader::ContentType));
+}
+
+void TestHeaders::testETagMatch_data()
+{
+    QTest::addColumn<QByteArray>("header");
+    QTest::addColumn<bool>("match");
+
+    QTest::newRow("empty") << QByteArray() << false;
+    QTest::newRow("strong") << "\"abc\""_ba << true;
+    QTest::newRow("weak") << "W/\"abc\""_ba << true;
+    QTest::newRow("other") << "\"abcd\""_ba << false;
+    QTest::newRow("list") << "\"x\", W/\"y\",\"abc\""_ba << true;
+    QTest::newRow("list-other") << "\"x\", \"y\""_ba << false;
+    QTest::newRow("any") << "*"_ba << true;
+    QTest::newRow("unquoted") << "abc"_ba << false;
+    QTest::newRow("short") << "\""_ba << false;
+    QTest::newRow("short-weak") << "W/"_ba << false;
+}
+
+void TestHeaders::testETagMatch()
+{
+    QFETCH(QByteArray, header);
+    QFETCH(bool, match);
+
+    Headers headers;
+    if (!header.isEmpty()) {
+        headers.setHeader("If-None-Match"_ba, header);
+        headers.setHeader("If-Match"_ba, header);
+    }
+    QCOMPARE(headers.ifNoneMatch(u"abc"), match);
+    QCOMPARE(headers.ifMatch(u"abc"), match || header.isEmpty());
+}
+
 QTEST_MAIN(TestHeaders)
 #include "testheaders.moc"
 
@@ -4,6 +4,8 @@
 #include "coverageobject.h"
 #include "headers.h"
 
+#include <Cutelyst/CoroContext.h>
+#include <Cutelyst/Plugins/Memcached/AsyncMemcached>
 #include <Cutelyst/Plugins/Memcached/Memcached>
 #include <Cutelyst/application.h>
 #include <Cutelyst/controller.h>
@@ -11,12 +13,15 @@
 #include <Cutelyst/upload.h>
 #include <utility>
 
+#include <QDateTime>
 #include <QObject>
+#include <QPoint>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QTest>
+#include <QTimeZone>
 #include <QUrlQuery>
 
 using namespace Cutelyst;
@@ -944,6 +949,282 @@ public:
         setValidity(c, h1 == h2);
     }
 
+    // **** Start testing mset valid
+    C_ATTR(msetValid, :Local :AutoArgs)
+    void msetValid(Context *c)
+    {
+        const auto h1 = getTestHash("vale");
+        const bool ok = Memcached::mset(h1, 1min);
+        setValidity(c, ok && Memcached::mget(h1.keys()) == h1);
+    }
+
+    // **** Start testing mset by key valid
+    C_ATTR(msetByKeyValid, :Local :AutoArgs)
+    void msetByKeyValid(Context *c)
+    {
+        const auto h1 = getTestHashList("valf");
+        const bool ok = Memcached::msetByKey("msetGroup", h1, 1min);
+        setValidity(c, ok && Memcached::mgetByKey<QVariantList>("msetGroup", h1.keys()) == h1);
+    }
+
+    // **** Start testing mremove valid
+    C_ATTR(mremoveValid, :Local :AutoArgs)
+    void mremoveValid(Context *c)
+    {
+        const auto h1 = getTestHash("valg");
+        Memcached::mset(h1, 1min);
+        QByteArrayList keys = h1.keys();
+        keys.append("mremoveMissing"_ba);
+        const bool ok = Memcached::mremove(keys);
+        setValidity(c, ok && Memcached::mget(h1.keys()).isEmpty());
+    }
+
+    // **** Start testing near cache
+    C_ATTR(nearCacheValid, :Local :AutoArgs)
+    void nearCacheValid(Context *c)
+    {
+        Memcached::set("near_key", "first"_ba, 1min);
+        Memcached::resetNearCacheStats();
+        const QByteArray read   = Memcached::get("near_key");
+        const QByteArray cached = Memcached::get("near_key");
+        // Reads with a group key always go to the servers
+        Memcached::getByKey("nearGroup", "near_key");
+        const auto stats = Memcached::nearCacheStats();
+
+        Memcached::set("near_key", "second"_ba, 1min);
+        const QByteArray changed = Memcached::get("near_key");
+        Memcached::remove("near_key");
+        const QByteArray removed = Memcached::get("near_key");
+        setValidity(c,
+                    read == "first"_ba && cached == "first"_ba && stats.nearHits == 1 &&
+                        stats.nearMisses == 1 && stats.memcachedHits + stats.memcachedMisses == 2 &&
+                        changed == "second"_ba && removed.isNull());
+    }
+
+    // **** Start testing near cache with version key
+    C_ATTR(nearCacheVersionValid, :Local :AutoArgs)
+    void nearCacheVersionValid(Context *c)
+    {
+        Memcached::set("nearVersion", "1"_ba, 1min);
+        Memcached::set("nearVersioned_key", "first"_ba, 1min);
+        Memcached::get("nearVersioned_key");
+        Memcached::resetNearCacheStats();
+        Memcached::get("nearVersioned_key");
+        const auto cached = Memcached::nearCacheStats();
+
+        Memcached::increment("nearVersion", 1);
+        const QByteArray read = Memcached::get("nearVersioned_key");
+        const auto bumped     = Memcached::nearCacheStats();
+        setValidity(c,
+                    cached.nearHits == 1 && read == "first"_ba && bumped.nearHits == 1 &&
+                        bumped.nearMisses == 1);
+    }
+
+    // **** Start testing the CBOR codec
+    C_ATTR(codecValid, :Local :AutoArgs)
+    CoroContext codecValid(Context *c)
+    {
+        const QVariantHash hash{
+            {u"user"_s, u"Lorem ipsum"_s},
+            {u"expires"_s, 1234567890},
+            {u"login"_s, QDateTime::fromMSecsSinceEpoch(1700000000123, QTimeZone::UTC)},
+            {u"roles"_s, QVariantMap{{u"admin"_s, true}, {u"level"_s, 3.5}}}};
+        const QVariantList unsupported{QPoint{1, 2}, u"dolor"_s};
+
+        quint32 hashFlags = 0;
+        Memcached::encode(hash, &hashFlags);
+        quint32 unsupportedFlags = 0;
+        Memcached::encode(unsupported, &unsupportedFlags);
+
+        Memcached::set("codecHash", hash, 1min);
+        Memcached::set("codecUnsupported", unsupported, 1min);
+        co_await AsyncMemcached::coSet(c, "codecAsync", getTestVariantList2(), 1min);
+        const auto asyncGet = co_await AsyncMemcached::coGet(c, "codecHash");
+
+        setValidity(c,
+                    hashFlags != 0 && unsupportedFlags == 0 &&
+                        Memcached::get<QVariantHash>("codecHash") == hash &&
+                        Memcached::get<QVariantList>("codecUnsupported") == unsupported &&
+                        Memcached::get<QVariantList>("codecAsync") == getTestVariantList2() &&
+                        asyncGet.valueAs<QVariantHash>() == hash);
+    }
+
+    // **** Start testing get or load
+    C_ATTR(getOrLoadValid, :Local :AutoArgs)
+    void getOrLoadValid(Context *c)
+    {
+        const QByteArray key = "getOrLoadKey";
+        Memcached::remove(key);
+        Memcached::getOrLoad(
+            c,
+            key,
+            1min,
+            [](SingleFlight::Callback done) { done({"Lorem ipsum"_ba, {}}); },
+            [this, c, key](const SingleFlight::Result &result) {
+            // The loaded value was stored
+            setValidity(c,
+                        result.value.toByteArray() == "Lorem ipsum" &&
+                            Memcached::get(key) == "Lorem ipsum");
+        });
+    }
+
+    // **** Start testing the non-blocking client
+    C_ATTR(asyncSetGet, :Local :AutoArgs)
+    CoroContext asyncSetGet(Context *c)
+    {
+        const auto set = co_await AsyncMemcached::coSet(c, "asyncKey", "Lorem ipsum"_ba, 5min);
+        const auto get = co_await AsyncMemcached::coGet(c, "asyncKey");
+        setValidity(c,
+                    set.ok() && get.ok() && get.value == "Lorem ipsum" &&
+                        Memcached::get("asyncKey") == "Lorem ipsum");
+    }
+
+    C_ATTR(asyncGetCallback, :Local :AutoArgs)
+    void asyncGetCallback(Context *c)
+    {
+        Memcached::set("asyncCallbackKey", "dolor sit amet"_ba, 5min);
+        AsyncMemcached::get(c, "asyncCallbackKey", [this, c](const AsyncMemcached::Reply &reply) {
+            setValidity(c, reply.ok() && reply.value == "dolor sit amet");
+        });
+    }
+
+    C_ATTR(asyncAddReplace, :Local :AutoArgs)
+    CoroContext asyncAddReplace(Context *c)
+    {
+        co_await AsyncMemcached::coRemove(c, "asyncAddKey");
+        const auto add =
+            co_await AsyncMemcached::coAdd(c, "asyncAddKey", getTestVariantList(), 5min);
+        const auto addAgain = co_await AsyncMemcached::coAdd(c, "asyncAddKey", "x"_ba, 5min);
+        const auto replace =
+            co_await AsyncMemcached::coReplace(c, "asyncAddKey", getTestVariantList2(), 5min);
+        const auto get = co_await AsyncMemcached::coGet(c, "asyncAddKey");
+        setValidity(c,
+                    add.ok() && addAgain.returnType == Memcached::ReturnType::NotStored &&
+                        replace.ok() && get.valueAs<QVariantList>() == getTestVariantList2());
+    }
+
+    C_ATTR(asyncIncrement, :Local :AutoArgs)
+    CoroContext asyncIncrement(Context *c)
+    {
+        co_await AsyncMemcached::coRemove(c, "asyncCounter");
+        const auto missing = co_await AsyncMemcached::coIncrement(c, "asyncCounter", 1);
+        const auto initial =
+            co_await AsyncMemcached::coIncrementWithInitial(c, "asyncCounter", 5, 10, 5min);
+        const auto incr = co_await AsyncMemcached::coIncrement(c, "asyncCounter", 5);
+        const auto decr = co_await AsyncMemcached::coDecrement(c, "asyncCounter", 3);
+        setValidity(c,
+                    missing.returnType == Memcached::ReturnType::NotFound &&
+                        initial.number == 10 && incr.number == 15 && decr.number == 12);
+    }
+
+    C_ATTR(asyncCas, :Local :AutoArgs)
+    CoroContext asyncCas(Context *c)
+    {
+        co_await AsyncMemcached::coSet(c, "asyncCasKey", "first"_ba, 5min);
+        const auto get     = co_await AsyncMemcached::coGet(c, "asyncCasKey");
+        const auto changed = co_await AsyncMemcached::coCas(
+            c, "asyncCasKey", "second"_ba, 5min, get.cas);
+        const auto stale =
+            co_await AsyncMemcached::coCas(c, "asyncCasKey", "third"_ba, 5min, get.cas);
+        setValidity(c,
+                    get.cas != 0 && changed.ok() &&
+                        stale.returnType == Memcached::ReturnType::DataExists);
+    }
+
+    C_ATTR(asyncMget, :Local :AutoArgs)
+    CoroContext asyncMget(Context *c)
+    {
+        const auto hash = getTestHash("async");
+        for (const auto &[key, value] : hash.asKeyValueRange()) {
+            co_await AsyncMemcached::coSet(c, key, value, 5min);
+        }
+
+        QByteArrayList keys = hash.keys();
+        keys.append("asyncMissing"_ba);
+        const auto reply = co_await AsyncMemcached::coMget(c, keys);
+        setValidity(c,
+                    reply.ok() && reply.values == hash &&
+                        reply.casValues.size() == hash.size());
+    }
+
+    // The keys are spread over the async connections, so their replies get gathered
+    C_ATTR(asyncMgetFlags, :Local :AutoArgs)
+    CoroContext asyncMgetFlags(Context *c)
+    {
+        const auto hash = getTestHashList("asyncFlags");
+        for (const auto &[key, value] : hash.asKeyValueRange()) {
+            co_await AsyncMemcached::coSet(c, key, value, 5min);
+        }
+
+        const auto reply = co_await AsyncMemcached::coMget(c, hash.keys());
+        setValidity(c,
+                    reply.ok() && reply.flagValues.size() == hash.size() &&
+                        reply.valuesAs<QVariantList>() == hash);
+    }
+
+    C_ATTR(asyncMsetMremove, :Local :AutoArgs)
+    CoroContext asyncMsetMremove(Context *c)
+    {
+        const auto hash   = getTestHash("asyncMset");
+        const auto stored = co_await AsyncMemcached::coMset(c, hash, 5min);
+        const auto read   = co_await AsyncMemcached::coMget(c, hash.keys());
+
+        QByteArrayList keys = hash.keys();
+        keys.append("asyncMremoveMissing"_ba);
+        const auto removed = co_await AsyncMemcached::coMremove(c, keys);
+        const auto empty   = co_await AsyncMemcached::coMget(c, hash.keys());
+        setValidity(c,
+                    stored.ok() && read.values == hash && removed.ok() &&
+                        empty.ok() && empty.values.isEmpty());
+    }
+
+    C_ATTR(asyncBatchedGets, :Local :AutoArgs)
+    CoroContext asyncBatchedGets(Context *c)
+    {
+        co_await AsyncMemcached::coSet(c, "asyncBatchA", "first"_ba, 5min);
+        co_await AsyncMemcached::coSet(c, "asyncBatchB", "second"_ba, 5min);
+
+        // Issued before awaiting so they are sent together
+        auto a       = AsyncMemcached::coGet(c, "asyncBatchA");
+        auto b       = AsyncMemcached::coGet(c, "asyncBatchB");
+        auto again   = AsyncMemcached::coGet(c, "asyncBatchA");
+        auto missing = AsyncMemcached::coGet(c, "asyncBatchMissing");
+
+        const auto replyA       = co_await a;
+        const auto replyB       = co_await b;
+        const auto replyAgain   = co_await again;
+        const auto replyMissing = co_await missing;
+        setValidity(c,
+                    replyA.value == "first"_ba && replyA.cas != 0 &&
+                        replyB.value == "second"_ba && replyAgain.value == "first"_ba &&
+                        replyMissing.returnType == Memcached::ReturnType::NotFound);
+    }
+
+    C_ATTR(asyncExistTouchRemove, :Local :AutoArgs)
+    CoroContext asyncExistTouchRemove(Context *c)
+    {
+        co_await AsyncMemcached::coSet(c, "asyncExistKey", "Lorem ipsum"_ba, 5min);
+        const auto exist   = co_await AsyncMemcached::coExist(c, "asyncExistKey");
+        const auto touch   = co_await AsyncMemcached::coTouch(c, "asyncExistKey", 1min);
+        const auto remove  = co_await AsyncMemcached::coRemove(c, "asyncExistKey");
+        const auto removed = co_await AsyncMemcached::coExist(c, "asyncExistKey");
+        setValidity(c,
+                    exist.ok() && touch.ok() && remove.ok() &&
+                        removed.returnType == Memcached::ReturnType::NotFound);
+    }
+
+    C_ATTR(asyncInvalidKey, :Local :AutoArgs)
+    CoroContext asyncInvalidKey(Context *c)
+    {
+        const auto empty   = co_await AsyncMemcached::coSet(c, {}, "x"_ba, 5min);
+        const auto spaces  = co_await AsyncMemcached::coGet(c, "with space");
+        const auto tooLong = co_await AsyncMemcached::coGet(c, QByteArray(500, 'a'));
+        setValidity(c,
+                    empty.returnType == Memcached::ReturnType::BadKeyProvided &&
+                        spaces.returnType == Memcached::ReturnType::BadKeyProvided &&
+                        tooLong.returnType == Memcached::ReturnType::KeyTooBig);
+    }
+
     // **** Start testing flush
     C_ATTR(flush, :Local :AutoArgs)
     void flush(Context *c)
@@ -1095,8 +1376,12 @@ TestEngine *TestMemcached::getEngine()
     QVariantMap pluginConfig{{u"binary_protocol"_s, true},
                              {u"compression"_s, true},
                              {u"compression_threshold"_s, 10},
-                             {u"servers"_s, m_memcServers}};
+                             {u"codec"_s, u"cbor"_s},
+                             {u"servers"_s, m_memcServers},
+                             {u"near_cache"_s, u"worker"_s}};
     plugin->setDefaultConfig(pluginConfig);
+    plugin->addNearCachePolicy("near_", 1min);
+    plugin->addNearCachePolicy("nearVersioned_", 1min, "nearVersion");
     new MemcachedTest(app);
     if (!engine->init()) {
         return nullptr;
@@ -1296,6 +1581,24 @@ void TestMemcached::testController_data()
         {u"mgetByKeyValid"_s, QByteArrayLiteral("valid")},
         {u"mgetVariantValid"_s, QByteArrayLiteral("valid")},
         {u"mgetByKeyVariantValid"_s, QByteArrayLiteral("valid")},
+        {u"msetValid"_s, QByteArrayLiteral("valid")},
+        {u"msetByKeyValid"_s, QByteArrayLiteral("valid")},
+        {u"mremoveValid"_s, QByteArrayLiteral("valid")},
+        {u"nearCacheValid"_s, QByteArrayLiteral("valid")},
+        {u"nearCacheVersionValid"_s, QByteArrayLiteral("valid")},
+        {u"codecValid"_s, QByteArrayLiteral("valid")},
+        {u"getOrLoadValid"_s, QByteArrayLiteral("valid")},
+        {u"asyncSetGet"_s, QByteArrayLiteral("valid")},
+        {u"asyncGetCallback"_s, QByteArrayLiteral("valid")},
+        {u"asyncAddReplace"_s, QByteArrayLiteral("valid")},
+        {u"asyncIncrement"_s, QByteArrayLiteral("valid")},
+        {u"asyncCas"_s, QByteArrayLiteral("valid")},
+        {u"asyncMget"_s, QByteArrayLiteral("valid")},
+        {u"asyncMgetFlags"_s, QByteArrayLiteral("valid")},
+        {u"asyncMsetMremove"_s, QByteArrayLiteral("valid")},
+        {u"asyncBatchedGets"_s, QByteArrayLiteral("valid")},
+        {u"asyncExistTouchRemove"_s, QByteArrayLiteral("valid")},
+        {u"asyncInvalidKey"_s, QByteArrayLiteral("valid")},
         {u"flush"_s, QByteArrayLiteral("valid")}};
 
     for (const std::pair<QString, QByteArray> &test : testVect) {
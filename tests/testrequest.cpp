@@ -7,13 +7,20 @@
 #include <Cutelyst/application.h>
 #include <Cutelyst/controller.h>
 #include <Cutelyst/headers.h>
+#include <Cutelyst/jsonstreamreader.h>
+#include <Cutelyst/multipartformdataparser.h>
 #include <Cutelyst/upload.h>
 
+#include <QBuffer>
+#include <QCborValue>
+#include <QFile>
 #include <QHostInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QObject>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
 #include <QTest>
 #include <QUrlQuery>
 #include <QUuid>
@@ -39,12 +46,22 @@ private Q_SLOTS:
     void testUploads_data();
     void testUploads() { doTest(); }
 
+    void testMultiPartStream_data();
+    void testMultiPartStream();
+
+    void testJsonStreamReader_data();
+    void testJsonStreamReader();
+
+    void testBodyDataLimit_data();
+    void testBodyDataLimit();
+
     void cleanupTestCase();
 
 private:
-    TestEngine *m_engine = nullptr;
+    TestEngine *m_engine        = nullptr;
+    TestEngine *m_limitedEngine = nullptr;
 
-    TestEngine *getEngine();
+    TestEngine *getEngine(qint64 bodyDataLimit = -1);
 
     void doTest();
 };
@@ -86,6 +103,13 @@ public:
     C_ATTR(path, :Local :AutoArgs)
     void path(Context *c) { c->response()->setBody(c->request()->path()); }
 
+    C_ATTR(pathUtf8, :Local :AutoArgs)
+    void pathUtf8(Context *c, const QString &arg)
+    {
+        c->response()->setBody(c->request()->pathUtf8() + ';' + arg.toUtf8() + ';' +
+                               c->request()->path().toUtf8());
+    }
+
     C_ATTR(match, :Local :AutoArgs)
     void match(Context *c) { c->response()->setBody(c->request()->match()); }
 
@@ -361,13 +385,19 @@ void TestRequest::initTestCase()
 {
     m_engine = getEngine();
     QVERIFY(m_engine);
+
+    m_limitedEngine = getEngine(16);
+    QVERIFY(m_limitedEngine);
 }
 
-TestEngine *TestRequest::getEngine()
+TestEngine *TestRequest::getEngine(qint64 bodyDataLimit)
 {
     qputenv("RECURSION", QByteArrayLiteral("100"));
     auto app    = new TestApplication;
     auto engine = new TestEngine(app, QVariantMap());
+    if (bodyDataLimit >= 0) {
+        engine->setConfig({{u"Cutelyst"_s, QVariantMap{{u"body_data_limit"_s, bodyDataLimit}}}});
+    }
     new RequestTest(app);
     if (!engine->init()) {
         return nullptr;
@@ -378,6 +408,7 @@ TestEngine *TestRequest::getEngine()
 void TestRequest::cleanupTestCase()
 {
     delete m_engine;
+    delete m_limitedEngine;
 }
 
 void TestRequest::doTest()
@@ -436,6 +467,12 @@ void TestRequest::testController_data()
                                  << QByteArrayLiteral("http://127.0.0.1");
     QTest::newRow("path-test00") << get << u"/request/test/path"_s << headers << QByteArray()
                                  << QByteArrayLiteral("/request/test/path");
+    QTest::newRow("pathutf8-test00")
+        << get << u"/request/test/pathUtf8/foo"_s << headers << QByteArray()
+        << QByteArrayLiteral("/request/test/pathUtf8/foo;foo;/request/test/pathUtf8/foo");
+    QTest::newRow("pathutf8-test01")
+        << get << u"/request/test/pathUtf8/ação"_s << headers << QByteArray()
+        << u"/request/test/pathUtf8/ação;ação;/request/test/pathUtf8/ação"_s.toUtf8();
     QTest::newRow("match-test00") << get << u"/request/test/match"_s << headers << QByteArray()
                                   << QByteArrayLiteral("/request/test/match");
 
@@ -1063,6 +1100,219 @@ void TestRequest::testUploads_data()
     headers.setContentType("multipart/form-data; boundary=----WebKitFormBoundaryoPPQLwBBssFnOTVH");
     QTest::newRow("uploads-100") << post << u"/request/test/uploads"_s << headers << body << result;
 }
+
+void TestRequest::testMultiPartStream_data()
+{
+    QTest::addColumn<QByteArray>("body");
+    QTest::addColumn<int>("chunkSize");
+    QTest::addColumn<qint64>("memoryLimit");
+
+    // A field that looks like the start of a delimiter
+    const QByteArray field = "\r\n------WebKitFormBoundary"_ba;
+
+    QByteArray result;
+    QByteArray body = "preamble\r\n------WebKitFormBoundaryoPPQLwBBssFnOTVH\r\n"
+                      "Content-Disposition: form-data; name=\"field\"\r\n\r\n"_ba +
+                      field + "\r\n" + createBody(result, 10);
+
+    QTest::newRow("stream-1") << body << 1 << qint64(64 * 1024);
+    QTest::newRow("stream-7") << body << 7 << qint64(64 * 1024);
+    QTest::newRow("stream-41") << body << 41 << qint64(64 * 1024);
+    QTest::newRow("stream-all") << body << int(body.size()) << qint64(64 * 1024);
+    QTest::newRow("stream-spill") << body << 3 << qint64(4);
+}
+
+void TestRequest::testMultiPartStream()
+{
+    QFETCH(QByteArray, body);
+    QFETCH(int, chunkSize);
+    QFETCH(qint64, memoryLimit);
+
+    const QByteArray contentType =
+        "multipart/form-data; boundary=----WebKitFormBoundaryoPPQLwBBssFnOTVH";
+
+    QBuffer buffer(&body);
+    buffer.open(QIODevice::ReadOnly);
+    const Uploads expected = MultiPartFormDataParser::parse(&buffer, contentType);
+
+    MultiPartFormDataStream stream(contentType);
+    stream.setMemoryLimit(memoryLimit);
+    for (qsizetype pos = 0; pos < body.size(); pos += chunkSize) {
+        const QByteArray chunk = body.mid(pos, chunkSize);
+        QCOMPARE(stream.write(chunk), qint64(chunk.size()));
+    }
+    QVERIFY(stream.isFinished());
+    QVERIFY(!stream.hasError());
+    QCOMPARE(stream.size(), qint64(body.size()));
+
+    const Uploads uploads = stream.takeUploads();
+    QCOMPARE(uploads.size(), expected.size());
+    for (qsizetype i = 0; i < uploads.size(); ++i) {
+        Upload *upload = uploads.at(i);
+        QCOMPARE(upload->name(), expected.at(i)->name());
+        QCOMPARE(upload->filename(), expected.at(i)->filename());
+        QCOMPARE(upload->contentType(), expected.at(i)->contentType());
+        QCOMPARE(upload->readAll(), expected.at(i)->readAll());
+    }
+    QVERIFY(uploads.first()->seek(0));
+    QCOMPARE(uploads.first()->readAll(), "\r\n------WebKitFormBoundary"_ba);
+
+    // Saving a file backed upload and one that is a view over the body
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    for (Upload *upload : {uploads.last(), expected.last()}) {
+        const QString fileName = dir.filePath(QUuid::createUuid().toString(QUuid::WithoutBraces));
+        QVERIFY(upload->save(fileName));
+
+        QFile saved(fileName);
+        QVERIFY(saved.open(QIODevice::ReadOnly));
+        QVERIFY(upload->seek(0));
+        QCOMPARE(saved.readAll(), upload->readAll());
+    }
+
+#ifdef Q_OS_UNIX
+    // Linked uploads get the mode of a newly created file, not the one of the temporary file
+    QFile created(dir.filePath(u"created"_s));
+    QVERIFY(created.open(QIODevice::WriteOnly));
+    const QString linkedName = dir.filePath(u"linked"_s);
+    QVERIFY(uploads.last()->save(linkedName));
+    QCOMPARE(QFile::permissions(linkedName), created.permissions());
+#endif
+
+    // Parts of a body stored on a file are copied by the kernel from their offset
+    QTemporaryFile bodyFile;
+    QVERIFY(bodyFile.open());
+    QCOMPARE(bodyFile.write(body), qint64(body.size()));
+    QVERIFY(bodyFile.seek(0));
+    const Uploads fromFile = MultiPartFormDataParser::parse(&bodyFile, contentType);
+    QCOMPARE(fromFile.size(), expected.size());
+    for (qsizetype i = 0; i < fromFile.size(); ++i) {
+        Upload *upload         = fromFile.at(i);
+        const QString fileName = dir.filePath(u"offset-"_s + QString::number(i));
+        QVERIFY(upload->save(fileName));
+
+        QFile saved(fileName);
+        QVERIFY(saved.open(QIODevice::ReadOnly));
+        QVERIFY(expected.at(i)->seek(0));
+        QCOMPARE(saved.readAll(), expected.at(i)->readAll());
+    }
+
+    qDeleteAll(fromFile);
+    qDeleteAll(uploads);
+    qDeleteAll(expected);
+}
+
+void TestRequest::testJsonStreamReader_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<qint64>("maxSize");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("object") << R"({"a": 1, "b": [true, false, null], "c": {"d": -1.5e3}})"_ba
+                            << qint64(-1) << true;
+    QTest::newRow("array") << R"( [ "x\ty\u00e7\ud83d\ude00", 0, -0.25, [], {} ] )"_ba
+                           << qint64(-1) << true;
+    QTest::newRow("scalar") << R"("text")"_ba << qint64(-1) << true;
+    QTest::newRow("escapes") << R"(["\"\\\/\b\f\n\r\t"])"_ba << qint64(-1) << true;
+
+    // Crosses the internal read buffer many times
+    QByteArray big = "["_ba;
+    for (int i = 0; i < 20000; ++i) {
+        big.append(R"({"id": )" + QByteArray::number(i) + R"(, "name": "\u00e3\ud83d\ude00 )" +
+                   QByteArray::number(i * 3) + R"("},)");
+    }
+    big.append("null]");
+    QTest::newRow("big") << big << qint64(-1) << true;
+    QTest::newRow("big-limit") << big << qint64(big.size()) << true;
+    QTest::newRow("big-over-limit") << big << qint64(big.size() - 1) << false;
+
+    QTest::newRow("empty") << ""_ba << qint64(-1) << false;
+    QTest::newRow("trailing-comma") << "[1, 2,]"_ba << qint64(-1) << false;
+    QTest::newRow("unterminated") << R"({"a": "b)"_ba << qint64(-1) << false;
+    QTest::newRow("bad-number") << "[01]"_ba << qint64(-1) << false;
+    QTest::newRow("bad-literal") << "[tru]"_ba << qint64(-1) << false;
+    QTest::newRow("missing-colon") << R"({"a" 1})"_ba << qint64(-1) << false;
+    QTest::newRow("mismatch") << "[1}"_ba << qint64(-1) << false;
+    QTest::newRow("garbage") << "{} {}"_ba << qint64(-1) << false;
+}
+
+void TestRequest::testJsonStreamReader()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(qint64, maxSize);
+    QFETCH(bool, valid);
+
+    QBuffer buffer(&json);
+    buffer.open(QIODevice::ReadOnly);
+
+    JsonStreamReader reader(&buffer);
+    reader.setMaxSize(maxSize);
+    reader.readNext();
+    const QJsonValue value = reader.readValue();
+    reader.readNext();
+
+    QCOMPARE(reader.hasError(), !valid);
+    if (!valid) {
+        QVERIFY(!reader.errorString().isEmpty());
+        return;
+    }
+
+    QCOMPARE(reader.tokenType(), JsonStreamReader::EndDocument);
+    QCOMPARE(reader.offset(), qint64(json.size()));
+
+    QJsonParseError error;
+    const QJsonDocument expected = QJsonDocument::fromJson("[" + json + "]", &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(value, expected.array().first());
+}
+
+void TestRequest::testBodyDataLimit_data()
+{
+    QTest::addColumn<QByteArray>("contentType");
+    QTest::addColumn<QByteArray>("body");
+    QTest::addColumn<bool>("parsed");
+
+    // The limit is 16 bytes
+    const QByteArray json    = R"({"foo":"bar"})"_ba;
+    const QByteArray bigJson = R"({"foo":"bar","baz":"qux"})"_ba;
+    const QByteArray exact   = R"({"foo":"barbaz"})"_ba;
+    const QByteArray form    = "foo=bar"_ba;
+    const QByteArray bigForm = "foo=bar&baz=qux&quux=corge"_ba;
+    const QByteArray cbor    = QCborValue(u"foo"_s).toCbor();
+    const QByteArray bigCbor = QCborValue(QString(32, u'x')).toCbor();
+
+    QTest::newRow("json") << "application/json"_ba << json << true;
+    QTest::newRow("json-big") << "application/json"_ba << bigJson << false;
+    QTest::newRow("json-exact") << "application/json"_ba << exact << true;
+    QTest::newRow("form") << "application/x-www-form-urlencoded"_ba << form << true;
+    QTest::newRow("form-big") << "application/x-www-form-urlencoded"_ba << bigForm << false;
+    QTest::newRow("cbor") << "application/cbor"_ba << cbor << true;
+    QTest::newRow("cbor-big") << "application/cbor"_ba << bigCbor << false;
+    QTest::newRow("empty") << "application/x-www-form-urlencoded"_ba << QByteArray() << true;
+}
+
+void TestRequest::testBodyDataLimit()
+{
+    QFETCH(QByteArray, contentType);
+    QFETCH(QByteArray, body);
+    QFETCH(bool, parsed);
+
+    // Sequential bodies don't have a known size and are bounded while they are read
+    for (bool sequential : {false, true}) {
+        Headers headers;
+        headers.setContentType(contentType);
+        if (sequential) {
+            headers.setHeader("Sequential"_ba, "1"_ba);
+        }
+
+        QByteArray data = body;
+        const auto result = m_limitedEngine->createRequest(
+            "POST"_ba, "/request/test/bodyData"_ba, {}, headers, &data);
+        QCOMPARE(result.statusCode, 200);
+        QCOMPARE(!result.body.isEmpty(), parsed);
+    }
+}
+
 QTEST_MAIN(TestRequest)
 
 #include "testrequest.moc"
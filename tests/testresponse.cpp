@@ -4,11 +4,15 @@
 #include "coverageobject.h"
 #include "headers.h"
 
+#include <Cutelyst/CborWriter>
 #include <Cutelyst/application.h>
 #include <Cutelyst/controller.h>
 #include <Cutelyst/headers.h>
 #include <Cutelyst/upload.h>
 
+#include <QBuffer>
+#include <QCborArray>
+#include <QCborMap>
 #include <QCryptographicHash>
 #include <QHostInfo>
 #include <QJsonArray>
@@ -38,6 +42,11 @@ private Q_SLOTS:
     void testController_data();
     void testController() { doTest(); }
 
+    void testCborWriter();
+
+    void testETag();
+    void testETagVersion();
+
     void cleanupTestCase();
 
 private:
@@ -223,6 +232,22 @@ public:
         QJsonArray array;
         c->response()->setJsonArrayBody(array);
     }
+
+    C_ATTR(autoETag, :Local :AutoArgs)
+    void autoETag(Context *c)
+    {
+        c->response()->setAutoETag(true);
+        c->response()->setBody(c->request()->queryParam(u"data"_s));
+    }
+
+    C_ATTR(etagVersion, :Local :AutoArgs)
+    void etagVersion(Context *c)
+    {
+        if (c->response()->setETagVersion(c->request()->queryParam(u"version"_s).toLatin1())) {
+            return;
+        }
+        c->response()->setBody("rendered"_ba);
+    }
 };
 
 void TestResponse::initTestCase()
@@ -602,6 +627,96 @@ void TestResponse::testController_data()
                              "domain=cutelyst.org; path=/path");
 }
 
+void TestResponse::testCborWriter()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    QCborArray expected;
+    {
+        CborWriter writer(&buffer, 128);
+        QCOMPARE(writer.flushSize(), qsizetype(128));
+
+        QCborStreamWriter &stream = writer.stream();
+        stream.startArray();
+        for (int i = 0; i < 100; ++i) {
+            stream.startMap(2);
+            stream.append(u"id"_s);
+            stream.append(qint64(i));
+            stream.append(u"name"_s);
+            stream.append(u"item "_s + QString::number(i));
+            stream.endMap();
+
+            expected.append(QCborMap{{u"id"_s, i}, {u"name"_s, u"item "_s + QString::number(i)}});
+        }
+        writer.append(QCborMap{{u"last"_s, true}});
+        expected.append(QCborMap{{u"last"_s, true}});
+
+        // Blocks are written while the items are produced
+        QVERIFY(buffer.size() > 0);
+
+        stream.endArray();
+    }
+
+    QCOMPARE(QCborValue::fromCbor(buffer.data()), QCborValue(expected));
+}
+
+void TestResponse::testETag()
+{
+    const QString path = u"/response/test/autoETag"_s;
+
+    auto result = m_engine->createRequest("GET", path, "data=Hello"_ba, {}, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, "Hello"_ba);
+    const QByteArray etag = result.headers.header("ETag");
+    QVERIFY(etag.size() > 2);
+    QVERIFY(etag.startsWith('"'));
+
+    Headers headers;
+    headers.setHeader("If-None-Match"_ba, "\"other\", "_ba + etag);
+    result = m_engine->createRequest("GET", path, "data=Hello"_ba, headers, nullptr);
+    QCOMPARE(result.statusCode, Response::NotModified);
+    QVERIFY(result.body.isEmpty());
+    QCOMPARE(result.headers.header("ETag"), etag);
+
+    // A different body gets a different ETag
+    result = m_engine->createRequest("GET", path, "data=World"_ba, headers, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, "World"_ba);
+    QVERIFY(result.headers.header("ETag") != etag);
+
+    // Only safe methods are answered with 304
+    result = m_engine->createRequest("POST", path, "data=Hello"_ba, headers, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, "Hello"_ba);
+
+    // Disabled by default
+    result = m_engine->createRequest(
+        "GET", u"/response/test/contentLength"_s, "data=Hello"_ba, {}, nullptr);
+    QVERIFY(!result.headers.contains("ETag"));
+}
+
+void TestResponse::testETagVersion()
+{
+    const QString path = u"/response/test/etagVersion"_s;
+
+    auto result = m_engine->createRequest("GET", path, "version=1"_ba, {}, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, "rendered"_ba);
+    const QByteArray etag = result.headers.header("ETag");
+    QVERIFY(etag.size() > 2);
+
+    Headers headers;
+    headers.setHeader("If-None-Match"_ba, "W/"_ba + etag);
+    result = m_engine->createRequest("GET", path, "version=1"_ba, headers, nullptr);
+    QCOMPARE(result.statusCode, Response::NotModified);
+    QVERIFY(result.body.isEmpty());
+
+    result = m_engine->createRequest("GET", path, "version=2"_ba, headers, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, "rendered"_ba);
+}
+
 QTEST_MAIN(TestResponse)
 
 #include "testresponse.moc"
@@ -0,0 +1,384 @@
+#ifndef TESTRESPONSECACHE_H
+#define TESTRESPONSECACHE_H
+
+#include "coverageobject.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Controller>
+#include <Cutelyst/Plugins/ResponseCache/ResponseCache>
+#include <Cutelyst/Plugins/ResponseCache/ResponseCacheMemoryStore>
+#ifdef CUTELYST_RESPONSECACHE_WITH_SHAREDMEMORY
+#    include <Cutelyst/Plugins/Cache/SharedMemoryCache>
+#    include <Cutelyst/Plugins/ResponseCache/ResponseCacheSharedMemoryStore>
+#endif
+
+#include <QNetworkCookie>
+#include <QTest>
+#include <QTimer>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+using namespace std::chrono_literals;
+
+class TestResponseCache : public CoverageObject
+{
+    Q_OBJECT
+public:
+    explicit TestResponseCache(QObject *parent = nullptr)
+        : CoverageObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testMemoryStore();
+
+    void testCache_data();
+    void testCache();
+
+    void testNotStored_data();
+    void testNotStored();
+
+    void testVary();
+    void testTags();
+    void testStaleIfError();
+    void testCoalesce();
+#ifdef CUTELYST_RESPONSECACHE_WITH_SHAREDMEMORY
+    void testSharedMemoryStore();
+#endif
+
+    void cleanupTestCase();
+
+private:
+    TestEngine *m_engine   = nullptr;
+    ResponseCache *m_cache = nullptr;
+
+    TestEngine *getEngine();
+};
+
+class ResponseCacheTest : public Controller
+{
+    Q_OBJECT
+public:
+    explicit ResponseCacheTest(QObject *parent)
+        : Controller(parent)
+    {
+    }
+
+    static inline int count = 0;
+    static inline bool fail = false;
+
+    C_ATTR(counter, :Local :AutoArgs)
+    void counter(Context *c)
+    {
+        c->res()->setContentType("text/plain"_ba);
+        c->res()->setBody(QByteArray::number(++count));
+    }
+
+    C_ATTR(query, :Local :AutoArgs)
+    void query(Context *c) { counter(c); }
+
+    C_ATTR(vary, :Local :AutoArgs)
+    void vary(Context *c)
+    {
+        c->res()->headers().setHeader("Vary"_ba, "Accept-Language"_ba);
+        c->res()->setBody(c->req()->header("Accept-Language") + QByteArray::number(++count));
+    }
+
+    C_ATTR(tagged, :Local :AutoArgs)
+    void tagged(Context *c)
+    {
+        ResponseCache::addTags(c, {u"items"_s});
+        counter(c);
+    }
+
+    C_ATTR(priv, :Local :AutoArgs)
+    void priv(Context *c)
+    {
+        c->res()->headers().setHeader("Cache-Control"_ba, "private"_ba);
+        counter(c);
+    }
+
+    C_ATTR(skip, :Local :AutoArgs)
+    void skip(Context *c)
+    {
+        ResponseCache::skip(c);
+        counter(c);
+    }
+
+    C_ATTR(cookie, :Local :AutoArgs)
+    void cookie(Context *c)
+    {
+        c->res()->setCookie(QNetworkCookie("id"_ba, "1"_ba));
+        counter(c);
+    }
+
+    C_ATTR(stream, :Local :AutoArgs)
+    void stream(Context *c) { c->res()->write(QByteArray::number(++count)); }
+
+    C_ATTR(error, :Local :AutoArgs)
+    void error(Context *c)
+    {
+        c->res()->setStatus(Response::InternalServerError);
+        counter(c);
+    }
+
+    C_ATTR(slow, :Local :AutoArgs)
+    void slow(Context *c)
+    {
+        ASync async(c);
+        QTimer::singleShot(50ms, c, [this, c, async] { counter(c); });
+    }
+
+    C_ATTR(stale, :Local :AutoArgs)
+    void stale(Context *c)
+    {
+        if (fail) {
+            c->appendError(u"failed"_s);
+            return;
+        }
+        counter(c);
+    }
+};
+
+void TestResponseCache::initTestCase()
+{
+    m_engine = getEngine();
+    QVERIFY(m_engine);
+}
+
+TestEngine *TestResponseCache::getEngine()
+{
+    auto app    = new TestApplication;
+    auto engine = new TestEngine(app, {});
+    m_cache     = new ResponseCache(app, {{u"paths"_s, u"/response/cache/test"_s}});
+    m_cache->addPath(u"/response/cache/test/query"_s, {.queryParams = {u"page"_s}});
+    m_cache->addPath(u"/response/cache/test/stale"_s, {.ttl = 0s, .staleIfError = 60s});
+    new ResponseCacheTest(app);
+    if (!engine->init()) {
+        return nullptr;
+    }
+    return engine;
+}
+
+void TestResponseCache::cleanupTestCase()
+{
+    delete m_engine;
+    m_engine = nullptr;
+}
+
+void TestResponseCache::testMemoryStore()
+{
+    ResponseCacheMemoryStore store;
+    QVERIFY(store.get("key"_ba).isNull());
+    QVERIFY(store.set("key"_ba, "value"_ba, 0s));
+    QCOMPARE(store.get("key"_ba), "value"_ba);
+    QVERIFY(!store.add("key"_ba, "other"_ba, 0s));
+    QCOMPARE(store.get("key"_ba), "value"_ba);
+    QVERIFY(store.remove("key"_ba));
+    QVERIFY(store.add("key"_ba, "other"_ba, 0s));
+    QCOMPARE(store.get("key"_ba), "other"_ba);
+
+    // Each of the 16 shards gets 64 bytes
+    const qint64 maxCost = ResponseCacheMemoryStore::maxCost();
+    ResponseCacheMemoryStore::setMaxCost(16 * 64);
+    QVERIFY(!store.set("big"_ba, QByteArray(64, 'x'), 0s));
+    QVERIFY(store.set("big"_ba, QByteArray(32, 'x'), 0s));
+    QVERIFY(ResponseCacheMemoryStore::totalCost() <= 16 * 64);
+
+    ResponseCacheMemoryStore::clear();
+    QCOMPARE(ResponseCacheMemoryStore::totalCost(), qint64(0));
+    QVERIFY(store.get("big"_ba).isNull());
+    ResponseCacheMemoryStore::setMaxCost(maxCost);
+}
+
+void TestResponseCache::testCache_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QByteArray>("query");
+    QTest::addColumn<QByteArray>("method");
+    QTest::addColumn<QByteArray>("output");
+
+    QTest::newRow("miss") << u"/response/cache/test/counter"_s << QByteArray() << "GET"_ba
+                          << "1"_ba;
+    QTest::newRow("hit") << u"/response/cache/test/counter"_s << QByteArray() << "GET"_ba
+                         << "1"_ba;
+    QTest::newRow("query-miss") << u"/response/cache/test/counter"_s << "a=1"_ba << "GET"_ba
+                                << "2"_ba;
+    QTest::newRow("query-hit") << u"/response/cache/test/counter"_s << "a=1"_ba << "GET"_ba
+                               << "2"_ba;
+    QTest::newRow("selected-miss")
+        << u"/response/cache/test/query"_s << "page=1&utm=a"_ba << "GET"_ba << "3"_ba;
+    QTest::newRow("selected-hit")
+        << u"/response/cache/test/query"_s << "utm=b&page=1"_ba << "GET"_ba << "3"_ba;
+    QTest::newRow("selected-other")
+        << u"/response/cache/test/query"_s << "page=2"_ba << "GET"_ba << "4"_ba;
+    QTest::newRow("post") << u"/response/cache/test/counter"_s << QByteArray() << "POST"_ba
+                          << "5"_ba;
+}
+
+void TestResponseCache::testCache()
+{
+    QFETCH(QString, path);
+    QFETCH(QByteArray, query);
+    QFETCH(QByteArray, method);
+    QFETCH(QByteArray, output);
+
+    if (QByteArrayView(QTest::currentDataTag()) == "miss") {
+        ResponseCacheMemoryStore::clear();
+        ResponseCacheTest::count = 0;
+    }
+
+    const auto result = m_engine->createRequest(method, path, query, {}, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, output);
+    const bool hit = QByteArrayView(QTest::currentDataTag()).endsWith("hit");
+    QCOMPARE(result.headers.contains("Age"), hit);
+}
+
+void TestResponseCache::testNotStored_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QByteArray>("cookie");
+
+    QTest::newRow("private") << u"/response/cache/test/priv"_s << QByteArray();
+    QTest::newRow("skip") << u"/response/cache/test/skip"_s << QByteArray();
+    QTest::newRow("set-cookie") << u"/response/cache/test/cookie"_s << QByteArray();
+    QTest::newRow("stream") << u"/response/cache/test/stream"_s << QByteArray();
+    QTest::newRow("error") << u"/response/cache/test/error"_s << QByteArray();
+    QTest::newRow("cookie") << u"/response/cache/test/counter"_s << "id=1"_ba;
+}
+
+void TestResponseCache::testNotStored()
+{
+    QFETCH(QString, path);
+    QFETCH(QByteArray, cookie);
+
+    ResponseCacheMemoryStore::clear();
+
+    Headers headers;
+    if (!cookie.isEmpty()) {
+        headers.setHeader("Cookie"_ba, cookie);
+    }
+
+    const auto first  = m_engine->createRequest("GET", path, {}, headers, nullptr);
+    const auto second = m_engine->createRequest("GET", path, {}, headers, nullptr);
+    QVERIFY(first.body != second.body);
+    QVERIFY(!second.headers.contains("Age"));
+}
+
+void TestResponseCache::testVary()
+{
+    ResponseCacheMemoryStore::clear();
+    ResponseCacheTest::count = 0;
+
+    const QString path = u"/response/cache/test/vary"_s;
+    auto request       = [this, &path](const QByteArray &language) {
+        Headers headers;
+        headers.setHeader("Accept-Language"_ba, language);
+        return m_engine->createRequest("GET", path, {}, headers, nullptr).body;
+    };
+
+    QCOMPARE(request("pt"_ba), "pt1"_ba);
+    QCOMPARE(request("en"_ba), "en2"_ba);
+    QCOMPARE(request("pt"_ba), "pt1"_ba);
+    QCOMPARE(request("en"_ba), "en2"_ba);
+}
+
+void TestResponseCache::testTags()
+{
+    ResponseCacheMemoryStore::clear();
+    ResponseCacheTest::count = 0;
+
+    const QString path = u"/response/cache/test/tagged"_s;
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "1"_ba);
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "1"_ba);
+
+    m_cache->invalidateTags({u"other"_s});
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "1"_ba);
+
+    m_cache->invalidateTags({u"items"_s});
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "2"_ba);
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "2"_ba);
+}
+
+void TestResponseCache::testStaleIfError()
+{
+    ResponseCacheMemoryStore::clear();
+    ResponseCacheTest::count = 0;
+
+    // Responses of this path are stale right away
+    const QString path = u"/response/cache/test/stale"_s;
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "1"_ba);
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "2"_ba);
+
+    ResponseCacheTest::fail = true;
+    const auto result       = m_engine->createRequest("GET", path, {}, {}, nullptr);
+    ResponseCacheTest::fail = false;
+    QCOMPARE(result.statusCode, Response::OK);
+    QCOMPARE(result.body, "2"_ba);
+    QVERIFY(result.headers.contains("Age"));
+
+    QCOMPARE(m_engine->createRequest("GET", path, {}, {}, nullptr).body, "3"_ba);
+}
+
+void TestResponseCache::testCoalesce()
+{
+    ResponseCacheMemoryStore::clear();
+    ResponseCacheTest::count = 0;
+
+    // Arrives while the first request waits for its timer
+    const QString path = u"/response/cache/test/slow"_s;
+    TestEngine::TestResponse second;
+    QTimer::singleShot(10ms, this, [this, &path, &second] {
+        second = m_engine->createRequest("GET", path, {}, {}, nullptr);
+    });
+    const auto first = m_engine->createRequest("GET", path, {}, {}, nullptr);
+
+    QCOMPARE(first.body, "1"_ba);
+    QVERIFY(!first.headers.contains("Age"));
+    QCOMPARE(second.statusCode, Response::OK);
+    QCOMPARE(second.body, "1"_ba);
+    QVERIFY(second.headers.contains("Age"));
+    QCOMPARE(ResponseCacheTest::count, 1);
+}
+
+#ifdef CUTELYST_RESPONSECACHE_WITH_SHAREDMEMORY
+void TestResponseCache::testSharedMemoryStore()
+{
+    auto app    = new TestApplication;
+    auto engine = new TestEngine(app, {});
+    new SharedMemoryCache(app, {{u"size"_s, 256 * 1024}, {u"shards"_s, 2}});
+    auto cache = new ResponseCache(app, {{u"paths"_s, u"/response/cache/test"_s}});
+    cache->setStorage(std::make_unique<ResponseCacheSharedMemoryStore>());
+    new ResponseCacheTest(app);
+    QVERIFY(engine->init());
+
+    ResponseCacheTest::count = 0;
+
+    const QString path = u"/response/cache/test/tagged"_s;
+    const auto miss    = engine->createRequest("GET", path, {}, {}, nullptr);
+    QCOMPARE(miss.body, "1"_ba);
+    QVERIFY(!miss.headers.contains("Age"));
+    QVERIFY(SharedMemoryCache::stats().count > 0);
+
+    const auto hit = engine->createRequest("GET", path, {}, {}, nullptr);
+    QCOMPARE(hit.body, "1"_ba);
+    QVERIFY(hit.headers.contains("Age"));
+
+    // Tag versions are kept in the shared memory too
+    cache->invalidateTags({u"items"_s});
+    QCOMPARE(engine->createRequest("GET", path, {}, {}, nullptr).body, "2"_ba);
+    QCOMPARE(engine->createRequest("GET", path, {}, {}, nullptr).body, "2"_ba);
+    QCOMPARE(ResponseCacheTest::count, 2);
+
+    delete engine;
+}
+#endif
+
+QTEST_MAIN(TestResponseCache)
+
+#include "testresponsecache.moc"
+
+#endif // TESTRESPONSECACHE_H
@@ -0,0 +1,203 @@
+#ifndef TESTSINGLEFLIGHT_H
+#define TESTSINGLEFLIGHT_H
+
+#include "coverageobject.h"
+
+#include <Cutelyst/Application>
+#include <Cutelyst/Controller>
+#include <Cutelyst/CoroContext.h>
+#include <Cutelyst/SingleFlight>
+
+#include <QTest>
+#include <QTimer>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+using namespace std::chrono_literals;
+
+class TestSingleFlight : public CoverageObject
+{
+    Q_OBJECT
+public:
+    explicit TestSingleFlight(QObject *parent = nullptr)
+        : CoverageObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testRun();
+    void testError();
+    void testDropped();
+    void testCoroutine();
+    void testReady();
+
+    void cleanupTestCase();
+
+private:
+    TestEngine *m_engine = nullptr;
+
+    TestEngine *getEngine();
+
+    // Sends a second request while the first one is loading
+    std::pair<QByteArray, QByteArray> concurrent(const QString &path);
+};
+
+class SingleFlightTest : public Controller
+{
+    Q_OBJECT
+public:
+    explicit SingleFlightTest(QObject *parent)
+        : Controller(parent)
+    {
+    }
+
+    static inline int loads = 0;
+    static inline QString error;
+
+    // Finishes later, letting other requests join
+    static SingleFlight::Loader loader(Context *c)
+    {
+        return [c](SingleFlight::Callback done) {
+            ++loads;
+            QTimer::singleShot(50ms, c, [done] {
+                if (error.isEmpty()) {
+                    done({QByteArray::number(loads), {}});
+                } else {
+                    done({{}, error});
+                }
+            });
+        };
+    }
+
+    static void setBody(Context *c, const SingleFlight::Result &result)
+    {
+        c->res()->setBody(result.hasError() ? result.error.toUtf8() : result.value.toByteArray());
+    }
+
+    C_ATTR(load, :Local :AutoArgs)
+    void load(Context *c)
+    {
+        SingleFlight::run(c, "load"_ba, loader(c), [c](const SingleFlight::Result &result) {
+            setBody(c, result);
+        });
+    }
+
+    C_ATTR(dropped, :Local :AutoArgs)
+    void dropped(Context *c)
+    {
+        SingleFlight::run(
+            c,
+            "dropped"_ba,
+            [](SingleFlight::Callback done) { Q_UNUSED(done) },
+            [c](const SingleFlight::Result &result) { setBody(c, result); });
+    }
+
+    C_ATTR(coLoad, :Local :AutoArgs)
+    CoroContext coLoad(Context *c)
+    {
+        const auto result = co_await SingleFlight::coRun(c, "coLoad"_ba, loader(c));
+        setBody(c, result);
+    }
+
+    C_ATTR(ready, :Local :AutoArgs)
+    CoroContext ready(Context *c)
+    {
+        const auto result = co_await SingleFlight::coRun(
+            c, "ready"_ba, [](SingleFlight::Callback done) { done({"ready"_ba, {}}); });
+        setBody(c, result);
+    }
+};
+
+void TestSingleFlight::initTestCase()
+{
+    m_engine = getEngine();
+    QVERIFY(m_engine);
+}
+
+TestEngine *TestSingleFlight::getEngine()
+{
+    auto app    = new TestApplication;
+    auto engine = new TestEngine(app, {});
+    new SingleFlightTest(app);
+    if (!engine->init()) {
+        return nullptr;
+    }
+    return engine;
+}
+
+void TestSingleFlight::cleanupTestCase()
+{
+    delete m_engine;
+    m_engine = nullptr;
+}
+
+std::pair<QByteArray, QByteArray> TestSingleFlight::concurrent(const QString &path)
+{
+    QByteArray second;
+    QTimer::singleShot(10ms, this, [this, &path, &second] {
+        second = m_engine->createRequest("GET", path, {}, {}, nullptr).body;
+    });
+    const QByteArray first = m_engine->createRequest("GET", path, {}, {}, nullptr).body;
+    return {first, second};
+}
+
+void TestSingleFlight::testRun()
+{
+    SingleFlightTest::loads = 0;
+
+    const auto [first, second] = concurrent(u"/single/flight/test/load"_s);
+    QCOMPARE(first, "1"_ba);
+    QCOMPARE(second, "1"_ba);
+    QCOMPARE(SingleFlightTest::loads, 1);
+    QVERIFY(!SingleFlight::isRunning("load"_ba));
+
+    // Results are not kept
+    QCOMPARE(m_engine->createRequest("GET", u"/single/flight/test/load"_s, {}, {}, nullptr).body,
+             "2"_ba);
+}
+
+void TestSingleFlight::testError()
+{
+    SingleFlightTest::loads = 0;
+    SingleFlightTest::error = u"failed"_s;
+
+    const auto [first, second] = concurrent(u"/single/flight/test/load"_s);
+    SingleFlightTest::error.clear();
+    QCOMPARE(first, "failed"_ba);
+    QCOMPARE(second, "failed"_ba);
+    QCOMPARE(SingleFlightTest::loads, 1);
+}
+
+void TestSingleFlight::testDropped()
+{
+    const auto result =
+        m_engine->createRequest("GET", u"/single/flight/test/dropped"_s, {}, {}, nullptr);
+    QCOMPARE(result.statusCode, Response::OK);
+    // The leader gets the same error as the waiters
+    QCOMPARE(result.body, "The loader did not finish"_ba);
+    QVERIFY(!SingleFlight::isRunning("dropped"_ba));
+}
+
+void TestSingleFlight::testCoroutine()
+{
+    SingleFlightTest::loads = 0;
+
+    const auto [first, second] = concurrent(u"/single/flight/test/coLoad"_s);
+    QCOMPARE(first, "1"_ba);
+    QCOMPARE(second, "1"_ba);
+    QCOMPARE(SingleFlightTest::loads, 1);
+}
+
+void TestSingleFlight::testReady()
+{
+    QCOMPARE(m_engine->createRequest("GET", u"/single/flight/test/ready"_s, {}, {}, nullptr).body,
+             "ready"_ba);
+}
+
+QTEST_MAIN(TestSingleFlight)
+
+#include "testsingleflight.moc"
+
+#endif // TESTSINGLEFLIGHT_H
@@ -41,6 +41,7 @@ private Q_SLOTS:
     void testFileNotFoundFromForcedDirsOnly();
     void testFileNotInForcedDirsOnly();
     void testControllerPath();
+    void testBackgroundCompression();
 
 private:
     TestEngine *m_engine{nullptr};
@@ -49,7 +50,7 @@ private:
     static const QStringList types;
     static const QByteArrayList encoding;
 
-    TestEngine *getEngine(bool serveDirsOnly = false);
+    TestEngine *getEngine(bool serveDirsOnly = false, bool preCompress = false);
 
     TestEngine::TestResponse getFile(const QString &path, const Headers &headers = {});
     TestEngine::TestResponse getForcedFile(const QString &path, const Headers &headers = {});
@@ -84,7 +85,7 @@ void TestStaticCompressed::initTestCase()
     QVERIFY(m_engineDirsOnly);
 }
 
-TestEngine *TestStaticCompressed::getEngine(bool serveDirsOnly)
+TestEngine *TestStaticCompressed::getEngine(bool serveDirsOnly, bool preCompress)
 {
     auto app    = new TestApplication;
     auto engine = new TestEngine(app, {});
@@ -93,7 +94,8 @@ TestEngine *TestStaticCompressed::getEngine(bool serveDirsOnly)
                                     {u"brotli_quality_level"_s, 0},
                                     {u"use_zopfli"_s, true},
                                     {u"zopfli_iterations"_s, 5},
-                                    {u"zstd_compression_level"_s, 1}};
+                                    {u"zstd_compression_level"_s, 1},
+                                    {u"pre_compress"_s, preCompress}};
 
     auto plug = new StaticCompressed(app, defaultConfig);
     plug->setIncludePaths({m_dataDir.path()});
@@ -361,6 +363,29 @@ void TestStaticCompressed::testControllerPath()
     QCOMPARE(resp.statusCode, Response::OK);
 }
 
+/**
+ * @internal
+ * Test that files are compressed in the background and that new files are picked up.
+ */
+void TestStaticCompressed::testBackgroundCompression()
+{
+    QVERIFY(writeTestFile(u"background.css"_s));
+
+    std::unique_ptr<TestEngine> engine(getEngine(false, true));
+    QVERIFY(engine);
+
+    const Headers headers({{"Accept-Encoding", "gzip"}});
+    QTRY_COMPARE(
+        engine->createRequest("GET", u"/background.css"_s, {}, headers, nullptr).headers.header(
+            "Content-Encoding"),
+        "gzip"_ba);
+
+    QVERIFY(writeTestFile(u"background-new.css"_s));
+    QTRY_COMPARE(engine->createRequest("GET", u"/background-new.css"_s, {}, headers, nullptr)
+                     .headers.header("Content-Encoding"),
+                 "gzip"_ba);
+}
+
 QTEST_MAIN(TestStaticCompressed)
 
 // NOLINTEND(cppcoreguidelines-avoid-do-while)
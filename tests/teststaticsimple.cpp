@@ -4,6 +4,7 @@
 #include "coverageobject.h"
 
 #include <Cutelyst/Plugins/StaticSimple/staticsimple.h>
+#include <Cutelyst/StaticFileCache>
 
 #include <QDir>
 #include <QFile>
@@ -34,6 +35,11 @@ private Q_SLOTS:
     void testFileNotFoundFomForcedDirs();
     void testGetFileFromForcedDirs();
     void testLastModifiedSince();
+    void testCache();
+    void testCacheOpenFile();
+    void testRange_data();
+    void testRange();
+    void testMultiRange();
     void testGetFileFromForcedDirsOnly();
     void testFileNotFoundFromForcedDirsOnly();
     void testFileNotInForcedDirsOnly();
@@ -49,6 +55,7 @@ private:
     TestEngine::TestResponse getFile(const QString &path, const Headers &headers = {});
     TestEngine::TestResponse getForcedFile(const QString &path, const Headers &headers = {});
     bool writeTestFile(const QString &name);
+    bool writeFile(const QString &name, const QByteArray &data);
 };
 
 void TestStaticSimple::initTestCase()
@@ -113,6 +120,16 @@ bool TestStaticSimple::writeTestFile(const QString &name)
     return true;
 }
 
+bool TestStaticSimple::writeFile(const QString &name, const QByteArray &data)
+{
+    QFile f(m_dataDir.filePath(name));
+    if (!f.open(QIODeviceBase::WriteOnly | QIODeviceBase::Truncate)) {
+        qCritical() << "Failed to open test file for writing:" << f.errorString();
+        return false;
+    }
+    return f.write(data) == data.size();
+}
+
 void TestStaticSimple::cleanupTestCase()
 {
     delete m_engine;
@@ -169,6 +186,151 @@ void TestStaticSimple::testLastModifiedSince()
     QCOMPARE(resp.statusCode, Response::NotModified);
 }
 
+void TestStaticSimple::testCache()
+{
+    auto cache = StaticFileCache::instance();
+    QVERIFY(writeFile(u"cached.css"_s, "body { color: red; }"_ba));
+
+    auto resp = getFile(u"/cached.css"_s);
+    QCOMPARE(resp.statusCode, Response::OK);
+    QCOMPARE(resp.body, "body { color: red; }"_ba);
+    QCOMPARE(resp.headers.contentType(), "text/css"_ba);
+    const QByteArray etag = resp.headers.header("ETag");
+    QVERIFY(etag.startsWith('"'));
+    QVERIFY(cache->count() > 0);
+    QVERIFY(cache->totalCost() >= resp.body.size());
+
+    resp = getFile(u"/cached.css"_s, {{"If-None-Match", "W/" + etag}});
+    QCOMPARE(resp.statusCode, Response::NotModified);
+    QCOMPARE(resp.headers.header("ETag"), etag);
+
+    resp = getFile(u"/cached.css"_s, {{"If-None-Match", "\"other\""_ba}});
+    QCOMPARE(resp.statusCode, Response::OK);
+
+    resp = getFile(u"/cached.css"_s, {{"If-None-Match", "\"other\", "_ba + etag}});
+    QCOMPARE(resp.statusCode, Response::NotModified);
+
+    // The cached copy is dropped once the file changes
+    QVERIFY(writeFile(u"cached.css"_s, "body { color: blue; }"_ba));
+    QTRY_COMPARE(getFile(u"/cached.css"_s).body, "body { color: blue; }"_ba);
+
+    QVERIFY(QFile::remove(m_dataDir.filePath(u"cached.css"_s)));
+    QTRY_VERIFY(getFile(u"/cached.css"_s).statusCode >= Response::BadRequest);
+
+    cache->clear();
+    QCOMPARE(cache->count(), 0);
+    QCOMPARE(cache->totalCost(), 0);
+}
+
+void TestStaticSimple::testCacheOpenFile()
+{
+    auto cache               = StaticFileCache::instance();
+    const qint64 maxFileSize = cache->maxFileSize();
+    cache->setMaxFileSize(16);
+
+    const QByteArray data = "console.log('Larger than 16 bytes');\n"_ba.repeated(4096);
+    QVERIFY(writeFile(u"large.js"_s, data));
+
+    // Served twice from the same open file
+    for (int i = 0; i < 2; ++i) {
+        const auto resp = getFile(u"/large.js"_s);
+        QCOMPARE(resp.statusCode, Response::OK);
+        QCOMPARE(resp.headers.contentLength(), data.size());
+        QCOMPARE(resp.body, data);
+    }
+    QCOMPARE(cache->totalCost(), 0);
+
+    const auto resp = getFile(u"/large.js"_s, {{"Range", "bytes=70000-70009"}});
+    QCOMPARE(resp.statusCode, Response::PartialContent);
+    QCOMPARE(resp.body, data.mid(70000, 10));
+
+    cache->setMaxOpenFiles(0);
+    QCOMPARE(cache->count(), 0);
+    QCOMPARE(getFile(u"/large.js"_s).body, data);
+    QCOMPARE(cache->count(), 0);
+
+    cache->setMaxOpenFiles(64);
+    cache->setMaxFileSize(maxFileSize);
+}
+
+void TestStaticSimple::testRange_data()
+{
+    QTest::addColumn<QByteArray>("range");
+    QTest::addColumn<bool>("ifRange");
+    QTest::addColumn<int>("status");
+    QTest::addColumn<QByteArray>("contentRange");
+    QTest::addColumn<QByteArray>("body");
+
+    QTest::newRow("first") << "bytes=0-4"_ba << false << int(Response::PartialContent)
+                           << "bytes 0-4/26"_ba << "abcde"_ba;
+    QTest::newRow("middle") << "bytes=10-12"_ba << false << int(Response::PartialContent)
+                            << "bytes 10-12/26"_ba << "klm"_ba;
+    QTest::newRow("open") << "bytes=20-"_ba << false << int(Response::PartialContent)
+                          << "bytes 20-25/26"_ba << "uvwxyz"_ba;
+    QTest::newRow("suffix") << "bytes=-3"_ba << false << int(Response::PartialContent)
+                            << "bytes 23-25/26"_ba << "xyz"_ba;
+    QTest::newRow("past-end") << "bytes=24-100"_ba << false << int(Response::PartialContent)
+                              << "bytes 24-25/26"_ba << "yz"_ba;
+    QTest::newRow("if-range") << "bytes=0-1"_ba << true << int(Response::PartialContent)
+                              << "bytes 0-1/26"_ba << "ab"_ba;
+    QTest::newRow("unsatisfiable") << "bytes=26-30"_ba << false
+                                   << int(Response::RequestedRangeNotSatisfiable)
+                                   << "bytes */26"_ba << QByteArray();
+    QTest::newRow("invalid") << "bytes=5-2"_ba << false << int(Response::OK) << QByteArray()
+                             << "abcdefghijklmnopqrstuvwxyz"_ba;
+    QTest::newRow("unit") << "items=0-1"_ba << false << int(Response::OK) << QByteArray()
+                          << "abcdefghijklmnopqrstuvwxyz"_ba;
+}
+
+void TestStaticSimple::testRange()
+{
+    QFETCH(QByteArray, range);
+    QFETCH(bool, ifRange);
+    QFETCH(int, status);
+    QFETCH(QByteArray, contentRange);
+    QFETCH(QByteArray, body);
+
+    QVERIFY(writeFile(u"range.txt"_s, "abcdefghijklmnopqrstuvwxyz"_ba));
+    const auto full = getFile(u"/range.txt"_s);
+    QCOMPARE(full.headers.header("Accept-Ranges"), "bytes"_ba);
+
+    Headers headers{{"Range", range}};
+    if (ifRange) {
+        headers.setHeader("If-Range"_ba, full.headers.header("ETag"));
+    }
+
+    const auto resp = getFile(u"/range.txt"_s, headers);
+    QCOMPARE(resp.statusCode, status);
+    QCOMPARE(resp.headers.header("Content-Range"), contentRange);
+    QCOMPARE(resp.headers.contentLength(), body.size());
+    QCOMPARE(resp.body, body);
+
+    // A stale validator gets the whole file
+    headers.setHeader("If-Range"_ba, "\"stale\""_ba);
+    QCOMPARE(getFile(u"/range.txt"_s, headers).statusCode, Response::OK);
+}
+
+void TestStaticSimple::testMultiRange()
+{
+    QVERIFY(writeFile(u"multirange.txt"_s, "abcdefghijklmnopqrstuvwxyz"_ba));
+
+    const auto resp = getFile(u"/multirange.txt"_s, {{"Range", "bytes=0-1, -2"}});
+    QCOMPARE(resp.statusCode, Response::PartialContent);
+
+    const QByteArray contentType = resp.headers.header("Content-Type");
+    QVERIFY(contentType.startsWith("multipart/byteranges; boundary="));
+    const QByteArray boundary = contentType.mid(contentType.indexOf('=') + 1);
+
+    const auto part = [&boundary](const QByteArray &range, const QByteArray &data) {
+        return "\r\n--" + boundary + "\r\nContent-Type: text/plain\r\nContent-Range: bytes " +
+               range + "\r\n\r\n" + data;
+    };
+    const QByteArray expected =
+        part("0-1/26"_ba, "ab"_ba) + part("24-25/26"_ba, "yz"_ba) + "\r\n--" + boundary + "--\r\n";
+    QCOMPARE(resp.body, expected);
+    QCOMPARE(resp.headers.contentLength(), expected.size());
+}
+
 /**
  * @internal
  * Test for a file that is below a path that is set to TestStaticSimple::setDirs()
@@ -0,0 +1,258 @@
+#ifndef CUTELEEVIEWTEST_H
+#define CUTELEEVIEWTEST_H
+
+#include "coverageobject.h"
+
+#include <Cutelyst/Plugins/View/Cutelee/cuteleeview.h>
+#include <Cutelyst/application.h>
+#include <Cutelyst/controller.h>
+#include <cutelee/engine.h>
+#include <cutelee/template.h>
+
+#include <QFile>
+#include <QLocale>
+#include <QTemporaryDir>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QtCore/QObject>
+#include <QtTest/QTest>
+
+using namespace Cutelyst;
+using namespace Qt::Literals::StringLiterals;
+
+class TestViewCutelee : public Controller
+{
+    Q_OBJECT
+public:
+    explicit TestViewCutelee(QObject *parent)
+        : Controller(parent)
+    {
+    }
+
+    C_ATTR(render, :Local)
+    void render(Context *c)
+    {
+        const QString locale = c->req()->queryParam(u"locale"_s);
+        if (!locale.isEmpty()) {
+            c->setLocale(QLocale(locale));
+        }
+        c->setStash(u"template"_s, c->req()->queryParam(u"template"_s));
+        c->setStash(u"items"_s, QVariantList{1, 2, 3});
+        c->setStash(u"number"_s, 1234.5);
+        c->forward(c->view(c->req()->queryParam(u"view"_s)));
+    }
+};
+
+class TestCuteleeView : public CoverageObject
+{
+    Q_OBJECT
+public:
+    explicit TestCuteleeView(QObject *parent = nullptr)
+        : CoverageObject(parent)
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testController_data();
+    void testController() { doTest(); }
+
+    void testPreloadedCache();
+    void testLocalizer();
+    void testStreaming();
+    void testStreamingError();
+    void testWrapperError();
+
+    void cleanupTestCase();
+
+private:
+    TestEngine *m_engine = nullptr;
+    QTemporaryDir m_templates;
+
+    TestEngine *getEngine();
+
+    void writeTemplate(const QString &name, const QByteArray &data);
+    TestEngine::TestResponse request(const QString &view,
+                                     const QString &templateName,
+                                     const QString &locale = {});
+    QByteArray render(const QString &view, const QString &templateName);
+
+    void doTest();
+};
+
+void TestCuteleeView::initTestCase()
+{
+    QVERIFY(m_templates.isValid());
+    writeTemplate(u"cycle.html"_s, "{% for i in items %}{% cycle 'a' 'b' %}{% endfor %}");
+    writeTemplate(u"base.html"_s, "<{% block content %}base{% endblock %}>");
+    writeTemplate(u"child.html"_s,
+                  "{% extends \"base.html\" %}{% block content %}child{% endblock %}");
+    writeTemplate(u"number.html"_s, "{{ number }}");
+    writeTemplate(u"big.html"_s, QByteArray(100 * 1024, 'x'));
+    writeTemplate(u"fail.html"_s, "before{% include \"missing.html\" %}after");
+
+    m_engine = getEngine();
+    QVERIFY(m_engine);
+}
+
+TestEngine *TestCuteleeView::getEngine()
+{
+    auto app    = new TestApplication;
+    auto engine = new TestEngine(app, QVariantMap());
+    new TestViewCutelee(app);
+
+    auto view = new CuteleeView(app, u"plain"_s);
+    view->setIncludePaths({m_templates.path()});
+
+    auto cached = new CuteleeView(app, u"cached"_s);
+    cached->setIncludePaths({m_templates.path()});
+    cached->preloadTemplates();
+
+    auto stream = new CuteleeView(app, u"stream"_s);
+    stream->setIncludePaths({m_templates.path()});
+    stream->setStreaming(true);
+
+    auto wrapped = new CuteleeView(app, u"wrapped"_s);
+    wrapped->setIncludePaths({m_templates.path()});
+    wrapped->setWrapper(u"missing-wrapper.html"_s);
+
+    if (!engine->init()) {
+        return nullptr;
+    }
+    return engine;
+}
+
+void TestCuteleeView::cleanupTestCase()
+{
+    delete m_engine;
+}
+
+void TestCuteleeView::writeTemplate(const QString &name, const QByteArray &data)
+{
+    QFile file(m_templates.filePath(name));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(data);
+}
+
+TestEngine::TestResponse TestCuteleeView::request(const QString &view,
+                                                  const QString &templateName,
+                                                  const QString &locale)
+{
+    QUrlQuery query;
+    query.addQueryItem(u"view"_s, view);
+    query.addQueryItem(u"template"_s, templateName);
+    if (!locale.isEmpty()) {
+        query.addQueryItem(u"locale"_s, locale);
+    }
+    return m_engine->createRequest("GET",
+                                   u"/test/view/cutelee/render"_s,
+                                   query.toString(QUrl::FullyEncoded).toLatin1(),
+                                   Headers(),
+                                   nullptr);
+}
+
+QByteArray TestCuteleeView::render(const QString &view, const QString &templateName)
+{
+    return request(view, templateName).body;
+}
+
+void TestCuteleeView::doTest()
+{
+    QFETCH(QString, view);
+    QFETCH(QString, templateName);
+    QFETCH(QByteArray, output);
+
+    QCOMPARE(render(view, templateName), output);
+}
+
+void TestCuteleeView::testController_data()
+{
+    QTest::addColumn<QString>("view");
+    QTest::addColumn<QString>("templateName");
+    QTest::addColumn<QByteArray>("output");
+
+    QTest::newRow("plain-cycle") << u"plain"_s << u"cycle.html"_s << "aba"_ba;
+    QTest::newRow("plain-extends") << u"plain"_s << u"child.html"_s << "<child>"_ba;
+    QTest::newRow("cached-cycle") << u"cached"_s << u"cycle.html"_s << "aba"_ba;
+    QTest::newRow("cached-cycle-again") << u"cached"_s << u"cycle.html"_s << "aba"_ba;
+    QTest::newRow("cached-extends") << u"cached"_s << u"child.html"_s << "<child>"_ba;
+}
+
+void TestCuteleeView::testPreloadedCache()
+{
+    auto view = qobject_cast<CuteleeView *>(m_engine->app()->view(u"cached"));
+    QVERIFY(view);
+    QVERIFY(view->isCaching());
+
+    // Compiled by preloadTemplates(), loading it again returns the same instance
+    const Cutelee::Template tmpl = view->engine()->loadByName(u"cycle.html"_s);
+    QVERIFY(tmpl);
+    QCOMPARE(tmpl->error(), Cutelee::NoError);
+    QCOMPARE(view->engine()->loadByName(u"cycle.html"_s).data(), tmpl.data());
+}
+
+void TestCuteleeView::testLocalizer()
+{
+    const QByteArray english = request(u"plain"_s, u"number.html"_s, u"en"_s).body;
+    const QByteArray german  = request(u"plain"_s, u"number.html"_s, u"de"_s).body;
+    QVERIFY(!english.isEmpty());
+    QVERIFY(english != german);
+
+    // Localizers are cached per locale
+    QCOMPARE(request(u"plain"_s, u"number.html"_s, u"en"_s).body, english);
+    QCOMPARE(request(u"plain"_s, u"number.html"_s, u"de"_s).body, german);
+}
+
+void TestCuteleeView::testStreaming()
+{
+    // Small pages are sent as a regular body
+    auto result = request(u"stream"_s, u"cycle.html"_s);
+    QCOMPARE(result.statusCode, 200);
+    QCOMPARE(result.body, "aba"_ba);
+    QVERIFY(!result.headers.contains("Transfer-Encoding"));
+
+    result = request(u"stream"_s, u"big.html"_s);
+    QCOMPARE(result.statusCode, 200);
+    QCOMPARE(result.headers.header("Transfer-Encoding"), "chunked"_ba);
+    QVERIFY(result.body.size() > 100 * 1024);
+    QVERIFY(result.body.endsWith("0\r\n\r\n"));
+
+    // Decode the chunks
+    QByteArray body;
+    qsizetype pos = 0;
+    while (pos < result.body.size()) {
+        const qsizetype lineEnd = result.body.indexOf("\r\n", pos);
+        QVERIFY(lineEnd > pos);
+        bool ok              = false;
+        const qsizetype size = result.body.mid(pos, lineEnd - pos).toLongLong(&ok, 16);
+        QVERIFY(ok);
+        body.append(result.body.mid(lineEnd + 2, size));
+        pos = lineEnd + 2 + size + 2;
+    }
+    QCOMPARE(body, QByteArray(100 * 1024, 'x'));
+}
+
+void TestCuteleeView::testStreamingError()
+{
+    // Nothing was sent yet, the client gets a clean error
+    const auto result = request(u"stream"_s, u"fail.html"_s);
+    QCOMPARE(result.statusCode, 500);
+    QVERIFY(!result.headers.contains("Transfer-Encoding"));
+    QVERIFY(!result.body.contains("before"));
+}
+
+void TestCuteleeView::testWrapperError()
+{
+    const auto result = request(u"wrapped"_s, u"cycle.html"_s);
+    QCOMPARE(result.statusCode, 500);
+    // The error of the wrapper is reported, not the one of the template
+    QVERIFY(result.body.contains("missing-wrapper.html"));
+    QVERIFY(!result.body.contains("aba"));
+}
+
+QTEST_MAIN(TestCuteleeView)
+
+#include "testviewcutelee.moc"
+
+#endif
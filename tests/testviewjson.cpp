@@ -4,11 +4,17 @@
 #include "coverageobject.h"
 
 #include <Cutelyst/Plugins/View/JSON/viewjson.h>
+#include <Cutelyst/JsonWriter>
 #include <Cutelyst/View>
 #include <Cutelyst/application.h>
 #include <Cutelyst/controller.h>
 
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QRegularExpression>
+#include <QUrl>
 #include <QtCore/QObject>
 #include <QtTest/QTest>
 
@@ -89,6 +95,11 @@ private Q_SLOTS:
     void testController_data();
     void testController() { doTest(); }
 
+    void testJsonWriter_data();
+    void testJsonWriter();
+
+    void testJsonWriterDevice();
+
     void cleanupTestCase();
 
 private:
@@ -191,6 +202,90 @@ void TestActionRenderView::testController_data()
         << QByteArrayLiteral("{\n    \"1\": 1\n}\n") << u"application/json"_s << false;
 }
 
+void TestActionRenderView::testJsonWriter_data()
+{
+    QTest::addColumn<QVariant>("value");
+
+    QTest::newRow("null") << QVariant();
+    QTest::newRow("bool") << QVariant(true);
+    QTest::newRow("int") << QVariant(-42);
+    QTest::newRow("int64-min") << QVariant(std::numeric_limits<qint64>::min());
+    QTest::newRow("uint64-max") << QVariant(std::numeric_limits<quint64>::max());
+    QTest::newRow("double") << QVariant(0.1);
+    QTest::newRow("double-small") << QVariant(1.5e-10);
+    QTest::newRow("double-integral") << QVariant(1024.0);
+    QTest::newRow("double-nan") << QVariant(std::numeric_limits<double>::quiet_NaN());
+    QTest::newRow("string") << QVariant(u"Hello \"World\"\\/\b\f\n\r\t\x01\x1f"_s);
+    QTest::newRow("string-unicode") << QVariant(u"ação 😀 \u2028"_s);
+    QTest::newRow("bytearray") << QVariant(u"ação \n"_s.toUtf8());
+    QTest::newRow("bytearray-invalid") << QVariant(QByteArray("a\xff\xfe"));
+    QTest::newRow("stringlist") << QVariant(QStringList{u"a"_s, u"b"_s});
+    QTest::newRow("url") << QVariant(QUrl(u"http://example.com/a b"_s));
+    QTest::newRow("list") << QVariant(QVariantList{1, u"two"_s, QVariantList{}, QVariantMap{}});
+    QTest::newRow("map") << QVariant(QVariantMap{{u"b"_s, 1}, {u"a"_s, QVariantList{true}}});
+    QTest::newRow("hash") << QVariant(QVariantHash{
+        {u"zeta"_s, 1}, {u"alpha"_s, 2}, {u"Beta"_s, 3}, {u"ação"_s, 4}, {u"10"_s, 5}});
+    QTest::newRow("json-object")
+        << QVariant(QJsonObject{{u"k"_s, QJsonArray{1, 2.5, u"x"_s, QJsonValue::Null}}});
+    QTest::newRow("json-document")
+        << QVariant(QJsonDocument(QJsonArray{QJsonObject{{u"k"_s, false}}}));
+}
+
+void TestActionRenderView::testJsonWriter()
+{
+    QFETCH(QVariant, value);
+
+    // Scalars are wrapped so QJsonDocument can write them
+    const QByteArray expected =
+        QJsonDocument(QJsonArray{QJsonValue::fromVariant(value)}).toJson(QJsonDocument::Compact);
+
+    QByteArray fromVariant;
+    JsonWriter::appendVariant(fromVariant, QVariantList{value});
+    QCOMPARE(fromVariant, expected);
+
+    QByteArray fromJson;
+    JsonWriter::appendJson(fromJson, QJsonArray{QJsonValue::fromVariant(value)});
+    QCOMPARE(fromJson, expected);
+}
+
+void TestActionRenderView::testJsonWriterDevice()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    QJsonArray expected;
+    {
+        JsonWriter writer(&buffer, 64);
+        writer.startArray();
+        for (int i = 0; i < 100; ++i) {
+            writer.startObject();
+            writer.writeName(u"id");
+            writer.writeInteger(i);
+            writer.writeName(u"name");
+            writer.writeString(u"item "_s + QString::number(i));
+            writer.writeName(u"tags");
+            writer.startArray();
+            writer.writeBool(i % 2);
+            writer.writeNull();
+            writer.writeDouble(i / 4.0);
+            writer.endArray();
+            writer.endObject();
+
+            expected.append(QJsonObject{
+                {u"id"_s, i},
+                {u"name"_s, u"item "_s + QString::number(i)},
+                {u"tags"_s, QJsonArray{bool(i % 2), QJsonValue::Null, i / 4.0}},
+            });
+        }
+
+        // Blocks are written while the document is built
+        QVERIFY(buffer.size() > 0);
+        writer.endArray();
+    }
+
+    QCOMPARE(buffer.data(), QJsonDocument(expected).toJson(QJsonDocument::Compact));
+}
+
 QTEST_MAIN(TestActionRenderView)
 
 #include "testviewjson.moc"